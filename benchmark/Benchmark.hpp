@@ -0,0 +1,90 @@
+/**
+ * @file Benchmark.hpp
+ * Benchmark helpers
+ *
+ * Small timing, thread pinning and statistics helpers shared by benchmark programs.
+ */
+
+#pragma once
+
+#include <algorithm>  // for std::sort
+#include <chrono>     // for std::chrono::steady_clock
+#include <cstddef>    // for std::size_t
+#include <cstdint>    // for std::uint64_t
+#include <iomanip>    // for std::setw
+#include <iostream>   // for std::cout
+#include <thread>     // for std::thread
+#include <vector>     // for std::vector
+
+#if defined(__linux__)
+    #include <pthread.h>  // for pthread_setaffinity_np
+    #include <sched.h>    // for cpu_set_t
+#elif defined(_WIN32)
+    #include "FTC/Detail/Windows.hpp"  // for SetThreadAffinityMask
+#endif
+
+namespace ftc::bench {
+
+/// Gets a monotonic timestamp in nanoseconds.
+inline std::uint64_t NowNs() noexcept
+{
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+/// Pins the calling thread to a logical cpu (modulo the hardware thread count).
+inline void PinThread(std::size_t cpu) noexcept
+{
+    std::size_t numCpus = std::thread::hardware_concurrency();
+    if (numCpus == 0)
+        return;
+    cpu %= numCpus;
+
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#elif defined(_WIN32)
+    SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << cpu);
+#endif
+}
+
+/// Prevents the compiler from optimizing away a computed value.
+template <typename T> inline void DoNotOptimize(const T &value)
+{
+#if defined(__GNUC__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const T *sink;
+    sink = &value;
+#endif
+}
+
+/// Latency percentiles in nanoseconds.
+struct Percentiles
+{
+    std::uint64_t p50;
+    std::uint64_t p99;
+    std::uint64_t p999;
+};
+
+/// Computes percentiles of samples (samples are sorted in place).
+inline Percentiles ComputePercentiles(std::vector<std::uint64_t> &samples)
+{
+    if (samples.empty())
+        return {};
+
+    std::sort(samples.begin(), samples.end());
+    auto at = [&](double q) { return samples[std::size_t(q * (samples.size() - 1))]; };
+    return {at(0.5), at(0.99), at(0.999)};
+}
+
+/// Prints a row of right-aligned columns.
+template <typename... Ts> inline void PrintRow(const Ts &... columns)
+{
+    ((std::cout << std::setw(14) << columns), ...);
+    std::cout << '\n';
+}
+
+}  // namespace ftc::bench
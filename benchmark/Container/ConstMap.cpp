@@ -0,0 +1,66 @@
+#include "Benchmark.hpp"
+#include "FTC/Container/ConstMap.hpp"
+#include "FTC/Container/FlatHashMap.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+using namespace ftc;
+
+constexpr auto ConfigKeys = MakeConstMap<int>({
+    {"log.level", 0},          {"log.file", 1},           {"log.rotate", 2},
+    {"net.port", 3},           {"net.host", 4},           {"net.timeout_ms", 5},
+    {"net.max_connections", 6}, {"db.url", 7},            {"db.pool_size", 8},
+    {"db.retry", 9},           {"cache.size_mb", 10},     {"cache.ttl_s", 11},
+    {"auth.token", 12},        {"auth.expiry_s", 13},     {"metrics.enabled", 14},
+    {"metrics.interval_ms", 15},
+});
+
+/// Looks up numLookups keys (hits and misses), returns ns per lookup.
+template <typename F>
+double MeasureLookup(const std::vector<std::string> &queries, std::size_t numLookups, F &&find)
+{
+    std::uint64_t sum     = 0;
+    std::uint64_t t_start = bench::NowNs();
+    for (std::size_t i = 0; i < numLookups; i++)
+        sum += find(std::string_view(queries[i % queries.size()]));
+    std::uint64_t t_end = bench::NowNs();
+    bench::DoNotOptimize(sum);
+    return double(t_end - t_start) / numLookups;
+}
+
+int main(int argc, char *argv[])
+{
+    std::size_t numLookups = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1 << 24;
+
+    std::unordered_map<std::string, int> stdMap;
+    FlatHashMap<std::string, int>        flatMap;
+    std::vector<std::string>             queries;
+    for (const auto &[key, value] : ConfigKeys) {
+        stdMap.emplace(key, value);
+        flatMap.emplace(key, value);
+        queries.emplace_back(key);
+        queries.emplace_back(std::string(key) + ".missing");
+    }
+
+    std::cout << "lookups: " << numLookups << ", half of them missing (ns/lookup)\n";
+    bench::PrintRow("ConstMap", "unordered_map", "FlatHashMap");
+    bench::PrintRow(MeasureLookup(queries,
+                                  numLookups,
+                                  [](std::string_view key) { return ConfigKeys.Get(key, -1); }),
+                    MeasureLookup(queries,
+                                  numLookups,
+                                  [&](std::string_view key) {
+                                      // A std::string key is needed to search std::unordered_map
+                                      auto it = stdMap.find(std::string(key));
+                                      return it == stdMap.end() ? -1 : it->second;
+                                  }),
+                    MeasureLookup(queries, numLookups, [&](std::string_view key) {
+                        auto it = flatMap.find(key);
+                        return it == flatMap.end() ? -1 : it->second;
+                    }));
+}
\ No newline at end of file
@@ -0,0 +1,102 @@
+#include "Benchmark.hpp"
+#include "FTC/Container/FlatHashMap.hpp"
+#include "FTC/Memory/pmr/ProfileResource.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <memory_resource>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+using namespace ftc;
+
+struct Result
+{
+    double insert;  ///< ns per insertion
+    double hit;     ///< ns per successful find
+    double miss;    ///< ns per failed find
+    double erase;   ///< ns per erase
+    double bytes;   ///< Bytes of memory resource in use per entry
+};
+
+/// Runs insert / find / erase of keys on a map allocating from a profile resource.
+/// Keys are looked up through Lookup, to measure heterogeneous lookup of string keys.
+template <typename Map, typename Lookup, typename Key>
+Result Measure(const std::vector<Key> &keys, const std::vector<Key> &missing)
+{
+    pmr::profile_resource profile {pmr::profile_resource::record_mode::none};
+    Map                   m {&profile};
+    Result                r;
+    std::size_t           n = keys.size();
+
+    std::uint64_t t0 = bench::NowNs();
+    for (std::size_t i = 0; i < n; i++)
+        m.emplace(keys[i], i);
+    std::uint64_t t1 = bench::NowNs();
+    r.bytes          = double(profile.get_stat().bytes_in_use) / n;
+
+    std::size_t found = 0;
+    for (const Key &key : keys)
+        found += m.find(Lookup(key)) != m.end();
+    std::uint64_t t2 = bench::NowNs();
+    for (const Key &key : missing)
+        found += m.find(Lookup(key)) != m.end();
+    std::uint64_t t3 = bench::NowNs();
+    bench::DoNotOptimize(found);
+
+    for (const Key &key : keys)
+        m.erase(key);
+    std::uint64_t t4 = bench::NowNs();
+
+    r.insert = double(t1 - t0) / n;
+    r.hit    = double(t2 - t1) / n;
+    r.miss   = double(t3 - t2) / n;
+    r.erase  = double(t4 - t3) / n;
+    return r;
+}
+
+void PrintResult(const char *name, const Result &r)
+{
+    bench::PrintRow(name, r.insert, r.hit, r.miss, r.erase, r.bytes);
+}
+
+int main(int argc, char *argv[])
+{
+    std::size_t maxSize = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1 << 20;
+
+    std::mt19937_64 rng(42);
+    for (std::size_t n = 1024; n <= maxSize; n *= 32) {
+        std::vector<std::uint64_t> keys(n), missing(n);
+        for (std::size_t i = 0; i < n; i++) {
+            keys[i]    = rng() & ~std::uint64_t(1);
+            missing[i] = rng() | 1;
+        }
+        std::cout << '\n' << n << " uint64 keys (ns/op, bytes/entry)\n";
+        bench::PrintRow("map", "insert", "find hit", "find miss", "erase", "bytes");
+        PrintResult("unordered_map",
+                    Measure<std::pmr::unordered_map<std::uint64_t, std::size_t>, std::uint64_t>(
+                        keys, missing));
+        PrintResult("FlatHashMap",
+                    Measure<FlatHashMap<std::uint64_t, std::size_t>, std::uint64_t>(keys, missing));
+    }
+
+    // std::unordered_map needs a std::string to look up a std::string_view
+    for (std::size_t n = 1024; n <= maxSize; n *= 32) {
+        std::vector<std::pmr::string> keys(n), missing(n);
+        for (std::size_t i = 0; i < n; i++) {
+            keys[i]    = "some/resource/path/" + std::to_string(rng() << 1);
+            missing[i] = "some/resource/path/" + std::to_string((rng() << 1) | 1);
+        }
+        std::cout << '\n' << n << " string keys, found by string_view (ns/op, bytes/entry)\n";
+        bench::PrintRow("map", "insert", "find hit", "find miss", "erase", "bytes");
+        PrintResult("unordered_map",
+                    Measure<std::pmr::unordered_map<std::pmr::string, std::size_t>,
+                            std::pmr::string>(keys, missing));
+        PrintResult("FlatHashMap",
+                    Measure<FlatHashMap<std::pmr::string, std::size_t>, std::string_view>(keys,
+                                                                                        missing));
+    }
+}
\ No newline at end of file
@@ -0,0 +1,193 @@
+#include "Benchmark.hpp"
+#include "FTC/Container/LockFreeCircularQueue.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#ifdef FTC_HAS_BOOST_LOCKFREE
+    #include <boost/lockfree/queue.hpp>
+    #include <boost/lockfree/spsc_queue.hpp>
+#endif
+
+using namespace ftc;
+
+constexpr std::size_t QueueSize = 4096;
+
+// Every queue below is driven through TryPush(std::uint64_t) / TryPop(std::uint64_t &).
+
+template <bool SP, bool SC> class FtcQueue
+{
+public:
+    bool TryPush(std::uint64_t v) { return queue.TryPush(v); }
+    bool TryPop(std::uint64_t &v)
+    {
+        std::optional<std::uint64_t> item = queue.TryPop();
+        if (item)
+            v = *item;
+        return item.has_value();
+    }
+
+private:
+    LockFreeCircularQueue<std::uint64_t, QueueSize, SP, SC> queue;
+};
+
+class MutexDequeQueue
+{
+public:
+    bool TryPush(std::uint64_t v)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (queue.size() >= QueueSize)
+            return false;
+        queue.push_back(v);
+        return true;
+    }
+    bool TryPop(std::uint64_t &v)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (queue.empty())
+            return false;
+        v = queue.front();
+        queue.pop_front();
+        return true;
+    }
+
+private:
+    std::mutex                mutex;
+    std::deque<std::uint64_t> queue;
+};
+
+#ifdef FTC_HAS_BOOST_LOCKFREE
+class BoostSpscQueue
+{
+public:
+    bool TryPush(std::uint64_t v) { return queue.push(v); }
+    bool TryPop(std::uint64_t &v) { return queue.pop(v); }
+
+private:
+    boost::lockfree::spsc_queue<std::uint64_t, boost::lockfree::capacity<QueueSize>> queue;
+};
+
+class BoostMpmcQueue
+{
+public:
+    bool TryPush(std::uint64_t v) { return queue.bounded_push(v); }
+    bool TryPop(std::uint64_t &v) { return queue.pop(v); }
+
+private:
+    boost::lockfree::queue<std::uint64_t, boost::lockfree::capacity<QueueSize>> queue;
+};
+#endif
+
+struct Result
+{
+    double             mops;
+    bench::Percentiles latency;
+};
+
+/// Pushes numItems timestamps from numProducers threads and pops them from numConsumers threads.
+/// Latency is the time from push to pop of each item, so it includes time spent in the queue.
+template <typename Queue>
+Result Measure(std::size_t numProducers, std::size_t numConsumers, std::size_t numItems)
+{
+    auto queue = std::make_unique<Queue>();
+
+    std::size_t                             perProducer = numItems / numProducers;
+    std::size_t                             perConsumer = numItems / numConsumers;
+    std::vector<std::vector<std::uint64_t>> latencies(numConsumers);
+    std::atomic<std::size_t>                ready {0};
+    std::atomic<bool>                       go {false};
+    std::vector<std::thread>                threads;
+
+    auto waitForStart = [&](std::size_t cpu) {
+        bench::PinThread(cpu);
+        ready.fetch_add(1);
+        while (!go.load(std::memory_order_acquire))
+            std::this_thread::yield();
+    };
+
+    for (std::size_t i = 0; i < numProducers; i++) {
+        threads.emplace_back([&, i] {
+            waitForStart(i);
+            for (std::size_t n = 0; n < perProducer; n++) {
+                while (!queue->TryPush(bench::NowNs()))
+                    std::this_thread::yield();
+            }
+        });
+    }
+    for (std::size_t i = 0; i < numConsumers; i++) {
+        threads.emplace_back([&, i] {
+            std::vector<std::uint64_t> &samples = latencies[i];
+            samples.reserve(perConsumer);
+            waitForStart(numProducers + i);
+            for (std::size_t n = 0; n < perConsumer; n++) {
+                std::uint64_t stamp;
+                while (!queue->TryPop(stamp))
+                    std::this_thread::yield();
+                samples.push_back(bench::NowNs() - stamp);
+            }
+        });
+    }
+
+    while (ready.load() != threads.size())
+        std::this_thread::yield();
+    std::uint64_t t_start = bench::NowNs();
+    go.store(true, std::memory_order_release);
+    for (std::thread &t : threads)
+        t.join();
+    std::uint64_t t_end = bench::NowNs();
+
+    std::vector<std::uint64_t> samples;
+    samples.reserve(numItems);
+    for (std::vector<std::uint64_t> &s : latencies)
+        samples.insert(samples.end(), s.begin(), s.end());
+
+    return {numItems * 1000.0 / (t_end - t_start), bench::ComputePercentiles(samples)};
+}
+
+template <typename Queue>
+void Report(const char *name,
+            std::size_t numProducers,
+            std::size_t numConsumers,
+            std::size_t numItems)
+{
+    Result r = Measure<Queue>(numProducers, numConsumers, numItems);
+    bench::PrintRow(name, r.mops, r.latency.p50, r.latency.p99, r.latency.p999);
+}
+
+template <bool SP, bool SC> void RunConfig(const char *title, std::size_t numItems)
+{
+    std::size_t numProducers = SP ? 1 : 4;
+    std::size_t numConsumers = SC ? 1 : 4;
+
+    std::cout << '\n' << title << " (" << numProducers << " producers, " << numConsumers
+              << " consumers)\n";
+    bench::PrintRow("queue", "Mops/s", "p50(ns)", "p99(ns)", "p999(ns)");
+    Report<FtcQueue<SP, SC>>("ftc", numProducers, numConsumers, numItems);
+    Report<MutexDequeQueue>("mutex+deque", numProducers, numConsumers, numItems);
+#ifdef FTC_HAS_BOOST_LOCKFREE
+    if constexpr (SP && SC)
+        Report<BoostSpscQueue>("boost::spsc", numProducers, numConsumers, numItems);
+    Report<BoostMpmcQueue>("boost::queue", numProducers, numConsumers, numItems);
+#endif
+}
+
+int main(int argc, char *argv[])
+{
+    std::size_t numItems = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1 << 20;
+    numItems             = (numItems + 3) / 4 * 4;  // divisible among 4 threads
+
+    std::cout << "items: " << numItems << ", queue size: " << QueueSize
+              << ", hardware threads: " << std::thread::hardware_concurrency() << '\n';
+    RunConfig<true, true>("SPSC", numItems);
+    RunConfig<false, true>("MPSC", numItems);
+    RunConfig<true, false>("SPMC", numItems);
+    RunConfig<false, false>("MPMC", numItems);
+}
\ No newline at end of file
@@ -0,0 +1,106 @@
+#include "Benchmark.hpp"
+#include "FTC/Container/SmallString.hpp"
+#include "FTC/Container/SmallVector.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <memory_resource>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+using namespace ftc;
+
+template <typename T> T MakeValue(std::size_t i)
+{
+    if constexpr (std::is_arithmetic_v<T>)
+        return T(i);
+    else
+        return T(std::to_string(i));
+}
+
+/// Builds and destroys numRounds containers of length elements, returns ns per element.
+template <typename Vector> double MeasurePushBack(std::size_t length, std::size_t numRounds)
+{
+    std::uint64_t t_start = bench::NowNs();
+    for (std::size_t r = 0; r < numRounds; r++) {
+        Vector v;
+        for (std::size_t i = 0; i < length; i++)
+            v.push_back(MakeValue<typename Vector::value_type>(i));
+        bench::DoNotOptimize(v.data());
+    }
+    std::uint64_t t_end = bench::NowNs();
+    return double(t_end - t_start) / (numRounds * length);
+}
+
+/// Copies a vector of length elements numRounds times, returns ns per copy.
+template <typename Vector> double MeasureCopy(std::size_t length, std::size_t numRounds)
+{
+    Vector source;
+    for (std::size_t i = 0; i < length; i++)
+        source.push_back(MakeValue<typename Vector::value_type>(i));
+
+    std::uint64_t t_start = bench::NowNs();
+    for (std::size_t r = 0; r < numRounds; r++) {
+        Vector copy = source;
+        bench::DoNotOptimize(copy.data());
+    }
+    std::uint64_t t_end = bench::NowNs();
+    return double(t_end - t_start) / numRounds;
+}
+
+/// Builds numRounds strings of length characters by appending, returns ns per string.
+template <typename String> double MeasureString(std::size_t length, std::size_t numRounds)
+{
+    std::uint64_t t_start = bench::NowNs();
+    for (std::size_t r = 0; r < numRounds; r++) {
+        String s;
+        for (std::size_t i = 0; i < length; i++)
+            s += char('a' + i % 26);
+        bench::DoNotOptimize(s.data());
+    }
+    std::uint64_t t_end = bench::NowNs();
+    return double(t_end - t_start) / numRounds;
+}
+
+template <typename T> void RunVector(const char *title, std::size_t numRounds)
+{
+    std::cout << '\n' << title << " push_back (ns/element)\n";
+    bench::PrintRow("length", "std::vector", "pmr::vector", "SmallVec<16>");
+    for (std::size_t length : {4, 16, 64, 1024}) {
+        std::size_t rounds = numRounds / length;
+        bench::PrintRow(length,
+                        MeasurePushBack<std::vector<T>>(length, rounds),
+                        MeasurePushBack<std::pmr::vector<T>>(length, rounds),
+                        MeasurePushBack<SmallVector<T, 16>>(length, rounds));
+    }
+
+    std::cout << '\n' << title << " copy (ns/copy)\n";
+    bench::PrintRow("length", "std::vector", "pmr::vector", "SmallVec<16>");
+    for (std::size_t length : {4, 16, 64, 1024}) {
+        std::size_t rounds = numRounds / length;
+        bench::PrintRow(length,
+                        MeasureCopy<std::vector<T>>(length, rounds),
+                        MeasureCopy<std::pmr::vector<T>>(length, rounds),
+                        MeasureCopy<SmallVector<T, 16>>(length, rounds));
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    std::size_t numRounds = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1 << 22;
+
+    std::cout << "elements per configuration: " << numRounds << '\n';
+    RunVector<int>("int", numRounds);
+    RunVector<std::string>("std::string", numRounds / 4);
+
+    std::cout << "\nappend characters (ns/string)\n";
+    bench::PrintRow("length", "std::string", "SmallStr<32>", "SmallStr<64>");
+    for (std::size_t length : {8, 24, 48, 256}) {
+        std::size_t rounds = numRounds / length;
+        bench::PrintRow(length,
+                        MeasureString<std::string>(length, rounds),
+                        MeasureString<SmallString<32>>(length, rounds),
+                        MeasureString<SmallString<64>>(length, rounds));
+    }
+}
\ No newline at end of file
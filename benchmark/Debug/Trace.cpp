@@ -0,0 +1,45 @@
+#include "Benchmark.hpp"
+#include "FTC/Debug/Trace.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <sstream>
+
+using namespace ftc;
+
+/// Runs numScopes traced scopes, returns ns per scope
+double MeasureScopes(std::size_t numScopes)
+{
+    std::uint64_t sum     = 0;
+    std::uint64_t t_start = bench::NowNs();
+    for (std::size_t i = 0; i < numScopes; i++) {
+        TRACE_SCOPE("bench");
+        sum += i;
+        bench::DoNotOptimize(sum);
+    }
+    std::uint64_t t_end = bench::NowNs();
+    return double(t_end - t_start) / numScopes;
+}
+
+int main(int argc, char *argv[])
+{
+    std::size_t numScopes = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1 << 16;
+
+    // The drainer stays idle while recording, so that only the cost of recording is measured
+    // even on a single core, then exports every event at Stop()
+    TraceOptions options;
+    options.drainPeriod    = std::chrono::hours(1);
+    options.bufferCapacity = numScopes;
+
+    std::ostringstream out;
+    double             idle = MeasureScopes(numScopes);
+    Tracer::Instance().Start(out, options);
+    double        recording = MeasureScopes(numScopes);
+    std::uint64_t t_start   = bench::NowNs();
+    Tracer::Instance().Stop();
+    double exporting = double(bench::NowNs() - t_start) / numScopes;
+
+    std::cout << "scopes: " << numScopes << " (ns/scope)\n";
+    bench::PrintRow("idle", "recording", "exporting", "dropped");
+    bench::PrintRow(idle, recording, exporting, Tracer::Instance().DroppedEvents());
+}
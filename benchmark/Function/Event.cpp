@@ -0,0 +1,72 @@
+#include "Benchmark.hpp"
+#include "FTC/Function/Event.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <vector>
+
+using namespace ftc;
+
+/// Listener state of 24 bytes, too large for the small buffer of std::function
+struct Listener
+{
+    std::uint64_t *sum;
+    std::uint64_t  weight;
+    std::uint64_t  offset;
+
+    void operator()(std::uint64_t x) const { *sum += x * weight + offset; }
+};
+
+/// Dispatches numRounds times to numListeners listeners, returns ns per listener call.
+template <typename Dispatcher, typename Subscribe, typename Dispatch>
+double MeasureDispatch(std::size_t numListeners,
+                       std::size_t numRounds,
+                       Subscribe &&subscribe,
+                       Dispatch &&  dispatch)
+{
+    Dispatcher    dispatcher;
+    std::uint64_t sum = 0;
+
+    // Interleave other allocations, as listeners of a long running program are scattered
+    std::vector<std::unique_ptr<char[]>> noise;
+    for (std::size_t i = 0; i < numListeners; i++) {
+        subscribe(dispatcher, Listener {&sum, i, i * 3});
+        noise.emplace_back(new char[64 + i % 7 * 48]);
+    }
+
+    std::uint64_t t_start = bench::NowNs();
+    for (std::size_t r = 0; r < numRounds; r++)
+        dispatch(dispatcher, std::uint64_t(r));
+    std::uint64_t t_end = bench::NowNs();
+    bench::DoNotOptimize(sum);
+    return double(t_end - t_start) / double(numRounds * numListeners);
+}
+
+int main(int argc, char *argv[])
+{
+    std::size_t numCalls = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1 << 24;
+
+    using FunctionVector = std::vector<std::function<void(std::uint64_t)>>;
+    auto pushFunction    = [](FunctionVector &v, Listener l) { v.push_back(l); };
+    auto callFunctions   = [](FunctionVector &v, std::uint64_t x) {
+        for (auto &f : v)
+            f(x);
+    };
+    auto subscribeEvent = [](Event<void(std::uint64_t)> &e, Listener l) { e.Subscribe(l); };
+    auto dispatchEvent  = [](Event<void(std::uint64_t)> &e, std::uint64_t x) { e(x); };
+
+    std::cout << "dispatch (ns/listener)\n";
+    bench::PrintRow("listeners", "std::function", "Event");
+    for (std::size_t numListeners : {4, 64, 1024, 65536}) {
+        std::size_t rounds = numCalls / numListeners;
+        bench::PrintRow(
+            numListeners,
+            MeasureDispatch<FunctionVector>(numListeners, rounds, pushFunction, callFunctions),
+            MeasureDispatch<Event<void(std::uint64_t)>>(numListeners,
+                                                        rounds,
+                                                        subscribeEvent,
+                                                        dispatchEvent));
+    }
+}
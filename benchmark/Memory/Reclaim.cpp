@@ -0,0 +1,110 @@
+#include "Benchmark.hpp"
+#include "FTC/Memory/Reclaim.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace ftc;
+
+struct Config
+{
+    std::uint64_t values[8];
+};
+
+/// Runs numThreads readers doing numReads reads each while a writer keeps replacing the
+/// config, returns ns per read of a reader.
+template <typename Read, typename Replace>
+double MeasureRead(std::size_t numThreads, std::size_t numReads, Read read, Replace replace)
+{
+    std::atomic<bool>          stop {false};
+    std::atomic<std::uint64_t> totalNs {0};
+    std::vector<std::thread>   readers;
+    for (std::size_t t = 0; t < numThreads; t++)
+        readers.emplace_back([&, t] {
+            bench::PinThread(t + 1);
+            std::uint64_t sum     = 0;
+            std::uint64_t t_start = bench::NowNs();
+            for (std::size_t i = 0; i < numReads; i++)
+                sum += read(i);
+            totalNs += bench::NowNs() - t_start;
+            bench::DoNotOptimize(sum);
+        });
+
+    std::thread writer([&] {
+        bench::PinThread(0);
+        for (std::uint64_t v = 0; !stop.load(std::memory_order_relaxed); v++) {
+            replace(v);
+            std::this_thread::sleep_for(std::chrono::microseconds(10));
+        }
+    });
+    for (std::thread &t : readers)
+        t.join();
+    stop = true;
+    writer.join();
+    return double(totalNs.load()) / (numThreads * numReads);
+}
+
+int main(int argc, char *argv[])
+{
+    std::size_t numReads   = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1 << 24;
+    std::size_t maxThreads = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+
+    std::cout << "reads per thread: " << numReads
+              << ", a writer replaces the object every 10us (ns/read)\n";
+    bench::PrintRow("readers", "unsafe load", "EpochDomain", "HazardPointer", "shared_ptr");
+    for (std::size_t numThreads = 1; numThreads <= maxThreads; numThreads *= 2) {
+        // Baseline leaking every replaced object
+        std::atomic<Config *> leaky {new Config {}};
+        double                unsafe = MeasureRead(
+            numThreads,
+            numReads,
+            [&](std::size_t i) { return leaky.load(std::memory_order_acquire)->values[i & 7]; },
+            [&](std::uint64_t v) { leaky.store(new Config {{v}}, std::memory_order_release); });
+
+        EpochDomain           epochDomain;
+        std::atomic<Config *> epochConfig {new Config {}};
+        double                epoch = MeasureRead(
+            numThreads,
+            numReads,
+            [&](std::size_t i) {
+                EpochDomain::Guard guard = epochDomain.Pin();
+                return epochConfig.load(std::memory_order_acquire)->values[i & 7];
+            },
+            [&](std::uint64_t v) { epochDomain.Retire(epochConfig.exchange(new Config {{v}})); });
+        epochDomain.Retire(epochConfig.exchange(nullptr));
+
+        HazardDomain          hazardDomain;
+        std::atomic<Config *> hazardConfig {new Config {}};
+        double                hazard = MeasureRead(
+            numThreads,
+            numReads,
+            [&](std::size_t i) {
+                thread_local HazardPointer hp {hazardDomain};
+                std::uint64_t              value = hp.Protect(hazardConfig)->values[i & 7];
+                hp.Reset();
+                return value;
+            },
+            [&](std::uint64_t v) {
+                hazardDomain.Retire(hazardConfig.exchange(new Config {{v}}));
+            });
+        hazardDomain.Retire(hazardConfig.exchange(nullptr));
+
+        // The usual fix, paying two refcount updates on a shared cache line per read
+        std::shared_ptr<Config> shared     = std::make_shared<Config>();
+        double                  refcounted = MeasureRead(
+            numThreads,
+            numReads,
+            [&](std::size_t i) { return std::atomic_load(&shared)->values[i & 7]; },
+            [&](std::uint64_t v) {
+                std::atomic_store(&shared, std::make_shared<Config>(Config {{v}}));
+            });
+
+        bench::PrintRow(numThreads, unsafe, epoch, hazard, refcounted);
+    }
+}
\ No newline at end of file
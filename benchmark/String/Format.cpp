@@ -0,0 +1,82 @@
+#include "Benchmark.hpp"
+#include "FTC/String/Format.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <sstream>
+
+using namespace ftc;
+
+constexpr auto LogLine = FORMAT_STRING("[{:>8}] req #{} from {:x} took {:.3f} ms ({})");
+
+/// Formats numLines log lines with f(buffer, size, i), returns ns per line.
+template <typename F> double MeasureFormat(std::size_t numLines, F &&f)
+{
+    char          buffer[256];
+    std::uint64_t sum     = 0;
+    std::uint64_t t_start = bench::NowNs();
+    for (std::size_t i = 0; i < numLines; i++) {
+        sum += f(buffer, sizeof(buffer), i);
+        bench::DoNotOptimize(buffer);
+    }
+    std::uint64_t t_end = bench::NowNs();
+    bench::DoNotOptimize(sum);
+    return double(t_end - t_start) / numLines;
+}
+
+int main(int argc, char *argv[])
+{
+    std::size_t numLines = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1 << 22;
+    const char *module   = "network";
+
+    std::cout << "lines: " << numLines << ", logger style line with 5 fields (ns/line)\n";
+    bench::PrintRow("FormatTo", "snprintf", "ostringstream", "Format");
+    bench::PrintRow(
+        MeasureFormat(numLines,
+                      [&](char *buffer, std::size_t size, std::size_t i) {
+                          return FormatTo(buffer,
+                                          size,
+                                          LogLine,
+                                          module,
+                                          i,
+                                          0xC0A80000u + unsigned(i & 0xFF),
+                                          double(i % 1000) * 0.125,
+                                          i & 1 ? "ok" : "retry");
+                      }),
+        MeasureFormat(numLines,
+                      [&](char *buffer, std::size_t size, std::size_t i) {
+                          return std::size_t(
+                              std::snprintf(buffer,
+                                            size,
+                                            "[%8s] req #%zu from %x took %.3f ms (%s)",
+                                            module,
+                                            i,
+                                            0xC0A80000u + unsigned(i & 0xFF),
+                                            double(i % 1000) * 0.125,
+                                            i & 1 ? "ok" : "retry"));
+                      }),
+        MeasureFormat(numLines,
+                      [&](char *buffer, std::size_t, std::size_t i) {
+                          std::ostringstream ss;
+                          ss << '[' << std::setw(8) << module << "] req #" << i << " from "
+                             << std::hex << 0xC0A80000u + unsigned(i & 0xFF) << std::dec
+                             << " took " << std::fixed << std::setprecision(3)
+                             << double(i % 1000) * 0.125 << " ms (" << (i & 1 ? "ok" : "retry")
+                             << ')';
+                          buffer[0] = ss.str()[0];
+                          return std::size_t(ss.tellp());
+                      }),
+        MeasureFormat(numLines, [&](char *buffer, std::size_t, std::size_t i) {
+            // Into an inline SmallString, still without allocation
+            SmallString<127> s = Format(LogLine,
+                                        module,
+                                        i,
+                                        0xC0A80000u + unsigned(i & 0xFF),
+                                        double(i % 1000) * 0.125,
+                                        i & 1 ? "ok" : "retry");
+            buffer[0] = s[0];
+            return s.size();
+        }));
+}
\ No newline at end of file
@@ -0,0 +1,87 @@
+#include "Benchmark.hpp"
+#include "FTC/String/Simd.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+
+using namespace ftc;
+using namespace ftc::simd;
+
+/// Runs f(input) numIters times, returns the throughput in GB/s
+template <typename F>
+double MeasureThroughput(std::size_t numIters, std::string_view input, F &&f)
+{
+    std::uint64_t sum     = 0;
+    std::uint64_t t_start = bench::NowNs();
+    for (std::size_t i = 0; i < numIters; i++) {
+        bench::DoNotOptimize(input);  // Not loop invariant
+        sum += f(input);
+    }
+    std::uint64_t t_end = bench::NowNs();
+    bench::DoNotOptimize(sum);
+    return double(numIters * input.size()) / double(t_end - t_start);
+}
+
+int main(int argc, char *argv[])
+{
+    std::size_t numIters = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1 << 14;
+    std::size_t length   = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1 << 14;
+
+    // A line of text with the searched characters at the very end
+    std::string text;
+    for (std::size_t i = 0; text.size() < length; i++)
+        text += "the quick brown fox jumps over the lazy dog " + std::to_string(i) + ' ';
+    text.resize(length);
+    std::string line = text + "Content-Length: 42\r\n";
+    std::string copy = line, upper = ToUpper(line), out = line;
+
+    constexpr CharSet  Delims(ConstString("\r\n;=&"));
+    constexpr Searcher Header(ConstString("Content-Length:"));
+
+    std::cout << "bytes: " << line.size() << ", iterations: " << numIters << " (GB/s)\n";
+    bench::PrintRow("level",
+                    "FindChar",
+                    "FindAnyOf",
+                    "Searcher",
+                    "Equal",
+                    "EqualIcase",
+                    "ToLower",
+                    "IsValidUtf8");
+
+    auto measure = [&](auto &&f) { return MeasureThroughput(numIters, line, f); };
+    auto printLevel = [&](const char *name) {
+        bench::PrintRow(name,
+                        measure([&](std::string_view s) { return FindChar(s, '\r'); }),
+                        measure([&](std::string_view s) { return FindAnyOf(s, Delims); }),
+                        measure([&](std::string_view s) { return Header.Find(s); }),
+                        measure([&](std::string_view s) { return Equal(s, copy); }),
+                        measure([&](std::string_view s) { return EqualIgnoreCase(s, upper); }),
+                        measure([&](std::string_view s) {
+                            ToLower(s, out.data());
+                            return std::size_t(out[0]);
+                        }),
+                        measure([&](std::string_view s) { return IsValidUtf8(s); }));
+    };
+
+    bench::PrintRow("std",
+                    measure([&](std::string_view s) { return s.find('\r'); }),
+                    measure([&](std::string_view s) { return s.find_first_of("\r\n;=&"); }),
+                    measure([&](std::string_view s) { return s.find("Content-Length:"); }),
+                    measure([&](std::string_view s) { return s == copy; }),
+                    "-",
+                    "-",
+                    "-");
+
+    SimdLevel saved = ActiveLevel();
+    for (auto [level, name] : {std::pair {SimdLevel::Scalar, "Scalar"},
+                               std::pair {SimdLevel::SSE2, "SSE2"},
+                               std::pair {SimdLevel::SSE42, "SSE4.2"},
+                               std::pair {SimdLevel::AVX2, "AVX2"},
+                               std::pair {SimdLevel::NEON, "NEON"}}) {
+        if (SetLevel(level) == level)
+            printLevel(name);
+    }
+    SetLevel(saved);
+}
@@ -0,0 +1,113 @@
+// Compile time benchmark of Variadic algorithms: this file instantiates every transformation on a
+// pack of FTC_VARIADIC_PACK_SIZE distinct types. The build system reports its compile time and
+// builds it with a small template depth limit, so that a recursive algorithm fails to compile.
+
+#include "FTC/Utility/Variadic.hpp"
+
+#include <cstddef>
+#include <iostream>
+#include <type_traits>
+#include <utility>
+
+#ifndef FTC_VARIADIC_PACK_SIZE
+    #define FTC_VARIADIC_PACK_SIZE 32
+#endif
+
+using namespace ftc::variadic;
+
+constexpr std::size_t PackSize = FTC_VARIADIC_PACK_SIZE;
+
+/// Distinct argument types, each algorithm is instantiated for new types
+template <std::size_t I> struct Tag
+{
+    static constexpr std::size_t value = I;
+};
+
+/// Weighted sum of indices of the received tags, checks the order of arguments
+struct Checksum
+{
+    template <typename... Ts> constexpr std::size_t operator()(Ts...) const
+    {
+        std::size_t sum = 0;
+        std::size_t pos = 0;
+        ((sum += ++pos * (Ts::value + 1)), ...);
+        return sum;
+    }
+};
+
+template <typename F, std::size_t... I> constexpr auto Apply(F &&func, std::index_sequence<I...>)
+{
+    return std::forward<F>(func)(Tag<I> {}...);
+}
+
+template <typename F> constexpr auto Apply(F &&func)
+{
+    return Apply(std::forward<F>(func), std::make_index_sequence<PackSize>());
+}
+
+struct IsEven
+{
+    template <std::size_t I> constexpr auto operator()(Tag<I>) const
+    {
+        return std::bool_constant<I % 2 == 0> {};
+    }
+};
+
+struct AddIndex
+{
+    template <std::size_t I> constexpr std::size_t operator()(std::size_t acc, Tag<I>) const
+    {
+        return acc + I;
+    }
+    template <std::size_t I> constexpr std::size_t operator()(Tag<I>, std::size_t acc) const
+    {
+        return acc + I;
+    }
+};
+
+struct Next
+{
+    template <std::size_t I> constexpr auto operator()(Tag<I>) const { return Tag<I + 1> {}; }
+};
+
+template <std::size_t... I> constexpr std::size_t ExpectedChecksum(std::index_sequence<I...>)
+{
+    return Checksum {}(Tag<I> {}...);
+}
+
+constexpr std::size_t Expected = ExpectedChecksum(std::make_index_sequence<PackSize>());
+
+static_assert(Apply(Checksum {}) == Expected);
+static_assert(Apply(Reverse(Reverse(Checksum {}))) == Expected);
+static_assert(Apply(RotateLeft<PackSize / 3>(RotateRight<PackSize / 3>(Checksum {}))) ==
+              Expected);
+static_assert(Apply(Swap<0, PackSize - 1>(Swap<PackSize - 1, 0>(Checksum {}))) == Expected);
+static_assert(Apply(Take<PackSize / 2>(Checksum {})) ==
+              ExpectedChecksum(std::make_index_sequence<PackSize / 2>()));
+static_assert(Apply(Drop<1>(Reverse(Checksum {}))) ==
+              Apply(Take<1 - int(PackSize)>(Reverse(Checksum {}))));
+static_assert(Apply(Slice<1, PackSize / 2>(Checksum {})) ==
+              Apply(Take<PackSize / 2>(Drop<1>(Checksum {}))));
+static_assert(Apply(ReplaceAt<-1>(Tag<PackSize - 1> {}, Checksum {})) == Expected);
+static_assert(Apply(Permute<-1, 0, 1>(Checksum {})) == Checksum {}(Tag<PackSize - 1> {},
+                                                                  Tag<0> {},
+                                                                  Tag<1> {}));
+static_assert(Apply(Filter(IsEven {}, [](auto... vs) { return sizeof...(vs); })) ==
+              (PackSize + 1) / 2);
+static_assert(Apply(Map(Next {}, Drop<-1>(Checksum {}))) == Apply(Drop<1>(Checksum {})));
+static_assert(Apply(Foldl(AddIndex {}, std::size_t(0))) == PackSize * (PackSize - 1) / 2);
+static_assert(Apply(Foldr(AddIndex {}, std::size_t(0))) == PackSize * (PackSize - 1) / 2);
+static_assert(Apply([](auto... vs) { return decltype(Get<-1>(vs...))::value; }) == PackSize - 1);
+static_assert(Apply([](auto... vs) { return decltype(Last(vs...))::value; }) == PackSize - 1);
+static_assert(Apply([](auto... vs) { return type_at_t<PackSize / 2, decltype(vs)...>::value; }) ==
+              PackSize / 2);
+static_assert(Apply([](auto... vs) { return !are_same_v<decltype(vs)...>; }));
+static_assert(IndexSequence<PackSize>([](auto... is) { return (is + ... + 0); }) ==
+              PackSize * (PackSize - 1) / 2);
+static_assert(IntSequence<int(PackSize), 0, -1>([](auto... is) { return sizeof...(is); }) ==
+              PackSize);
+
+int main()
+{
+    std::cout << "Variadic algorithms instantiated on a pack of " << PackSize << " types\n";
+}
@@ -0,0 +1,56 @@
+#include "FTC/Concurrency/ThreadPool.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+using namespace ftc;
+
+long Fibonacci(ThreadPool &pool, int n)
+{
+    if (n < 20) {
+        long a = 0, b = 1;
+        for (int i = 0; i < n; i++)
+            b = a + std::exchange(a, b);
+        return a;
+    }
+
+    // Fork one half, compute the other half on this thread
+    TaskFuture<long> left  = pool.Submit([&pool, n] { return Fibonacci(pool, n - 1); });
+    long             right = Fibonacci(pool, n - 2);
+    return left.Get() + right;
+}
+
+int main()
+{
+    ThreadPool pool;
+    std::cout << "workers: " << pool.NumThreads() << std::endl;
+
+    TaskFuture<int> answer = pool.Submit([] { return 42; });
+    std::cout << "answer: " << answer.Get() << std::endl;
+
+    std::chrono::time_point t_start = std::chrono::steady_clock::now();
+    std::cout << "fib(32): " << Fibonacci(pool, 32) << std::endl;
+    std::chrono::time_point                   t_end = std::chrono::steady_clock::now();
+    std::chrono::duration<double, std::milli> dt    = t_end - t_start;
+    std::cout << "fork-join took " << dt.count() << " ms" << std::endl;
+
+    std::vector<double> values(1 << 20);
+    pool.ParallelFor(std::size_t(0), values.size(), [&](std::size_t i) {
+        values[i] = std::sqrt(double(i));
+    });
+    double sum = 0;
+    for (double v : values)
+        sum += v;
+    std::cout << "sum of sqrt: " << sum << std::endl;
+
+    try {
+        pool.Submit([]() -> int { throw std::runtime_error("task failed"); }).Get();
+    }
+    catch (const std::exception &e) {
+        std::cout << "caught: " << e.what() << std::endl;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,86 @@
+#include "FTC/Container/LockFreeCircularQueue.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace ftc;
+
+constexpr std::size_t QueueSize = 4096;
+constexpr std::size_t NumItems  = 1 << 22;
+
+template <typename Queue> double MeasureBulk(std::size_t batchSize)
+{
+    auto queue = std::make_unique<Queue>();
+
+    std::chrono::time_point t_start = std::chrono::steady_clock::now();
+
+    std::thread producer([&] {
+        std::vector<std::uint64_t> batch(batchSize);
+        for (std::size_t i = 0; i < NumItems;) {
+            std::size_t count = std::min(batchSize, NumItems - i);
+            for (std::size_t j = 0; j < count; j++)
+                batch[j] = i + j;
+            for (std::size_t pushed = 0; pushed < count;) {
+                std::size_t n = queue->TryPushBulk(batch.begin() + pushed, batch.begin() + count);
+                if (n == 0)
+                    std::this_thread::yield();
+                pushed += n;
+            }
+            i += count;
+        }
+    });
+
+    std::vector<std::uint64_t> batch(batchSize);
+    std::uint64_t              sum = 0;
+    for (std::size_t i = 0; i < NumItems;) {
+        std::size_t count = queue->TryPopBulk(batch.begin(), batchSize);
+        if (count == 0)
+            std::this_thread::yield();
+        for (std::size_t j = 0; j < count; j++)
+            sum += batch[j];
+        i += count;
+    }
+    producer.join();
+
+    std::chrono::time_point                   t_end = std::chrono::steady_clock::now();
+    std::chrono::duration<double, std::milli> dt    = t_end - t_start;
+    if (sum != (std::uint64_t)NumItems * (NumItems - 1) / 2)
+        std::cout << "checksum mismatch!\n";
+    return NumItems / dt.count() / 1000.0;
+}
+
+template <bool SP, bool SC, typename Layout = PaddedLayout>
+using Queue = LockFreeCircularQueue<std::uint64_t, QueueSize, SP, SC, BusySpinWait, Layout>;
+
+int main()
+{
+    std::cout << "batch   SPSC(Mops/s)   MPMC(Mops/s)\n";
+    for (std::size_t batchSize : {1, 8, 32, 64, 128, 256}) {
+        std::cout.width(5);
+        std::cout << batchSize << "   ";
+        std::cout.width(12);
+        std::cout << MeasureBulk<Queue<true, true>>(batchSize) << "   ";
+        std::cout.width(12);
+        std::cout << MeasureBulk<Queue<false, false>>(batchSize) << "\n";
+    }
+
+    std::cout << "\nlayout    size(KiB)   SPSC(Mops/s)   MPMC(Mops/s)\n";
+    std::cout << "padded    ";
+    std::cout.width(9);
+    std::cout << sizeof(Queue<true, true>) / 1024 << "   ";
+    std::cout.width(12);
+    std::cout << MeasureBulk<Queue<true, true>>(1) << "   ";
+    std::cout.width(12);
+    std::cout << MeasureBulk<Queue<false, false>>(1) << "\n";
+    std::cout << "compact   ";
+    std::cout.width(9);
+    std::cout << sizeof(Queue<true, true, CompactLayout>) / 1024 << "   ";
+    std::cout.width(12);
+    std::cout << MeasureBulk<Queue<true, true, CompactLayout>>(1) << "   ";
+    std::cout.width(12);
+    std::cout << MeasureBulk<Queue<false, false, CompactLayout>>(1) << "\n";
+}
\ No newline at end of file
@@ -1,9 +1,13 @@
-﻿#include "FTC/Memory/pmr/ProfileResource.hpp"
+﻿#include "FTC/Memory/pmr/ConcurrentPoolResource.hpp"
+#include "FTC/Memory/pmr/FrameArenaResource.hpp"
+#include "FTC/Memory/pmr/ProfileResource.hpp"
 
 #include <chrono>
 #include <forward_list>
 #include <iostream>
 #include <memory_resource>
+#include <thread>
+#include <vector>
 
 #pragma comment(linker, "/STACK:60000000")
 
@@ -54,6 +58,22 @@ int main()
         std::cout << "-bytes allocated: " << pr.get_stat().bytes_allocated << "\n";
     }
 
+    {
+        pmr::profile_resource pr {pmr::profile_resource::record_mode::none,
+                                  std::pmr::new_delete_resource()};
+        std::pmr::forward_list<int> intList3 {&pr};
+
+        t_start = std::chrono::steady_clock::now();
+
+        for (int i = 0; i < 100000; i++)
+            intList3.push_front(i);
+
+        t_end = std::chrono::steady_clock::now();
+        dt    = t_end - t_start;
+        std::cout << "new_delete(profile, no record)  elapsed time: " << dt.count() << "ms\n";
+        std::cout << "-bytes allocated: " << pr.get_stat().bytes_allocated << "\n";
+    }
+
     {
         std::pmr::monotonic_buffer_resource mbr2 {buffer, sizeof(buffer)};
         pmr::profile_resource               pmbr {&mbr2};
@@ -69,4 +89,46 @@ int main()
         std::cout << "monotonic(profile)  elapsed time: " << dt.count() << "ms\n";
         std::cout << "-bytes allocated: " << pmbr.get_stat().bytes_allocated << "\n";
     }
+
+    {
+        pmr::concurrent_pool_resource cpr {std::pmr::new_delete_resource()};
+
+        t_start = std::chrono::steady_clock::now();
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; t++)
+            threads.emplace_back([&] {
+                std::pmr::forward_list<int> intList5 {&cpr};
+                for (int i = 0; i < 100000; i++)
+                    intList5.push_front(i);
+            });
+        for (std::thread &th : threads)
+            th.join();
+
+        t_end = std::chrono::steady_clock::now();
+        dt    = t_end - t_start;
+        std::cout << "concurrent_pool(4 threads)  elapsed time: " << dt.count() << "ms\n";
+    }
+
+    {
+        pmr::profile_resource     pr {pmr::profile_resource::record_mode::none};
+        pmr::frame_arena_resource arena {&pr};
+
+        t_start = std::chrono::steady_clock::now();
+
+        // 10 "requests" of 10000 nodes each, the arena is reset between requests
+        for (int request = 0; request < 10; request++) {
+            {
+                std::pmr::forward_list<int> intList6 {&arena};
+                for (int i = 0; i < 10000; i++)
+                    intList6.push_front(i);
+            }
+            arena.reset();
+        }
+
+        t_end = std::chrono::steady_clock::now();
+        dt    = t_end - t_start;
+        std::cout << "frame_arena(profile)  elapsed time: " << dt.count() << "ms\n";
+        std::cout << "-peak bytes per request: " << pr.get_stat().bytes_highestest << "\n";
+    }
 }
@@ -1,6 +1,7 @@
 #include "FTC/String/ConstString.hpp"
 
 #include <iostream>
+#include <string>
 
 using namespace ftc;
 
@@ -51,4 +52,13 @@ int main()
 
     std::printf("%s\n", ("abcd" + cs + "edf").c_str());
     std::cout << ToLiteral<123456789>() << '\n';
+
+    static constexpr ConstString metric = "net.http.requests";
+    constexpr auto parts = metric.Split<metric.Count(".") + 1>(".");
+    constexpr auto name  = metric.Replace('.', '_') + "_p" + ToConstString<99>();
+    for (std::string_view part : parts) {
+        std::cout << part << ',';
+    }
+    std::cout << '\n' << name << ' ' << std::hex << name.Hash() << '\n';
+    std::cout << (name.Hash() == HashString(std::string(name.c_str()))) << '\n';
 }
@@ -133,4 +133,12 @@ int main()
     static_assert(std::is_same_v<arg_at_t<decltype(std::move(fo)), 0>, int>);
     static_assert(std::is_same_v<arg_at_t<decltype(std::move(fo)), 1>, float>);
     static_assert(std::is_same_v<arg_at_t<decltype(std::move(fo)), 2>, double>);
+
+    // signature
+    static_assert(std::is_same_v<signature_of_t<decltype(f)>, double(int, float, double)>);
+    static_assert(std::is_same_v<signature_of_t<decltype(&g)>, float(int, float)>);
+    static_assert(std::is_same_v<signature_of_t<decltype(&A::g)>, double(A &, float)>);
+    static_assert(std::is_same_v<signature_of_t<A>, bool(int)>);
+    static_assert(std::is_same_v<signature_of_t<decltype(lambda)>, float(int)>);
+    static_assert(std::is_same_v<signature_of_t<decltype(fo)>, double(int, float, double)>);
 }
\ No newline at end of file
@@ -0,0 +1,464 @@
+/**
+ * @file ThreadPool.hpp
+ * A work-stealing thread pool.
+ *
+ * Fixed-size worker pool with per-worker Chase-Lev deques. Tasks are stored in preallocated
+ * task slots as SmallUniqueFunction, so submitting a task never allocates.
+ */
+
+#pragma once
+
+#include "FTC/Concurrency/WorkStealingDeque.hpp"
+#include "FTC/Container/LockFreeCircularQueue.hpp"
+#include "FTC/Container/WaitStrategy.hpp"
+#include "FTC/Detail/CacheLine.hpp"
+#include "FTC/Function/SmallUniqueFunction.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <new>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ftc {
+
+class ThreadPool;
+
+namespace detail {
+
+    /// A task slot. Slots are allocated once by the pool and recycled through a free list.
+    struct __pool_task
+    {
+        static constexpr std::size_t functionSize = 48;
+        static constexpr std::size_t resultSize   = 32;
+
+        SmallUniqueFunction<void(__pool_task &), functionSize> function;
+        std::atomic<std::uint32_t>                             refs {0};
+        std::atomic<bool>                                      ready {false};
+        ParkingWait<>                                          done;
+        std::exception_ptr                                     error;
+        void (*destroyResult)(void *) = nullptr;
+        alignas(std::max_align_t) unsigned char result[resultSize];
+
+        /// Checks if a result of type R can be stored in the slot
+        template <typename R> static constexpr bool FitsResult() noexcept
+        {
+            if constexpr (std::is_void_v<R>)
+                return true;
+            else
+                return sizeof(R) <= resultSize && alignof(R) <= alignof(std::max_align_t);
+        }
+
+        template <typename R, typename... Args> void EmplaceResult(Args &&... args)
+        {
+            new (result) R(std::forward<Args>(args)...);
+            destroyResult = [](void *p) { static_cast<R *>(p)->~R(); };
+        }
+
+        template <typename R> R &Result() noexcept
+        {
+            return *std::launder(reinterpret_cast<R *>(result));
+        }
+    };
+
+}  // namespace detail
+
+/// Handle to the result of a task submitted to a ThreadPool
+/// Unlike std::future, it does not allocate a shared state: it holds a reference to the task
+/// slot, which is recycled once both the task has run and the future is released.
+/// @tparam R Result type of the task
+template <typename R> class TaskFuture
+{
+public:
+    TaskFuture() noexcept = default;
+    TaskFuture(TaskFuture &&other) noexcept;
+    TaskFuture &operator=(TaskFuture &&other) noexcept;
+    ~TaskFuture();
+
+    TaskFuture(const TaskFuture &) = delete;
+    TaskFuture &operator=(const TaskFuture &) = delete;
+
+    /// Checks if the future refers to a task.
+    bool Valid() const noexcept { return task_ != nullptr; }
+
+    /// Checks if the task has finished.
+    bool IsReady() const noexcept;
+
+    /// @brief Blocks until the task has finished.
+    /// While waiting, the calling thread helps running pending tasks of the pool.
+    void Wait() const;
+
+    /// @brief Waits for the task, then takes its result.
+    /// Rethrows the exception thrown by the task, if any. The future is invalid afterwards.
+    R Get();
+
+private:
+    friend class ThreadPool;
+
+    TaskFuture(ThreadPool *pool, detail::__pool_task *task) noexcept : pool_(pool), task_(task) {}
+
+    ThreadPool *          pool_ = nullptr;
+    detail::__pool_task *task_ = nullptr;
+};
+
+/// Fixed-size work-stealing thread pool
+///
+/// Each worker owns a deque: tasks submitted from a worker go to the bottom of its own deque
+/// and are popped in LIFO order, idle workers steal from the top of random victims' deques.
+/// Tasks submitted from other threads go through a shared injection queue.
+///
+/// Tasks are stored in a fixed number of preallocated slots as SmallUniqueFunction, so
+/// callables must fit into 48 bytes and results into 32 bytes. When all slots are in use,
+/// Submit() runs pending tasks until a slot is recycled.
+class ThreadPool
+{
+    using Task = detail::__pool_task;
+
+public:
+    static constexpr std::size_t dequeSize = 1024;
+
+    /// @brief Starts the worker threads.
+    /// @param numThreads Number of workers, hardware thread count by default.
+    /// @param taskCapacity Number of task slots, rounded up to a power of 2.
+    explicit ThreadPool(std::size_t numThreads   = std::thread::hardware_concurrency(),
+                        std::size_t taskCapacity = 4096);
+
+    /// Runs all pending tasks, then joins the worker threads.
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    /// Returns the number of worker threads.
+    std::size_t NumThreads() const noexcept { return workers_.size(); }
+
+    /// @brief Submits a callable for execution.
+    /// @return Future of the result of f().
+    template <typename F> TaskFuture<std::invoke_result_t<std::decay_t<F> &>> Submit(F &&f);
+
+    /// @brief Submits a callable for execution without a future.
+    /// Exceptions thrown by f are discarded.
+    template <typename F> void Post(F &&f);
+
+    /// @brief Calls f(i) for every i in [begin, end), split into chunks run by the pool.
+    /// Blocks until all calls have returned, helping to run tasks meanwhile, so it can be
+    /// nested inside tasks. Rethrows the first exception thrown by f.
+    /// @param grain Number of indices per chunk, chosen from the pool size if 0.
+    template <typename Index, typename F>
+    void ParallelFor(Index begin, Index end, F &&f, std::size_t grain = 0);
+
+    /// @brief Runs one pending task on the calling thread.
+    /// @return Whether a task was found and run.
+    bool RunPendingTask();
+
+private:
+    template <typename R> friend class TaskFuture;
+
+    struct alignas(detail::__cache_line_size) Worker
+    {
+        WorkStealingDeque<Task *, dequeSize> deque;
+        std::thread                          thread;
+    };
+
+    /// Per-thread state of the worker running on the calling thread
+    struct WorkerContext
+    {
+        ThreadPool *  pool;
+        std::size_t   index;
+        std::uint32_t rng;
+    };
+
+    inline static thread_local WorkerContext context_ {nullptr, 0, 0};
+
+    /// Worker of this pool running on the calling thread, or nullptr.
+    Worker *CurrentWorker() noexcept
+    {
+        return context_.pool == this ? workers_[context_.index].get() : nullptr;
+    }
+
+    void WorkerLoop(std::size_t index);
+
+    /// Takes a free task slot, running pending tasks while none is free.
+    Task *AcquireTask(std::uint32_t refs);
+
+    /// Drops a reference to a task slot, recycling it when the last reference is gone.
+    void ReleaseTask(Task *task) noexcept;
+
+    /// Schedules a filled task slot.
+    void Schedule(Task *task);
+
+    /// Finds a task from the own deque, the injection queue or other workers.
+    Task *FindTask() noexcept;
+
+    void Run(Task *task) noexcept;
+
+    using TaskQueue = LockFreeCircularQueue<Task *, DynamicSize, false, false>;
+
+    std::unique_ptr<Task[]>              tasks_;
+    TaskQueue                            freeTasks_;
+    TaskQueue                            injection_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::atomic<bool>                    stop_ {false};
+    ParkingWait<>                        workAvailable_;
+};
+
+}  // namespace ftc
+
+inline ftc::ThreadPool::ThreadPool(std::size_t numThreads, std::size_t taskCapacity)
+    : freeTasks_(taskCapacity)
+    , injection_(taskCapacity)
+{
+    numThreads = std::max<std::size_t>(numThreads, 1);
+    tasks_     = std::make_unique<Task[]>(freeTasks_.Capacity());
+    for (std::size_t i = 0; i < freeTasks_.Capacity(); i++)
+        freeTasks_.TryPush(&tasks_[i]);
+
+    for (std::size_t i = 0; i < numThreads; i++)
+        workers_.push_back(std::make_unique<Worker>());
+    for (std::size_t i = 0; i < numThreads; i++)
+        workers_[i]->thread = std::thread([this, i] { WorkerLoop(i); });
+}
+
+inline ftc::ThreadPool::~ThreadPool()
+{
+    stop_.store(true, std::memory_order_seq_cst);
+    workAvailable_.Notify();
+    for (std::unique_ptr<Worker> &worker : workers_)
+        worker->thread.join();
+}
+
+template <typename F>
+inline ftc::TaskFuture<std::invoke_result_t<std::decay_t<F> &>> ftc::ThreadPool::Submit(F &&f)
+{
+    using R = std::invoke_result_t<std::decay_t<F> &>;
+    static_assert(Task::FitsResult<R>(), "result type is too large for a task slot");
+
+    Task *task     = AcquireTask(2);
+    task->function = [f = std::forward<F>(f)](Task &t) mutable {
+        if constexpr (std::is_void_v<R>)
+            f();
+        else
+            t.EmplaceResult<R>(f());
+    };
+    Schedule(task);
+    return TaskFuture<R>(this, task);
+}
+
+template <typename F> inline void ftc::ThreadPool::Post(F &&f)
+{
+    Task *task     = AcquireTask(1);
+    task->function = [f = std::forward<F>(f)](Task &) mutable { f(); };
+    Schedule(task);
+}
+
+template <typename Index, typename F>
+inline void ftc::ThreadPool::ParallelFor(Index begin, Index end, F &&f, std::size_t grain)
+{
+    if (!(begin < end))
+        return;
+
+    std::size_t count = std::size_t(end - begin);
+    if (grain == 0)
+        grain = std::max<std::size_t>(1, count / (NumThreads() * 4));
+    std::size_t numChunks = (count + grain - 1) / grain;
+
+    struct Latch
+    {
+        std::atomic<std::size_t> remaining {0};
+        std::atomic<bool>        failed {false};
+        std::exception_ptr       error;
+    } latch;
+    latch.remaining.store(numChunks, std::memory_order_relaxed);
+
+    auto runChunk = [&f, &latch](Index lo, Index hi) {
+        try {
+            for (Index i = lo; i < hi; ++i)
+                f(i);
+        }
+        catch (...) {
+            if (!latch.failed.exchange(true, std::memory_order_relaxed))
+                latch.error = std::current_exception();
+        }
+        latch.remaining.fetch_sub(1, std::memory_order_release);
+    };
+
+    for (std::size_t c = 1; c < numChunks; c++) {
+        Index lo = Index(begin + c * grain);
+        Index hi = c + 1 == numChunks ? end : Index(lo + grain);
+        Post([&runChunk, lo, hi] { runChunk(lo, hi); });
+    }
+    runChunk(begin, numChunks == 1 ? end : Index(begin + grain));
+
+    while (latch.remaining.load(std::memory_order_acquire) != 0) {
+        if (!RunPendingTask())
+            std::this_thread::yield();
+    }
+    if (latch.error)
+        std::rethrow_exception(latch.error);
+}
+
+inline bool ftc::ThreadPool::RunPendingTask()
+{
+    Task *task = FindTask();
+    if (task)
+        Run(task);
+    return task != nullptr;
+}
+
+inline void ftc::ThreadPool::WorkerLoop(std::size_t index)
+{
+    context_ = {this, index, std::uint32_t(index * 2654435761u + 1)};
+
+    for (;;) {
+        Task *task = nullptr;
+        workAvailable_.WaitUntil(
+            [&] { return (task = FindTask()) || stop_.load(std::memory_order_acquire); });
+        if (!task)
+            break;
+        Run(task);
+    }
+
+    context_ = {};
+}
+
+inline ftc::ThreadPool::Task *ftc::ThreadPool::AcquireTask(std::uint32_t refs)
+{
+    for (;;) {
+        if (std::optional<Task *> task = freeTasks_.TryPop()) {
+            (*task)->refs.store(refs, std::memory_order_relaxed);
+            (*task)->ready.store(false, std::memory_order_relaxed);
+            return *task;
+        }
+        if (!RunPendingTask())
+            std::this_thread::yield();
+    }
+}
+
+inline void ftc::ThreadPool::ReleaseTask(Task *task) noexcept
+{
+    if (task->refs.fetch_sub(1, std::memory_order_acq_rel) != 1)
+        return;
+
+    if (task->destroyResult) {
+        task->destroyResult(task->result);
+        task->destroyResult = nullptr;
+    }
+    task->error = nullptr;
+    // There is room for every slot, but TryPush() may still fail while a consumer is moving a
+    // slot out of the same position, so wait for it rather than losing the slot.
+    freeTasks_.Push(task);
+}
+
+inline void ftc::ThreadPool::Schedule(Task *task)
+{
+    Worker *worker = CurrentWorker();
+    if (!worker || !worker->deque.TryPush(task))
+        injection_.Push(task);  // never blocks, there are only Capacity() slots
+    workAvailable_.Notify();
+}
+
+inline ftc::ThreadPool::Task *ftc::ThreadPool::FindTask() noexcept
+{
+    Worker *self = CurrentWorker();
+    if (self) {
+        if (std::optional<Task *> task = self->deque.TryPop())
+            return *task;
+    }
+    if (std::optional<Task *> task = injection_.TryPop())
+        return *task;
+
+    // Steal from workers starting at a random victim
+    std::size_t numWorkers = workers_.size();
+    std::size_t start      = 0;
+    if (self) {
+        std::uint32_t &x = context_.rng;
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        start = x % numWorkers;
+    }
+    for (std::size_t i = 0; i < numWorkers; i++) {
+        Worker *victim = workers_[(start + i) % numWorkers].get();
+        if (victim == self)
+            continue;
+        if (std::optional<Task *> task = victim->deque.TrySteal())
+            return *task;
+    }
+    return nullptr;
+}
+
+inline void ftc::ThreadPool::Run(Task *task) noexcept
+{
+    try {
+        task->function(*task);
+    }
+    catch (...) {
+        task->error = std::current_exception();
+    }
+    task->function = nullptr;
+    task->ready.store(true, std::memory_order_release);
+    task->done.Notify();
+    ReleaseTask(task);
+}
+
+template <typename R>
+inline ftc::TaskFuture<R>::TaskFuture(TaskFuture &&other) noexcept
+    : pool_(other.pool_)
+    , task_(other.task_)
+{
+    other.task_ = nullptr;
+}
+
+template <typename R>
+inline ftc::TaskFuture<R> &ftc::TaskFuture<R>::operator=(TaskFuture &&other) noexcept
+{
+    if (this != &other) {
+        if (task_)
+            pool_->ReleaseTask(task_);
+        pool_       = other.pool_;
+        task_       = other.task_;
+        other.task_ = nullptr;
+    }
+    return *this;
+}
+
+template <typename R> inline ftc::TaskFuture<R>::~TaskFuture()
+{
+    if (task_)
+        pool_->ReleaseTask(task_);
+}
+
+template <typename R> inline bool ftc::TaskFuture<R>::IsReady() const noexcept
+{
+    return task_->ready.load(std::memory_order_acquire);
+}
+
+template <typename R> inline void ftc::TaskFuture<R>::Wait() const
+{
+    task_->done.WaitUntil([this] { return IsReady() || (pool_->RunPendingTask(), IsReady()); });
+}
+
+template <typename R> inline R ftc::TaskFuture<R>::Get()
+{
+    Wait();
+
+    detail::__pool_task *task = std::exchange(task_, nullptr);
+    struct Releaser
+    {
+        ThreadPool *          pool;
+        detail::__pool_task *task;
+        ~Releaser() { pool->ReleaseTask(task); }
+    } releaser {pool_, task};
+
+    if (task->error)
+        std::rethrow_exception(task->error);
+    if constexpr (!std::is_void_v<R>)
+        return std::move(task->template Result<R>());
+}
@@ -0,0 +1,137 @@
+/**
+ * @file WorkStealingDeque.hpp
+ * A bounded Chase-Lev work-stealing deque.
+ *
+ * The owner thread pushes and pops at the bottom end, other threads steal from the top end.
+ */
+
+#pragma once
+
+#include "FTC/Detail/CacheLine.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <type_traits>
+
+namespace ftc {
+
+/// Bounded work-stealing deque (Chase-Lev, with the C11 memory orderings of Le et al.)
+/// @tparam T Element type, must be trivially copyable (usually a pointer to a task)
+/// @tparam Size Capacity of the deque, must be a power of 2
+template <typename T, std::size_t Size> class WorkStealingDeque
+{
+    static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+    static_assert(Size >= 2 && (Size & (Size - 1)) == 0, "Size must be a power of 2");
+
+    static constexpr std::size_t cacheLineSize = detail::__cache_line_size;
+
+public:
+    WorkStealingDeque() noexcept = default;
+
+    WorkStealingDeque(const WorkStealingDeque &) = delete;
+    WorkStealingDeque &operator=(const WorkStealingDeque &) = delete;
+
+    /// @brief Push a value at the bottom. Must only be called by the owner thread.
+    /// @return Whether the push is success, fails only if the deque is full.
+    bool TryPush(T value) noexcept;
+
+    /// @brief Pop the most recently pushed value. Must only be called by the owner thread.
+    /// @return Value if the deque is not empty, otherwise std::nullopt.
+    std::optional<T> TryPop() noexcept;
+
+    /// @brief Steal the least recently pushed value. Can be called by any thread.
+    /// Retries while losing races against other thieves or the owner, so std::nullopt is only
+    /// returned when the deque was observed empty.
+    /// @return Value if the deque is not empty, otherwise std::nullopt.
+    std::optional<T> TrySteal() noexcept;
+
+    /// Returns the capacity of the deque.
+    static constexpr std::size_t Capacity() noexcept { return Size; }
+
+    /// Returns the estimated count of current elements.
+    std::size_t Count() const noexcept;
+
+    /// Checks if the deque is empty.
+    bool Empty() const noexcept { return Count() == 0; }
+
+private:
+    static constexpr std::int64_t mask = std::int64_t(Size - 1);
+
+    alignas(cacheLineSize) std::atomic<std::int64_t> top_ {0};
+    alignas(cacheLineSize) std::atomic<std::int64_t> bottom_ {0};
+    alignas(cacheLineSize) std::array<std::atomic<T>, Size> buffer_ {};
+};
+
+}  // namespace ftc
+
+template <typename T, std::size_t Size>
+inline bool ftc::WorkStealingDeque<T, Size>::TryPush(T value) noexcept
+{
+    std::int64_t b = bottom_.load(std::memory_order_relaxed);
+    std::int64_t t = top_.load(std::memory_order_acquire);
+    if (b - t >= std::int64_t(Size))
+        return false;
+
+    buffer_[b & mask].store(value, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom_.store(b + 1, std::memory_order_relaxed);
+    return true;
+}
+
+template <typename T, std::size_t Size>
+inline std::optional<T> ftc::WorkStealingDeque<T, Size>::TryPop() noexcept
+{
+    std::int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+    bottom_.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::int64_t t = top_.load(std::memory_order_relaxed);
+
+    if (t > b) {
+        // Empty, restore bottom
+        bottom_.store(b + 1, std::memory_order_relaxed);
+        return std::nullopt;
+    }
+
+    T value = buffer_[b & mask].load(std::memory_order_relaxed);
+    if (t == b) {
+        // Last element, race against thieves for it
+        bool won = top_.compare_exchange_strong(t,
+                                                t + 1,
+                                                std::memory_order_seq_cst,
+                                                std::memory_order_relaxed);
+        bottom_.store(b + 1, std::memory_order_relaxed);
+        if (!won)
+            return std::nullopt;
+    }
+    return value;
+}
+
+template <typename T, std::size_t Size>
+inline std::optional<T> ftc::WorkStealingDeque<T, Size>::TrySteal() noexcept
+{
+    for (;;) {
+        std::int64_t t = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t b = bottom_.load(std::memory_order_acquire);
+        if (t >= b)
+            return std::nullopt;
+
+        T value = buffer_[t & mask].load(std::memory_order_relaxed);
+        if (top_.compare_exchange_strong(t,
+                                         t + 1,
+                                         std::memory_order_seq_cst,
+                                         std::memory_order_relaxed))
+            return value;
+    }
+}
+
+template <typename T, std::size_t Size>
+inline std::size_t ftc::WorkStealingDeque<T, Size>::Count() const noexcept
+{
+    std::int64_t t = top_.load(std::memory_order_relaxed);
+    std::int64_t b = bottom_.load(std::memory_order_relaxed);
+    return b > t ? std::size_t(b - t) : 0;
+}
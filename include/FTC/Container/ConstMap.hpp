@@ -0,0 +1,274 @@
+/**
+ * @file ConstMap.hpp
+ * Compile time string lookup tables
+ *
+ * An immutable map from string keys to values, whose perfect hash is built during constant
+ * evaluation, so that a table of config keys or commands costs nothing at program start.
+ */
+
+#pragma once
+
+#include <cstddef>      // for size_t
+#include <cstdint>      // for std::uint32_t, std::uint64_t
+#include <stdexcept>    // for std::invalid_argument, std::out_of_range
+#include <string_view>  // for std::string_view
+#include <utility>      // for std::pair, std::index_sequence, std::make_index_sequence
+
+namespace ftc {
+
+/// @defgroup CMap Compile Time Maps
+/// @{
+
+/// An entry of ConstMap
+template <typename Value> struct ConstMapEntry
+{
+    std::string_view key;
+    Value            value;
+};
+
+/// Immutable string map with a compile time perfect hash
+///
+/// The table is built by MakeConstMap() (hash and displace): keys are split into buckets by their
+/// hash, and each bucket gets a seed that sends its keys to free slots, searched from the
+/// largest bucket down. Find() then hashes the key once, reads the seed of its bucket, and
+/// compares a single candidate key, without any probing.
+///
+/// Keys are std::string_view, so they must outlive the map: string literals, or ConstString
+/// with static storage duration. Building the map in a constexpr variable checks this, as well
+/// as the uniqueness of keys, at compile time.
+///
+/// @tparam Value Value type, a literal type to build the map at compile time.
+/// @tparam N Number of entries.
+template <typename Value, size_t N> class ConstMap
+{
+public:
+    using Entry = ConstMapEntry<Value>;
+
+    /// Array of key-value pairs to build the map from
+    using SourceArray = std::pair<std::string_view, Value>[N ? N : 1];
+
+    /// Number of slots, the power of two not less than N
+    static constexpr size_t NumSlots = [] {
+        size_t n = 1;
+        while (n < N)
+            n *= 2;
+        return n;
+    }();
+
+    /// Number of buckets, each with its own seed
+    static constexpr size_t NumBuckets = N ? N : 1;
+
+    /// Constructor, builds the perfect hash of entries
+    /// @throw std::invalid_argument if a key is duplicated, which fails compilation in a
+    /// constant expression.
+    [[nodiscard]] constexpr ConstMap(const SourceArray &entries);
+
+    /// Constructor, initialize an empty map (N must be 0)
+    [[nodiscard]] constexpr ConstMap();
+
+    /// Finds the value of a key
+    /// @return Pointer to the value, or nullptr if the key is absent.
+    [[nodiscard]] constexpr const Value *Find(std::string_view key) const;
+
+    /// Checks whether a key is present
+    [[nodiscard]] constexpr bool Contains(std::string_view key) const { return Find(key); }
+
+    /// Gets the value of a key
+    /// @throw std::out_of_range if the key is absent.
+    [[nodiscard]] constexpr const Value &At(std::string_view key) const;
+
+    /// Gets the value of a key, or a fallback value if the key is absent
+    [[nodiscard]] constexpr Value Get(std::string_view key, Value fallback) const
+    {
+        const Value *value = Find(key);
+        return value ? *value : fallback;
+    }
+
+    /// Gets the number of entries
+    [[nodiscard]] constexpr size_t Size() const { return N; }
+
+    /// Checks whether the map is empty
+    [[nodiscard]] constexpr bool Empty() const { return N == 0; }
+
+    /// Gets an iterator at the first entry, entries keep their order of construction
+    [[nodiscard]] constexpr const Entry *begin() const { return entries; }
+
+    /// Gets an iterator at the end
+    [[nodiscard]] constexpr const Entry *end() const { return entries + N; }
+
+private:
+    template <size_t... I>
+    constexpr ConstMap(const SourceArray &src, std::index_sequence<I...>);
+
+    /// Hash of a key, then mixed with the seed of its bucket
+    static constexpr std::uint64_t HashKey(std::string_view key);
+    static constexpr size_t        SlotOf(std::uint64_t hash, std::uint32_t seed);
+
+    constexpr void Build();
+
+    static constexpr std::uint32_t EmptySlot = std::uint32_t(-1);
+
+    Entry         entries[N ? N : 1];
+    std::uint32_t seeds[NumBuckets] {};
+    std::uint32_t slots[NumSlots] {};  ///< Index of the entry in each slot, or EmptySlot
+};
+
+/// Makes a ConstMap from a list of key-value pairs
+///
+/// Example:
+/// ```cpp
+/// constexpr auto Commands = MakeConstMap<int>({{"get", 1}, {"set", 2}, {"del", 3}});
+/// static_assert(*Commands.Find("set") == 2);
+/// ```
+///
+/// @tparam Value Value type.
+/// @tparam N Number of entries (deduced).
+template <typename Value, size_t N>
+[[nodiscard]] constexpr ConstMap<Value, N>
+MakeConstMap(const std::pair<std::string_view, Value> (&entries)[N])
+{
+    return ConstMap<Value, N>(entries);
+}
+
+/// Makes an empty ConstMap
+template <typename Value> [[nodiscard]] constexpr ConstMap<Value, 0> MakeConstMap()
+{
+    return ConstMap<Value, 0>();
+}
+
+/// @}
+
+}  // namespace ftc
+
+// -------------------------------------------------
+// Implementation
+
+template <typename Value, size_t N>
+constexpr ftc::ConstMap<Value, N>::ConstMap(const SourceArray &entries)
+    : ConstMap(entries, std::make_index_sequence<N>())
+{}
+
+template <typename Value, size_t N> constexpr ftc::ConstMap<Value, N>::ConstMap() : entries {}
+{
+    static_assert(N == 0, "Only an empty ConstMap can be default constructed");
+    Build();
+}
+
+template <typename Value, size_t N>
+template <size_t... I>
+constexpr ftc::ConstMap<Value, N>::ConstMap(const SourceArray &src, std::index_sequence<I...>)
+    : entries {Entry {src[I].first, src[I].second}...}
+{
+    Build();
+}
+
+template <typename Value, size_t N>
+constexpr const Value *ftc::ConstMap<Value, N>::Find(std::string_view key) const
+{
+    std::uint64_t hash  = HashKey(key);
+    std::uint32_t index = slots[SlotOf(hash, seeds[hash % NumBuckets])];
+    if (index != EmptySlot && entries[index].key == key)
+        return &entries[index].value;
+    return nullptr;
+}
+
+template <typename Value, size_t N>
+constexpr const Value &ftc::ConstMap<Value, N>::At(std::string_view key) const
+{
+    const Value *value = Find(key);
+    if (!value)
+        throw std::out_of_range("ConstMap::At: key not found");
+    return *value;
+}
+
+template <typename Value, size_t N>
+constexpr std::uint64_t ftc::ConstMap<Value, N>::HashKey(std::string_view key)
+{
+    // Little endian word of up to 8 chars, recognized as a single load by compilers
+    auto load = [&](size_t pos, size_t count) {
+        std::uint64_t word = 0;
+        for (size_t i = 0; i < count; i++)
+            word |= std::uint64_t(static_cast<unsigned char>(key[pos + i])) << (8 * i);
+        return word;
+    };
+    auto mix = [](std::uint64_t x) {
+        x *= 0xBF58476D1CE4E5B9ull;
+        return x ^ (x >> 32);
+    };
+
+    std::uint64_t hash = 0x9E3779B97F4A7C15ull ^ key.size();
+    size_t        pos  = 0;
+    for (; pos + 8 <= key.size(); pos += 8)
+        hash = mix(hash ^ load(pos, 8));
+    if (pos < key.size())
+        hash = mix(hash ^ load(pos, key.size() - pos));
+    return hash;
+}
+
+template <typename Value, size_t N>
+constexpr size_t ftc::ConstMap<Value, N>::SlotOf(std::uint64_t hash, std::uint32_t seed)
+{
+    // splitmix64 finalizer of the hash perturbed by the seed
+    std::uint64_t x = hash + (std::uint64_t(seed) + 1) * 0x9E3779B97F4A7C15ull;
+    x               = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x               = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return size_t(x ^ (x >> 31)) & (NumSlots - 1);
+}
+
+template <typename Value, size_t N> constexpr void ftc::ConstMap<Value, N>::Build()
+{
+    for (size_t s = 0; s < NumSlots; s++)
+        slots[s] = EmptySlot;
+    if constexpr (N > 0) {
+        std::uint64_t hashes[N] {};
+        size_t        bucketSize[NumBuckets] {};
+        for (size_t i = 0; i < N; i++) {
+            for (size_t j = 0; j < i; j++)
+                if (entries[j].key == entries[i].key)
+                    throw std::invalid_argument("ConstMap: duplicated key");
+            hashes[i] = HashKey(entries[i].key);
+            bucketSize[hashes[i] % NumBuckets]++;
+        }
+
+        // Buckets ordered by decreasing size (stable insertion sort)
+        size_t order[NumBuckets] {};
+        for (size_t b = 0; b < NumBuckets; b++) {
+            size_t k = b;
+            for (; k > 0 && bucketSize[order[k - 1]] < bucketSize[b]; k--)
+                order[k] = order[k - 1];
+            order[k] = b;
+        }
+
+        for (size_t b : order) {
+            if (bucketSize[b] == 0)
+                break;
+
+            // Searches the first seed sending all keys of the bucket to distinct free slots
+            for (std::uint32_t seed = 0;; seed++) {
+                if (seed == EmptySlot)
+                    throw std::invalid_argument("ConstMap: no perfect hash found");
+
+                size_t taken[N] {};
+                size_t numTaken = 0;
+                bool   fits     = true;
+                for (size_t i = 0; i < N && fits; i++) {
+                    if (hashes[i] % NumBuckets != b)
+                        continue;
+                    size_t slot = SlotOf(hashes[i], seed);
+                    fits        = slots[slot] == EmptySlot;
+                    for (size_t t = 0; t < numTaken && fits; t++)
+                        fits = taken[t] != slot;
+                    taken[numTaken++] = slot;
+                }
+                if (!fits)
+                    continue;
+
+                seeds[b] = seed;
+                for (size_t i = 0, t = 0; i < N; i++)
+                    if (hashes[i] % NumBuckets == b)
+                        slots[taken[t++]] = std::uint32_t(i);
+                break;
+            }
+        }
+    }
+}
@@ -0,0 +1,232 @@
+/**
+ * @file FlatHashMap.hpp
+ * Open-addressing hash map.
+ *
+ * A Swiss table map storing key-value pairs inline in a flat array, as a faster and more
+ * compact replacement of std::unordered_map.
+ */
+
+#pragma once
+
+#include "FTC/Container/FlatHashTable.hpp"
+
+#include <tuple>
+
+namespace ftc {
+
+namespace detail {
+
+    template <typename Key, typename Value> struct __flat_map_policy
+    {
+        using key_type         = Key;
+        using value_type       = std::pair<const Key, Value>;
+        using mutable_type     = std::pair<Key, Value>;
+        static constexpr bool constant_iterators = false;
+
+        /// Slot seen as std::pair<const Key, Value> by users, and moved as std::pair<Key, Value>
+        /// on rehash, so that keys are not copied (the layout trick of Abseil's map_slot_type).
+        union slot_type
+        {
+            slot_type() {}
+            ~slot_type() {}
+
+            value_type   value;
+            mutable_type mutable_value;
+        };
+
+        static const Key &key(const slot_type *slot) noexcept { return slot->value.first; }
+        static const Key &key_of(const value_type &value) noexcept { return value.first; }
+        static value_type &element(slot_type *slot) noexcept { return slot->value; }
+
+        template <typename Alloc, typename... Args>
+        static void construct(Alloc &alloc, slot_type *slot, Args &&... args)
+        {
+            std::allocator_traits<Alloc>::construct(alloc,
+                                                    &slot->value,
+                                                    std::forward<Args>(args)...);
+        }
+
+        template <typename Alloc> static void destroy(Alloc &alloc, slot_type *slot) noexcept
+        {
+            std::allocator_traits<Alloc>::destroy(alloc, &slot->value);
+        }
+
+        template <typename Alloc>
+        static void transfer(Alloc &alloc, slot_type *dst, slot_type *src)
+        {
+            std::allocator_traits<Alloc>::construct(alloc,
+                                                    &dst->mutable_value,
+                                                    std::move(src->mutable_value));
+            std::allocator_traits<Alloc>::destroy(alloc, &src->mutable_value);
+        }
+    };
+
+}  // namespace detail
+
+/// Hash map with open addressing and SIMD probing
+///
+/// The std::unordered_map interface without buckets or node handles. Elements live in a flat
+/// array and move on rehash, so unlike std::unordered_map, pointers and iterators to elements
+/// are invalidated by any insertion that grows the table (reserve() avoids it). Erasing keeps
+/// other iterators valid.
+///
+/// If both Hash and KeyEqual define is_transparent, lookups accept any key type they accept,
+/// which is the default for string-like keys: a map keyed by std::string can be searched with a
+/// std::string_view, a const char* or a ConstString without building a temporary std::string.
+///
+/// @tparam Key Key type.
+/// @tparam Value Mapped type.
+/// @tparam Hash Hash function, its result is mixed again so that identity hashes are fine.
+/// @tparam KeyEqual Key equality.
+/// @tparam Alloc Allocator of std::pair<const Key, Value>.
+template <typename Key,
+          typename Value,
+          typename Hash     = FlatHash<Key>,
+          typename KeyEqual = FlatKeyEqual<Key>,
+          typename Alloc    = std::pmr::polymorphic_allocator<std::pair<const Key, Value>>>
+class FlatHashMap
+    : public detail::__flat_hash_table<detail::__flat_map_policy<Key, Value>, Hash, KeyEqual, Alloc>
+{
+    using Policy = detail::__flat_map_policy<Key, Value>;
+    using Base   = detail::__flat_hash_table<Policy, Hash, KeyEqual, Alloc>;
+
+    template <typename K>
+    using EnableIfHeterogeneous = typename Base::template EnableIfHeterogeneous<K>;
+
+public:
+    using mapped_type    = Value;
+    using iterator       = typename Base::iterator;
+    using const_iterator = typename Base::const_iterator;
+    using size_type      = typename Base::size_type;
+    using value_type     = typename Base::value_type;
+
+    using Base::Base;
+
+    FlatHashMap() = default;
+    FlatHashMap(std::initializer_list<value_type> il,
+                size_type                         bucketCount = 0,
+                const Hash &                      hash        = Hash(),
+                const KeyEqual &                  eq          = KeyEqual(),
+                const Alloc &                     alloc       = Alloc())
+        : Base(std::max(bucketCount, il.size()), hash, eq, alloc)
+    {
+        this->insert(il);
+    }
+    template <typename InputIt>
+    FlatHashMap(InputIt          first,
+                InputIt          last,
+                size_type        bucketCount = 0,
+                const Hash &     hash        = Hash(),
+                const KeyEqual & eq          = KeyEqual(),
+                const Alloc &    alloc       = Alloc())
+        : Base(bucketCount, hash, eq, alloc)
+    {
+        this->insert(first, last);
+    }
+
+    using Base::insert;
+
+    /// Inserts a pair built from a value convertible to value_type.
+    template <typename P, typename = std::enable_if_t<std::is_constructible_v<value_type, P &&>>>
+    std::pair<iterator, bool> insert(P &&value)
+    {
+        return this->emplace(std::forward<P>(value));
+    }
+
+    /// @name Element access
+    /// @{
+    /// Inserts value-initialized mapped values for absent keys.
+    Value &operator[](const Key &key) { return try_emplace(key).first->second; }
+    Value &operator[](Key &&key) { return try_emplace(std::move(key)).first->second; }
+    template <typename K, EnableIfHeterogeneous<K> = 0> Value &operator[](K &&key)
+    {
+        return try_emplace(std::forward<K>(key)).first->second;
+    }
+
+    /// @throw std::out_of_range if the key is not present.
+    Value &at(const Key &key) { return At(key); }
+    const Value &at(const Key &key) const { return const_cast<FlatHashMap *>(this)->At(key); }
+    template <typename K, EnableIfHeterogeneous<K> = 0> Value &at(const K &key) { return At(key); }
+    template <typename K, EnableIfHeterogeneous<K> = 0> const Value &at(const K &key) const
+    {
+        return const_cast<FlatHashMap *>(this)->At(key);
+    }
+    /// @}
+
+    /// @name Modifiers
+    /// @{
+    /// Inserts (key, Value(args...)) if key is not present, args are left untouched otherwise.
+    /// A heterogeneous key is converted to Key only when inserted.
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(const Key &key, Args &&... args)
+    {
+        return TryEmplace(key, std::forward<Args>(args)...);
+    }
+    template <typename... Args> std::pair<iterator, bool> try_emplace(Key &&key, Args &&... args)
+    {
+        return TryEmplace(std::move(key), std::forward<Args>(args)...);
+    }
+    template <typename K, typename... Args, EnableIfHeterogeneous<K> = 0>
+    std::pair<iterator, bool> try_emplace(K &&key, Args &&... args)
+    {
+        return TryEmplace(std::forward<K>(key), std::forward<Args>(args)...);
+    }
+
+    template <typename V> std::pair<iterator, bool> insert_or_assign(const Key &key, V &&value)
+    {
+        return InsertOrAssign(key, std::forward<V>(value));
+    }
+    template <typename V> std::pair<iterator, bool> insert_or_assign(Key &&key, V &&value)
+    {
+        return InsertOrAssign(std::move(key), std::forward<V>(value));
+    }
+    template <typename K, typename V, EnableIfHeterogeneous<K> = 0>
+    std::pair<iterator, bool> insert_or_assign(K &&key, V &&value)
+    {
+        return InsertOrAssign(std::forward<K>(key), std::forward<V>(value));
+    }
+    /// @}
+
+    friend bool operator==(const FlatHashMap &a, const FlatHashMap &b)
+    {
+        if (a.size() != b.size())
+            return false;
+        for (const value_type &v : a) {
+            const_iterator it = b.find(v.first);
+            if (it == b.end() || !(it->second == v.second))
+                return false;
+        }
+        return true;
+    }
+    friend bool operator!=(const FlatHashMap &a, const FlatHashMap &b) { return !(a == b); }
+
+private:
+    template <typename K> Value &At(const K &key)
+    {
+        iterator it = this->find(key);
+        if (it == this->end())
+            throw std::out_of_range("FlatHashMap::at: key not found");
+        return it->second;
+    }
+
+    template <typename K, typename... Args>
+    std::pair<iterator, bool> TryEmplace(K &&key, Args &&... args)
+    {
+        return this->EmplaceUnique(key,
+                                   std::piecewise_construct,
+                                   std::forward_as_tuple(std::forward<K>(key)),
+                                   std::forward_as_tuple(std::forward<Args>(args)...));
+    }
+
+    template <typename K, typename V>
+    std::pair<iterator, bool> InsertOrAssign(K &&key, V &&value)
+    {
+        // value is only consumed when the key is inserted
+        std::pair<iterator, bool> result = TryEmplace(std::forward<K>(key), std::forward<V>(value));
+        if (!result.second)
+            result.first->second = std::forward<V>(value);
+        return result;
+    }
+};
+
+}  // namespace ftc
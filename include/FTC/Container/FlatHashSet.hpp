@@ -0,0 +1,122 @@
+/**
+ * @file FlatHashSet.hpp
+ * Open-addressing hash set.
+ *
+ * A Swiss table set storing keys inline in a flat array, as a faster and more compact
+ * replacement of std::unordered_set.
+ */
+
+#pragma once
+
+#include "FTC/Container/FlatHashTable.hpp"
+
+namespace ftc {
+
+namespace detail {
+
+    template <typename Key> struct __flat_set_policy
+    {
+        using key_type   = Key;
+        using value_type = Key;
+        using slot_type  = Key;
+        static constexpr bool constant_iterators = true;
+
+        static const Key &key(const slot_type *slot) noexcept { return *slot; }
+        static const Key &key_of(const value_type &value) noexcept { return value; }
+        static Key &      element(slot_type *slot) noexcept { return *slot; }
+
+        template <typename Alloc, typename... Args>
+        static void construct(Alloc &alloc, slot_type *slot, Args &&... args)
+        {
+            std::allocator_traits<Alloc>::construct(alloc, slot, std::forward<Args>(args)...);
+        }
+
+        template <typename Alloc> static void destroy(Alloc &alloc, slot_type *slot) noexcept
+        {
+            std::allocator_traits<Alloc>::destroy(alloc, slot);
+        }
+
+        template <typename Alloc>
+        static void transfer(Alloc &alloc, slot_type *dst, slot_type *src)
+        {
+            std::allocator_traits<Alloc>::construct(alloc, dst, std::move(*src));
+            std::allocator_traits<Alloc>::destroy(alloc, src);
+        }
+    };
+
+}  // namespace detail
+
+/// Hash set with open addressing and SIMD probing
+///
+/// The std::unordered_set interface without buckets or node handles. Like FlatHashMap, growing
+/// the table invalidates pointers and iterators, and lookups are heterogeneous when Hash and
+/// KeyEqual are transparent (the default for string-like keys).
+///
+/// @tparam Key Key type.
+/// @tparam Hash Hash function, its result is mixed again so that identity hashes are fine.
+/// @tparam KeyEqual Key equality.
+/// @tparam Alloc Allocator of Key.
+template <typename Key,
+          typename Hash     = FlatHash<Key>,
+          typename KeyEqual = FlatKeyEqual<Key>,
+          typename Alloc    = std::pmr::polymorphic_allocator<Key>>
+class FlatHashSet
+    : public detail::__flat_hash_table<detail::__flat_set_policy<Key>, Hash, KeyEqual, Alloc>
+{
+    using Policy = detail::__flat_set_policy<Key>;
+    using Base   = detail::__flat_hash_table<Policy, Hash, KeyEqual, Alloc>;
+
+public:
+    using iterator   = typename Base::iterator;
+    using size_type  = typename Base::size_type;
+    using value_type = typename Base::value_type;
+
+    using Base::Base;
+
+    FlatHashSet() = default;
+    FlatHashSet(std::initializer_list<Key> il,
+                size_type                  bucketCount = 0,
+                const Hash &               hash        = Hash(),
+                const KeyEqual &           eq          = KeyEqual(),
+                const Alloc &              alloc       = Alloc())
+        : Base(std::max(bucketCount, il.size()), hash, eq, alloc)
+    {
+        this->insert(il);
+    }
+    template <typename InputIt>
+    FlatHashSet(InputIt          first,
+                InputIt          last,
+                size_type        bucketCount = 0,
+                const Hash &     hash        = Hash(),
+                const KeyEqual & eq          = KeyEqual(),
+                const Alloc &    alloc       = Alloc())
+        : Base(bucketCount, hash, eq, alloc)
+    {
+        this->insert(first, last);
+    }
+
+    using Base::insert;
+
+    /// Inserts a key built from a heterogeneous key only if it is not present.
+    template <typename K,
+              typename = std::enable_if_t<detail::__is_transparent<Hash, KeyEqual>::value
+                                          && !std::is_same_v<std::decay_t<K>, Key>
+                                          && std::is_constructible_v<Key, K &&>>>
+    std::pair<iterator, bool> insert(K &&key)
+    {
+        return this->EmplaceUnique(key, std::forward<K>(key));
+    }
+
+    friend bool operator==(const FlatHashSet &a, const FlatHashSet &b)
+    {
+        if (a.size() != b.size())
+            return false;
+        for (const Key &k : a)
+            if (!b.contains(k))
+                return false;
+        return true;
+    }
+    friend bool operator!=(const FlatHashSet &a, const FlatHashSet &b) { return !(a == b); }
+};
+
+}  // namespace ftc
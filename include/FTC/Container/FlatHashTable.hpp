@@ -0,0 +1,903 @@
+/**
+ * @file FlatHashTable.hpp
+ * Open-addressing hash table with SIMD group probing.
+ *
+ * The Swiss table core shared by FlatHashMap and FlatHashSet. Every slot has a control byte
+ * holding 7 bits of its hash, and probing compares a whole group of control bytes at once with
+ * SSE2 or NEON (or 64-bit SWAR as a fallback), so most lookups touch a single cache line of
+ * control bytes and compare keys only on a hash match.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define FTC_FLAT_HASH_SSE2 1
+#elif defined(__ARM_NEON) || defined(__aarch64__) || defined(_M_ARM64)
+    #include <arm_neon.h>
+    #define FTC_FLAT_HASH_NEON 1
+#endif
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
+namespace ftc {
+
+/// Default hash of flat hash containers
+///
+/// std::hash, except for string-like keys (anything convertible to std::string_view but a
+/// pointer), which are hashed as std::string_view and support heterogeneous lookup.
+template <typename Key, typename = void> struct FlatHash : std::hash<Key>
+{};
+
+template <typename Key>
+struct FlatHash<Key,
+                std::enable_if_t<std::is_convertible_v<const Key &, std::string_view>
+                                 && !std::is_pointer_v<std::decay_t<Key>>>>
+{
+    using is_transparent = void;
+
+    template <typename S> std::size_t operator()(const S &s) const noexcept
+    {
+        return std::hash<std::string_view>()(std::string_view(s));
+    }
+};
+
+/// Default key equality of flat hash containers
+///
+/// std::equal_to, except for string-like keys, which are compared as std::string_view and
+/// support heterogeneous lookup.
+template <typename Key, typename = void> struct FlatKeyEqual : std::equal_to<Key>
+{};
+
+template <typename Key>
+struct FlatKeyEqual<Key,
+                    std::enable_if_t<std::is_convertible_v<const Key &, std::string_view>
+                                     && !std::is_pointer_v<std::decay_t<Key>>>>
+{
+    using is_transparent = void;
+
+    template <typename S1, typename S2> bool operator()(const S1 &a, const S2 &b) const noexcept
+    {
+        return std::string_view(a) == std::string_view(b);
+    }
+};
+
+namespace detail {
+
+    /// Control byte: 0..127 for a full slot (7 bits of its hash), or one of the states below.
+    using __ctrl_t = signed char;
+
+    inline constexpr __ctrl_t __ctrl_empty    = -128;
+    inline constexpr __ctrl_t __ctrl_deleted  = -2;
+    inline constexpr __ctrl_t __ctrl_sentinel = -1;
+
+    inline std::uint32_t __ctz(std::uint64_t x) noexcept
+    {
+#if defined(_MSC_VER)
+        unsigned long i;
+        _BitScanForward64(&i, x);
+        return i;
+#else
+        return static_cast<std::uint32_t>(__builtin_ctzll(x));
+#endif
+    }
+
+    inline std::uint32_t __clz(std::uint64_t x) noexcept
+    {
+#if defined(_MSC_VER)
+        unsigned long i;
+        _BitScanReverse64(&i, x);
+        return 63 - i;
+#else
+        return static_cast<std::uint32_t>(__builtin_clzll(x));
+#endif
+    }
+
+    /// Bit mask of matching lanes in a group, a lane occupies 2^Shift bits with one bit set.
+    template <typename T, std::uint32_t Width, std::uint32_t Shift> class __bitmask
+    {
+    public:
+        explicit __bitmask(T mask) noexcept : mask_(mask) {}
+
+        explicit operator bool() const noexcept { return mask_ != 0; }
+
+        std::uint32_t LowestBitSet() const noexcept { return __ctz(mask_) >> Shift; }
+        std::uint32_t TrailingZeros() const noexcept { return __ctz(mask_) >> Shift; }
+        std::uint32_t LeadingZeros() const noexcept
+        {
+            constexpr std::uint32_t extraBits = 64 - (Width << Shift);
+            return (__clz(std::uint64_t(mask_) << extraBits)) >> Shift;
+        }
+
+        /// Iterates over the matching lanes
+        __bitmask     begin() const noexcept { return *this; }
+        __bitmask     end() const noexcept { return __bitmask(0); }
+        std::uint32_t operator*() const noexcept { return LowestBitSet(); }
+        __bitmask &   operator++() noexcept
+        {
+            mask_ &= mask_ - 1;
+            return *this;
+        }
+        bool operator!=(const __bitmask &other) const noexcept { return mask_ != other.mask_; }
+
+    private:
+        T mask_;
+    };
+
+#if defined(FTC_FLAT_HASH_SSE2)
+    struct __group
+    {
+        static constexpr std::size_t width = 16;
+        using mask_type                    = __bitmask<std::uint32_t, 16, 0>;
+
+        explicit __group(const __ctrl_t *pos) noexcept
+            : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i *>(pos)))
+        {}
+
+        mask_type Match(__ctrl_t h2) const noexcept
+        {
+            return Mask(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl));
+        }
+        mask_type MatchEmpty() const noexcept
+        {
+            return Mask(_mm_cmpeq_epi8(_mm_set1_epi8(__ctrl_empty), ctrl));
+        }
+        mask_type MatchEmptyOrDeleted() const noexcept
+        {
+            return Mask(_mm_cmpgt_epi8(_mm_set1_epi8(__ctrl_sentinel), ctrl));
+        }
+        mask_type MatchFullOrSentinel() const noexcept
+        {
+            return Mask(_mm_cmpgt_epi8(ctrl, _mm_set1_epi8(__ctrl_deleted)));
+        }
+
+    private:
+        static mask_type Mask(__m128i v) noexcept
+        {
+            return mask_type(static_cast<std::uint32_t>(_mm_movemask_epi8(v)));
+        }
+
+        __m128i ctrl;
+    };
+#elif defined(FTC_FLAT_HASH_NEON)
+    struct __group
+    {
+        static constexpr std::size_t width = 16;
+        using mask_type                    = __bitmask<std::uint64_t, 16, 2>;
+
+        explicit __group(const __ctrl_t *pos) noexcept : ctrl(vld1q_s8(pos)) {}
+
+        mask_type Match(__ctrl_t h2) const noexcept { return Mask(vceqq_s8(vdupq_n_s8(h2), ctrl)); }
+        mask_type MatchEmpty() const noexcept
+        {
+            return Mask(vceqq_s8(vdupq_n_s8(__ctrl_empty), ctrl));
+        }
+        mask_type MatchEmptyOrDeleted() const noexcept
+        {
+            return Mask(vcgtq_s8(vdupq_n_s8(__ctrl_sentinel), ctrl));
+        }
+        mask_type MatchFullOrSentinel() const noexcept
+        {
+            return Mask(vcgtq_s8(ctrl, vdupq_n_s8(__ctrl_deleted)));
+        }
+
+    private:
+        /// Narrows each 8-bit lane to 4 bits, then keeps one bit per lane
+        static mask_type Mask(uint8x16_t v) noexcept
+        {
+            uint8x8_t     narrowed = vshrn_n_u16(vreinterpretq_u16_u8(v), 4);
+            std::uint64_t bits     = vget_lane_u64(vreinterpret_u64_u8(narrowed), 0);
+            return mask_type(bits & 0x8888888888888888ull);
+        }
+
+        int8x16_t ctrl;
+    };
+#else
+    /// Portable group of 8 control bytes, matched with SWAR arithmetic
+    struct __group
+    {
+        static constexpr std::size_t width = 8;
+        using mask_type                    = __bitmask<std::uint64_t, 8, 3>;
+
+        explicit __group(const __ctrl_t *pos) noexcept : ctrl(0)
+        {
+            for (std::size_t i = 0; i < width; i++)
+                ctrl |= std::uint64_t(static_cast<unsigned char>(pos[i])) << (8 * i);
+        }
+
+        /// May report false positives next to a true match, keys are compared anyway.
+        mask_type Match(__ctrl_t h2) const noexcept
+        {
+            std::uint64_t x = ctrl ^ (lsbs * static_cast<unsigned char>(h2));
+            return mask_type((x - lsbs) & ~x & msbs);
+        }
+        mask_type MatchEmpty() const noexcept { return mask_type((ctrl & ~(ctrl << 6)) & msbs); }
+        mask_type MatchEmptyOrDeleted() const noexcept
+        {
+            return mask_type((ctrl & ~(ctrl << 7)) & msbs);
+        }
+        mask_type MatchFullOrSentinel() const noexcept
+        {
+            return mask_type(~(ctrl & ~(ctrl << 7)) & msbs);
+        }
+
+    private:
+        static constexpr std::uint64_t lsbs = 0x0101010101010101ull;
+        static constexpr std::uint64_t msbs = 0x8080808080808080ull;
+
+        std::uint64_t ctrl;
+    };
+#endif
+
+    /// Control bytes of a table without storage: a sentinel, then empty bytes to load a group
+    alignas(16) inline constexpr __ctrl_t __empty_group[16] = {
+        __ctrl_sentinel, __ctrl_empty, __ctrl_empty, __ctrl_empty, __ctrl_empty, __ctrl_empty,
+        __ctrl_empty,    __ctrl_empty, __ctrl_empty, __ctrl_empty, __ctrl_empty, __ctrl_empty,
+        __ctrl_empty,    __ctrl_empty, __ctrl_empty, __ctrl_empty};
+
+    /// Checks if both hash and equality of a table accept keys of other types
+    template <typename Hash, typename Eq, typename = void>
+    struct __is_transparent : std::false_type
+    {};
+
+    template <typename Hash, typename Eq>
+    struct __is_transparent<Hash,
+                            Eq,
+                            std::void_t<typename Hash::is_transparent, typename Eq::is_transparent>>
+        : std::true_type
+    {};
+
+    /// Open-addressing table of Policy::slot_type
+    ///
+    /// Capacity is 0 or 2^n - 1. The control array holds capacity bytes, a sentinel, and a copy
+    /// of the first width - 1 bytes, so a group can be loaded at any position without wrapping.
+    template <typename Policy, typename Hash, typename Eq, typename Alloc>
+    class __flat_hash_table
+    {
+    protected:
+        using slot_type   = typename Policy::slot_type;
+        using AllocTraits = std::allocator_traits<Alloc>;
+
+        /// Enables lookups by K other than the key type, if Hash and Eq are transparent
+        template <typename K>
+        using EnableIfHeterogeneous =
+            std::enable_if_t<__is_transparent<Hash, Eq>::value
+                                 && !std::is_same_v<std::remove_cv_t<std::remove_reference_t<K>>,
+                                                    typename Policy::key_type>,
+                             int>;
+
+    public:
+        using key_type        = typename Policy::key_type;
+        using value_type      = typename Policy::value_type;
+        using size_type       = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using hasher          = Hash;
+        using key_equal       = Eq;
+        using allocator_type  = Alloc;
+        using reference       = value_type &;
+        using const_reference = const value_type &;
+
+        template <bool Const> class basic_iterator
+        {
+            friend class __flat_hash_table;
+
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type        = typename Policy::value_type;
+            using difference_type   = std::ptrdiff_t;
+            using reference         = std::conditional_t<Const || Policy::constant_iterators,
+                                                 const value_type &,
+                                                 value_type &>;
+            using pointer = std::remove_reference_t<reference> *;
+
+            basic_iterator() noexcept = default;
+            template <bool C, typename = std::enable_if_t<Const && !C>>
+            basic_iterator(const basic_iterator<C> &it) noexcept : ctrl(it.ctrl)
+                                                                 , slot(it.slot)
+            {}
+
+            reference operator*() const noexcept { return Policy::element(slot); }
+            pointer   operator->() const noexcept { return &Policy::element(slot); }
+
+            basic_iterator &operator++() noexcept
+            {
+                ++ctrl;
+                ++slot;
+                SkipEmptyOrDeleted();
+                return *this;
+            }
+            basic_iterator operator++(int) noexcept
+            {
+                basic_iterator tmp = *this;
+                ++*this;
+                return tmp;
+            }
+
+            friend bool operator==(const basic_iterator &a, const basic_iterator &b) noexcept
+            {
+                return a.ctrl == b.ctrl;
+            }
+            friend bool operator!=(const basic_iterator &a, const basic_iterator &b) noexcept
+            {
+                return a.ctrl != b.ctrl;
+            }
+
+        private:
+            template <bool> friend class basic_iterator;
+
+            basic_iterator(const __ctrl_t *_ctrl, slot_type *_slot) noexcept
+                : ctrl(_ctrl)
+                , slot(_slot)
+            {}
+
+            void SkipEmptyOrDeleted() noexcept
+            {
+                // Stops at a full slot or the sentinel
+                while (*ctrl < __ctrl_sentinel) {
+                    typename __group::mask_type mask = __group(ctrl).MatchFullOrSentinel();
+                    std::uint32_t shift = mask ? mask.LowestBitSet() : std::uint32_t(width);
+                    ctrl += shift;
+                    slot += shift;
+                }
+            }
+
+            const __ctrl_t *ctrl = nullptr;
+            slot_type *     slot = nullptr;
+        };
+
+        using iterator       = basic_iterator<false>;
+        using const_iterator = basic_iterator<true>;
+
+        __flat_hash_table() noexcept(noexcept(Alloc())) : __flat_hash_table(0) {}
+        explicit __flat_hash_table(size_type bucketCount,
+                                   const Hash & hash  = Hash(),
+                                   const Eq &   eq    = Eq(),
+                                   const Alloc &alloc = Alloc())
+            : hash_(hash)
+            , eq_(eq)
+            , alloc_(alloc)
+        {
+            if (bucketCount)
+                reserve(bucketCount);
+        }
+        explicit __flat_hash_table(const Alloc &alloc) : __flat_hash_table(0, Hash(), Eq(), alloc)
+        {}
+
+        __flat_hash_table(const __flat_hash_table &other)
+            : __flat_hash_table(other,
+                                AllocTraits::select_on_container_copy_construction(other.alloc_))
+        {}
+        __flat_hash_table(const __flat_hash_table &other, const Alloc &alloc)
+            : __flat_hash_table(0, other.hash_, other.eq_, alloc)
+        {
+            CopyElementsFrom(other);
+        }
+        __flat_hash_table(__flat_hash_table &&other) noexcept
+            : hash_(std::move(other.hash_))
+            , eq_(std::move(other.eq_))
+            , alloc_(std::move(other.alloc_))
+        {
+            StealFrom(other);
+        }
+        __flat_hash_table(__flat_hash_table &&other, const Alloc &alloc)
+            : __flat_hash_table(0, other.hash_, other.eq_, alloc)
+        {
+            if (alloc_ == other.alloc_)
+                StealFrom(other);
+            else
+                MoveElementsFrom(other);
+        }
+        ~__flat_hash_table() { DestroyAll(); }
+
+        __flat_hash_table &operator=(const __flat_hash_table &other)
+        {
+            if (this == &other)
+                return *this;
+            clear();
+            hash_ = other.hash_;
+            eq_   = other.eq_;
+            if constexpr (AllocTraits::propagate_on_container_copy_assignment::value) {
+                if (alloc_ != other.alloc_)
+                    DestroyAll();
+                alloc_ = other.alloc_;
+            }
+            CopyElementsFrom(other);
+            return *this;
+        }
+        __flat_hash_table &operator=(__flat_hash_table &&other) noexcept(
+            AllocTraits::propagate_on_container_move_assignment::value
+            || AllocTraits::is_always_equal::value)
+        {
+            if (this == &other)
+                return *this;
+            DestroyAll();
+            hash_ = std::move(other.hash_);
+            eq_   = std::move(other.eq_);
+            if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+                alloc_ = std::move(other.alloc_);
+                StealFrom(other);
+            }
+            else if (alloc_ == other.alloc_)
+                StealFrom(other);
+            else
+                MoveElementsFrom(other);
+            return *this;
+        }
+
+        allocator_type get_allocator() const noexcept { return alloc_; }
+        hasher         hash_function() const { return hash_; }
+        key_equal      key_eq() const { return eq_; }
+
+        /// @name Iterators
+        /// @{
+        iterator begin() noexcept
+        {
+            iterator it(ctrl_, slots_);
+            it.SkipEmptyOrDeleted();
+            return it;
+        }
+        const_iterator begin() const noexcept
+        {
+            return const_cast<__flat_hash_table *>(this)->begin();
+        }
+        const_iterator cbegin() const noexcept { return begin(); }
+        iterator       end() noexcept { return iterator(ctrl_ + capacity_, nullptr); }
+        const_iterator end() const noexcept { return const_iterator(ctrl_ + capacity_, nullptr); }
+        const_iterator cend() const noexcept { return end(); }
+        /// @}
+
+        /// @name Capacity
+        /// @{
+        [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+        size_type          size() const noexcept { return size_; }
+        size_type          max_size() const noexcept { return ~size_type(0) / 4 / sizeof(Unit); }
+        size_type          capacity() const noexcept { return capacity_; }
+        size_type          bucket_count() const noexcept { return capacity_; }
+        float              max_load_factor() const noexcept { return 7.0f / 8; }
+        float              load_factor() const noexcept
+        {
+            return capacity_ ? float(size_) / float(capacity_) : 0.0f;
+        }
+        /// @}
+
+        /// @name Lookup
+        /// @{
+        iterator       find(const key_type &key) { return FindIterator(key); }
+        const_iterator find(const key_type &key) const
+        {
+            return const_cast<__flat_hash_table *>(this)->FindIterator(key);
+        }
+        bool      contains(const key_type &key) const { return find(key) != end(); }
+        size_type count(const key_type &key) const { return contains(key) ? 1 : 0; }
+
+        template <typename K, EnableIfHeterogeneous<K> = 0> iterator find(const K &key)
+        {
+            return FindIterator(key);
+        }
+        template <typename K, EnableIfHeterogeneous<K> = 0> const_iterator find(const K &key) const
+        {
+            return const_cast<__flat_hash_table *>(this)->FindIterator(key);
+        }
+        template <typename K, EnableIfHeterogeneous<K> = 0> bool contains(const K &key) const
+        {
+            return find(key) != end();
+        }
+        template <typename K, EnableIfHeterogeneous<K> = 0> size_type count(const K &key) const
+        {
+            return contains(key) ? 1 : 0;
+        }
+        /// @}
+
+        /// @name Modifiers
+        /// @{
+        void clear() noexcept
+        {
+            if (!capacity_)
+                return;
+            if constexpr (!std::is_trivially_destructible_v<slot_type>) {
+                for (iterator it = begin(); it != end(); ++it)
+                    Policy::destroy(alloc_, it.slot);
+            }
+            std::memset(ctrl_, __ctrl_empty, capacity_ + __group::width);
+            ctrl_[capacity_] = __ctrl_sentinel;
+            size_            = 0;
+            growth_left_     = CapacityToGrowth(capacity_);
+        }
+
+        std::pair<iterator, bool> insert(const value_type &value)
+        {
+            return EmplaceUnique(Policy::key_of(value), value);
+        }
+        std::pair<iterator, bool> insert(value_type &&value)
+        {
+            return EmplaceUnique(Policy::key_of(value), std::move(value));
+        }
+        template <typename InputIt> void insert(InputIt first, InputIt last)
+        {
+            for (; first != last; ++first)
+                insert(*first);
+        }
+        void insert(std::initializer_list<value_type> il) { insert(il.begin(), il.end()); }
+
+        /// Constructs an element, then inserts it if its key is not present.
+        template <typename... Args> std::pair<iterator, bool> emplace(Args &&... args)
+        {
+            // Build the element in a scratch slot to look up its key
+            alignas(slot_type) unsigned char buffer[sizeof(slot_type)];
+            slot_type *tmp = reinterpret_cast<slot_type *>(buffer);
+            Policy::construct(alloc_, tmp, std::forward<Args>(args)...);
+
+            std::pair<iterator, bool> result;
+            try {
+                auto [index, inserted] = FindOrPrepareInsert(Policy::key(tmp));
+                if (inserted)
+                    Policy::transfer(alloc_, slots_ + index, tmp);
+                else
+                    Policy::destroy(alloc_, tmp);
+                result = {IteratorAt(index), inserted};
+            }
+            catch (...) {
+                Policy::destroy(alloc_, tmp);
+                throw;
+            }
+            return result;
+        }
+
+        iterator erase(const_iterator pos)
+        {
+            std::size_t index = static_cast<std::size_t>(pos.slot - slots_);
+            Policy::destroy(alloc_, slots_ + index);
+            EraseMeta(index);
+            iterator it(ctrl_ + index, slots_ + index);
+            it.SkipEmptyOrDeleted();
+            return it;
+        }
+        iterator erase(iterator pos) { return erase(const_iterator(pos)); }
+        iterator erase(const_iterator first, const_iterator last)
+        {
+            while (first != last)
+                first = erase(first);
+            return iterator(const_cast<__ctrl_t *>(first.ctrl), first.slot);
+        }
+        size_type erase(const key_type &key) { return EraseKey(key); }
+        template <typename K,
+                  EnableIfHeterogeneous<K> = 0,
+                  typename = std::enable_if_t<!std::is_convertible_v<K &&, const_iterator>>>
+        size_type erase(K &&key)
+        {
+            return EraseKey(key);
+        }
+
+        void swap(__flat_hash_table &other) noexcept
+        {
+            using std::swap;
+            swap(hash_, other.hash_);
+            swap(eq_, other.eq_);
+            if constexpr (AllocTraits::propagate_on_container_swap::value)
+                swap(alloc_, other.alloc_);
+            swap(ctrl_, other.ctrl_);
+            swap(slots_, other.slots_);
+            swap(capacity_, other.capacity_);
+            swap(size_, other.size_);
+            swap(growth_left_, other.growth_left_);
+        }
+
+        /// Reserves room for n elements without rehashing.
+        void reserve(size_type n)
+        {
+            if (n > size_ + growth_left_)
+                Resize(NormalizeCapacity(0, n));
+        }
+
+        /// Rehashes to a capacity for at least n slots and the current elements.
+        void rehash(size_type n)
+        {
+            size_type capacity = NormalizeCapacity(n, size_);
+            if (n == 0 && size_ == 0)
+                DestroyAll();
+            else if (capacity != capacity_ || n == 0)
+                Resize(capacity);
+        }
+        /// @}
+
+    protected:
+        friend void swap(__flat_hash_table &a, __flat_hash_table &b) noexcept { a.swap(b); }
+
+        static constexpr std::size_t width = __group::width;
+
+        /// Smallest capacity of the form 2^n - 1 (at least width - 1) with n slots and room for
+        /// growth elements.
+        static size_type NormalizeCapacity(size_type n, size_type growth = 0) noexcept
+        {
+            size_type capacity = width - 1;
+            while (capacity < n || CapacityToGrowth(capacity) < growth)
+                capacity = capacity * 2 + 1;
+            return capacity;
+        }
+        /// Maximal load factor of 7/8, always keeping an empty slot to end probing
+        static size_type CapacityToGrowth(size_type capacity) noexcept
+        {
+            return capacity - std::max<size_type>(capacity / 8, 1);
+        }
+
+        /// Mixes the user hash, so that identity hashes of integers probe well.
+        template <typename K> std::size_t HashOf(const K &key) const
+        {
+            std::uint64_t h = std::uint64_t(hash_(key)) * 0x9E3779B97F4A7C15ull;
+            return static_cast<std::size_t>(h ^ (h >> 32));
+        }
+        static std::size_t H1(std::size_t hash) noexcept { return hash >> 7; }
+        static __ctrl_t    H2(std::size_t hash) noexcept { return __ctrl_t(hash & 0x7F); }
+
+        template <typename K> iterator FindIterator(const K &key)
+        {
+            std::size_t index;
+            return Find(key, index) ? IteratorAt(index) : end();
+        }
+
+        template <typename K> size_type EraseKey(const K &key)
+        {
+            std::size_t index;
+            if (!Find(key, index))
+                return 0;
+            Policy::destroy(alloc_, slots_ + index);
+            EraseMeta(index);
+            return 1;
+        }
+
+        iterator IteratorAt(std::size_t index) noexcept
+        {
+            return iterator(ctrl_ + index, slots_ + index);
+        }
+
+        void SetCtrl(std::size_t index, __ctrl_t h) noexcept
+        {
+            ctrl_[index] = h;
+            if (index < width - 1)
+                ctrl_[capacity_ + 1 + index] = h;  // Cloned byte after the sentinel
+        }
+
+        template <typename K> bool Find(const K &key, std::size_t &index)
+        {
+            std::size_t hash = HashOf(key);
+            __ctrl_t    h2   = H2(hash);
+            std::size_t pos  = H1(hash) & capacity_;
+            for (std::size_t step = width;; step += width) {
+                __group g(ctrl_ + pos);
+                for (std::uint32_t i : g.Match(h2)) {
+                    std::size_t candidate = (pos + i) & capacity_;
+                    if (eq_(Policy::key(slots_ + candidate), key)) {
+                        index = candidate;
+                        return true;
+                    }
+                }
+                if (g.MatchEmpty())
+                    return false;
+                pos = (pos + step) & capacity_;
+            }
+        }
+
+        std::size_t FindFirstNonFull(std::size_t hash) const noexcept
+        {
+            std::size_t pos = H1(hash) & capacity_;
+            for (std::size_t step = width;; step += width) {
+                typename __group::mask_type mask = __group(ctrl_ + pos).MatchEmptyOrDeleted();
+                if (mask)
+                    return (pos + mask.LowestBitSet()) & capacity_;
+                pos = (pos + step) & capacity_;
+            }
+        }
+
+        /// Claims a slot for a new element of hash, growing the table if needed.
+        std::size_t PrepareInsert(std::size_t hash)
+        {
+            std::size_t target = FindFirstNonFull(hash);
+            if (growth_left_ == 0 && ctrl_[target] != __ctrl_deleted) {
+                // Reclaim tombstones when they are more than the elements, otherwise grow
+                if (capacity_ > width && size_ * 32 <= capacity_ * 25)
+                    Resize(capacity_);
+                else
+                    Resize(NormalizeCapacity(capacity_ * 2 + 1));
+                target = FindFirstNonFull(hash);
+            }
+            size_++;
+            growth_left_ -= ctrl_[target] == __ctrl_empty;
+            SetCtrl(target, H2(hash));
+            return target;
+        }
+
+        /// Finds the key, or claims a slot for it.
+        /// @return Index of the slot, and whether the slot is claimed (still unconstructed).
+        template <typename K> std::pair<std::size_t, bool> FindOrPrepareInsert(const K &key)
+        {
+            std::size_t index;
+            if (Find(key, index))
+                return {index, false};
+            return {PrepareInsert(HashOf(key)), true};
+        }
+
+        /// Constructs an element from args in the slot of key if key is not present.
+        template <typename K, typename... Args>
+        std::pair<iterator, bool> EmplaceUnique(const K &key, Args &&... args)
+        {
+            auto [index, inserted] = FindOrPrepareInsert(key);
+            if (inserted) {
+                try {
+                    Policy::construct(alloc_, slots_ + index, std::forward<Args>(args)...);
+                }
+                catch (...) {
+                    EraseMeta(index);
+                    throw;
+                }
+            }
+            return {IteratorAt(index), inserted};
+        }
+
+        /// Marks a slot free. It becomes empty if no probe sequence can pass it, as there is an
+        /// empty slot in every group containing it, otherwise it becomes a tombstone.
+        void EraseMeta(std::size_t index) noexcept
+        {
+            std::size_t before      = (index - width) & capacity_;
+            auto        emptyAfter  = __group(ctrl_ + index).MatchEmpty();
+            auto        emptyBefore = __group(ctrl_ + before).MatchEmpty();
+            bool        wasNeverFull =
+                emptyBefore && emptyAfter
+                && emptyAfter.TrailingZeros() + emptyBefore.LeadingZeros() < width;
+
+            SetCtrl(index, wasNeverFull ? __ctrl_empty : __ctrl_deleted);
+            growth_left_ += wasNeverFull;
+            size_--;
+        }
+
+        /// Moves all elements to new storage of newCapacity slots.
+        void Resize(std::size_t newCapacity)
+        {
+            __ctrl_t *   oldCtrl     = ctrl_;
+            slot_type *  oldSlots    = slots_;
+            std::size_t  oldCapacity = capacity_;
+
+            Allocate(newCapacity);
+            growth_left_ = CapacityToGrowth(newCapacity) - size_;
+            for (std::size_t i = 0; i < oldCapacity; i++) {
+                if (oldCtrl[i] >= 0) {
+                    std::size_t hash   = HashOf(Policy::key(oldSlots + i));
+                    std::size_t target = FindFirstNonFull(hash);
+                    SetCtrl(target, H2(hash));
+                    Policy::transfer(alloc_, slots_ + target, oldSlots + i);
+                }
+            }
+            if (oldCapacity)
+                Deallocate(oldCtrl, oldCapacity);
+        }
+
+        /// Storage unit of the single allocation holding control bytes and slots
+        struct alignas(slot_type) Unit
+        {
+            unsigned char bytes[alignof(slot_type)];
+        };
+        using UnitAlloc = typename AllocTraits::template rebind_alloc<Unit>;
+
+        static std::size_t CtrlBytes(std::size_t capacity) noexcept
+        {
+            std::size_t bytes = capacity + width;
+            return (bytes + alignof(slot_type) - 1) / alignof(slot_type) * alignof(slot_type);
+        }
+        static std::size_t UnitCount(std::size_t capacity) noexcept
+        {
+            return (CtrlBytes(capacity) + capacity * sizeof(slot_type) + sizeof(Unit) - 1)
+                   / sizeof(Unit);
+        }
+
+        void Allocate(std::size_t capacity)
+        {
+            UnitAlloc alloc(alloc_);
+            Unit *    mem = std::allocator_traits<UnitAlloc>::allocate(alloc, UnitCount(capacity));
+            ctrl_         = reinterpret_cast<__ctrl_t *>(mem);
+            slots_        = reinterpret_cast<slot_type *>(reinterpret_cast<char *>(mem)
+                                                   + CtrlBytes(capacity));
+            capacity_     = capacity;
+            std::memset(ctrl_, __ctrl_empty, capacity + width);
+            ctrl_[capacity] = __ctrl_sentinel;
+        }
+
+        void Deallocate(__ctrl_t *ctrl, std::size_t capacity) noexcept
+        {
+            UnitAlloc alloc(alloc_);
+            std::allocator_traits<UnitAlloc>::deallocate(alloc,
+                                                         reinterpret_cast<Unit *>(ctrl),
+                                                         UnitCount(capacity));
+        }
+
+        /// Destroys all elements and releases the storage.
+        void DestroyAll() noexcept
+        {
+            if (!capacity_)
+                return;
+            if constexpr (!std::is_trivially_destructible_v<slot_type>) {
+                for (iterator it = begin(); it != end(); ++it)
+                    Policy::destroy(alloc_, it.slot);
+            }
+            Deallocate(ctrl_, capacity_);
+            ctrl_        = const_cast<__ctrl_t *>(__empty_group);
+            slots_       = nullptr;
+            capacity_    = 0;
+            size_        = 0;
+            growth_left_ = 0;
+        }
+
+        void StealFrom(__flat_hash_table &other) noexcept
+        {
+            ctrl_              = other.ctrl_;
+            slots_             = other.slots_;
+            capacity_          = other.capacity_;
+            size_              = other.size_;
+            growth_left_       = other.growth_left_;
+            other.ctrl_        = const_cast<__ctrl_t *>(__empty_group);
+            other.slots_       = nullptr;
+            other.capacity_    = 0;
+            other.size_        = 0;
+            other.growth_left_ = 0;
+        }
+
+        /// Copies all elements of other into this empty table. If a copy throws, the elements
+        /// copied so far are kept, so that the table stays valid.
+        void CopyElementsFrom(const __flat_hash_table &other)
+        {
+            reserve(other.size_);
+            for (const_iterator it = other.begin(); it != other.end(); ++it) {
+                std::size_t index = PrepareInsert(HashOf(Policy::key(it.slot)));
+                try {
+                    Policy::construct(alloc_, slots_ + index, Policy::element(it.slot));
+                }
+                catch (...) {
+                    EraseMeta(index);
+                    throw;
+                }
+            }
+        }
+
+        void MoveElementsFrom(__flat_hash_table &other)
+        {
+            reserve(other.size_);
+            for (iterator it = other.begin(); it != other.end(); ++it) {
+                std::size_t index = PrepareInsert(HashOf(Policy::key(it.slot)));
+                Policy::transfer(alloc_, slots_ + index, it.slot);
+            }
+            // Elements are transferred out, only the storage is left
+            other.Deallocate(other.ctrl_, other.capacity_);
+            other.ctrl_        = const_cast<__ctrl_t *>(__empty_group);
+            other.slots_       = nullptr;
+            other.capacity_    = 0;
+            other.size_        = 0;
+            other.growth_left_ = 0;
+        }
+
+        Hash        hash_;
+        Eq          eq_;
+        Alloc       alloc_;
+        __ctrl_t *  ctrl_        = const_cast<__ctrl_t *>(__empty_group);
+        slot_type * slots_       = nullptr;
+        std::size_t capacity_    = 0;
+        std::size_t size_        = 0;
+        std::size_t growth_left_ = 0;
+    };
+
+}  // namespace detail
+
+}  // namespace ftc
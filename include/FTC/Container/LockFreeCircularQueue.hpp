@@ -7,32 +7,98 @@
 
 #pragma once
 
+#include "FTC/Container/WaitStrategy.hpp"
+#include "FTC/Detail/CacheLine.hpp"
+#include "FTC/Traits/Relocatable.hpp"
+
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <cstddef>
+#include <iterator>
 #include <memory>
+#include <memory_resource>
+#include <mutex>
 #include <optional>
 #include <thread>
+#include <type_traits>
+#include <vector>
 
 namespace ftc {
 
-template <typename T, std::size_t Size, bool SP, bool SC> class LockFreeCircularQueue
+/// Size value indicating that the capacity of a LockFreeCircularQueue is decided at runtime.
+inline constexpr std::size_t DynamicSize = 0;
+
+/// Slot layout where every slot occupies a whole cache line, so that no two slots share a line.
+struct PaddedLayout
+{};
+
+/// Slot layout where slots are packed densely into cache lines to reduce memory footprint.
+/// Positions are swizzled so that consecutive positions still fall on different cache lines.
+struct CompactLayout
+{};
+
+namespace detail {
+
+    /// Dense index of the calling thread among the live threads of the process, assigned on
+    /// first use. The lowest free index is taken, and given back when the thread exits.
+    std::size_t __thread_index();
+
+}  // namespace detail
+
+/// Bounded lock-free circular queue
+/// @tparam T Element type
+/// @tparam Size Capacity of the queue, must be a power of 2, or DynamicSize to allocate the
+/// slots from a memory resource with a capacity given at construction.
+/// @tparam SP Whether there is only a single producer
+/// @tparam SC Whether there is only a single consumer
+/// @tparam Wait Wait strategy used by blocking operations, see @ref WaitStrategy
+/// @tparam Layout Slot layout, PaddedLayout or CompactLayout
+template <typename T,
+          std::size_t Size,
+          bool        SP,
+          bool        SC,
+          typename Wait   = BusySpinWait,
+          typename Layout = PaddedLayout>
+class LockFreeCircularQueue
 {
-    static_assert(Size >= 32, "Size must be at least 32");
-    static_assert(Size & (Size - 1) == 0, "Size must be a power of 2");
-
-#ifdef __cpp_lib_hardware_interference_size
-    static constexpr std::size_t cacheLineSize = std::hardware_destructive_interference_size;
-#else
-    static constexpr std::size_t cacheLineSize = 64;
-#endif
+    static_assert(Size >= 32 || Size == DynamicSize, "Size must be at least 32");
+    static_assert((Size & (Size - 1)) == 0, "Size must be a power of 2");
+    static_assert(std::is_same_v<Layout, PaddedLayout> || std::is_same_v<Layout, CompactLayout>,
+                  "Layout must be PaddedLayout or CompactLayout");
 
-    static constexpr std::size_t numMaxThreads = 16;
+    static constexpr std::size_t cacheLineSize = detail::__cache_line_size;
 
 public:
-    LockFreeCircularQueue();
+    /// @brief Gets the default bound of concurrent producers.
+    /// @return Hardware thread count, or 16 if it is not computable.
+    static std::size_t DefaultMaxProducers() noexcept;
+
+    /// @brief Constructs a queue with fixed capacity of Size.
+    /// @param maxProducers Expected bound of concurrently pushing threads.
+    /// @note While the queue has spare room for maxProducers elements, producers reserve
+    /// positions with a single fetch_add instead of CAS. Only threads whose process-wide thread
+    /// index is below maxProducers take this path, so that any number of producers is safe;
+    /// the others use the CAS path. A position reserved with fetch_add may only have to wait
+    /// for a consumer that already reserved the previous value of its slot to move it out.
+    template <std::size_t S = Size, std::enable_if_t<S != DynamicSize, int> = 0>
+    explicit LockFreeCircularQueue(std::size_t maxProducers = DefaultMaxProducers());
+
+    /// @brief Constructs a queue with runtime capacity, allocating its slots from resource.
+    /// @param capacity Minimal capacity, rounded up to a power of 2 and at least 32.
+    /// @param resource Memory resource to allocate the slot array from.
+    /// @param maxProducers Expected bound of concurrently pushing threads.
+    template <std::size_t S = Size, std::enable_if_t<S == DynamicSize, int> = 0>
+    explicit LockFreeCircularQueue(
+        std::size_t                capacity,
+        std::pmr::memory_resource *resource     = std::pmr::get_default_resource(),
+        std::size_t                maxProducers = DefaultMaxProducers());
+
     ~LockFreeCircularQueue();
 
+    LockFreeCircularQueue(const LockFreeCircularQueue &) = delete;
+    LockFreeCircularQueue &operator=(const LockFreeCircularQueue &) = delete;
+
     /// @brief Try to construct a value into the queue (non-blocking).
     /// @return Whether the emplacement operation is success.
     /// Returns immediately if emplacement fails due to contention or buffer is full.
@@ -69,6 +135,23 @@ public:
     /// Blocks due to contention or buffer is empty until pop succeeds.
     T Pop();
 
+    /// @brief Try to copy a range of values into the queue (non-blocking).
+    /// Positions for the whole range are reserved with a single atomic operation.
+    /// @return Count of values pushed, which are always a prefix of [first, last).
+    /// Pushes as many values as there is room for, returns 0 if buffer is full.
+    template <typename ForwardIt> std::size_t TryPushBulk(ForwardIt first, ForwardIt last);
+
+    /// @brief Try to pop at most maxCount values out of the queue (non-blocking).
+    /// Positions for all values are reserved with a single atomic operation. If out is a T*
+    /// and T is trivially relocatable, each target is destroyed and the value is relocated over
+    /// it with memcpy, instead of moving through a temporary.
+    /// @return Count of values popped into out.
+    /// Pops as many values as available, returns 0 if buffer is empty.
+    template <typename OutputIt> std::size_t TryPopBulk(OutputIt out, std::size_t maxCount);
+
+    /// Returns the capacity of the queue.
+    std::size_t Capacity() const noexcept;
+
     /// Returns the estimated count of current elements.
     std::size_t Count() const;
 
@@ -79,20 +162,76 @@ public:
     bool Full() const;
 
 private:
+    /// @brief Tag describes the state of a slot.
+    /// Slot for position p is writable when its tag is {CycleOf(p), false}, and is readable when
+    /// its tag is {CycleOf(p), true}. After a value is moved out, consumer hands the slot over to
+    /// the next cycle by storing {CycleOf(p) + 1, false}.
     struct Tag
     {
         std::size_t cycle : sizeof(std::size_t) * 8 - 1;
         bool        full : 1;
+
+        friend bool operator==(const Tag &a, const Tag &b) noexcept
+        {
+            return a.cycle == b.cycle && a.full == b.full;
+        }
+        friend bool operator!=(const Tag &a, const Tag &b) noexcept { return !(a == b); }
     };
     static_assert(std::atomic<Tag>::is_always_lock_free);
 
-    // @brief Slot contains a tag and a value (default as uninitialized storage).
-    // Slot is aligned as the cache line size, to avoid false sharing.
-    struct alignas(cacheLineSize) Slot
+    struct PackedSlot
     {
         std::atomic<Tag>                              tag;
         std::aligned_storage_t<sizeof(T), alignof(T)> storage;
-    } slots_[Size];
+    };
+
+    static constexpr std::size_t BitCeil(std::size_t x)
+    {
+        std::size_t n = 1;
+        while (n < x)
+            n <<= 1;
+        return n;
+    }
+
+    static constexpr std::size_t Log2(std::size_t x)
+    {
+        std::size_t n = 0;
+        while ((std::size_t(1) << n) < x)
+            n++;
+        return n;
+    }
+
+    static constexpr std::size_t slotAlign =
+        std::is_same_v<Layout, CompactLayout> && BitCeil(sizeof(PackedSlot)) < cacheLineSize
+            ? BitCeil(sizeof(PackedSlot))
+            : cacheLineSize;
+
+    // @brief Slot contains a tag and a value (default as uninitialized storage).
+    // Padded slot is aligned as the cache line size, to avoid false sharing. Compact slot is
+    // aligned as its size rounded up to a power of 2, so that it never crosses a cache line.
+    struct alignas(slotAlign) Slot : PackedSlot
+    {};
+
+    static constexpr std::size_t slotsPerLine = slotAlign < cacheLineSize
+                                                    ? cacheLineSize / sizeof(Slot)
+                                                    : 1;
+
+    /// Slot array allocated from a memory resource, used when Size is DynamicSize.
+    struct DynamicSlots
+    {
+        Slot *                     data;
+        std::size_t                capacity;
+        std::size_t                capacityShift;
+        std::pmr::memory_resource *resource;
+
+        Slot &operator[](std::size_t i) const noexcept { return data[i]; }
+    };
+
+    alignas(cacheLineSize)
+        std::conditional_t<Size == DynamicSize, DynamicSlots, std::array<Slot, Size>> slots_;
+
+    /// Bound of concurrent producers that may reserve positions with fetch_add.
+    const std::size_t maxProducers_;
 
     /// Index of the front of the queue.
     alignas(cacheLineSize) std::atomic<std::size_t> head_;
@@ -100,128 +239,442 @@ private:
     /// Index of the back of the queue.
     alignas(cacheLineSize) std::atomic<std::size_t> tail_;
 
-    static inline std::size_t IndexOf(std::size_t p) { return p % Size; }
-    static inline std::size_t CycleOf(std::size_t p) { return p / Size; }
+    /// Wait strategy for consumers blocked on an empty queue.
+    alignas(cacheLineSize) Wait notEmpty_;
+
+    /// Wait strategy for producers blocked on a full queue.
+    alignas(cacheLineSize) Wait notFull_;
+
+    inline std::size_t CapacityShift() const;
+    inline std::size_t IndexOf(std::size_t p) const;
+    inline std::size_t CycleOf(std::size_t p) const { return p >> CapacityShift(); }
+    inline Slot &      SlotOf(std::size_t p) { return slots_[IndexOf(p)]; }
+
+    /// Constructs a value in the slot of position p, then publishes it to consumers.
+    template <typename... Args> void Produce(std::size_t p, Args &&... args);
+
+    /// Moves the value out of the slot of position p, then hands the slot over to producers.
+    T Consume(std::size_t p);
+
+    /// Relocates the value in the slot of position p to uninitialized dst, then hands the slot
+    /// over to producers.
+    void ConsumeTo(std::size_t p, T *dst);
+
+    /// Counts consecutive slots from position p (at most maxCount) with tag {CycleOf(p), full}.
+    std::size_t CountSlots(std::size_t p, std::size_t maxCount, bool full);
 };
 
 }  // namespace ftc
 
-template <typename T, std::size_t Size, bool SP, bool SC>
-inline ftc::LockFreeCircularQueue<T, Size, SP, SC>::LockFreeCircularQueue() : head_()
-                                                                            , tail_()
+inline std::size_t ftc::detail::__thread_index()
+{
+    struct Registry
+    {
+        std::mutex        mutex;
+        std::vector<bool> used;
+    };
+    static Registry registry;
+
+    struct Index
+    {
+        std::size_t value;
+
+        Index()
+        {
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            std::vector<bool> &         used = registry.used;
+            value = std::size_t(std::find(used.begin(), used.end(), false) - used.begin());
+            if (value == used.size())
+                used.push_back(true);
+            else
+                used[value] = true;
+        }
+        ~Index()
+        {
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            registry.used[value] = false;
+        }
+    };
+    thread_local Index index;
+    return index.value;
+}
+
+template <typename T, std::size_t Size, bool SP, bool SC, typename Wait, typename Layout>
+template <std::size_t S, std::enable_if_t<S != ftc::DynamicSize, int>>
+inline ftc::LockFreeCircularQueue<T, Size, SP, SC, Wait, Layout>::LockFreeCircularQueue(
+    std::size_t maxProducers)
+    : maxProducers_(SP ? 1 : maxProducers)
+    , head_()
+    , tail_()
+{
+    for (Slot &slot : slots_)
+        slot.tag.store(Tag {0, false}, std::memory_order_relaxed);
+}
+
+template <typename T, std::size_t Size, bool SP, bool SC, typename Wait, typename Layout>
+template <std::size_t S, std::enable_if_t<S == ftc::DynamicSize, int>>
+inline ftc::LockFreeCircularQueue<T, Size, SP, SC, Wait, Layout>::LockFreeCircularQueue(
+    std::size_t                capacity,
+    std::pmr::memory_resource *resource,
+    std::size_t                maxProducers)
+    : slots_ {nullptr, 32, 5, resource}
+    , maxProducers_(SP ? 1 : maxProducers)
+    , head_()
+    , tail_()
+{
+    while (slots_.capacity < capacity) {
+        slots_.capacity <<= 1;
+        slots_.capacityShift++;
+    }
+
+    slots_.data = static_cast<Slot *>(
+        resource->allocate(sizeof(Slot) * slots_.capacity, cacheLineSize));
+    for (std::size_t i = 0; i < slots_.capacity; i++)
+        new (&slots_.data[i]) Slot {{Tag {0, false}, {}}};
+}
+
+template <typename T, std::size_t Size, bool SP, bool SC, typename Wait, typename Layout>
+inline ftc::LockFreeCircularQueue<T, Size, SP, SC, Wait, Layout>::~LockFreeCircularQueue()
+{
+    std::size_t head = head_.load(std::memory_order_relaxed);
+    std::size_t tail = tail_.load(std::memory_order_relaxed);
+    for (std::size_t p = head; p != tail; p++) {
+        Slot &slot = SlotOf(p);
+        if (slot.tag.load(std::memory_order_acquire) == Tag {CycleOf(p), true})
+            reinterpret_cast<T *>(&slot.storage)->~T();
+    }
+
+    if constexpr (Size == DynamicSize) {
+        for (std::size_t i = 0; i < slots_.capacity; i++)
+            slots_.data[i].~Slot();
+        slots_.resource->deallocate(slots_.data, sizeof(Slot) * slots_.capacity, cacheLineSize);
+    }
+}
+
+template <typename T, std::size_t Size, bool SP, bool SC, typename Wait, typename Layout>
+inline std::size_t
+ftc::LockFreeCircularQueue<T, Size, SP, SC, Wait, Layout>::DefaultMaxProducers() noexcept
+{
+    std::size_t count = std::thread::hardware_concurrency();
+    return count ? count : 16;
+}
+
+template <typename T, std::size_t Size, bool SP, bool SC, typename Wait, typename Layout>
+inline std::size_t
+ftc::LockFreeCircularQueue<T, Size, SP, SC, Wait, Layout>::CapacityShift() const
+{
+    if constexpr (Size == DynamicSize)
+        return slots_.capacityShift;
+    else {
+        constexpr std::size_t shift = Log2(Size);
+        return shift;
+    }
+}
+
+template <typename T, std::size_t Size, bool SP, bool SC, typename Wait, typename Layout>
+inline std::size_t
+ftc::LockFreeCircularQueue<T, Size, SP, SC, Wait, Layout>::IndexOf(std::size_t p) const
+{
+    std::size_t index = p & (Capacity() - 1);
+    if constexpr (slotsPerLine > 1) {
+        // Spread consecutive indices over different cache lines:
+        // index = offset * numLines + line  =>  line * slotsPerLine + offset
+        std::size_t lineShift = CapacityShift() - Log2(slotsPerLine);
+        std::size_t line      = index & ((std::size_t(1) << lineShift) - 1);
+        std::size_t offset    = index >> lineShift;
+        return line * slotsPerLine + offset;
+    }
+    else
+        return index;
+}
+
+template <typename T, std::size_t Size, bool SP, bool SC, typename Wait, typename Layout>
+template <typename... Args>
+inline void
+ftc::LockFreeCircularQueue<T, Size, SP, SC, Wait, Layout>::Produce(std::size_t p, Args &&... args)
+{
+    Slot &slot = SlotOf(p);
+    new (&slot.storage) T(std::forward<Args>(args)...);
+    slot.tag.store(Tag {CycleOf(p), true}, std::memory_order_release);
+}
+
+template <typename T, std::size_t Size, bool SP, bool SC, typename Wait, typename Layout>
+inline T ftc::LockFreeCircularQueue<T, Size, SP, SC, Wait, Layout>::Consume(std::size_t p)
+{
+    Slot &slot  = SlotOf(p);
+    T *   ptr   = reinterpret_cast<T *>(&slot.storage);
+    T     value = std::move(*ptr);
+    ptr->~T();
+    slot.tag.store(Tag {CycleOf(p) + 1, false}, std::memory_order_release);
+    return value;
+}
+
+template <typename T, std::size_t Size, bool SP, bool SC, typename Wait, typename Layout>
+inline void ftc::LockFreeCircularQueue<T, Size, SP, SC, Wait, Layout>::ConsumeTo(std::size_t p,
+                                                                                 T *         dst)
 {
-    std::memset(slots_, 0, sizeof(slots_));
+    Slot &slot = SlotOf(p);
+    RelocateAt(reinterpret_cast<T *>(&slot.storage), dst);
+    slot.tag.store(Tag {CycleOf(p) + 1, false}, std::memory_order_release);
 }
 
-template <typename T, std::size_t Size, bool SP, bool SC>
-inline ftc::LockFreeCircularQueue<T, Size, SP, SC>::~LockFreeCircularQueue()
-{}
+template <typename T, std::size_t Size, bool SP, bool SC, typename Wait, typename Layout>
+inline std::size_t
+ftc::LockFreeCircularQueue<T, Size, SP, SC, Wait, Layout>::CountSlots(std::size_t p,
+                                                                      std::size_t maxCount,
+                                                                      bool        full)
+{
+    std::size_t count = 0;
+    while (count < maxCount
+           && SlotOf(p + count).tag.load(std::memory_order_acquire)
+                  == Tag {CycleOf(p + count), full})
+        count++;
+    return count;
+}
 
-template <typename T, std::size_t Size, bool SP, bool SC>
+template <typename T, std::size_t Size, bool SP, bool SC, typename Wait, typename Layout>
 template <typename... Args>
-inline bool ftc::LockFreeCircularQueue<T, Size, SP, SC>::TryEmplace(Args &&... args)
+inline bool
+ftc::LockFreeCircularQueue<T, Size, SP, SC, Wait, Layout>::TryEmplace(Args &&... args)
 {
     std::size_t tail = tail_.load(std::memory_order_relaxed);
-    std::size_t head = head_.load(std::memory_order_relaxed);
 
     if constexpr (SP) {
-        if (tail - head < Size) {
-            tail_.store(tail + 1, std::memory_order_relaxed);
-            std::size_t index = IndexOf(tail);
-            Tag         tag   = slots_[index].tag.load(std::memory_order_acquire);
-            if (!tag.full) {
-                new (&slots_[index].storage) T(std::forward<Args>(args)...);
-                slots_[index].tag.store(Tag {CycleOf(tail), true}, std::memory_order_release);
-                return true;
-            }
-        }
+        // Only this thread writes tail, so the slot can be checked without reservation.
+        Tag tag = SlotOf(tail).tag.load(std::memory_order_acquire);
+        if (tag != Tag {CycleOf(tail), false})
+            return false;
+
+        Produce(tail, std::forward<Args>(args)...);
+        tail_.store(tail + 1, std::memory_order_relaxed);
+        notEmpty_.Notify();
+        return true;
     }
     else {
+        std::size_t    head  = head_.load(std::memory_order_relaxed);
         std::ptrdiff_t count = tail - head;
-        if (count + numMaxThreads < Size) {
-            tail              = tail_.fetch_add(1, std::memory_order_relaxed);
-            std::size_t index = IndexOf(tail);
-            Tag         tag   = slots_[index].tag.load(std::memory_order_acquire);
-            if (!tag.full && tag.cycle == CycleOf(tail) - 1) {
-                new (&slots_[index].storage) T(std::forward<Args>(args)...);
-                slots_[index].tag.store(Tag {CycleOf(tail), true}, std::memory_order_release);
-                return true;
-            }
+
+        if (count + maxProducers_ < Capacity() && detail::__thread_index() < maxProducers_) {
+            // At most maxProducers_ threads have an index below it, so there is room for every
+            // producer between the check and the reservation, and the position is reserved
+            // unconditionally. The previous value of its slot is already reserved by a
+            // consumer, which may still be moving it out for a short while.
+            tail       = tail_.fetch_add(1, std::memory_order_relaxed);
+            Slot &slot = SlotOf(tail);
+            while (slot.tag.load(std::memory_order_acquire) != Tag {CycleOf(tail), false})
+                CpuRelax();
+
+            Produce(tail, std::forward<Args>(args)...);
+            notEmpty_.Notify();
+            return true;
         }
-        else if (count < Size) {
-            if (tail_.compare_exchange_strong(tail, tail + 1, std::memory_order_relaxed)) {
-                std::size_t index = IndexOf(tail);
-                new (&slots_[index].storage) T(std::forward<Args>(args)...);
-                slots_[index].tag.store(Tag {CycleOf(tail), true}, std::memory_order_release);
-                return true;
+
+        // Near full or beyond the producer bound, only reserve the position when its slot is
+        // known to be writable.
+        for (;;) {
+            Tag tag = SlotOf(tail).tag.load(std::memory_order_acquire);
+            if (tag == Tag {CycleOf(tail), false}) {
+                if (tail_.compare_exchange_weak(tail, tail + 1, std::memory_order_relaxed)) {
+                    Produce(tail, std::forward<Args>(args)...);
+                    notEmpty_.Notify();
+                    return true;
+                }
             }
+            else if (tag.cycle < CycleOf(tail))
+                return false;  // value of previous cycle is not consumed yet
+            else
+                tail = tail_.load(std::memory_order_relaxed);
         }
     }
-
-    return false;
 }
 
-template <typename T, std::size_t Size, bool SP, bool SC>
+template <typename T, std::size_t Size, bool SP, bool SC, typename Wait, typename Layout>
 template <typename... Args>
-inline void ftc::LockFreeCircularQueue<T, Size, SP, SC>::Emplace(Args &&... args)
+inline void ftc::LockFreeCircularQueue<T, Size, SP, SC, Wait, Layout>::Emplace(Args &&... args)
 {
-    while (!TryEmplace(std::forward<Args>(args)...)) {
-        std::atomic_thread_fence(std::memory_order_seq_cst);
-    }
+    notFull_.WaitUntil([&] { return TryEmplace(std::forward<Args>(args)...); });
 }
 
-template <typename T, std::size_t Size, bool SP, bool SC>
-inline bool ftc::LockFreeCircularQueue<T, Size, SP, SC>::TryPush(const T &value)
+template <typename T, std::size_t Size, bool SP, bool SC, typename Wait, typename Layout>
+inline bool ftc::LockFreeCircularQueue<T, Size, SP, SC, Wait, Layout>::TryPush(const T &value)
 {
     return TryEmplace(value);
 }
 
-template <typename T, std::size_t Size, bool SP, bool SC>
-inline bool ftc::LockFreeCircularQueue<T, Size, SP, SC>::TryPush(T &&value)
+template <typename T, std::size_t Size, bool SP, bool SC, typename Wait, typename Layout>
+inline bool ftc::LockFreeCircularQueue<T, Size, SP, SC, Wait, Layout>::TryPush(T &&value)
 {
     return TryEmplace(std::move(value));
 }
 
-template <typename T, std::size_t Size, bool SP, bool SC>
-inline void ftc::LockFreeCircularQueue<T, Size, SP, SC>::Push(const T &value)
+template <typename T, std::size_t Size, bool SP, bool SC, typename Wait, typename Layout>
+inline void ftc::LockFreeCircularQueue<T, Size, SP, SC, Wait, Layout>::Push(const T &value)
 {
     Emplace(value);
 }
 
-template <typename T, std::size_t Size, bool SP, bool SC>
-inline void ftc::LockFreeCircularQueue<T, Size, SP, SC>::Push(T &&value)
+template <typename T, std::size_t Size, bool SP, bool SC, typename Wait, typename Layout>
+inline void ftc::LockFreeCircularQueue<T, Size, SP, SC, Wait, Layout>::Push(T &&value)
 {
     Emplace(std::move(value));
 }
 
-template <typename T, std::size_t Size, bool SP, bool SC>
-inline std::optional<T> ftc::LockFreeCircularQueue<T, Size, SP, SC>::TryPop()
+template <typename T, std::size_t Size, bool SP, bool SC, typename Wait, typename Layout>
+inline std::optional<T>
+ftc::LockFreeCircularQueue<T, Size, SP, SC, Wait, Layout>::TryPop()
+{
+    std::size_t head = head_.load(std::memory_order_relaxed);
+
+    if constexpr (SC) {
+        // Only this thread writes head, so the slot can be checked without reservation.
+        Tag tag = SlotOf(head).tag.load(std::memory_order_acquire);
+        if (tag != Tag {CycleOf(head), true})
+            return std::nullopt;
+
+        std::optional<T> value {Consume(head)};
+        head_.store(head + 1, std::memory_order_relaxed);
+        notFull_.Notify();
+        return value;
+    }
+    else {
+        for (;;) {
+            Tag tag = SlotOf(head).tag.load(std::memory_order_acquire);
+            if (tag == Tag {CycleOf(head), true}) {
+                if (head_.compare_exchange_weak(head, head + 1, std::memory_order_relaxed)) {
+                    std::optional<T> value {Consume(head)};
+                    notFull_.Notify();
+                    return value;
+                }
+            }
+            else if (tag.cycle <= CycleOf(head))
+                return std::nullopt;  // value of current cycle is not produced yet
+            else
+                head = head_.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+template <typename T, std::size_t Size, bool SP, bool SC, typename Wait, typename Layout>
+inline T ftc::LockFreeCircularQueue<T, Size, SP, SC, Wait, Layout>::Pop()
+{
+    std::optional<T> value;
+    notEmpty_.WaitUntil([&] { return (value = TryPop()).has_value(); });
+    return std::move(*value);
+}
+
+template <typename T, std::size_t Size, bool SP, bool SC, typename Wait, typename Layout>
+template <typename ForwardIt>
+inline std::size_t
+ftc::LockFreeCircularQueue<T, Size, SP, SC, Wait, Layout>::TryPushBulk(ForwardIt first,
+                                                                       ForwardIt last)
+{
+    std::size_t maxCount = std::distance(first, last);
+    std::size_t tail     = tail_.load(std::memory_order_relaxed);
+    std::size_t count    = 0;
+
+    if (maxCount == 0)
+        return 0;
+
+    if constexpr (SP) {
+        count = CountSlots(tail, maxCount, false);
+    }
+    else {
+        for (;;) {
+            count = CountSlots(tail, maxCount, false);
+            if (count > 0) {
+                if (tail_.compare_exchange_weak(tail, tail + count, std::memory_order_relaxed))
+                    break;
+            }
+            else if (SlotOf(tail).tag.load(std::memory_order_acquire).cycle
+                     < CycleOf(tail))
+                return 0;  // value of previous cycle is not consumed yet
+            else
+                tail = tail_.load(std::memory_order_relaxed);
+        }
+    }
+
+    for (std::size_t i = 0; i < count; i++, ++first)
+        Produce(tail + i, *first);
+
+    if constexpr (SP)
+        tail_.store(tail + count, std::memory_order_relaxed);
+    notEmpty_.Notify();
+    return count;
+}
+
+template <typename T, std::size_t Size, bool SP, bool SC, typename Wait, typename Layout>
+template <typename OutputIt>
+inline std::size_t
+ftc::LockFreeCircularQueue<T, Size, SP, SC, Wait, Layout>::TryPopBulk(OutputIt    out,
+                                                                      std::size_t maxCount)
 {
-    return std::optional<T>();
+    std::size_t head  = head_.load(std::memory_order_relaxed);
+    std::size_t count = 0;
+
+    if (maxCount == 0)
+        return 0;
+
+    if constexpr (SC) {
+        count = CountSlots(head, maxCount, true);
+    }
+    else {
+        for (;;) {
+            count = CountSlots(head, maxCount, true);
+            if (count > 0) {
+                if (head_.compare_exchange_weak(head, head + count, std::memory_order_relaxed))
+                    break;
+            }
+            else if (SlotOf(head).tag.load(std::memory_order_acquire).cycle
+                     <= CycleOf(head))
+                return 0;  // value of current cycle is not produced yet
+            else
+                head = head_.load(std::memory_order_relaxed);
+        }
+    }
+
+    if constexpr (std::is_same_v<OutputIt, T *> && is_trivially_relocatable_v<T>) {
+        for (std::size_t i = 0; i < count; i++, ++out) {
+            out->~T();
+            ConsumeTo(head + i, out);
+        }
+    }
+    else {
+        for (std::size_t i = 0; i < count; i++, ++out)
+            *out = Consume(head + i);
+    }
+
+    if constexpr (SC)
+        head_.store(head + count, std::memory_order_relaxed);
+    notFull_.Notify();
+    return count;
 }
 
-template <typename T, std::size_t Size, bool SP, bool SC>
-inline T ftc::LockFreeCircularQueue<T, Size, SP, SC>::Pop()
+template <typename T, std::size_t Size, bool SP, bool SC, typename Wait, typename Layout>
+inline std::size_t
+ftc::LockFreeCircularQueue<T, Size, SP, SC, Wait, Layout>::Capacity() const noexcept
 {
-    return T();
+    if constexpr (Size == DynamicSize)
+        return slots_.capacity;
+    else
+        return Size;
 }
 
-template <typename T, std::size_t Size, bool SP, bool SC>
-inline std::size_t ftc::LockFreeCircularQueue<T, Size, SP, SC>::Count() const
+template <typename T, std::size_t Size, bool SP, bool SC, typename Wait, typename Layout>
+inline std::size_t ftc::LockFreeCircularQueue<T, Size, SP, SC, Wait, Layout>::Count() const
 {
     std::size_t head = head_.load(std::memory_order_relaxed);
     std::size_t tail = tail_.load(std::memory_order_relaxed);
-    return tail > head ? tail - head > Size ? Size : tail - head : 0;
+    return tail > head ? tail - head > Capacity() ? Capacity() : tail - head : 0;
 }
 
-template <typename T, std::size_t Size, bool SP, bool SC>
-inline bool ftc::LockFreeCircularQueue<T, Size, SP, SC>::Empty() const
+template <typename T, std::size_t Size, bool SP, bool SC, typename Wait, typename Layout>
+inline bool ftc::LockFreeCircularQueue<T, Size, SP, SC, Wait, Layout>::Empty() const
 {
     return Count() == 0;
 }
 
-template <typename T, std::size_t Size, bool SP, bool SC>
-inline bool ftc::LockFreeCircularQueue<T, Size, SP, SC>::Full() const
+template <typename T, std::size_t Size, bool SP, bool SC, typename Wait, typename Layout>
+inline bool ftc::LockFreeCircularQueue<T, Size, SP, SC, Wait, Layout>::Full() const
 {
-    return Count() == Size;
+    return Count() == Capacity();
 }
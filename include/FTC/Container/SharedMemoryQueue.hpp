@@ -0,0 +1,388 @@
+/**
+ * @file SharedMemoryQueue.hpp
+ * Shared memory circular queue
+ *
+ * Places a fixed-size LockFreeCircularQueue in a named shared memory region, so that processes
+ * on the same host can exchange values through it without system calls on the fast path.
+ */
+
+#pragma once
+
+#include "FTC/Container/LockFreeCircularQueue.hpp"
+
+#include <atomic>        // for std::atomic
+#include <cerrno>        // for errno
+#include <chrono>        // for std::chrono::milliseconds, std::chrono::steady_clock
+#include <cstddef>       // for std::size_t
+#include <cstdint>       // for std::uint32_t, std::uint64_t
+#include <new>           // for placement new
+#include <stdexcept>     // for std::runtime_error
+#include <string>        // for std::string
+#include <system_error>  // for std::system_error, std::system_category
+#include <thread>        // for std::this_thread::sleep_for
+#include <type_traits>   // for std::is_standard_layout_v, std::is_trivially_copyable_v
+#include <utility>       // for std::exchange, std::swap
+
+#if defined(_WIN32)
+    #include "FTC/Detail/Windows.hpp"  // for CreateFileMappingA, MapViewOfFile, OpenProcess
+#else
+    #include <fcntl.h>     // for O_CREAT, O_RDWR
+    #include <signal.h>    // for kill
+    #include <sys/mman.h>  // for shm_open, shm_unlink, mmap, munmap
+    #include <sys/stat.h>  // for fstat
+    #include <unistd.h>    // for ftruncate, close, getpid
+#endif
+
+namespace ftc {
+
+/// Options for opening a SharedMemoryQueue
+struct SharedMemoryOptions
+{
+    /// Version of the payload format, processes attaching with another version are rejected
+    std::uint32_t version = 0;
+
+    /// How long to wait for another process to finish initializing the queue
+    std::chrono::milliseconds attachTimeout {1000};
+
+    /// Expected bound of concurrently pushing threads over all processes, 0 for the default.
+    /// Each process only keeps its own threads beyond the bound off the fetch_add path, so the
+    /// bound must still hold for the sum over processes.
+    std::size_t maxProducers = 0;
+
+    /// Access permissions of a newly created region (POSIX only)
+    unsigned permissions = 0600;
+};
+
+namespace detail {
+
+    /// Header at the start of the shared memory region, followed by the queue
+    struct __shm_queue_header
+    {
+        /// State of the queue: empty, being initialized by a process, or ready
+        static constexpr std::uint64_t Empty = 0;
+        static constexpr std::uint64_t Ready = ~std::uint64_t(0);
+
+        static constexpr std::uint64_t Magic         = 0x3151484D53435446;  // "FTCSMHQ1"
+        static constexpr std::uint32_t FormatVersion = 1;
+
+        std::atomic<std::uint64_t> state;  ///< Empty, Ready or the pid of the initializer
+        std::uint64_t              magic;
+        std::uint32_t              formatVersion;
+        std::uint32_t              version;
+        std::uint64_t              layout;
+    };
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free);
+    static_assert(std::is_standard_layout_v<__shm_queue_header>);
+
+    /// Checks if a wait strategy can be shared by processes: it must not keep any state, as
+    /// parking (futex, WaitOnAddress) on a mapping is private to the process.
+    template <typename Wait> inline constexpr bool __is_process_shared_wait = std::is_empty_v<Wait>;
+
+    /// Mapping of a named shared memory region
+    class __shm_mapping
+    {
+    public:
+        __shm_mapping() noexcept = default;
+        __shm_mapping(__shm_mapping &&other) noexcept
+            : base(std::exchange(other.base, nullptr))
+            , size(other.size)
+        {}
+        __shm_mapping &operator=(__shm_mapping other) noexcept
+        {
+            std::swap(base, other.base);
+            std::swap(size, other.size);
+            return *this;
+        }
+        ~__shm_mapping() { Unmap(); }
+
+        /// Opens or creates the region of the given size and maps it
+        void Map(const std::string &name, std::size_t size, unsigned permissions);
+        void Unmap() noexcept;
+        void *Base() const noexcept { return base; }
+
+    private:
+        void *      base = nullptr;
+        std::size_t size = 0;
+    };
+
+    /// Returns the id of the calling process
+    std::uint64_t __current_pid() noexcept;
+    /// Checks if a process exists, errs on the side of alive
+    bool __process_alive(std::uint64_t pid) noexcept;
+
+}  // namespace detail
+
+/// LockFreeCircularQueue living in a named shared memory region
+///
+/// Every process opens the queue by name. The first one creates the region and constructs the
+/// queue in place, the others attach to it, after checking that the header written by the
+/// creator matches the element size, capacity, layout and payload version they were built with.
+/// If the creator died while initializing, the next process to attach takes over and
+/// initializes the queue again, instead of waiting for a process that will never finish.
+/// Crash safety only covers opening: a process dying in the middle of a push or a pop leaves its
+/// slot reserved, which may stall the other side of the queue.
+///
+/// The queue is never destroyed, values are plain bytes in the region. They must therefore be
+/// trivially copyable and must not point into the memory of a process. The wait strategy must
+/// be stateless (BusySpinWait or BackoffWait), as ParkingWait parks threads on process private
+/// futexes. The region outlives all handles until Remove() is called.
+///
+/// @tparam T Element type, trivially copyable
+/// @tparam Size Capacity of the queue, a power of 2 (DynamicSize is not supported)
+/// @tparam SP Whether there is only a single producer over all processes
+/// @tparam SC Whether there is only a single consumer over all processes
+/// @tparam Wait Stateless wait strategy
+/// @tparam Layout Slot layout, PaddedLayout or CompactLayout
+template <typename T,
+          std::size_t Size,
+          bool        SP,
+          bool        SC,
+          typename Wait   = BusySpinWait,
+          typename Layout = PaddedLayout>
+class SharedMemoryQueue
+{
+public:
+    using Queue = LockFreeCircularQueue<T, Size, SP, SC, Wait, Layout>;
+
+    static_assert(Size != DynamicSize, "slots of a shared queue must live in the region");
+    static_assert(std::is_trivially_copyable_v<T>, "values are shared as plain bytes");
+    static_assert(detail::__is_process_shared_wait<Wait>,
+                  "wait strategy must be stateless to be shared by processes");
+    static_assert(std::is_standard_layout_v<Queue>, "queue must have a stable layout");
+
+    /// @brief Opens the queue with the given name, creating it if it does not exist.
+    /// @param name Name of the region, without a leading slash.
+    /// @throw std::system_error if the region can not be opened or mapped.
+    /// @throw std::runtime_error if the region holds an incompatible queue, or if another
+    /// process is still initializing it after options.attachTimeout.
+    static SharedMemoryQueue Open(const std::string &name, const SharedMemoryOptions &options = {});
+
+    /// @brief Removes the region with the given name. Processes having it open keep their
+    /// mapping, the next Open() creates a new queue.
+    /// @return Whether the region existed. Always false on Windows, where a region is removed
+    /// when its last handle is closed.
+    static bool Remove(const std::string &name) noexcept;
+
+    SharedMemoryQueue(SharedMemoryQueue &&) noexcept = default;
+    SharedMemoryQueue &operator=(SharedMemoryQueue &&) noexcept = default;
+
+    Queue &Get() const noexcept { return *queue; }
+    Queue &operator*() const noexcept { return *queue; }
+    Queue *operator->() const noexcept { return queue; }
+
+    /// Returns the name the queue was opened with
+    const std::string &Name() const noexcept { return name; }
+    /// Checks if this handle constructed the queue, rather than attached to an existing one
+    bool Initialized() const noexcept { return initialized; }
+
+    /// Size of the shared memory region
+    static constexpr std::size_t RegionSize() noexcept { return queueOffset + sizeof(Queue); }
+
+private:
+    SharedMemoryQueue() = default;
+
+    static constexpr std::size_t queueOffset =
+        (sizeof(detail::__shm_queue_header) + alignof(Queue) - 1) / alignof(Queue)
+        * alignof(Queue);
+
+    /// Fingerprint of everything that decides the layout of the region
+    static constexpr std::uint64_t LayoutHash() noexcept;
+
+    void Attach(const SharedMemoryOptions &options);
+
+    detail::__shm_mapping mapping;
+    Queue *               queue = nullptr;
+    std::string           name;
+    bool                  initialized = false;
+};
+
+}  // namespace ftc
+
+// -------------------------------------------------
+// Implementation
+
+namespace ftc {
+
+namespace detail {
+
+    inline void __shm_mapping::Map(const std::string &name, std::size_t size, unsigned permissions)
+    {
+        Unmap();
+#if defined(_WIN32)
+        (void)permissions;
+        std::string objectName = "Local\\" + name;
+        HANDLE      handle     = CreateFileMappingA(INVALID_HANDLE_VALUE,
+                                           nullptr,
+                                           PAGE_READWRITE,
+                                           DWORD(std::uint64_t(size) >> 32),
+                                           DWORD(size),
+                                           objectName.c_str());
+        if (!handle)
+            throw std::system_error(
+                int(GetLastError()), std::system_category(), "CreateFileMapping");
+
+        // Fails if an existing mapping is smaller than the size we need
+        void *ptr = MapViewOfFile(handle, FILE_MAP_ALL_ACCESS, 0, 0, size);
+        DWORD err = GetLastError();
+        CloseHandle(handle);  // The view keeps the mapping alive
+        if (!ptr)
+            throw std::system_error(int(err), std::system_category(), "MapViewOfFile");
+#else
+        std::string objectName = "/" + name;
+        int         fd = shm_open(objectName.c_str(), O_CREAT | O_RDWR, mode_t(permissions));
+        if (fd < 0)
+            throw std::system_error(errno, std::system_category(), "shm_open");
+
+        // A new region is empty, whoever sees that first sizes it. Zero filled pages make the
+        // header read as Empty.
+        struct stat st;
+        if (fstat(fd, &st) != 0 || (st.st_size == 0 && ftruncate(fd, off_t(size)) != 0)) {
+            int err = errno;
+            close(fd);
+            throw std::system_error(err, std::system_category(), "ftruncate");
+        }
+        if (st.st_size != 0 && std::size_t(st.st_size) != size) {
+            close(fd);
+            throw std::runtime_error("SharedMemoryQueue: region " + name + " has another size");
+        }
+
+        void *ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        int   err = errno;
+        close(fd);  // The mapping keeps the region alive
+        if (ptr == MAP_FAILED)
+            throw std::system_error(err, std::system_category(), "mmap");
+#endif
+        base       = ptr;
+        this->size = size;
+    }
+
+    inline void __shm_mapping::Unmap() noexcept
+    {
+        if (!base)
+            return;
+#if defined(_WIN32)
+        UnmapViewOfFile(base);
+#else
+        munmap(base, size);
+#endif
+        base = nullptr;
+    }
+
+    inline std::uint64_t __current_pid() noexcept
+    {
+#if defined(_WIN32)
+        return GetCurrentProcessId();
+#else
+        return std::uint64_t(getpid());
+#endif
+    }
+
+    inline bool __process_alive(std::uint64_t pid) noexcept
+    {
+#if defined(_WIN32)
+        HANDLE process = OpenProcess(SYNCHRONIZE, FALSE, DWORD(pid));
+        if (!process)
+            return GetLastError() == ERROR_ACCESS_DENIED;
+        bool alive = WaitForSingleObject(process, 0) == WAIT_TIMEOUT;
+        CloseHandle(process);
+        return alive;
+#else
+        return kill(pid_t(pid), 0) == 0 || errno != ESRCH;
+#endif
+    }
+
+}  // namespace detail
+
+template <typename T, std::size_t Size, bool SP, bool SC, typename Wait, typename Layout>
+inline SharedMemoryQueue<T, Size, SP, SC, Wait, Layout>
+SharedMemoryQueue<T, Size, SP, SC, Wait, Layout>::Open(const std::string &        name,
+                                                       const SharedMemoryOptions &options)
+{
+    SharedMemoryQueue q;
+    q.name = name;
+    q.mapping.Map(name, RegionSize(), options.permissions);
+    q.Attach(options);
+    return q;
+}
+
+template <typename T, std::size_t Size, bool SP, bool SC, typename Wait, typename Layout>
+inline bool
+SharedMemoryQueue<T, Size, SP, SC, Wait, Layout>::Remove(const std::string &name) noexcept
+{
+#if defined(_WIN32)
+    (void)name;
+    return false;
+#else
+    return shm_unlink(("/" + name).c_str()) == 0;
+#endif
+}
+
+template <typename T, std::size_t Size, bool SP, bool SC, typename Wait, typename Layout>
+constexpr std::uint64_t SharedMemoryQueue<T, Size, SP, SC, Wait, Layout>::LayoutHash() noexcept
+{
+    const std::uint64_t fields[] = {sizeof(T),
+                                    alignof(T),
+                                    Size,
+                                    SP,
+                                    SC,
+                                    std::is_same_v<Layout, CompactLayout>,
+                                    sizeof(Queue),
+                                    alignof(Queue),
+                                    queueOffset};
+    std::uint64_t       h        = 0xCBF29CE484222325;  // FNV-1a
+    for (std::uint64_t field : fields)
+        h = (h ^ field) * 0x100000001B3;
+    return h;
+}
+
+template <typename T, std::size_t Size, bool SP, bool SC, typename Wait, typename Layout>
+inline void
+SharedMemoryQueue<T, Size, SP, SC, Wait, Layout>::Attach(const SharedMemoryOptions &options)
+{
+    using Header = detail::__shm_queue_header;
+
+    char *  base   = static_cast<char *>(mapping.Base());
+    Header &header = *reinterpret_cast<Header *>(base);
+    queue          = reinterpret_cast<Queue *>(base + queueOffset);
+
+    const std::uint64_t pid      = detail::__current_pid();
+    const auto          deadline = std::chrono::steady_clock::now() + options.attachTimeout;
+
+    for (;;) {
+        std::uint64_t state = header.state.load(std::memory_order_acquire);
+
+        if (state == Header::Ready) {
+            if (header.magic != Header::Magic || header.formatVersion != Header::FormatVersion)
+                throw std::runtime_error("SharedMemoryQueue: region " + name
+                                         + " does not hold a queue of this format");
+            if (header.layout != LayoutHash())
+                throw std::runtime_error("SharedMemoryQueue: region " + name
+                                         + " holds a queue of another type");
+            if (header.version != options.version)
+                throw std::runtime_error("SharedMemoryQueue: region " + name
+                                         + " holds a queue of another version");
+            return;
+        }
+
+        // Claim an empty region, or take over from an initializer that died
+        if ((state == Header::Empty || !detail::__process_alive(state))
+            && header.state.compare_exchange_strong(state, pid, std::memory_order_acquire)) {
+            header.magic         = Header::Magic;
+            header.formatVersion = Header::FormatVersion;
+            header.version       = options.version;
+            header.layout        = LayoutHash();
+            new (queue) Queue(options.maxProducers ? options.maxProducers
+                                                   : Queue::DefaultMaxProducers());
+            header.state.store(Header::Ready, std::memory_order_release);
+            initialized = true;
+            return;
+        }
+
+        if (std::chrono::steady_clock::now() >= deadline)
+            throw std::runtime_error("SharedMemoryQueue: timed out waiting for region " + name
+                                     + " to be initialized");
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+}  // namespace ftc
@@ -0,0 +1,320 @@
+/**
+ * @file SmallString.hpp
+ * Small-buffer-optimized string.
+ *
+ * A null-terminated string that stores up to N characters inline, built on SmallVector.
+ */
+
+#pragma once
+
+#include "FTC/Container/SmallVector.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <memory_resource>
+#include <ostream>
+#include <string_view>
+#include <type_traits>
+
+namespace ftc {
+
+template <std::size_t N, typename Alloc> class SmallString;
+
+namespace detail {
+
+    template <typename T> struct __is_small_string
+    {
+        static constexpr bool value = false;
+    };
+
+    template <std::size_t N, typename Alloc> struct __is_small_string<SmallString<N, Alloc>>
+    {
+        static constexpr bool value = true;
+    };
+
+}  // namespace detail
+
+/// String with inline storage for N characters
+///
+/// A subset of the std::string interface, always null-terminated, and implicitly convertible
+/// to std::string_view for everything else (searching, substrings, hashing). Unlike
+/// std::string, the inline capacity is chosen by the user instead of the standard library.
+///
+/// @tparam N Inline capacity in characters, excluding the terminating null.
+/// @tparam Alloc Allocator used when the string spills out of the inline buffer.
+template <std::size_t N = 23, typename Alloc = std::pmr::polymorphic_allocator<char>>
+class SmallString
+{
+    using Buffer = SmallVector<char, N + 1, Alloc>;
+
+    /// Enables types convertible to std::string_view other than this SmallString. With
+    /// AnySize = false, no SmallString is enabled, so that mixed-size comparisons are resolved
+    /// by the friends of the left operand.
+    template <typename S, bool AnySize = true>
+    using EnableIfStringLike =
+        std::enable_if_t<std::is_convertible_v<const S &, std::string_view>
+                             && !std::is_same_v<S, SmallString>
+                             && (AnySize || !detail::__is_small_string<S>::value),
+                         int>;
+
+public:
+    using value_type      = char;
+    using allocator_type  = Alloc;
+    using size_type       = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference       = char &;
+    using const_reference = const char &;
+    using pointer         = char *;
+    using const_pointer   = const char *;
+    using iterator        = char *;
+    using const_iterator  = const char *;
+
+    static constexpr size_type npos            = std::string_view::npos;
+    static constexpr size_type inline_capacity = N;
+
+    SmallString() noexcept(noexcept(Alloc())) : SmallString(Alloc()) {}
+    explicit SmallString(const Alloc &alloc) noexcept : buffer_(alloc) { buffer_.push_back('\0'); }
+    SmallString(std::string_view sv, const Alloc &alloc = Alloc()) : SmallString(alloc)
+    {
+        append(sv);
+    }
+    SmallString(const char *s, const Alloc &alloc = Alloc())
+        : SmallString(std::string_view(s), alloc)
+    {}
+    SmallString(const char *s, size_type n, const Alloc &alloc = Alloc())
+        : SmallString(std::string_view(s, n), alloc)
+    {}
+    SmallString(size_type n, char c, const Alloc &alloc = Alloc()) : SmallString(alloc)
+    {
+        append(n, c);
+    }
+
+    SmallString(const SmallString &) = default;
+    SmallString(SmallString &&other) noexcept : buffer_(std::move(other.buffer_))
+    {
+        other.buffer_.push_back('\0');
+    }
+
+    SmallString &operator=(const SmallString &) = default;
+    SmallString &operator=(SmallString &&other) noexcept(std::is_nothrow_move_assignable_v<Buffer>)
+    {
+        if (this != &other) {
+            buffer_ = std::move(other.buffer_);
+            other.buffer_.push_back('\0');
+        }
+        return *this;
+    }
+    SmallString &operator=(std::string_view sv)
+    {
+        clear();
+        return append(sv);
+    }
+    SmallString &operator=(const char *s) { return *this = std::string_view(s); }
+
+    allocator_type get_allocator() const noexcept { return buffer_.get_allocator(); }
+
+    /// @name Element access
+    /// @{
+    reference       operator[](size_type i) noexcept { return buffer_[i]; }
+    const_reference operator[](size_type i) const noexcept { return buffer_[i]; }
+    reference       front() noexcept { return buffer_.front(); }
+    const_reference front() const noexcept { return buffer_.front(); }
+    reference       back() noexcept { return buffer_[size() - 1]; }
+    const_reference back() const noexcept { return buffer_[size() - 1]; }
+    char *          data() noexcept { return buffer_.data(); }
+    const char *    data() const noexcept { return buffer_.data(); }
+    const char *    c_str() const noexcept { return buffer_.data(); }
+
+    std::string_view view() const noexcept { return {data(), size()}; }
+    operator std::string_view() const noexcept { return view(); }
+    /// @}
+
+    /// @name Iterators
+    /// @{
+    iterator       begin() noexcept { return data(); }
+    const_iterator begin() const noexcept { return data(); }
+    const_iterator cbegin() const noexcept { return data(); }
+    iterator       end() noexcept { return data() + size(); }
+    const_iterator end() const noexcept { return data() + size(); }
+    const_iterator cend() const noexcept { return data() + size(); }
+    /// @}
+
+    /// @name Capacity
+    /// @{
+    [[nodiscard]] bool empty() const noexcept { return size() == 0; }
+    size_type          size() const noexcept { return buffer_.size() - 1; }
+    size_type          length() const noexcept { return size(); }
+    size_type          capacity() const noexcept { return buffer_.capacity() - 1; }
+    bool               is_inline() const noexcept { return buffer_.is_inline(); }
+    void               reserve(size_type n) { buffer_.reserve(n + 1); }
+    void               shrink_to_fit() { buffer_.shrink_to_fit(); }
+    /// @}
+
+    /// @name Modifiers
+    /// @{
+    void clear() noexcept
+    {
+        buffer_.resize(1);
+        buffer_[0] = '\0';
+    }
+
+    void push_back(char c)
+    {
+        Grow(size() + 1);
+        buffer_.back() = c;
+        buffer_.push_back('\0');
+    }
+
+    void pop_back() noexcept
+    {
+        buffer_.pop_back();
+        buffer_.back() = '\0';
+    }
+
+    SmallString &append(std::string_view sv)
+    {
+        // sv may point into this string, which Grow() can move
+        std::less<const char *> less;
+        bool      inside = !less(sv.data(), data()) && less(sv.data(), data() + size());
+        size_type offset = inside ? static_cast<size_type>(sv.data() - data()) : 0;
+
+        // Nothing below throws after Grow()
+        Grow(size() + sv.size());
+        const char *src = inside ? data() + offset : sv.data();
+        buffer_.pop_back();
+        buffer_.insert(buffer_.end(), src, src + sv.size());
+        buffer_.push_back('\0');
+        return *this;
+    }
+
+    SmallString &append(size_type n, char c)
+    {
+        Grow(size() + n);
+        buffer_.pop_back();
+        buffer_.insert(buffer_.end(), n, c);
+        buffer_.push_back('\0');
+        return *this;
+    }
+
+    SmallString &operator+=(std::string_view sv) { return append(sv); }
+    SmallString &operator+=(const char *s) { return append(std::string_view(s)); }
+    SmallString &operator+=(char c)
+    {
+        push_back(c);
+        return *this;
+    }
+
+    void resize(size_type n, char c = '\0')
+    {
+        if (n <= size()) {
+            buffer_.resize(n + 1);
+            buffer_[n] = '\0';
+        }
+        else
+            append(n - size(), c);
+    }
+
+    void swap(SmallString &other) noexcept(noexcept(std::declval<Buffer &>().swap(
+        std::declval<Buffer &>())))
+    {
+        buffer_.swap(other.buffer_);
+    }
+    /// @}
+
+    /// @name Searching
+    /// @{
+    size_type find(std::string_view sv, size_type pos = 0) const noexcept
+    {
+        return view().find(sv, pos);
+    }
+    size_type find(char c, size_type pos = 0) const noexcept { return view().find(c, pos); }
+    size_type rfind(std::string_view sv, size_type pos = npos) const noexcept
+    {
+        return view().rfind(sv, pos);
+    }
+    size_type rfind(char c, size_type pos = npos) const noexcept { return view().rfind(c, pos); }
+    int       compare(std::string_view sv) const noexcept { return view().compare(sv); }
+    /// @}
+
+    /// @name Comparisons
+    /// Compares with another SmallString or anything convertible to std::string_view
+    /// @{
+    friend bool operator==(const SmallString &a, const SmallString &b) noexcept
+    {
+        return a.view() == b.view();
+    }
+    friend bool operator!=(const SmallString &a, const SmallString &b) noexcept
+    {
+        return a.view() != b.view();
+    }
+    friend bool operator<(const SmallString &a, const SmallString &b) noexcept
+    {
+        return a.view() < b.view();
+    }
+
+    template <typename S, EnableIfStringLike<S> = 0>
+    friend bool operator==(const SmallString &a, const S &b) noexcept
+    {
+        return a.view() == std::string_view(b);
+    }
+    template <typename S, EnableIfStringLike<S> = 0>
+    friend bool operator!=(const SmallString &a, const S &b) noexcept
+    {
+        return a.view() != std::string_view(b);
+    }
+    template <typename S, EnableIfStringLike<S> = 0>
+    friend bool operator<(const SmallString &a, const S &b) noexcept
+    {
+        return a.view() < std::string_view(b);
+    }
+
+    template <typename S, EnableIfStringLike<S, false> = 0>
+    friend bool operator==(const S &a, const SmallString &b) noexcept
+    {
+        return std::string_view(a) == b.view();
+    }
+    template <typename S, EnableIfStringLike<S, false> = 0>
+    friend bool operator!=(const S &a, const SmallString &b) noexcept
+    {
+        return std::string_view(a) != b.view();
+    }
+    template <typename S, EnableIfStringLike<S, false> = 0>
+    friend bool operator<(const S &a, const SmallString &b) noexcept
+    {
+        return std::string_view(a) < b.view();
+    }
+    /// @}
+
+    friend std::ostream &operator<<(std::ostream &os, const SmallString &s)
+    {
+        return os << s.view();
+    }
+
+    friend void swap(SmallString &a, SmallString &b) noexcept(noexcept(a.swap(b))) { a.swap(b); }
+
+private:
+    /// Reserves room for n characters, growing geometrically for repeated appends.
+    void Grow(size_type n)
+    {
+        if (n + 1 > buffer_.capacity())
+            buffer_.reserve(std::max(n + 1, buffer_.capacity() * 2));
+    }
+
+    Buffer buffer_;  ///< Characters followed by a null, never empty
+};
+
+}  // namespace ftc
+
+namespace std {
+
+template <std::size_t N, typename Alloc> struct hash<ftc::SmallString<N, Alloc>>
+{
+    std::size_t operator()(const ftc::SmallString<N, Alloc> &s) const noexcept
+    {
+        return std::hash<std::string_view>()(s.view());
+    }
+};
+
+}  // namespace std
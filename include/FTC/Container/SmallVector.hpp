@@ -0,0 +1,679 @@
+/**
+ * @file SmallVector.hpp
+ * Small-buffer-optimized vector.
+ *
+ * A std::vector replacement that stores its first N elements inline, and only allocates when
+ * growing beyond them.
+ */
+
+#pragma once
+
+#include "FTC/Traits/Relocatable.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace ftc {
+
+/// Vector with inline storage for N elements
+///
+/// Same interface as std::vector (without the bool specialization). Elements live in an
+/// inline buffer while size() <= N, which makes short vectors free of heap traffic. Growing
+/// beyond the buffer spills all elements to storage from Alloc, which defaults to a pmr
+/// polymorphic_allocator so the spill can be directed to any memory resource. Trivially
+/// relocatable elements (see is_trivially_relocatable) are moved with memcpy.
+///
+/// Unlike std::vector, a move or swap of an inline SmallVector moves the elements one by one,
+/// and iterators are invalidated by it.
+///
+/// @tparam T Element type
+/// @tparam N Inline capacity, may be 0.
+/// @tparam Alloc Allocator used when elements spill out of the inline buffer.
+template <typename T, std::size_t N = 8, typename Alloc = std::pmr::polymorphic_allocator<T>>
+class SmallVector
+{
+    using AllocTraits = std::allocator_traits<Alloc>;
+
+    /// Move assignment has to copy elements to its own storage, which may allocate, when the
+    /// allocators differ and are not propagated
+    static constexpr bool nothrowMoveAssign =
+        (AllocTraits::propagate_on_container_move_assignment::value
+         || AllocTraits::is_always_equal::value)
+        && std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_assignable_v<T>;
+
+public:
+    using value_type             = T;
+    using allocator_type         = Alloc;
+    using size_type              = std::size_t;
+    using difference_type        = std::ptrdiff_t;
+    using reference              = T &;
+    using const_reference        = const T &;
+    using pointer                = T *;
+    using const_pointer          = const T *;
+    using iterator               = T *;
+    using const_iterator         = const T *;
+    using reverse_iterator       = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    /// Count of elements stored without allocation
+    static constexpr size_type inline_capacity = N;
+
+    SmallVector() noexcept(noexcept(Alloc())) : SmallVector(Alloc()) {}
+    explicit SmallVector(const Alloc &alloc) noexcept
+        : alloc_(alloc)
+        , data_(InlineData())
+        , size_(0)
+        , capacity_(N)
+    {}
+    explicit SmallVector(size_type n, const Alloc &alloc = Alloc());
+    SmallVector(size_type n, const T &value, const Alloc &alloc = Alloc());
+    template <typename InputIt,
+              typename = typename std::iterator_traits<InputIt>::iterator_category>
+    SmallVector(InputIt first, InputIt last, const Alloc &alloc = Alloc());
+    SmallVector(std::initializer_list<T> il, const Alloc &alloc = Alloc());
+
+    SmallVector(const SmallVector &other);
+    SmallVector(const SmallVector &other, const Alloc &alloc);
+    SmallVector(SmallVector &&other) noexcept(std::is_nothrow_move_constructible_v<T>);
+    SmallVector(SmallVector &&other, const Alloc &alloc);
+    ~SmallVector();
+
+    SmallVector &operator=(const SmallVector &other);
+    SmallVector &operator=(SmallVector &&other) noexcept(nothrowMoveAssign);
+    SmallVector &operator=(std::initializer_list<T> il);
+
+    void assign(size_type n, const T &value);
+    template <typename InputIt,
+              typename = typename std::iterator_traits<InputIt>::iterator_category>
+    void assign(InputIt first, InputIt last);
+    void assign(std::initializer_list<T> il) { assign(il.begin(), il.end()); }
+
+    allocator_type get_allocator() const noexcept { return alloc_; }
+
+    /// @name Element access
+    /// @{
+    reference at(size_type i)
+    {
+        if (i >= size_)
+            throw std::out_of_range("SmallVector::at: index out of range");
+        return data_[i];
+    }
+    const_reference at(size_type i) const { return const_cast<SmallVector *>(this)->at(i); }
+
+    reference       operator[](size_type i) noexcept { return data_[i]; }
+    const_reference operator[](size_type i) const noexcept { return data_[i]; }
+    reference       front() noexcept { return data_[0]; }
+    const_reference front() const noexcept { return data_[0]; }
+    reference       back() noexcept { return data_[size_ - 1]; }
+    const_reference back() const noexcept { return data_[size_ - 1]; }
+    T *             data() noexcept { return data_; }
+    const T *       data() const noexcept { return data_; }
+    /// @}
+
+    /// @name Iterators
+    /// @{
+    iterator               begin() noexcept { return data_; }
+    const_iterator         begin() const noexcept { return data_; }
+    const_iterator         cbegin() const noexcept { return data_; }
+    iterator               end() noexcept { return data_ + size_; }
+    const_iterator         end() const noexcept { return data_ + size_; }
+    const_iterator         cend() const noexcept { return data_ + size_; }
+    reverse_iterator       rbegin() noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    const_reverse_iterator crbegin() const noexcept { return const_reverse_iterator(end()); }
+    reverse_iterator       rend() noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+    const_reverse_iterator crend() const noexcept { return const_reverse_iterator(begin()); }
+    /// @}
+
+    /// @name Capacity
+    /// @{
+    [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+    size_type          size() const noexcept { return size_; }
+    size_type          capacity() const noexcept { return capacity_; }
+    size_type          max_size() const noexcept { return AllocTraits::max_size(alloc_); }
+
+    /// Checks if the elements are stored in the inline buffer
+    bool is_inline() const noexcept { return data_ == InlineData(); }
+
+    void reserve(size_type n)
+    {
+        if (n > capacity_)
+            Reallocate(n);
+    }
+
+    /// Moves the elements back to the inline buffer if they fit, otherwise releases the
+    /// unused capacity.
+    void shrink_to_fit();
+    /// @}
+
+    /// @name Modifiers
+    /// @{
+    void clear() noexcept
+    {
+        Destroy(data_, data_ + size_);
+        size_ = 0;
+    }
+
+    iterator insert(const_iterator pos, const T &value) { return emplace(pos, value); }
+    iterator insert(const_iterator pos, T &&value) { return emplace(pos, std::move(value)); }
+    iterator insert(const_iterator pos, size_type n, const T &value);
+    template <typename InputIt,
+              typename = typename std::iterator_traits<InputIt>::iterator_category>
+    iterator insert(const_iterator pos, InputIt first, InputIt last);
+    iterator insert(const_iterator pos, std::initializer_list<T> il)
+    {
+        return insert(pos, il.begin(), il.end());
+    }
+
+    template <typename... Args> iterator emplace(const_iterator pos, Args &&... args);
+
+    iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+    iterator erase(const_iterator first, const_iterator last);
+
+    void push_back(const T &value) { emplace_back(value); }
+    void push_back(T &&value) { emplace_back(std::move(value)); }
+
+    template <typename... Args> reference emplace_back(Args &&... args)
+    {
+        if (size_ == capacity_)
+            return GrowAndEmplaceBack(std::forward<Args>(args)...);
+        AllocTraits::construct(alloc_, data_ + size_, std::forward<Args>(args)...);
+        return data_[size_++];
+    }
+
+    void pop_back() noexcept
+    {
+        size_--;
+        AllocTraits::destroy(alloc_, data_ + size_);
+    }
+
+    void resize(size_type n);
+    void resize(size_type n, const T &value);
+
+    void swap(SmallVector &other) noexcept(noexcept(std::declval<SmallVector &>() =
+                                                        std::declval<SmallVector &&>()));
+    /// @}
+
+    /// @name Comparisons
+    /// @{
+    friend bool operator==(const SmallVector &a, const SmallVector &b)
+    {
+        return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+    }
+    friend bool operator!=(const SmallVector &a, const SmallVector &b) { return !(a == b); }
+    friend bool operator<(const SmallVector &a, const SmallVector &b)
+    {
+        return std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end());
+    }
+    friend bool operator>(const SmallVector &a, const SmallVector &b) { return b < a; }
+    friend bool operator<=(const SmallVector &a, const SmallVector &b) { return !(b < a); }
+    friend bool operator>=(const SmallVector &a, const SmallVector &b) { return !(a < b); }
+    /// @}
+
+    friend void swap(SmallVector &a, SmallVector &b) noexcept(noexcept(a.swap(b))) { a.swap(b); }
+
+private:
+    /// Whether elements can be moved to new storage with memcpy
+    static constexpr bool relocateByMemcpy = is_trivially_relocatable_v<T>;
+
+    T *InlineData() noexcept { return reinterpret_cast<T *>(storage_); }
+    const T *InlineData() const noexcept { return reinterpret_cast<const T *>(storage_); }
+
+    size_type NextCapacity(size_type minCapacity) const
+    {
+        if (minCapacity > max_size())
+            throw std::length_error("SmallVector: size exceeds max_size()");
+        return std::max({capacity_ * 2, minCapacity, size_type(1)});
+    }
+
+    void Destroy(T *first, T *last) noexcept
+    {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            for (; first != last; ++first)
+                AllocTraits::destroy(alloc_, first);
+        }
+    }
+
+    /// Releases heap storage, and points back to the inline buffer.
+    void Deallocate() noexcept
+    {
+        if (!is_inline())
+            AllocTraits::deallocate(alloc_, data_, capacity_);
+        data_     = InlineData();
+        capacity_ = N;
+    }
+
+    /// Moves n elements from src to uninitialized dst, then destroys the elements in src.
+    /// Nothing is changed if an element copy throws.
+    void Relocate(T *src, size_type n, T *dst);
+
+    /// Moves the elements to storage of newCapacity (>= size_) elements.
+    void Reallocate(size_type newCapacity);
+
+    template <typename... Args> reference GrowAndEmplaceBack(Args &&... args);
+
+    /// Appends [first, last) to the end, for inserting or assigning ranges.
+    template <typename InputIt> void Append(InputIt first, InputIt last);
+
+    Alloc     alloc_;
+    T *       data_;
+    size_type size_;
+    size_type capacity_;
+    alignas(T) unsigned char storage_[(N ? N : 1) * sizeof(T)];
+};
+
+}  // namespace ftc
+
+template <typename T, std::size_t N, typename Alloc>
+inline ftc::SmallVector<T, N, Alloc>::SmallVector(size_type n, const Alloc &alloc)
+    : SmallVector(alloc)
+{
+    resize(n);
+}
+
+template <typename T, std::size_t N, typename Alloc>
+inline ftc::SmallVector<T, N, Alloc>::SmallVector(size_type n, const T &value, const Alloc &alloc)
+    : SmallVector(alloc)
+{
+    resize(n, value);
+}
+
+template <typename T, std::size_t N, typename Alloc>
+template <typename InputIt, typename>
+inline ftc::SmallVector<T, N, Alloc>::SmallVector(InputIt first, InputIt last, const Alloc &alloc)
+    : SmallVector(alloc)
+{
+    Append(first, last);
+}
+
+template <typename T, std::size_t N, typename Alloc>
+inline ftc::SmallVector<T, N, Alloc>::SmallVector(std::initializer_list<T> il, const Alloc &alloc)
+    : SmallVector(alloc)
+{
+    Append(il.begin(), il.end());
+}
+
+template <typename T, std::size_t N, typename Alloc>
+inline ftc::SmallVector<T, N, Alloc>::SmallVector(const SmallVector &other)
+    : SmallVector(other, AllocTraits::select_on_container_copy_construction(other.alloc_))
+{}
+
+template <typename T, std::size_t N, typename Alloc>
+inline ftc::SmallVector<T, N, Alloc>::SmallVector(const SmallVector &other, const Alloc &alloc)
+    : SmallVector(alloc)
+{
+    Append(other.begin(), other.end());
+}
+
+template <typename T, std::size_t N, typename Alloc>
+inline ftc::SmallVector<T, N, Alloc>::SmallVector(SmallVector &&other) noexcept(
+    std::is_nothrow_move_constructible_v<T>)
+    : SmallVector(std::move(other.alloc_))
+{
+    if (other.is_inline()) {
+        Relocate(other.data_, other.size_, data_);
+        size_       = other.size_;
+        other.size_ = 0;
+    }
+    else {
+        data_           = other.data_;
+        size_           = other.size_;
+        capacity_       = other.capacity_;
+        other.data_     = other.InlineData();
+        other.size_     = 0;
+        other.capacity_ = N;
+    }
+}
+
+template <typename T, std::size_t N, typename Alloc>
+inline ftc::SmallVector<T, N, Alloc>::SmallVector(SmallVector &&other, const Alloc &alloc)
+    : SmallVector(alloc)
+{
+    if (!other.is_inline() && alloc_ == other.alloc_) {
+        data_           = other.data_;
+        size_           = other.size_;
+        capacity_       = other.capacity_;
+        other.data_     = other.InlineData();
+        other.size_     = 0;
+        other.capacity_ = N;
+    }
+    else {
+        Append(std::make_move_iterator(other.begin()), std::make_move_iterator(other.end()));
+        other.clear();
+    }
+}
+
+template <typename T, std::size_t N, typename Alloc>
+inline ftc::SmallVector<T, N, Alloc>::~SmallVector()
+{
+    Destroy(data_, data_ + size_);
+    Deallocate();
+}
+
+template <typename T, std::size_t N, typename Alloc>
+inline ftc::SmallVector<T, N, Alloc> &
+ftc::SmallVector<T, N, Alloc>::operator=(const SmallVector &other)
+{
+    if (this == &other)
+        return *this;
+
+    if constexpr (AllocTraits::propagate_on_container_copy_assignment::value) {
+        if (alloc_ != other.alloc_) {
+            clear();
+            Deallocate();
+        }
+        alloc_ = other.alloc_;
+    }
+    assign(other.begin(), other.end());
+    return *this;
+}
+
+template <typename T, std::size_t N, typename Alloc>
+inline ftc::SmallVector<T, N, Alloc> &
+ftc::SmallVector<T, N, Alloc>::operator=(SmallVector &&other) noexcept(nothrowMoveAssign)
+{
+    if (this == &other)
+        return *this;
+
+    constexpr bool propagate = AllocTraits::propagate_on_container_move_assignment::value;
+    if (!other.is_inline() && (propagate || alloc_ == other.alloc_)) {
+        clear();
+        Deallocate();
+        if constexpr (propagate)
+            alloc_ = std::move(other.alloc_);
+        data_           = other.data_;
+        size_           = other.size_;
+        capacity_       = other.capacity_;
+        other.data_     = other.InlineData();
+        other.size_     = 0;
+        other.capacity_ = N;
+    }
+    else {
+        assign(std::make_move_iterator(other.begin()), std::make_move_iterator(other.end()));
+        other.clear();
+    }
+    return *this;
+}
+
+template <typename T, std::size_t N, typename Alloc>
+inline ftc::SmallVector<T, N, Alloc> &
+ftc::SmallVector<T, N, Alloc>::operator=(std::initializer_list<T> il)
+{
+    assign(il.begin(), il.end());
+    return *this;
+}
+
+template <typename T, std::size_t N, typename Alloc>
+inline void ftc::SmallVector<T, N, Alloc>::assign(size_type n, const T &value)
+{
+    if (n > capacity_) {
+        T copy(value);  // value may be an element
+        clear();
+        Reallocate(NextCapacity(n));
+        resize(n, copy);
+        return;
+    }
+
+    std::fill(data_, data_ + std::min(n, size_), value);
+    if (n > size_)
+        resize(n, value);
+    else {
+        Destroy(data_ + n, data_ + size_);
+        size_ = n;
+    }
+}
+
+template <typename T, std::size_t N, typename Alloc>
+template <typename InputIt, typename>
+inline void ftc::SmallVector<T, N, Alloc>::assign(InputIt first, InputIt last)
+{
+    using Category = typename std::iterator_traits<InputIt>::iterator_category;
+    if constexpr (std::is_base_of_v<std::forward_iterator_tag, Category>) {
+        size_type n = static_cast<size_type>(std::distance(first, last));
+        if (n > capacity_) {
+            clear();
+            Reallocate(NextCapacity(n));
+            Append(first, last);
+            return;
+        }
+
+        // Assign over existing elements, then construct or destroy the rest
+        T *out = data_;
+        for (T *end = data_ + size_; out != end && first != last; ++out, ++first)
+            *out = *first;
+        if (first != last)
+            Append(first, last);
+        else {
+            Destroy(out, data_ + size_);
+            size_ = static_cast<size_type>(out - data_);
+        }
+    }
+    else {
+        clear();
+        Append(first, last);
+    }
+}
+
+template <typename T, std::size_t N, typename Alloc>
+inline void ftc::SmallVector<T, N, Alloc>::shrink_to_fit()
+{
+    if (is_inline() || size_ == capacity_)
+        return;
+
+    if (size_ <= N) {
+        T *heap = data_;
+        Relocate(heap, size_, InlineData());
+        AllocTraits::deallocate(alloc_, heap, capacity_);
+        data_     = InlineData();
+        capacity_ = N;
+    }
+    else
+        Reallocate(size_);
+}
+
+template <typename T, std::size_t N, typename Alloc>
+inline typename ftc::SmallVector<T, N, Alloc>::iterator
+ftc::SmallVector<T, N, Alloc>::insert(const_iterator pos, size_type n, const T &value)
+{
+    size_type index = static_cast<size_type>(pos - data_);
+    size_type old   = size_;
+    if (size_ + n > capacity_) {
+        T copy(value);  // value may be an element
+        Reallocate(NextCapacity(size_ + n));
+        while (n--)
+            emplace_back(copy);
+    }
+    else {
+        while (n--)
+            emplace_back(value);
+    }
+    std::rotate(data_ + index, data_ + old, data_ + size_);
+    return data_ + index;
+}
+
+template <typename T, std::size_t N, typename Alloc>
+template <typename InputIt, typename>
+inline typename ftc::SmallVector<T, N, Alloc>::iterator
+ftc::SmallVector<T, N, Alloc>::insert(const_iterator pos, InputIt first, InputIt last)
+{
+    size_type index = static_cast<size_type>(pos - data_);
+    size_type old   = size_;
+    Append(first, last);
+    std::rotate(data_ + index, data_ + old, data_ + size_);
+    return data_ + index;
+}
+
+template <typename T, std::size_t N, typename Alloc>
+template <typename... Args>
+inline typename ftc::SmallVector<T, N, Alloc>::iterator
+ftc::SmallVector<T, N, Alloc>::emplace(const_iterator pos, Args &&... args)
+{
+    size_type index = static_cast<size_type>(pos - data_);
+    emplace_back(std::forward<Args>(args)...);
+    std::rotate(data_ + index, data_ + size_ - 1, data_ + size_);
+    return data_ + index;
+}
+
+template <typename T, std::size_t N, typename Alloc>
+inline typename ftc::SmallVector<T, N, Alloc>::iterator
+ftc::SmallVector<T, N, Alloc>::erase(const_iterator first, const_iterator last)
+{
+    T *dst = data_ + (first - data_);
+    if (first != last) {
+        T *end = std::move(dst + (last - first), data_ + size_, dst);
+        Destroy(end, data_ + size_);
+        size_ = static_cast<size_type>(end - data_);
+    }
+    return dst;
+}
+
+template <typename T, std::size_t N, typename Alloc>
+inline void ftc::SmallVector<T, N, Alloc>::resize(size_type n)
+{
+    if (n <= size_) {
+        Destroy(data_ + n, data_ + size_);
+        size_ = n;
+        return;
+    }
+
+    reserve(n);
+    while (size_ < n)
+        emplace_back();
+}
+
+template <typename T, std::size_t N, typename Alloc>
+inline void ftc::SmallVector<T, N, Alloc>::resize(size_type n, const T &value)
+{
+    if (n <= size_) {
+        Destroy(data_ + n, data_ + size_);
+        size_ = n;
+        return;
+    }
+    insert(end(), n - size_, value);
+}
+
+template <typename T, std::size_t N, typename Alloc>
+inline void ftc::SmallVector<T, N, Alloc>::swap(SmallVector &other) noexcept(
+    noexcept(std::declval<SmallVector &>() = std::declval<SmallVector &&>()))
+{
+    if (this == &other)
+        return;
+
+    constexpr bool propagate = AllocTraits::propagate_on_container_swap::value;
+    if (!is_inline() && !other.is_inline() && (propagate || alloc_ == other.alloc_)) {
+        if constexpr (propagate) {
+            using std::swap;
+            swap(alloc_, other.alloc_);
+        }
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+        std::swap(capacity_, other.capacity_);
+        return;
+    }
+
+    SmallVector tmp(std::move(other), other.alloc_);
+    other = std::move(*this);
+    *this = std::move(tmp);
+}
+
+template <typename T, std::size_t N, typename Alloc>
+inline void ftc::SmallVector<T, N, Alloc>::Relocate(T *src, size_type n, T *dst)
+{
+    if constexpr (relocateByMemcpy) {
+        if (n)
+            std::memcpy(static_cast<void *>(dst), static_cast<const void *>(src), n * sizeof(T));
+    }
+    else {
+        size_type i = 0;
+        try {
+            for (; i < n; i++)
+                AllocTraits::construct(alloc_, dst + i, std::move_if_noexcept(src[i]));
+        }
+        catch (...) {
+            Destroy(dst, dst + i);
+            throw;
+        }
+        Destroy(src, src + n);
+    }
+}
+
+template <typename T, std::size_t N, typename Alloc>
+inline void ftc::SmallVector<T, N, Alloc>::Reallocate(size_type newCapacity)
+{
+    T *newData = AllocTraits::allocate(alloc_, newCapacity);
+    try {
+        Relocate(data_, size_, newData);
+    }
+    catch (...) {
+        AllocTraits::deallocate(alloc_, newData, newCapacity);
+        throw;
+    }
+    Deallocate();
+    data_     = newData;
+    capacity_ = newCapacity;
+}
+
+template <typename T, std::size_t N, typename Alloc>
+template <typename... Args>
+inline typename ftc::SmallVector<T, N, Alloc>::reference
+ftc::SmallVector<T, N, Alloc>::GrowAndEmplaceBack(Args &&... args)
+{
+    size_type newCapacity = NextCapacity(size_ + 1);
+    T *       newData     = AllocTraits::allocate(alloc_, newCapacity);
+
+    // Construct the new element first, as args may refer to an element
+    try {
+        AllocTraits::construct(alloc_, newData + size_, std::forward<Args>(args)...);
+    }
+    catch (...) {
+        AllocTraits::deallocate(alloc_, newData, newCapacity);
+        throw;
+    }
+    try {
+        Relocate(data_, size_, newData);
+    }
+    catch (...) {
+        AllocTraits::destroy(alloc_, newData + size_);
+        AllocTraits::deallocate(alloc_, newData, newCapacity);
+        throw;
+    }
+
+    Deallocate();
+    data_     = newData;
+    capacity_ = newCapacity;
+    return data_[size_++];
+}
+
+template <typename T, std::size_t N, typename Alloc>
+template <typename InputIt>
+inline void ftc::SmallVector<T, N, Alloc>::Append(InputIt first, InputIt last)
+{
+    using Category = typename std::iterator_traits<InputIt>::iterator_category;
+    if constexpr (std::is_base_of_v<std::forward_iterator_tag, Category>) {
+        size_type n = static_cast<size_type>(std::distance(first, last));
+        if (size_ + n > capacity_)
+            Reallocate(NextCapacity(size_ + n));
+
+        constexpr bool copyByMemcpy =
+            std::is_trivially_copyable_v<T> && std::is_pointer_v<InputIt>
+            && std::is_same_v<std::remove_cv_t<std::remove_pointer_t<InputIt>>, T>;
+        if constexpr (copyByMemcpy) {
+            if (n)
+                std::memcpy(static_cast<void *>(data_ + size_), first, n * sizeof(T));
+            size_ += n;
+            return;
+        }
+    }
+
+    for (; first != last; ++first)
+        emplace_back(*first);
+}
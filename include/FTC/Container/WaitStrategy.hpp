@@ -0,0 +1,163 @@
+/**
+ * @file WaitStrategy.hpp
+ * Wait strategies for concurrent containers
+ *
+ * Policies that decide how a blocking operation waits for a non-blocking attempt to succeed.
+ */
+
+#pragma once
+
+#include <atomic>   // for std::atomic
+#include <cstddef>  // for std::size_t
+#include <cstdint>  // for std::uint32_t
+#include <thread>   // for std::this_thread::yield
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    #include <intrin.h>  // for _mm_pause
+#endif
+
+#if !defined(__cpp_lib_atomic_wait)
+    #if defined(__linux__)
+        #include <climits>        // for INT_MAX
+        #include <linux/futex.h>  // for FUTEX_WAIT_PRIVATE, FUTEX_WAKE_PRIVATE
+        #include <sys/syscall.h>  // for SYS_futex
+        #include <unistd.h>       // for syscall
+    #elif defined(_WIN32)
+        #include "FTC/Detail/Windows.hpp"  // for WaitOnAddress, WakeByAddressAll
+        #pragma comment(lib, "Synchronization.lib")
+    #endif
+#endif
+
+namespace ftc {
+
+/// @defgroup WaitStrategy Wait Strategies
+///
+/// A wait strategy provides two operations:
+/// - WaitUntil(pred): Repeatedly calls pred() until it returns true.
+/// - Notify(): Called by the other side after an operation that may satisfy a waiter.
+///
+/// Each blocking side of a container owns one wait strategy instance.
+/// @{
+
+/// Hints the processor that the caller is in a spin-wait loop.
+inline void CpuRelax() noexcept
+{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_pause();
+#elif defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield");
+#endif
+}
+
+/// Spins with a pause instruction between attempts.
+/// Lowest latency, but keeps a core (and its SMT sibling) busy while waiting.
+class BusySpinWait
+{
+public:
+    template <typename Pred> void WaitUntil(Pred &&pred)
+    {
+        while (!pred())
+            CpuRelax();
+    }
+
+    void Notify() noexcept {}
+};
+
+/// Spins with exponentially growing pause count, then yields the time slice between attempts.
+/// @tparam MaxSpinShift Spin for at most 2^MaxSpinShift pauses between attempts before yielding.
+template <unsigned MaxSpinShift = 6> class BackoffWait
+{
+public:
+    template <typename Pred> void WaitUntil(Pred &&pred)
+    {
+        for (unsigned shift = 0; !pred();) {
+            if (shift <= MaxSpinShift) {
+                for (std::size_t i = 0; i < (std::size_t(1) << shift); i++)
+                    CpuRelax();
+                shift++;
+            }
+            else
+                std::this_thread::yield();
+        }
+    }
+
+    void Notify() noexcept {}
+};
+
+/// Spins for a short while, then parks the thread until notified by the other side.
+/// Parking uses std::atomic::wait when available, otherwise futex on Linux and WaitOnAddress on
+/// Windows. Notify() costs a fence and a load when no thread is parked.
+/// @tparam SpinCount How many attempts to make before parking.
+template <std::size_t SpinCount = 64> class ParkingWait
+{
+public:
+    template <typename Pred> void WaitUntil(Pred &&pred)
+    {
+        for (std::size_t i = 0; i < SpinCount; i++) {
+            if (pred())
+                return;
+            CpuRelax();
+        }
+
+        for (;;) {
+            // Announce before the final attempt, so a notifier either sees the waiter or the
+            // attempt sees the notifier's operation.
+            waiters.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            std::uint32_t ticket = epoch.load(std::memory_order_acquire);
+
+            bool done = pred();
+            if (!done)
+                Park(ticket);
+            waiters.fetch_sub(1, std::memory_order_relaxed);
+            if (done)
+                return;
+        }
+    }
+
+    void Notify() noexcept
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiters.load(std::memory_order_relaxed) != 0) {
+            epoch.fetch_add(1, std::memory_order_release);
+            WakeAll();
+        }
+    }
+
+private:
+    void Park(std::uint32_t ticket) noexcept
+    {
+#if defined(__cpp_lib_atomic_wait)
+        epoch.wait(ticket, std::memory_order_acquire);
+#elif defined(__linux__)
+        syscall(SYS_futex, &epoch, FUTEX_WAIT_PRIVATE, ticket, nullptr, nullptr, 0);
+#elif defined(_WIN32)
+        WaitOnAddress(&epoch, &ticket, sizeof(ticket), INFINITE);
+#else
+        while (epoch.load(std::memory_order_acquire) == ticket)
+            std::this_thread::yield();
+#endif
+    }
+
+    void WakeAll() noexcept
+    {
+#if defined(__cpp_lib_atomic_wait)
+        epoch.notify_all();
+#elif defined(__linux__)
+        syscall(SYS_futex, &epoch, FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+#elif defined(_WIN32)
+        WakeByAddressAll(&epoch);
+#endif
+    }
+
+    static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t));
+
+    std::atomic<std::uint32_t> epoch {0};
+    std::atomic<std::uint32_t> waiters {0};
+};
+
+/// @}
+
+}  // namespace ftc
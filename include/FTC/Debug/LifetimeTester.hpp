@@ -1,12 +1,26 @@
 /**
  * @file LifetimeTester.hpp
  * Object Lifetime Tester
+ *
+ * LifetimeTester reports every special member function called on it to its policy. The default
+ * policy prints a message to stdout, while LifetimeCounter<Tag> counts the calls with atomic
+ * counters, so that tests can assert that a container or a function wrapper does not copy:
+ *
+ *     using Tester = LifetimeTester<LifetimeCounter<struct MyTag>>;
+ *     LifetimeCounter<MyTag>::Scope scope;
+ *     SmallFunction<void()> f = [t = Tester("f")] {};
+ *     auto g = std::move(f);
+ *     EXPECT_EQ(scope.Delta().Copies(), 0);
  */
 
 #pragma once
 
-#include <cstring>
-#include <iostream>
+#include <atomic>       // for std::atomic
+#include <cstddef>      // for std::size_t, std::ptrdiff_t
+#include <cstring>      // for std::memcpy
+#include <iostream>     // for std::cout
+#include <ostream>      // for std::ostream
+#include <type_traits>  // for std::void_t, std::true_type
 
 namespace ftc {
 
@@ -21,42 +35,233 @@ namespace {
     };
 }  // namespace
 
+/// Special member function called on a LifetimeTester
+enum class LifetimeEvent {
+    DefaultConstruct,
+    CopyConstruct,
+    MoveConstruct,
+    CopyAssign,
+    MoveAssign,
+    Destruct,
+};
+
+/// Counts of lifetime events, as returned by LifetimeCounter::Snapshot()
+struct LifetimeCounts
+{
+    std::size_t    defaultConstructs = 0;
+    std::size_t    copyConstructs    = 0;
+    std::size_t    moveConstructs    = 0;
+    std::size_t    copyAssigns       = 0;
+    std::size_t    moveAssigns       = 0;
+    std::size_t    destructs         = 0;
+    std::ptrdiff_t live              = 0;  ///< Objects alive (may be negative in a delta)
+
+    std::size_t Constructs() const noexcept
+    {
+        return defaultConstructs + copyConstructs + moveConstructs;
+    }
+    std::size_t Copies() const noexcept { return copyConstructs + copyAssigns; }
+    std::size_t Moves() const noexcept { return moveConstructs + moveAssigns; }
+
+    /// Returns the events happened between snapshot `base` and this snapshot
+    LifetimeCounts operator-(const LifetimeCounts &base) const noexcept;
+
+    friend bool operator==(const LifetimeCounts &a, const LifetimeCounts &b) noexcept;
+    friend bool operator!=(const LifetimeCounts &a, const LifetimeCounts &b) noexcept
+    {
+        return !(a == b);
+    }
+    /// Prints all counters, so that gtest assertions show readable failures
+    friend std::ostream &operator<<(std::ostream &os, const LifetimeCounts &c);
+};
+
+/// Counting policy of LifetimeTester. All testers sharing the same Tag update the same counters.
+template <typename Tag = void> struct LifetimeCounter
+{
+    /// Records one event, called by LifetimeTester
+    static void Record(LifetimeEvent event) noexcept;
+    /// Returns the current value of all counters
+    static LifetimeCounts Snapshot() noexcept;
+    /// Clears all event counters. The live count is kept, as live objects are not affected.
+    static void Reset() noexcept;
+
+    /// Takes a snapshot on construction and reports the events happened since then
+    class Scope
+    {
+    public:
+        Scope() noexcept : base(Snapshot()) {}
+        LifetimeCounts Delta() const noexcept { return Snapshot() - base; }
+
+    private:
+        LifetimeCounts base;
+    };
+
+private:
+    static inline std::atomic<std::size_t>    counters[6] {};
+    static inline std::atomic<std::ptrdiff_t> live {0};
+};
+
 template <typename OutputWarpper = StdoutWrapper, std::size_t NameSize = 16>
 class LifetimeTester
 {
 public:
     LifetimeTester(const char *_name = "Unnamed") noexcept
     {
-        strncpy(name, _name, sizeof(name));
-        OutputWarpper() << name << ": Default constructor called.\n";
+        SetName(_name);
+        Notify(LifetimeEvent::DefaultConstruct);
     }
 
     LifetimeTester(const LifetimeTester &t) noexcept
     {
-        strncpy(name, t.name, sizeof(name));
-        OutputWarpper() << name << ": Copy constructor called.\n";
+        SetName(t.name);
+        Notify(LifetimeEvent::CopyConstruct);
     }
     LifetimeTester(LifetimeTester &&t) noexcept
     {
-        strncpy(name, t.name, sizeof(name));
-        OutputWarpper() << name << ": Move constructor called.\n";
+        SetName(t.name);
+        Notify(LifetimeEvent::MoveConstruct);
     }
 
     LifetimeTester &operator=(const LifetimeTester &t) noexcept
     {
-        strncpy(name, t.name, sizeof(name));
-        OutputWarpper() << name << ": Copy Assignment called.\n";
+        SetName(t.name);
+        Notify(LifetimeEvent::CopyAssign);
+        return *this;
     }
     LifetimeTester &operator=(LifetimeTester &&t) noexcept
     {
-        strncpy(name, t.name, sizeof(name));
-        OutputWarpper() << name << ": Move Assignment called.\n";
+        SetName(t.name);
+        Notify(LifetimeEvent::MoveAssign);
+        return *this;
     }
 
-    ~LifetimeTester() { OutputWarpper() << name << ": Destructor called.\n"; }
+    ~LifetimeTester() { Notify(LifetimeEvent::Destruct); }
+
+    const char *Name() const noexcept { return name; }
 
 private:
     char name[NameSize];
+
+    void SetName(const char *_name) noexcept
+    {
+        if (_name == name)
+            return;
+        std::size_t length = 0;
+        while (length < NameSize - 1 && _name[length])
+            length++;
+        std::memcpy(name, _name, length);
+        name[length] = '\0';
+    }
+    void Notify(LifetimeEvent event) noexcept;
+};
+
+/// LifetimeTester that opts into trivial relocation (see is_trivially_relocatable), for testing
+/// that containers relocate it with memcpy instead of reporting moves and destructions.
+template <typename OutputWarpper = StdoutWrapper, std::size_t NameSize = 16>
+struct RelocatableLifetimeTester : LifetimeTester<OutputWarpper, NameSize>
+{
+    using trivially_relocatable = std::true_type;
+    using LifetimeTester<OutputWarpper, NameSize>::LifetimeTester;
 };
 
 }  // namespace ftc
+
+// -------------------------------------------------
+// Implementation
+
+namespace ftc {
+
+namespace detail {
+
+    template <typename P, typename = void> struct __is_counting_policy : std::false_type
+    {};
+
+    template <typename P>
+    struct __is_counting_policy<P, std::void_t<decltype(P::Record(LifetimeEvent::Destruct))>>
+        : std::true_type
+    {};
+
+    inline const char *__lifetime_message(LifetimeEvent event) noexcept
+    {
+        switch (event) {
+        case LifetimeEvent::DefaultConstruct: return ": Default constructor called.\n";
+        case LifetimeEvent::CopyConstruct: return ": Copy constructor called.\n";
+        case LifetimeEvent::MoveConstruct: return ": Move constructor called.\n";
+        case LifetimeEvent::CopyAssign: return ": Copy Assignment called.\n";
+        case LifetimeEvent::MoveAssign: return ": Move Assignment called.\n";
+        default: return ": Destructor called.\n";
+        }
+    }
+
+}  // namespace detail
+
+inline LifetimeCounts LifetimeCounts::operator-(const LifetimeCounts &base) const noexcept
+{
+    LifetimeCounts d;
+    d.defaultConstructs = defaultConstructs - base.defaultConstructs;
+    d.copyConstructs    = copyConstructs - base.copyConstructs;
+    d.moveConstructs    = moveConstructs - base.moveConstructs;
+    d.copyAssigns       = copyAssigns - base.copyAssigns;
+    d.moveAssigns       = moveAssigns - base.moveAssigns;
+    d.destructs         = destructs - base.destructs;
+    d.live              = live - base.live;
+    return d;
+}
+
+inline bool operator==(const LifetimeCounts &a, const LifetimeCounts &b) noexcept
+{
+    return a.defaultConstructs == b.defaultConstructs && a.copyConstructs == b.copyConstructs
+           && a.moveConstructs == b.moveConstructs && a.copyAssigns == b.copyAssigns
+           && a.moveAssigns == b.moveAssigns && a.destructs == b.destructs && a.live == b.live;
+}
+
+inline std::ostream &operator<<(std::ostream &os, const LifetimeCounts &c)
+{
+    return os << "{default: " << c.defaultConstructs << ", copy: " << c.copyConstructs
+              << ", move: " << c.moveConstructs << ", copyAssign: " << c.copyAssigns
+              << ", moveAssign: " << c.moveAssigns << ", destruct: " << c.destructs
+              << ", live: " << c.live << "}";
+}
+
+template <typename Tag> inline void LifetimeCounter<Tag>::Record(LifetimeEvent event) noexcept
+{
+    counters[std::size_t(event)].fetch_add(1, std::memory_order_relaxed);
+    if (event == LifetimeEvent::Destruct)
+        live.fetch_sub(1, std::memory_order_relaxed);
+    else if (event < LifetimeEvent::CopyAssign)
+        live.fetch_add(1, std::memory_order_relaxed);
+}
+
+template <typename Tag> inline LifetimeCounts LifetimeCounter<Tag>::Snapshot() noexcept
+{
+    auto load = [](LifetimeEvent event) {
+        return counters[std::size_t(event)].load(std::memory_order_relaxed);
+    };
+
+    LifetimeCounts c;
+    c.defaultConstructs = load(LifetimeEvent::DefaultConstruct);
+    c.copyConstructs    = load(LifetimeEvent::CopyConstruct);
+    c.moveConstructs    = load(LifetimeEvent::MoveConstruct);
+    c.copyAssigns       = load(LifetimeEvent::CopyAssign);
+    c.moveAssigns       = load(LifetimeEvent::MoveAssign);
+    c.destructs         = load(LifetimeEvent::Destruct);
+    c.live              = live.load(std::memory_order_relaxed);
+    return c;
+}
+
+template <typename Tag> inline void LifetimeCounter<Tag>::Reset() noexcept
+{
+    for (auto &counter : counters)
+        counter.store(0, std::memory_order_relaxed);
+}
+
+template <typename OutputWarpper, std::size_t NameSize>
+inline void LifetimeTester<OutputWarpper, NameSize>::Notify(LifetimeEvent event) noexcept
+{
+    if constexpr (detail::__is_counting_policy<OutputWarpper>::value)
+        OutputWarpper::Record(event);
+    else
+        OutputWarpper() << name << detail::__lifetime_message(event);
+}
+
+}  // namespace ftc
@@ -0,0 +1,474 @@
+/**
+ * @file Trace.hpp
+ * Low overhead scope tracing
+ *
+ * TRACE_SCOPE(name) records the begin and end timestamps of a scope into a per-thread SPSC
+ * LockFreeCircularQueue, and a background drainer of the Tracer collects the events of every
+ * thread into Chrome trace JSON, which can be opened by chrome://tracing or the Perfetto UI.
+ *
+ * While a trace session runs, a scope costs two timestamp reads and one queue push. Otherwise it
+ * costs a relaxed atomic load, and nothing at all when FTC_TRACE_ENABLED is defined to 0.
+ */
+
+#pragma once
+
+#include "FTC/Container/LockFreeCircularQueue.hpp"
+#include "FTC/String/ConstString.hpp"
+#include "FTC/Utility/Preprocessor.hpp"
+
+#include <atomic>              // for std::atomic
+#include <charconv>            // for std::to_chars
+#include <chrono>              // for std::chrono::steady_clock
+#include <condition_variable>  // for std::condition_variable
+#include <cstdint>             // for std::uint32_t, std::uint64_t
+#include <fstream>             // for std::ofstream
+#include <memory>              // for std::shared_ptr
+#include <mutex>               // for std::mutex
+#include <ostream>             // for std::ostream
+#include <string>              // for std::string
+#include <thread>              // for std::thread
+#include <vector>              // for std::vector
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    #include <intrin.h>  // for __rdtsc
+    #define FTC_TRACE_RDTSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+    #include <x86intrin.h>  // for __rdtsc
+    #define FTC_TRACE_RDTSC 1
+#endif
+
+#ifndef FTC_TRACE_ENABLED
+    /// Define to 0 to compile out every TRACE_SCOPE
+    #define FTC_TRACE_ENABLED 1
+#endif
+
+#if FTC_TRACE_ENABLED
+    /// Traces the enclosing scope under a name
+    ///
+    /// The name is a string literal or a constant expression of ConstString, it is stored as a
+    /// static ConstString so that events only record its address.
+    #define TRACE_SCOPE(name)                                                                   \
+        static constexpr auto PP_CONCAT(ftcTraceTag, __LINE__) = ::ftc::ConstString(name);      \
+        ::ftc::ScopedTimer    PP_CONCAT(ftcTraceScope, __LINE__)(                               \
+            PP_CONCAT(ftcTraceTag, __LINE__).c_str())
+#else
+    #define TRACE_SCOPE(name) static_cast<void>(0)
+#endif
+
+namespace ftc {
+
+/// @defgroup Trace Scope Tracing
+/// @{
+
+/// Clock of trace events, the timestamp counter on x86 and steady_clock elsewhere
+///
+/// Ticks are converted to time when events are exported, by measuring the tick rate against
+/// steady_clock over the trace session. Timestamp counters are assumed to be invariant, which is
+/// the case on every x86 cpu of the last decade.
+struct TraceClock
+{
+    static std::uint64_t Now() noexcept
+    {
+#if defined(FTC_TRACE_RDTSC)
+        return __rdtsc();
+#else
+        return SteadyNs();
+#endif
+    }
+
+    static std::uint64_t SteadyNs() noexcept
+    {
+        using namespace std::chrono;
+        return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+    }
+};
+
+/// A complete event, the span of a traced scope
+struct TraceEvent
+{
+    const char *  name;
+    std::uint64_t begin;
+    std::uint64_t end;
+};
+
+/// Options of a trace session
+struct TraceOptions
+{
+    /// Period of the background drainer
+    std::chrono::milliseconds drainPeriod {10};
+
+    /// Capacity of the event buffer of each thread, events are dropped when it is full
+    std::size_t bufferCapacity = 4096;
+};
+
+/// Collects trace events of every thread and exports them as Chrome trace JSON
+///
+/// There is one tracer per process, events are only recorded between Start() and Stop().
+///
+///     Tracer::Instance().Start("trace.json");
+///     {
+///         TRACE_SCOPE("frame");
+///         ...
+///     }
+///     Tracer::Instance().Stop();
+class Tracer
+{
+public:
+    /// Gets the tracer of the process
+    static Tracer &Instance();
+
+    /// Starts a trace session writing to a file
+    /// @return Whether the session is started, false if the file can not be opened or a session
+    /// is already running.
+    bool Start(const std::string &path, const TraceOptions &options = {});
+
+    /// Starts a trace session writing to a stream, which must outlive the session
+    /// @return Whether the session is started, false if a session is already running.
+    bool Start(std::ostream &out, const TraceOptions &options = {});
+
+    /// Stops the trace session, exports the remaining events and completes the JSON document
+    void Stop();
+
+    /// Checks whether a trace session is running
+    bool Running() const noexcept { return running.load(std::memory_order_relaxed); }
+
+    /// Gets the number of events dropped by full buffers in the current or last session
+    std::size_t DroppedEvents() const noexcept { return dropped.load(std::memory_order_relaxed); }
+
+    /// Names the calling thread in the exported trace
+    /// @param name Thread name, must outlive the trace session
+    void SetThreadName(const char *name);
+
+    /// Records an event of the calling thread if a session is running
+    void Record(const char *name, std::uint64_t begin, std::uint64_t end) noexcept;
+
+    ~Tracer();
+
+private:
+    using Queue =
+        LockFreeCircularQueue<TraceEvent, DynamicSize, true, true, BusySpinWait, CompactLayout>;
+
+    /// Event buffer of a thread, kept alive by the registry until drained after the thread exits
+    struct ThreadBuffer
+    {
+        ThreadBuffer(std::size_t capacity, std::uint32_t tid) : queue(capacity), tid(tid) {}
+
+        Queue                     queue;
+        const std::uint32_t       tid;
+        std::atomic<const char *> threadName {nullptr};
+        const char *              exportedName = nullptr;  ///< Only accessed by the drainer
+    };
+
+    Tracer() = default;
+
+    /// Gets the buffer of the calling thread, creating it on first use
+    /// @return The buffer, or nullptr if it can not be allocated.
+    ThreadBuffer *LocalBuffer() noexcept;
+
+    void StartSession(std::ostream &stream, const TraceOptions &sessionOptions);
+
+    /// Exports (or discards) the events in every buffer, and releases buffers of exited threads
+    void Drain(bool discard);
+
+    void WriteEvent(std::uint32_t tid, const TraceEvent &event);
+    void WriteThreadName(std::uint32_t tid, const char *name);
+    void WriteSeparator();
+    void AppendString(const char *str);
+    void AppendNumber(std::uint64_t value);
+    void AppendMicroseconds(std::uint64_t ns);
+    void Flush();
+
+    std::atomic<bool>        running {false};
+    std::atomic<std::size_t> dropped {0};
+    std::atomic<std::size_t> bufferCapacity {TraceOptions {}.bufferCapacity};
+
+    std::mutex                                 registryMutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    std::uint32_t                              nextTid = 1;
+
+    std::mutex sessionMutex;  ///< Serializes Start() and Stop()
+    std::mutex drainMutex;    ///< Guards stopping
+    std::condition_variable stopRequested;
+    bool                    stopping = false;
+    std::thread             drainer;
+
+    // Output state, only accessed by the drainer while a session runs
+    std::ofstream file;
+    std::ostream *out        = nullptr;
+    std::string   line;
+    bool          firstEvent = true;
+    std::uint64_t startTicks = 0;
+    std::uint64_t startNs    = 0;
+    double        nsPerTick  = 1.0;
+};
+
+/// Records the span of its lifetime as a trace event
+class ScopedTimer
+{
+public:
+    /// @param name Event name, must outlive the trace session (eg. a string literal)
+    explicit ScopedTimer(const char *name) noexcept
+        : name(name)
+        , begin(Tracer::Instance().Running() ? TraceClock::Now() : 0)
+    {}
+
+    ~ScopedTimer()
+    {
+        if (begin)
+            Tracer::Instance().Record(name, begin, TraceClock::Now());
+    }
+
+    ScopedTimer(const ScopedTimer &) = delete;
+    ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+private:
+    const char *        name;
+    const std::uint64_t begin;
+};
+
+/// @}
+
+}  // namespace ftc
+
+///////////////////////////////////////////////////////////////////////////////
+// Implementation
+///////////////////////////////////////////////////////////////////////////////
+
+namespace ftc {
+
+inline Tracer &Tracer::Instance()
+{
+    static Tracer tracer;
+    return tracer;
+}
+
+inline Tracer::~Tracer()
+{
+    Stop();
+}
+
+inline bool Tracer::Start(const std::string &path, const TraceOptions &options)
+{
+    std::lock_guard lock(sessionMutex);
+    if (drainer.joinable())
+        return false;
+
+    file.open(path, std::ios::out | std::ios::trunc);
+    if (!file)
+        return false;
+
+    StartSession(file, options);
+    return true;
+}
+
+inline bool Tracer::Start(std::ostream &stream, const TraceOptions &options)
+{
+    std::lock_guard lock(sessionMutex);
+    if (drainer.joinable())
+        return false;
+
+    StartSession(stream, options);
+    return true;
+}
+
+inline void Tracer::StartSession(std::ostream &stream, const TraceOptions &options)
+{
+    // Events recorded after the end of the last session are stale
+    Drain(true);
+
+    out        = &stream;
+    firstEvent = true;
+    startTicks = TraceClock::Now();
+    startNs    = TraceClock::SteadyNs();
+    nsPerTick  = 1.0;
+    *out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+
+    dropped.store(0, std::memory_order_relaxed);
+    bufferCapacity.store(options.bufferCapacity, std::memory_order_relaxed);
+    running.store(true, std::memory_order_relaxed);
+
+    stopping = false;
+    drainer  = std::thread([this, period = options.drainPeriod] {
+        std::unique_lock lock(drainMutex);
+        while (!stopRequested.wait_for(lock, period, [this] { return stopping; })) {
+            lock.unlock();
+            Drain(false);
+            lock.lock();
+        }
+    });
+}
+
+inline void Tracer::Stop()
+{
+    std::lock_guard lock(sessionMutex);
+    if (!drainer.joinable())
+        return;
+
+    running.store(false, std::memory_order_relaxed);
+    {
+        std::lock_guard drainLock(drainMutex);
+        stopping = true;
+    }
+    stopRequested.notify_one();
+    drainer.join();
+
+    Drain(false);
+    *out << "\n]}\n";
+    out->flush();
+    out = nullptr;
+    if (file.is_open())
+        file.close();
+}
+
+inline void Tracer::SetThreadName(const char *name)
+{
+    if (ThreadBuffer *buffer = LocalBuffer())
+        buffer->threadName.store(name, std::memory_order_relaxed);
+}
+
+inline void Tracer::Record(const char *name, std::uint64_t begin, std::uint64_t end) noexcept
+{
+    if (!Running())
+        return;
+
+    ThreadBuffer *buffer = LocalBuffer();
+    if (!buffer || !buffer->queue.TryEmplace(TraceEvent {name, begin, end}))
+        dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+inline Tracer::ThreadBuffer *Tracer::LocalBuffer() noexcept
+{
+    thread_local ThreadBuffer *local = nullptr;
+    if (local)
+        return local;
+
+    // Shares the buffer with the registry, so that events left at thread exit are not lost
+    thread_local std::shared_ptr<ThreadBuffer> holder;
+    try {
+        std::lock_guard lock(registryMutex);
+        holder = std::make_shared<ThreadBuffer>(bufferCapacity.load(std::memory_order_relaxed),
+                                                nextTid++);
+        buffers.push_back(holder);
+    }
+    catch (...) {
+        holder.reset();
+        return nullptr;
+    }
+    return local = holder.get();
+}
+
+inline void Tracer::Drain(bool discard)
+{
+    std::vector<std::shared_ptr<ThreadBuffer>> snapshot;
+    {
+        std::lock_guard lock(registryMutex);
+        snapshot = buffers;
+    }
+
+#if defined(FTC_TRACE_RDTSC)
+    // Tick rate measured over the whole session so far
+    if (!discard) {
+        std::uint64_t ticks = TraceClock::Now() - startTicks;
+        std::uint64_t ns    = TraceClock::SteadyNs() - startNs;
+        if (ticks > 0 && ns > 0)
+            nsPerTick = double(ns) / double(ticks);
+    }
+#endif
+
+    constexpr std::size_t batchSize = 256;
+    TraceEvent            events[batchSize];
+    for (auto &buffer : snapshot) {
+        const char *name = discard ? nullptr : buffer->threadName.load(std::memory_order_relaxed);
+        if (name && name != buffer->exportedName)
+            WriteThreadName(buffer->tid, name);
+        buffer->exportedName = name;
+
+        while (std::size_t count = buffer->queue.TryPopBulk(events, batchSize)) {
+            for (std::size_t i = 0; i < count && !discard; i++)
+                WriteEvent(buffer->tid, events[i]);
+        }
+    }
+    snapshot.clear();
+
+    // Buffers only referenced by the registry belong to exited threads
+    std::lock_guard lock(registryMutex);
+    for (std::size_t i = 0; i < buffers.size();) {
+        if (buffers[i].use_count() == 1 && buffers[i]->queue.Empty()) {
+            buffers[i] = std::move(buffers.back());
+            buffers.pop_back();
+        }
+        else
+            i++;
+    }
+}
+
+inline void Tracer::WriteEvent(std::uint32_t tid, const TraceEvent &event)
+{
+    // Events of the last session may still be buffered when the first drain of a session exports
+    if (event.begin < startTicks)
+        return;
+
+    WriteSeparator();
+    line.append("{\"name\":\"");
+    AppendString(event.name);
+    line.append("\",\"ph\":\"X\",\"ts\":");
+    AppendMicroseconds(std::uint64_t(double(event.begin - startTicks) * nsPerTick));
+    line.append(",\"dur\":");
+    AppendMicroseconds(std::uint64_t(double(event.end - event.begin) * nsPerTick));
+    line.append(",\"pid\":1,\"tid\":");
+    AppendNumber(tid);
+    line.push_back('}');
+    Flush();
+}
+
+inline void Tracer::WriteThreadName(std::uint32_t tid, const char *name)
+{
+    WriteSeparator();
+    line.append("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":");
+    AppendNumber(tid);
+    line.append(",\"args\":{\"name\":\"");
+    AppendString(name);
+    line.append("\"}}");
+    Flush();
+}
+
+inline void Tracer::WriteSeparator()
+{
+    if (!firstEvent)
+        line.append(",\n");
+    firstEvent = false;
+}
+
+inline void Tracer::AppendString(const char *str)
+{
+    for (; *str; str++) {
+        char ch = *str;
+        if (ch == '"' || ch == '\\')
+            line.push_back('\\');
+        line.push_back(static_cast<unsigned char>(ch) < 0x20 ? ' ' : ch);
+    }
+}
+
+inline void Tracer::AppendNumber(std::uint64_t value)
+{
+    char digits[20];
+    line.append(digits, std::to_chars(digits, digits + sizeof(digits), value).ptr - digits);
+}
+
+inline void Tracer::AppendMicroseconds(std::uint64_t ns)
+{
+    AppendNumber(ns / 1000);
+    char fraction[4] = {'.',
+                        char('0' + ns / 100 % 10),
+                        char('0' + ns / 10 % 10),
+                        char('0' + ns % 10)};
+    line.append(fraction, sizeof(fraction));
+}
+
+inline void Tracer::Flush()
+{
+    out->write(line.data(), static_cast<std::streamsize>(line.size()));
+    line.clear();
+}
+
+}  // namespace ftc
@@ -0,0 +1,18 @@
+/**
+ * @file CacheLine.hpp
+ * Cache Line Size
+ *
+ * Internal header with the alignment used to keep concurrently written data on separate cache
+ * lines. It is a fixed value rather than std::hardware_destructive_interference_size, so that
+ * the layout of types does not depend on compiler tuning flags.
+ */
+
+#pragma once
+
+#include <cstddef>  // for std::size_t
+
+namespace ftc::detail {
+
+inline constexpr std::size_t __cache_line_size = 64;
+
+}  // namespace ftc::detail
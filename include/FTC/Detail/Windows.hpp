@@ -0,0 +1,22 @@
+/**
+ * @file Windows.hpp
+ * Windows Header
+ *
+ * Internal header including <Windows.h> for the platform code of other headers, without
+ * leaving any configuration macro defined in the files including them.
+ */
+
+#pragma once
+
+#if defined(_WIN32)
+    // Keep min and max functions usable in this library, then restore the user's setting
+    #ifndef NOMINMAX
+        #define NOMINMAX
+        #define FTC_WINDOWS_UNDEF_NOMINMAX 1
+    #endif
+    #include <Windows.h>
+    #ifdef FTC_WINDOWS_UNDEF_NOMINMAX
+        #undef NOMINMAX
+        #undef FTC_WINDOWS_UNDEF_NOMINMAX
+    #endif
+#endif
@@ -0,0 +1,329 @@
+/**
+ * @file Event.hpp
+ * Event (Multicast Delegate)
+ *
+ * A list of listeners invoked together, stored contiguously as SmallFunctions.
+ */
+
+#pragma once
+
+#include "FTC/Function/SmallFunction.hpp"
+
+#include <cstdint>      // for std::uint32_t
+#include <type_traits>  // for std::is_rvalue_reference_v
+#include <utility>      // for std::forward, std::move
+#include <vector>       // for std::vector
+
+namespace ftc {
+
+template <typename, std::size_t BufferSize = 24, typename Overflow = OverflowAssert>
+class Event; /* undefined */
+
+/// Multicast delegate, an alias of Event
+template <typename Signature, std::size_t BufferSize = 24, typename Overflow = OverflowAssert>
+using MulticastDelegate = Event<Signature, BufferSize, Overflow>;
+
+/// Event that invokes all subscribed listeners in subscription order
+///
+/// Listeners are stored by value in one contiguous array, so dispatching walks memory linearly
+/// and never allocates. Subscribing returns a Handle which unsubscribes in O(1): the listener
+/// is only marked as removed, and removed listeners are compacted away once they make up half
+/// of the array.
+///
+/// Listeners may subscribe, unsubscribe (including themselves) and clear the event while it is
+/// being dispatched. Removed listeners are no longer invoked, but are destroyed only after the
+/// outermost dispatch returns. Listeners subscribed during a dispatch are first invoked by the
+/// next dispatch. Destroying or moving an event while it is being dispatched is undefined.
+///
+/// @tparam Args Listener argument types
+/// @tparam BufferSize Storage size of each listener, see SmallFunction.
+/// @tparam Overflow Policy for listeners larger than the buffer, see SmallFunctionOverflow.
+template <typename... Args, std::size_t BufferSize, typename Overflow>
+class Event<void(Args...), BufferSize, Overflow>
+{
+    static_assert((!std::is_rvalue_reference_v<Args> && ...),
+                  "arguments can not be moved into more than one listener");
+
+public:
+    using Listener = SmallFunction<void(Args...), BufferSize, Overflow>;
+
+    /// Identifies a subscribed listener. Becomes stale once the listener is unsubscribed.
+    class Handle
+    {
+    public:
+        Handle() noexcept = default;
+
+        /// Checks if the handle was returned by Subscribe(), it may still be stale
+        explicit operator bool() const noexcept { return slot != npos; }
+
+        friend bool operator==(Handle a, Handle b) noexcept
+        {
+            return a.slot == b.slot && a.generation == b.generation;
+        }
+        friend bool operator!=(Handle a, Handle b) noexcept { return !(a == b); }
+
+    private:
+        friend class Event;
+        Handle(std::uint32_t slot, std::uint32_t generation) noexcept
+            : slot(slot)
+            , generation(generation)
+        {}
+
+        std::uint32_t slot       = npos;
+        std::uint32_t generation = 0;
+    };
+
+    Event() noexcept = default;
+    Event(Event &&) noexcept = default;
+    Event &operator=(Event &&) noexcept = default;
+    /// Handles refer to one event, so events are not copyable
+    Event(const Event &) = delete;
+    Event &operator=(const Event &) = delete;
+
+    /// Adds a listener, returns the handle to unsubscribe it
+    template <typename F> Handle Subscribe(F &&listener);
+    /// Removes a listener, returns false if the handle is stale
+    bool Unsubscribe(Handle handle) noexcept;
+    /// Checks if the listener of a handle is still subscribed
+    bool Contains(Handle handle) const noexcept;
+    /// Removes all listeners
+    void Clear() noexcept;
+
+    /// Returns the number of subscribed listeners
+    std::size_t Size() const noexcept { return numAlive; }
+    bool        Empty() const noexcept { return numAlive == 0; }
+    /// Reserves storage for n listeners
+    void Reserve(std::size_t n);
+
+    /// Invokes all subscribed listeners with the given arguments
+    void Dispatch(const Args &... args);
+    void operator()(const Args &... args) { Dispatch(args...); }
+
+private:
+    static constexpr std::uint32_t npos = std::uint32_t(-1);
+
+    struct Entry
+    {
+        Listener      fn;
+        std::uint32_t slot;  ///< npos if removed
+    };
+
+    struct Slot
+    {
+        std::uint32_t index;  ///< Index of the entry, or the next free slot
+        std::uint32_t generation;
+    };
+
+    /// Entries are indexed as if pending followed listeners
+    Entry &EntryAt(std::uint32_t index) noexcept
+    {
+        return index < listeners.size() ? listeners[index] : pending[index - listeners.size()];
+    }
+
+    std::uint32_t AllocSlot();
+    void          FreeSlot(std::uint32_t slot) noexcept;
+    /// Appends pending listeners that are still subscribed to listeners, outside dispatch.
+    /// Leaves pending intact if growing listeners throws, it is then retried by the next
+    /// Subscribe() or Dispatch().
+    void MergePending();
+    void Compact() noexcept;
+
+    std::vector<Entry> listeners;
+    std::vector<Entry> pending;  ///< Subscribed during dispatch
+    std::vector<Slot>  slots;
+    std::uint32_t      freeSlot      = npos;
+    std::uint32_t      numAlive      = 0;
+    std::uint32_t      numRemoved    = 0;  ///< Removed entries in listeners
+    std::uint32_t      dispatchDepth = 0;
+};
+
+}  // namespace ftc
+
+// -------------------------------------------------
+// Implementation
+
+namespace ftc {
+
+template <typename... Args, std::size_t BufferSize, typename Overflow>
+template <typename F>
+inline typename Event<void(Args...), BufferSize, Overflow>::Handle
+Event<void(Args...), BufferSize, Overflow>::Subscribe(F &&listener)
+{
+    Listener fn(std::forward<F>(listener));
+    if (dispatchDepth == 0 && !pending.empty())
+        MergePending();  // Appending to listeners must not shift pending indices
+
+    std::uint32_t slot = AllocSlot();
+    try {
+        // Listeners must not be reallocated while being dispatched
+        std::vector<Entry> &target = dispatchDepth ? pending : listeners;
+        target.push_back(Entry {std::move(fn), slot});
+    }
+    catch (...) {
+        FreeSlot(slot);
+        throw;
+    }
+    slots[slot].index = std::uint32_t(listeners.size() + pending.size() - 1);
+    numAlive++;
+    return Handle(slot, slots[slot].generation);
+}
+
+template <typename... Args, std::size_t BufferSize, typename Overflow>
+inline bool Event<void(Args...), BufferSize, Overflow>::Unsubscribe(Handle handle) noexcept
+{
+    if (!Contains(handle))
+        return false;
+
+    std::uint32_t index = slots[handle.slot].index;
+    Entry &       entry = EntryAt(index);
+    entry.slot          = npos;
+    FreeSlot(handle.slot);
+    numAlive--;
+
+    if (index >= listeners.size()) {
+        // Pending entries are never running, the last one is dropped right away
+        if (index == listeners.size() + pending.size() - 1)
+            pending.pop_back();
+        else
+            entry.fn = nullptr;
+    }
+    else {
+        numRemoved++;
+        if (dispatchDepth == 0) {
+            entry.fn = nullptr;
+            if (numRemoved * 2 > listeners.size())
+                Compact();
+        }
+    }
+    return true;
+}
+
+template <typename... Args, std::size_t BufferSize, typename Overflow>
+inline bool Event<void(Args...), BufferSize, Overflow>::Contains(Handle handle) const noexcept
+{
+    return handle.slot < slots.size() && slots[handle.slot].generation == handle.generation;
+}
+
+template <typename... Args, std::size_t BufferSize, typename Overflow>
+inline void Event<void(Args...), BufferSize, Overflow>::Clear() noexcept
+{
+    for (std::uint32_t index = 0; index < listeners.size() + pending.size(); index++) {
+        Entry &entry = EntryAt(index);
+        if (entry.slot != npos) {
+            FreeSlot(entry.slot);
+            entry.slot = npos;
+        }
+    }
+    pending.clear();
+    numAlive = 0;
+
+    if (dispatchDepth == 0) {
+        listeners.clear();
+        numRemoved = 0;
+    }
+    else
+        numRemoved = std::uint32_t(listeners.size());
+}
+
+template <typename... Args, std::size_t BufferSize, typename Overflow>
+inline void Event<void(Args...), BufferSize, Overflow>::Reserve(std::size_t n)
+{
+    if (dispatchDepth == 0)
+        listeners.reserve(n);
+    slots.reserve(n);
+}
+
+template <typename... Args, std::size_t BufferSize, typename Overflow>
+inline void Event<void(Args...), BufferSize, Overflow>::Dispatch(const Args &... args)
+{
+    struct DispatchGuard
+    {
+        Event &event;
+        DispatchGuard(Event &event) noexcept : event(event) { event.dispatchDepth++; }
+        ~DispatchGuard()
+        {
+            // Listeners removed during dispatch are destroyed even if a listener throws
+            if (--event.dispatchDepth == 0 && event.numRemoved)
+                event.Compact();
+        }
+    };
+
+    if (dispatchDepth == 0 && !pending.empty())
+        MergePending();
+
+    {
+        DispatchGuard guard(*this);
+
+        // Listeners is neither reallocated nor compacted during dispatch, indices stay valid
+        const std::size_t count = listeners.size();
+        for (std::size_t i = 0; i < count; i++) {
+            Entry &entry = listeners[i];
+            if (entry.slot != npos)
+                entry.fn(args...);
+        }
+    }
+
+    if (dispatchDepth == 0 && !pending.empty())
+        MergePending();
+}
+
+template <typename... Args, std::size_t BufferSize, typename Overflow>
+inline std::uint32_t Event<void(Args...), BufferSize, Overflow>::AllocSlot()
+{
+    if (freeSlot == npos) {
+        slots.push_back(Slot {npos, 0});
+        return std::uint32_t(slots.size() - 1);
+    }
+    std::uint32_t slot = freeSlot;
+    freeSlot           = slots[slot].index;
+    return slot;
+}
+
+template <typename... Args, std::size_t BufferSize, typename Overflow>
+inline void Event<void(Args...), BufferSize, Overflow>::FreeSlot(std::uint32_t slot) noexcept
+{
+    slots[slot].index = freeSlot;
+    slots[slot].generation++;  // Invalidates all handles to this slot
+    freeSlot = slot;
+}
+
+template <typename... Args, std::size_t BufferSize, typename Overflow>
+inline void Event<void(Args...), BufferSize, Overflow>::MergePending()
+{
+    std::size_t numSubscribed = 0;
+    for (const Entry &entry : pending)
+        numSubscribed += entry.slot != npos;
+    listeners.reserve(listeners.size() + numSubscribed);  // Only this may throw
+
+    // Unsubscribed pending entries are dropped instead of being merged
+    for (Entry &entry : pending) {
+        if (entry.slot == npos)
+            continue;
+        slots[entry.slot].index = std::uint32_t(listeners.size());
+        listeners.push_back(std::move(entry));
+    }
+    pending.clear();
+}
+
+template <typename... Args, std::size_t BufferSize, typename Overflow>
+inline void Event<void(Args...), BufferSize, Overflow>::Compact() noexcept
+{
+    std::uint32_t last = 0;
+    for (std::uint32_t i = 0; i < listeners.size(); i++) {
+        if (listeners[i].slot == npos)
+            continue;
+        if (i != last)
+            listeners[last] = std::move(listeners[i]);
+        slots[listeners[last].slot].index = last;
+        last++;
+    }
+    listeners.erase(listeners.begin() + last, listeners.end());
+    numRemoved = 0;
+
+    // Pending entries follow the compacted listeners
+    for (std::uint32_t i = 0; i < pending.size(); i++)
+        if (pending[i].slot != npos)
+            slots[pending[i].slot].index = last + i;
+}
+
+}  // namespace ftc
@@ -0,0 +1,108 @@
+/**
+ * @file FunctionRef.hpp
+ * Function Reference
+ *
+ * A non-owning reference to a callable, for callback parameters that never outlive the call.
+ */
+
+#pragma once
+
+#include "FTC/Traits/FunctionTraits.hpp"
+
+#include <memory>       // for std::addressof
+#include <type_traits>  // for std::is_function, std::is_invocable_r, std::is_void_v
+#include <utility>      // for std::forward
+
+namespace ftc {
+
+template <typename> class FunctionRef; /* undefined */
+
+namespace detail {
+
+    template <typename T> struct __is_function_ref
+    {
+        static constexpr bool value = false;
+    };
+
+    template <typename Result, typename... Args>
+    struct __is_function_ref<FunctionRef<Result(Args...)>>
+    {
+        static constexpr bool value = true;
+    };
+
+}  // namespace detail
+
+
+/// Non-owning function reference, two pointers in size
+///
+/// Binds to any callable (including temporaries) without copying or allocating. The referenced
+/// callable must outlive the FunctionRef, so it is best used as a function parameter type.
+/// A FunctionRef is never empty.
+///
+/// @tparam Result Function return type
+/// @tparam Args Function argument types
+template <typename Result, typename... Args> class FunctionRef<Result(Args...)>
+{
+public:
+    /// Binds to a function or function pointer
+    template <typename F,
+              typename = typename std::enable_if_t<
+                  std::is_function<F>::value && std::is_invocable_r<Result, F &, Args...>::value>>
+    FunctionRef(F *f) noexcept : invoke(InvokeFunction<F>)
+    {
+        target.fn = reinterpret_cast<void (*)()>(f);
+    }
+
+    /// Binds to a callable object
+    template <typename F,
+              typename = typename std::enable_if_t<
+                  !std::is_function<std::remove_reference_t<F>>::value
+                  && !std::is_pointer<std::decay_t<F>>::value
+                  && !detail::__is_function_ref<std::decay_t<F>>::value
+                  && std::is_invocable_r<Result, F &, Args...>::value>>
+    FunctionRef(F &&f) noexcept : invoke(InvokeObject<std::remove_reference_t<F>>)
+    {
+        target.obj = const_cast<void *>(static_cast<const void *>(std::addressof(f)));
+    }
+
+    FunctionRef(const FunctionRef &) noexcept = default;
+    FunctionRef &operator=(const FunctionRef &) noexcept = default;
+
+    /// Invokes the referenced function
+    /// @param args Function arguments
+    /// @return Function call result
+    Result operator()(Args... args) const { return invoke(target, std::forward<Args>(args)...); }
+
+private:
+    /// Object pointers and function pointers may not convert to each other
+    union Target {
+        void *obj;
+        void (*fn)();
+    };
+
+    /// A void FunctionRef discards the result of the callable
+    template <typename F> static Result InvokeFunction(Target t, Args &&... args)
+    {
+        if constexpr (std::is_void_v<Result>)
+            reinterpret_cast<F *>(t.fn)(std::forward<Args>(args)...);
+        else
+            return reinterpret_cast<F *>(t.fn)(std::forward<Args>(args)...);
+    }
+
+    template <typename F> static Result InvokeObject(Target t, Args &&... args)
+    {
+        if constexpr (std::is_void_v<Result>)
+            (*static_cast<F *>(t.obj))(std::forward<Args>(args)...);
+        else
+            return (*static_cast<F *>(t.obj))(std::forward<Args>(args)...);
+    }
+
+    Target target;
+    Result (*invoke)(Target, Args &&...);
+};
+
+template <typename F> FunctionRef(F *) -> FunctionRef<signature_of_t<F>>;
+template <typename F>
+FunctionRef(F &&) -> FunctionRef<signature_of_t<std::remove_reference_t<F>>>;
+
+}  // namespace ftc
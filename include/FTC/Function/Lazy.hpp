@@ -0,0 +1,85 @@
+/**
+ * @file Lazy.hpp
+ * Lazily Computed Value
+ *
+ * A value computed by a function on first access, at most once even with concurrent accesses.
+ */
+
+#pragma once
+
+#include "FTC/Function/SmallUniqueFunction.hpp"
+
+#include <atomic>       // for std::atomic
+#include <mutex>        // for std::mutex, std::lock_guard
+#include <optional>     // for std::optional
+#include <type_traits>  // for std::decay_t, std::invoke_result_t
+#include <utility>      // for std::forward
+
+namespace ftc {
+
+/// Value computed on first access
+///
+/// The first call to Get() (from any thread) runs the init function and stores its result,
+/// later calls return the stored value after a single acquire load. The init function is
+/// released once the value is computed. If it throws, nothing is stored and the next access
+/// tries again.
+///
+/// @tparam T Value type.
+/// @tparam BufferSize Storage size of the init function, see SmallUniqueFunction.
+template <typename T, std::size_t BufferSize = 24> class Lazy
+{
+public:
+    using InitFunction = SmallUniqueFunction<T(), BufferSize, OverflowToResource>;
+
+    template <typename F,
+              typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, Lazy>
+                                          && std::is_invocable_r_v<T, F &>>>
+    Lazy(F &&init) : init(std::forward<F>(init))
+    {}
+
+    /// Accesses the value from several threads, so it can not be copied or moved
+    Lazy(const Lazy &) = delete;
+    Lazy &operator=(const Lazy &) = delete;
+
+    /// Returns the value, computes it on first access
+    const T &Get() const
+    {
+        if (!ready.load(std::memory_order_acquire))
+            Compute();
+        return *value;
+    }
+    const T &operator*() const { return Get(); }
+    const T *operator->() const { return &Get(); }
+
+    /// Checks if the value is computed, without computing it
+    bool HasValue() const noexcept { return ready.load(std::memory_order_acquire); }
+
+private:
+    void Compute() const;
+
+    mutable InitFunction      init;
+    mutable std::optional<T>  value;
+    mutable std::atomic<bool> ready {false};
+    mutable std::mutex        mutex;
+};
+
+template <typename F> Lazy(F) -> Lazy<std::decay_t<std::invoke_result_t<F &>>>;
+
+}  // namespace ftc
+
+// -------------------------------------------------
+// Implementation
+
+namespace ftc {
+
+template <typename T, std::size_t BufferSize> inline void Lazy<T, BufferSize>::Compute() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (ready.load(std::memory_order_relaxed))
+        return;
+    value.emplace(init());
+    init = nullptr;
+    ready.store(true, std::memory_order_release);
+}
+
+}  // namespace ftc
@@ -0,0 +1,395 @@
+/**
+ * @file Memoize.hpp
+ * Memoized Function
+ *
+ * Wraps a pure function with a bounded cache of its results, keyed by its arguments.
+ */
+
+#pragma once
+
+#include "FTC/Container/FlatHashMap.hpp"
+#include "FTC/Detail/CacheLine.hpp"
+#include "FTC/Traits/FunctionTraits.hpp"
+
+#include <array>        // for std::array
+#include <cstdint>      // for std::uint32_t
+#include <functional>   // for std::invoke
+#include <mutex>        // for std::mutex, std::lock_guard
+#include <tuple>        // for std::tuple, std::apply
+#include <type_traits>  // for std::decay_t, std::conditional_t
+#include <utility>      // for std::forward, std::move, std::index_sequence
+#include <vector>       // for std::vector
+
+namespace ftc {
+
+/// Eviction policy of a memoization cache
+enum class CachePolicy {
+    LRU,    ///< Evicts the least recently used result, a hit relinks the entry in a list
+    Clock,  ///< Approximates LRU with one reference bit per entry, a hit only sets the bit
+};
+
+/// Hit and miss counts of a memoized function
+struct MemoizeStats
+{
+    std::size_t hits   = 0;
+    std::size_t misses = 0;
+};
+
+namespace detail {
+
+    template <typename F, typename Seq> struct __memo_key;
+    template <typename Key, typename Value, CachePolicy Policy> class __memo_cache;
+
+}  // namespace detail
+
+/// Function wrapper caching the results of at most `capacity` distinct argument lists
+///
+/// The cache key is built from the argument types of F found with FunctionTraits: the decayed
+/// argument type for unary functions, a std::tuple of decayed argument types otherwise. Keys
+/// are hashed with FlatHash (tuples hash each element) and looked up in a FlatHashMap, entries
+/// are stored in a flat array of exactly `capacity` slots and evicted by Policy.
+///
+/// F must be an unoverloaded callable with at least one argument (see Lazy for none) and should
+/// be pure: a cached result is returned instead of calling F again. Results are returned by
+/// value, so they stay valid after eviction.
+///
+/// With NumShards == 0 the cache is not synchronized. Otherwise keys are spread over NumShards
+/// independently locked caches, and F is called without holding any lock, so that concurrent
+/// misses on different keys do not serialize (a key missed by two threads at once may be
+/// computed twice).
+///
+/// @tparam F Callable type.
+/// @tparam Policy Eviction policy.
+/// @tparam NumShards Number of locked shards, or 0 for a single unsynchronized cache.
+template <typename F, CachePolicy Policy = CachePolicy::LRU, std::size_t NumShards = 0>
+class Memoized
+{
+    static constexpr std::size_t Arity = arity_of_v<F>;
+    static_assert(Arity > 0, "functions without arguments should use Lazy");
+
+public:
+    using Key   = typename detail::__memo_key<F, std::make_index_sequence<Arity>>::type;
+    using Value = std::decay_t<result_of_t<F>>;
+    static_assert(!std::is_void_v<Value>, "memoized function must return a value");
+
+    Memoized(F f, std::size_t capacity);
+
+    /// Returns the cached result for the arguments, calls the function on a miss
+    template <typename... Ts> Value operator()(Ts &&... args);
+
+    /// Returns the number of cached results
+    std::size_t Size() const;
+    /// Returns the maximum number of cached results
+    std::size_t Capacity() const;
+    MemoizeStats Stats() const;
+    /// Drops all cached results
+    void Clear();
+
+private:
+    using Cache = detail::__memo_cache<Key, Value, Policy>;
+
+    struct alignas(detail::__cache_line_size) Shard
+    {
+        mutable std::mutex mutex;
+        Cache              cache;
+    };
+
+    Value Invoke(const Key &key);
+    /// Calls fn(cache) for every cache of self, under its lock
+    template <typename Self, typename Fn> static void ForEachCache(Self &self, Fn &&fn);
+
+    F f;
+    std::conditional_t<NumShards == 0, Cache, std::array<Shard, NumShards>> caches;
+};
+
+/// Memoizes a function with a cache of at most capacity results
+/// @see Memoized
+template <CachePolicy Policy = CachePolicy::LRU, std::size_t NumShards = 0, typename F>
+Memoized<std::decay_t<F>, Policy, NumShards> Memoize(F &&f, std::size_t capacity);
+
+}  // namespace ftc
+
+// -------------------------------------------------
+// Implementation
+
+namespace ftc {
+
+namespace detail {
+
+    template <typename F, std::size_t... I> struct __memo_key<F, std::index_sequence<I...>>
+    {
+        using type = std::tuple<std::decay_t<arg_at_t<F, I>>...>;
+    };
+
+    template <typename F> struct __memo_key<F, std::index_sequence<0>>
+    {
+        using type = std::decay_t<arg_at_t<F, 0>>;
+    };
+
+    template <typename T> struct __memo_hash : FlatHash<T>
+    {};
+
+    template <typename... Ts> struct __memo_hash<std::tuple<Ts...>>
+    {
+        std::size_t operator()(const std::tuple<Ts...> &key) const
+        {
+            return std::apply(
+                [](const Ts &... values) {
+                    std::size_t h = 0;
+                    ((h = (h ^ __memo_hash<Ts>()(values)) * 0x9E3779B97F4A7C15ull), ...);
+                    return h;
+                },
+                key);
+        }
+    };
+
+    /// Links of an entry in the recency list, or its reference bit
+    template <CachePolicy Policy> struct __memo_links
+    {
+        std::uint32_t prev, next;
+    };
+
+    template <> struct __memo_links<CachePolicy::Clock>
+    {
+        bool referenced;
+    };
+
+    /// Bounded cache of at most capacity entries, which are reused on eviction
+    template <typename Key, typename Value, CachePolicy Policy> class __memo_cache
+    {
+    public:
+        explicit __memo_cache(std::size_t capacity = 1) { SetCapacity(capacity); }
+
+        void SetCapacity(std::size_t capacity)
+        {
+            capacity_ = std::uint32_t(capacity ? capacity : 1);
+            Clear();
+            entries.reserve(capacity_);
+            index.reserve(capacity_);
+        }
+
+        /// Returns the cached value and marks it as used, or nullptr
+        const Value *Find(const Key &key)
+        {
+            auto it = index.find(key);
+            if (it == index.end()) {
+                stats.misses++;
+                return nullptr;
+            }
+            stats.hits++;
+            Touch(it->second);
+            return &entries[it->second].value;
+        }
+
+        /// Caches a value, unless another one was inserted for the key since Find()
+        void Insert(const Key &key, const Value &value)
+        {
+            if (index.contains(key))
+                return;
+
+            std::uint32_t i;
+            if (entries.size() < capacity_) {
+                i = std::uint32_t(entries.size());
+                entries.push_back(Entry {key, value, {}});
+            }
+            else {
+                // Evict before inserting, so that the index never grows beyond capacity
+                i = Evict();
+                index.erase(entries[i].key);
+                entries[i].key   = key;
+                entries[i].value = value;
+            }
+            index.emplace(key, i);
+
+            if constexpr (Policy == CachePolicy::LRU)
+                PushFront(i);
+            else
+                entries[i].links.referenced = false;
+        }
+
+        void Clear() noexcept
+        {
+            entries.clear();
+            index.clear();
+            head = tail = npos;
+            hand        = 0;
+        }
+
+        std::size_t  Size() const noexcept { return entries.size(); }
+        std::size_t  Capacity() const noexcept { return capacity_; }
+        MemoizeStats Stats() const noexcept { return stats; }
+
+    private:
+        static constexpr std::uint32_t npos = std::uint32_t(-1);
+
+        struct Entry
+        {
+            Key                  key;
+            Value                value;
+            __memo_links<Policy> links;
+        };
+
+        void Touch(std::uint32_t i) noexcept
+        {
+            if constexpr (Policy == CachePolicy::LRU) {
+                if (head != i) {
+                    Unlink(i);
+                    PushFront(i);
+                }
+            }
+            else
+                entries[i].links.referenced = true;
+        }
+
+        /// Returns the entry to reuse, the cache is full
+        std::uint32_t Evict() noexcept
+        {
+            if constexpr (Policy == CachePolicy::LRU) {
+                std::uint32_t victim = tail;
+                Unlink(victim);
+                return victim;
+            }
+            else {
+                // Gives every referenced entry a second chance, terminates after one round
+                while (entries[hand].links.referenced) {
+                    entries[hand].links.referenced = false;
+                    hand                           = hand + 1 == capacity_ ? 0 : hand + 1;
+                }
+                std::uint32_t victim = hand;
+                hand                 = hand + 1 == capacity_ ? 0 : hand + 1;
+                return victim;
+            }
+        }
+
+        void PushFront(std::uint32_t i) noexcept
+        {
+            entries[i].links.prev = npos;
+            entries[i].links.next = head;
+            if (head != npos)
+                entries[head].links.prev = i;
+            head = i;
+            if (tail == npos)
+                tail = i;
+        }
+
+        void Unlink(std::uint32_t i) noexcept
+        {
+            auto &links = entries[i].links;
+            (links.prev != npos ? entries[links.prev].links.next : head) = links.next;
+            (links.next != npos ? entries[links.next].links.prev : tail) = links.prev;
+        }
+
+        std::vector<Entry>                                entries;
+        FlatHashMap<Key, std::uint32_t, __memo_hash<Key>> index;
+        std::uint32_t                                     capacity_ = 1;
+        std::uint32_t                                     head = npos, tail = npos;  // LRU
+        std::uint32_t                                     hand = 0;                  // Clock
+        MemoizeStats                                      stats;
+    };
+
+}  // namespace detail
+
+template <typename F, CachePolicy Policy, std::size_t NumShards>
+inline Memoized<F, Policy, NumShards>::Memoized(F f, std::size_t capacity) : f(std::move(f))
+{
+    if constexpr (NumShards == 0)
+        caches.SetCapacity(capacity);
+    else {
+        for (Shard &shard : caches)
+            shard.cache.SetCapacity((capacity + NumShards - 1) / NumShards);
+    }
+}
+
+template <typename F, CachePolicy Policy, std::size_t NumShards>
+template <typename... Ts>
+inline typename Memoized<F, Policy, NumShards>::Value
+Memoized<F, Policy, NumShards>::operator()(Ts &&... args)
+{
+    static_assert(sizeof...(Ts) == Arity, "wrong number of arguments");
+    const Key key(std::forward<Ts>(args)...);
+
+    if constexpr (NumShards == 0) {
+        if (const Value *cached = caches.Find(key))
+            return *cached;
+        Value value = Invoke(key);
+        caches.Insert(key, value);
+        return value;
+    }
+    else {
+        Shard &shard = caches[detail::__memo_hash<Key>()(key) % NumShards];
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            if (const Value *cached = shard.cache.Find(key))
+                return *cached;
+        }
+        Value value = Invoke(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.cache.Insert(key, value);
+        return value;
+    }
+}
+
+template <typename F, CachePolicy Policy, std::size_t NumShards>
+inline std::size_t Memoized<F, Policy, NumShards>::Size() const
+{
+    std::size_t size = 0;
+    ForEachCache(*this, [&](const Cache &cache) { size += cache.Size(); });
+    return size;
+}
+
+template <typename F, CachePolicy Policy, std::size_t NumShards>
+inline std::size_t Memoized<F, Policy, NumShards>::Capacity() const
+{
+    std::size_t capacity = 0;
+    ForEachCache(*this, [&](const Cache &cache) { capacity += cache.Capacity(); });
+    return capacity;
+}
+
+template <typename F, CachePolicy Policy, std::size_t NumShards>
+inline MemoizeStats Memoized<F, Policy, NumShards>::Stats() const
+{
+    MemoizeStats stats;
+    ForEachCache(*this, [&](const Cache &cache) {
+        stats.hits += cache.Stats().hits;
+        stats.misses += cache.Stats().misses;
+    });
+    return stats;
+}
+
+template <typename F, CachePolicy Policy, std::size_t NumShards>
+inline void Memoized<F, Policy, NumShards>::Clear()
+{
+    ForEachCache(*this, [](Cache &cache) { cache.Clear(); });
+}
+
+template <typename F, CachePolicy Policy, std::size_t NumShards>
+inline typename Memoized<F, Policy, NumShards>::Value
+Memoized<F, Policy, NumShards>::Invoke(const Key &key)
+{
+    if constexpr (Arity == 1)
+        return std::invoke(f, key);
+    else
+        return std::apply(f, key);
+}
+
+template <typename F, CachePolicy Policy, std::size_t NumShards>
+template <typename Self, typename Fn>
+inline void Memoized<F, Policy, NumShards>::ForEachCache(Self &self, Fn &&fn)
+{
+    if constexpr (NumShards == 0)
+        fn(self.caches);
+    else {
+        for (auto &shard : self.caches) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            fn(shard.cache);
+        }
+    }
+}
+
+template <CachePolicy Policy, std::size_t NumShards, typename F>
+inline Memoized<std::decay_t<F>, Policy, NumShards> Memoize(F &&f, std::size_t capacity)
+{
+    return Memoized<std::decay_t<F>, Policy, NumShards>(std::forward<F>(f), capacity);
+}
+
+}  // namespace ftc
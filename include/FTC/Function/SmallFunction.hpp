@@ -7,12 +7,42 @@
 
 #pragma once
 
-#include <functional>  // for std::bad_function_call
-#include <utility>     // for std::forward, std::move
+#include "FTC/Traits/FunctionTraits.hpp"
+#include "FTC/Traits/Relocatable.hpp"
+
+#include <cstring>          // for std::memcpy
+#include <functional>       // for std::bad_function_call
+#include <memory_resource>  // for std::pmr::memory_resource
+#include <type_traits>      // for std::is_same_v, std::is_trivially_copyable_v
+#include <utility>          // for std::forward, std::move
 
 namespace ftc {
 
-template <typename, std::size_t BufferSize = 24> class SmallFunction; /* undefined */
+/// @defgroup SmallFunctionOverflow SmallFunction Overflow Policies
+///
+/// Decides what SmallFunction does with a callable that does not fit into its buffer.
+/// A policy other than OverflowAssert must provide a static Resource() function returning the
+/// memory resource to allocate oversized callables from.
+/// @{
+
+/// Rejects callables that do not fit into the buffer at compile time.
+struct OverflowAssert
+{};
+
+/// Allocates callables that do not fit into the buffer from the default memory resource.
+/// Callables that fit are still stored inline.
+struct OverflowToResource
+{
+    static std::pmr::memory_resource *Resource() noexcept
+    {
+        return std::pmr::get_default_resource();
+    }
+};
+
+/// @}
+
+template <typename, std::size_t BufferSize = 24, typename Overflow = OverflowAssert>
+class SmallFunction; /* undefined */
 
 namespace detail {
 
@@ -21,93 +51,185 @@ namespace detail {
         static constexpr bool value = false;
     };
 
-    template <typename Result, typename... Args, std::size_t BufferSize>
-    struct __is_small_function<SmallFunction<Result(Args...), BufferSize>>
+    template <typename Result, typename... Args, std::size_t BufferSize, typename Overflow>
+    struct __is_small_function<SmallFunction<Result(Args...), BufferSize, Overflow>>
     {
         static constexpr bool value = true;
     };
 
+    /// Lifetime operations of a callable stored in a SmallFunction buffer.
+    /// Trivially copyable callables have no table and are copied with memcpy.
+    /// Move-only containers use tables without clone.
+    struct __small_function_ops
+    {
+        void (*clone)(void *dst, const void *src);  ///< May be null for move-only containers
+        void (*move)(void *dst, void *src) noexcept;  ///< Also destroys src, null to memcpy
+        void (*destroy)(void *p) noexcept;
+    };
+
+    /// Callable stored inline in the buffer.
+    template <typename T> struct __small_function_inline
+    {
+        template <typename Result, typename... Args>
+        static Result Invoke(void *p, Args &&... args)
+        {
+            return (*static_cast<T *>(p))(std::forward<Args>(args)...);
+        }
+
+        static void Clone(void *dst, const void *src) { new (dst) T(*static_cast<const T *>(src)); }
+        static void Move(void *dst, void *src) noexcept
+        {
+            new (dst) T(std::move(*static_cast<T *>(src)));
+            static_cast<T *>(src)->~T();
+        }
+        static void Destroy(void *p) noexcept { static_cast<T *>(p)->~T(); }
+
+        /// Trivially relocatable callables are moved with memcpy
+        static constexpr auto move = is_trivially_relocatable_v<T> ? nullptr : Move;
+
+        static constexpr __small_function_ops ops {Clone, move, Destroy};
+        static constexpr __small_function_ops unique_ops {nullptr, move, Destroy};
+    };
+
+    /// Callable that does not fit into the buffer, stored in memory from a pmr resource.
+    /// The buffer only keeps a pointer, so moving never allocates.
+    template <typename T> struct __small_function_heap
+    {
+        struct Box
+        {
+            std::pmr::memory_resource *resource;
+            T                          f;
+        };
+
+        template <typename U> static void Construct(void *p, U &&f, std::pmr::memory_resource *r)
+        {
+            void *mem = r->allocate(sizeof(Box), alignof(Box));
+            try {
+                *static_cast<Box **>(p) = new (mem) Box {r, T(std::forward<U>(f))};
+            }
+            catch (...) {
+                r->deallocate(mem, sizeof(Box), alignof(Box));
+                throw;
+            }
+        }
+
+        template <typename Result, typename... Args>
+        static Result Invoke(void *p, Args &&... args)
+        {
+            return (*static_cast<Box **>(p))->f(std::forward<Args>(args)...);
+        }
+
+        static void Clone(void *dst, const void *src)
+        {
+            const Box *box = *static_cast<Box *const *>(src);
+            Construct(dst, box->f, box->resource);
+        }
+        static void Destroy(void *p) noexcept
+        {
+            Box *                      box      = *static_cast<Box **>(p);
+            std::pmr::memory_resource *resource = box->resource;
+            box->~Box();
+            resource->deallocate(box, sizeof(Box), alignof(Box));
+        }
+
+        // Moving only copies the box pointer
+        static constexpr __small_function_ops ops {Clone, nullptr, Destroy};
+        static constexpr __small_function_ops unique_ops {nullptr, nullptr, Destroy};
+    };
+
+    template <typename Result, typename... Args> Result __small_function_empty(void *, Args &&...)
+    {
+        throw std::bad_function_call();
+    }
+
 }  // namespace detail
 
 
 /// Function container with static storage size
+///
+/// The contained callable is invoked through a single function pointer stored next to the
+/// buffer. Copying, moving and destroying go through a shared static table, which is omitted
+/// for trivially copyable callables (those are copied with memcpy). A call is a single indirect
+/// call without loading a table first, at the cost of one more word: sizeof(SmallFunction) is
+/// BufferSize + 16.
+///
 /// @tparam Result Function return type
 /// @tparam Args Function argument types
 /// @tparam BufferSize Storage size, default is 24.
-template <typename Result, typename... Args, std::size_t BufferSize>
-class SmallFunction<Result(Args...), BufferSize>
+/// @tparam Overflow Policy for callables larger than the buffer, see SmallFunctionOverflow.
+template <typename Result, typename... Args, std::size_t BufferSize, typename Overflow>
+class SmallFunction<Result(Args...), BufferSize, Overflow>
 {
     static_assert(BufferSize >= 8, "buffer size should be at least 8");
 
+    /// Copying may allocate if oversized callables are allowed
+    static constexpr bool nothrowCopy = std::is_same_v<Overflow, OverflowAssert>;
+
+    template <typename, std::size_t, typename> friend class SmallFunction;
+    template <typename, std::size_t, typename> friend class SmallUniqueFunction;
+
 public:
-    SmallFunction() noexcept { new (storage) CallableT<std::nullptr_t>(nullptr); }
-    ~SmallFunction() { ((ICallable *)storage)->~ICallable(); }
+    SmallFunction() noexcept : invoke(detail::__small_function_empty<Result, Args...>), ops(nullptr)
+    {}
+    ~SmallFunction() { Destroy(); }
 
-    SmallFunction(const SmallFunction &other) noexcept
-    {
-        const ICallable *_callable = reinterpret_cast<const ICallable *>(other.storage);
-        _callable->Clone((void *)storage);
-    }
+    SmallFunction(const SmallFunction &other) noexcept(nothrowCopy) { CopyFrom(other); }
 
-    SmallFunction(SmallFunction &&other) noexcept
-    {
-        ICallable *_callable = reinterpret_cast<ICallable *>(other.storage);
-        _callable->Move((void *)storage);
-        other = nullptr;
-    }
+    SmallFunction(SmallFunction &&other) noexcept { MoveFrom(other); }
 
     template <std::size_t BufferSizeT>
-    SmallFunction(const SmallFunction<Result(Args...), BufferSizeT> &t) noexcept
+    SmallFunction(const SmallFunction<Result(Args...), BufferSizeT, Overflow> &t) noexcept(
+        nothrowCopy)
     {
         static_assert(BufferSizeT <= BufferSize, "buffer size is smaller than needed");
-        const ICallable *_callable =
-            reinterpret_cast<const ICallable *>(reinterpret_cast<const SmallFunction &>(t).storage);
-        _callable->Clone((void *)storage);
+        CopyFrom(t);
     }
 
     template <std::size_t BufferSizeT>
-    SmallFunction(SmallFunction<Result(Args...), BufferSizeT> &&t) noexcept
+    SmallFunction(SmallFunction<Result(Args...), BufferSizeT, Overflow> &&t) noexcept
     {
         static_assert(BufferSizeT <= BufferSize, "buffer size is smaller than needed");
-        SmallFunction &other     = reinterpret_cast<SmallFunction &>(t);
-        ICallable *    _callable = reinterpret_cast<ICallable *>(other.storage);
-        _callable->Move((void *)storage);
-        other = nullptr;
+        MoveFrom(t);
     }
 
     template <typename T,
               typename = typename std::enable_if_t<
                   !std::is_function<T>::value
                   && !detail::__is_small_function<typename std::decay<T>::type>::value>>
-    SmallFunction(T &&t) noexcept
+    SmallFunction(T &&t) noexcept(fitsInline<typename std::decay<T>::type>)
     {
-        using CallableType = typename std::decay<T>::type;
-        static_assert(sizeof(CallableT<CallableType>) <= sizeof(storage),
-                      "function is too large for buffer");
-        new (storage) CallableT<CallableType>(std::forward<T>(t));
+        Construct<typename std::decay<T>::type>(std::forward<T>(t));
     }
 
     template <typename T,
               typename = typename std::enable_if_t<
                   !std::is_function<T>::value
                   && !detail::__is_small_function<typename std::decay<T>::type>::value>>
-    SmallFunction &operator=(T &&t) noexcept
+    SmallFunction &operator=(T &&t) noexcept(fitsInline<typename std::decay<T>::type>)
     {
         using CallableType = typename std::decay<T>::type;
-        static_assert(sizeof(CallableT<CallableType>) <= sizeof(storage),
-                      "function is too large for buffer");
-        ((ICallable *)storage)->~ICallable();
-        new (storage) CallableT<CallableType>(std::forward<T>(t));
+        if constexpr (fitsInline<CallableType>) {
+            Destroy();
+            Construct<CallableType>(std::forward<T>(t));
+        }
+        else {
+            // Allocate before releasing the current callable, in case allocation throws
+            SmallFunction tmp(std::forward<T>(t));
+            *this = std::move(tmp);
+        }
         return *this;
     }
 
-    SmallFunction &operator=(const SmallFunction &other) noexcept
+    SmallFunction &operator=(const SmallFunction &other) noexcept(nothrowCopy)
     {
         if (this == &other)
             return *this;
-        ((ICallable *)storage)->~ICallable();
-        const ICallable *_callable = reinterpret_cast<const ICallable *>(other.storage);
-        _callable->Clone((void *)storage);
+        if constexpr (!nothrowCopy) {
+            SmallFunction tmp(other);
+            return *this = std::move(tmp);
+        }
+        Destroy();
+        CopyFrom(other);
         return *this;
     }
 
@@ -115,95 +237,123 @@ public:
     {
         if (this == &other)
             return *this;
-        ((ICallable *)storage)->~ICallable();
-        ICallable *_callable = reinterpret_cast<ICallable *>(other.storage);
-        _callable->Move((void *)storage);
-        other = nullptr;
+        Destroy();
+        MoveFrom(other);
         return *this;
     }
 
     template <std::size_t BufferSizeT>
-    SmallFunction &operator=(const SmallFunction<Result(Args...), BufferSizeT> &t) noexcept
+    SmallFunction &
+    operator=(const SmallFunction<Result(Args...), BufferSizeT, Overflow> &t) noexcept(nothrowCopy)
     {
         static_assert(BufferSizeT <= BufferSize, "buffer size is smaller than needed");
-        const SmallFunction &other = reinterpret_cast<const SmallFunction &>(t);
-        ((ICallable *)storage)->~ICallable();
-        const ICallable *_callable = reinterpret_cast<const ICallable *>(other.storage);
-        _callable->Clone((void *)storage);
+        if constexpr (!nothrowCopy) {
+            SmallFunction tmp(t);
+            return *this = std::move(tmp);
+        }
+        Destroy();
+        CopyFrom(t);
         return *this;
     }
 
     template <std::size_t BufferSizeT>
-    SmallFunction &operator=(SmallFunction<Result(Args...), BufferSizeT> &&t) noexcept
+    SmallFunction &operator=(SmallFunction<Result(Args...), BufferSizeT, Overflow> &&t) noexcept
     {
         static_assert(BufferSizeT <= BufferSize, "buffer size is smaller than needed");
-        SmallFunction &other = reinterpret_cast<SmallFunction &>(t);
-        ((ICallable *)storage)->~ICallable();
-        ICallable *_callable = reinterpret_cast<ICallable *>(other.storage);
-        _callable->Move((void *)storage);
-        other = nullptr;
+        Destroy();
+        MoveFrom(t);
         return *this;
     }
 
     /// Checks if a function is contained
-    explicit operator bool() const noexcept { return ((ICallable *)storage)->IsNotEmpty(); }
+    explicit operator bool() const noexcept
+    {
+        return invoke != detail::__small_function_empty<Result, Args...>;
+    }
 
     /// Invokes the function
-    /// 
+    ///
     /// Throws std::bad_function_call if no function is contained.
-    /// 
+    ///
     /// @param args Function arguments
     /// @return Function call result
-    Result   operator()(Args... args) const { return ((ICallable *)storage)->Invoke(args...); }
+    Result operator()(Args... args) const
+    {
+        return invoke(const_cast<char *>(storage), std::forward<Args>(args)...);
+    }
 
     /// @name Compares a SmallFunction with nullptr
     /// @{
-    friend bool operator==(const SmallFunction &f, std::nullptr_t p) noexcept { return !(bool)f; }
-    friend bool operator==(std::nullptr_t p, const SmallFunction &f) noexcept { return !(bool)f; }
-    friend bool operator!=(const SmallFunction &f, std::nullptr_t p) noexcept { return (bool)f; }
-    friend bool operator!=(std::nullptr_t p, const SmallFunction &f) noexcept { return (bool)f; }
+    friend bool operator==(const SmallFunction &f, std::nullptr_t) noexcept { return !(bool)f; }
+    friend bool operator==(std::nullptr_t, const SmallFunction &f) noexcept { return !(bool)f; }
+    friend bool operator!=(const SmallFunction &f, std::nullptr_t) noexcept { return (bool)f; }
+    friend bool operator!=(std::nullptr_t, const SmallFunction &f) noexcept { return (bool)f; }
     /// @}
 
 private:
-    class ICallable
-    {
-    public:
-        virtual ~ICallable() noexcept                         = default;
-        virtual bool   IsNotEmpty() const noexcept            = 0;
-        virtual Result Invoke(Args... args)                   = 0;
-        virtual void   Clone(void *dstStorage) const noexcept = 0;
-        virtual void   Move(void *dstStorage) noexcept        = 0;
-    };
+    using InvokeFn = Result (*)(void *, Args &&...);
 
-    template <typename T, typename Dummy = void> class CallableT : public ICallable
-    {
-    public:
-        CallableT(const T &callable) : f(callable) {}
-        CallableT(T &&callable) : f(std::move(callable)) {}
-        ~CallableT() noexcept override = default;
+    /// Checks if a callable of type T is stored inline
+    template <typename T>
+    static constexpr bool fitsInline = sizeof(T) <= BufferSize && alignof(T) <= alignof(void *);
 
-        bool   IsNotEmpty() const noexcept override { return true; }
-        Result Invoke(Args... args) override { return f(args...); }
-        void   Clone(void *dst) const noexcept override { new (dst) CallableT(f); }
-        void   Move(void *dst) noexcept override { new (dst) CallableT(std::move(f)); }
+    template <typename T, typename U> void Construct(U &&callable)
+    {
+        if constexpr (std::is_same_v<T, std::nullptr_t>) {
+            invoke = detail::__small_function_empty<Result, Args...>;
+            ops    = nullptr;
+        }
+        else if constexpr (fitsInline<T>) {
+            using Impl = detail::__small_function_inline<T>;
+            new (storage) T(std::forward<U>(callable));
+            invoke = Impl::template Invoke<Result, Args...>;
+            ops    = std::is_trivially_copyable_v<T> ? nullptr : &Impl::ops;
+        }
+        else {
+            static_assert(!std::is_same_v<Overflow, OverflowAssert>,
+                          "function is too large for buffer");
+            using Impl = detail::__small_function_heap<T>;
+            Impl::Construct(storage, std::forward<U>(callable), Overflow::Resource());
+            invoke = Impl::template Invoke<Result, Args...>;
+            ops    = &Impl::ops;
+        }
+    }
 
-    private:
-        T f;
-    };
+    template <std::size_t BufferSizeT>
+    void CopyFrom(const SmallFunction<Result(Args...), BufferSizeT, Overflow> &other)
+    {
+        if (other.ops)
+            other.ops->clone(storage, other.storage);
+        else
+            std::memcpy(storage, other.storage, BufferSizeT);
+        invoke = other.invoke;
+        ops    = other.ops;
+    }
 
-    template <typename Dummy> class CallableT<std::nullptr_t, Dummy> : public ICallable
+    template <std::size_t BufferSizeT>
+    void MoveFrom(SmallFunction<Result(Args...), BufferSizeT, Overflow> &other) noexcept
     {
-    public:
-        CallableT(const std::nullptr_t &t) {}
-        ~CallableT() noexcept override = default;
+        if (other.ops && other.ops->move)
+            other.ops->move(storage, other.storage);
+        else
+            std::memcpy(storage, other.storage, BufferSizeT);
+        invoke       = other.invoke;
+        ops          = other.ops;
+        other.invoke = detail::__small_function_empty<Result, Args...>;
+        other.ops    = nullptr;
+    }
 
-        bool   IsNotEmpty() const noexcept override { return false; }
-        Result Invoke(Args... args) override { throw std::bad_function_call(); }
-        void   Clone(void *dst) const noexcept override { new (dst) CallableT(nullptr); }
-        void   Move(void *dst) noexcept override { new (dst) CallableT(nullptr); }
-    };
+    void Destroy() noexcept
+    {
+        if (ops)
+            ops->destroy(storage);
+    }
 
-    char storage[BufferSize + 8];
+    InvokeFn                            invoke;
+    const detail::__small_function_ops *ops;
+    alignas(void *) char storage[BufferSize];
 };
 
+template <typename F> SmallFunction(F) -> SmallFunction<signature_of_t<F>>;
+
 }  // namespace ftc
@@ -0,0 +1,227 @@
+/**
+ * @file SmallUniqueFunction.hpp
+ * Small(static) Unique Function
+ *
+ * A move-only function container with static buffer, which can hold move-only callables such
+ * as lambdas capturing std::unique_ptr or std::promise.
+ */
+
+#pragma once
+
+#include "FTC/Function/SmallFunction.hpp"
+
+namespace ftc {
+
+template <typename, std::size_t BufferSize = 24, typename Overflow = OverflowAssert>
+class SmallUniqueFunction; /* undefined */
+
+namespace detail {
+
+    template <typename T> struct __is_small_unique_function
+    {
+        static constexpr bool value = false;
+    };
+
+    template <typename Result, typename... Args, std::size_t BufferSize, typename Overflow>
+    struct __is_small_unique_function<SmallUniqueFunction<Result(Args...), BufferSize, Overflow>>
+    {
+        static constexpr bool value = true;
+    };
+
+}  // namespace detail
+
+
+/// Move-only function container with static storage size
+///
+/// Same layout and dispatch as SmallFunction, but never copies the contained callable, so the
+/// callable only needs to be move constructible. A SmallFunction can be moved into a
+/// SmallUniqueFunction with the same signature and overflow policy.
+///
+/// @tparam Result Function return type
+/// @tparam Args Function argument types
+/// @tparam BufferSize Storage size, default is 24.
+/// @tparam Overflow Policy for callables larger than the buffer, see SmallFunctionOverflow.
+template <typename Result, typename... Args, std::size_t BufferSize, typename Overflow>
+class SmallUniqueFunction<Result(Args...), BufferSize, Overflow>
+{
+    static_assert(BufferSize >= 8, "buffer size should be at least 8");
+
+    template <typename, std::size_t, typename> friend class SmallUniqueFunction;
+
+public:
+    SmallUniqueFunction() noexcept
+        : invoke(detail::__small_function_empty<Result, Args...>)
+        , ops(nullptr)
+    {}
+    ~SmallUniqueFunction() { Destroy(); }
+
+    SmallUniqueFunction(const SmallUniqueFunction &) = delete;
+    SmallUniqueFunction &operator=(const SmallUniqueFunction &) = delete;
+
+    SmallUniqueFunction(SmallUniqueFunction &&other) noexcept { MoveFrom(other); }
+
+    template <std::size_t BufferSizeT>
+    SmallUniqueFunction(SmallUniqueFunction<Result(Args...), BufferSizeT, Overflow> &&t) noexcept
+    {
+        static_assert(BufferSizeT <= BufferSize, "buffer size is smaller than needed");
+        MoveFrom(t);
+    }
+
+    template <std::size_t BufferSizeT>
+    SmallUniqueFunction(SmallFunction<Result(Args...), BufferSizeT, Overflow> &&t) noexcept
+    {
+        static_assert(BufferSizeT <= BufferSize, "buffer size is smaller than needed");
+        MoveFrom(t);
+    }
+
+    template <typename T,
+              typename = typename std::enable_if_t<
+                  !std::is_function<T>::value
+                  && !detail::__is_small_function<typename std::decay<T>::type>::value
+                  && !detail::__is_small_unique_function<typename std::decay<T>::type>::value>>
+    SmallUniqueFunction(T &&t) noexcept(fitsInline<typename std::decay<T>::type>)
+    {
+        Construct<typename std::decay<T>::type>(std::forward<T>(t));
+    }
+
+    template <typename T,
+              typename = typename std::enable_if_t<
+                  !std::is_function<T>::value
+                  && !detail::__is_small_function<typename std::decay<T>::type>::value
+                  && !detail::__is_small_unique_function<typename std::decay<T>::type>::value>>
+    SmallUniqueFunction &operator=(T &&t) noexcept(fitsInline<typename std::decay<T>::type>)
+    {
+        using CallableType = typename std::decay<T>::type;
+        if constexpr (fitsInline<CallableType>) {
+            Destroy();
+            Construct<CallableType>(std::forward<T>(t));
+        }
+        else {
+            // Allocate before releasing the current callable, in case allocation throws
+            SmallUniqueFunction tmp(std::forward<T>(t));
+            *this = std::move(tmp);
+        }
+        return *this;
+    }
+
+    SmallUniqueFunction &operator=(SmallUniqueFunction &&other) noexcept
+    {
+        if (this == &other)
+            return *this;
+        Destroy();
+        MoveFrom(other);
+        return *this;
+    }
+
+    template <std::size_t BufferSizeT>
+    SmallUniqueFunction &
+    operator=(SmallUniqueFunction<Result(Args...), BufferSizeT, Overflow> &&t) noexcept
+    {
+        static_assert(BufferSizeT <= BufferSize, "buffer size is smaller than needed");
+        Destroy();
+        MoveFrom(t);
+        return *this;
+    }
+
+    template <std::size_t BufferSizeT>
+    SmallUniqueFunction &
+    operator=(SmallFunction<Result(Args...), BufferSizeT, Overflow> &&t) noexcept
+    {
+        static_assert(BufferSizeT <= BufferSize, "buffer size is smaller than needed");
+        Destroy();
+        MoveFrom(t);
+        return *this;
+    }
+
+    /// Checks if a function is contained
+    explicit operator bool() const noexcept
+    {
+        return invoke != detail::__small_function_empty<Result, Args...>;
+    }
+
+    /// Invokes the function
+    ///
+    /// Throws std::bad_function_call if no function is contained.
+    ///
+    /// @param args Function arguments
+    /// @return Function call result
+    Result operator()(Args... args) const
+    {
+        return invoke(const_cast<char *>(storage), std::forward<Args>(args)...);
+    }
+
+    /// @name Compares a SmallUniqueFunction with nullptr
+    /// @{
+    friend bool operator==(const SmallUniqueFunction &f, std::nullptr_t) noexcept
+    {
+        return !(bool)f;
+    }
+    friend bool operator==(std::nullptr_t, const SmallUniqueFunction &f) noexcept
+    {
+        return !(bool)f;
+    }
+    friend bool operator!=(const SmallUniqueFunction &f, std::nullptr_t) noexcept
+    {
+        return (bool)f;
+    }
+    friend bool operator!=(std::nullptr_t, const SmallUniqueFunction &f) noexcept
+    {
+        return (bool)f;
+    }
+    /// @}
+
+private:
+    using InvokeFn = Result (*)(void *, Args &&...);
+
+    /// Checks if a callable of type T is stored inline
+    template <typename T>
+    static constexpr bool fitsInline = sizeof(T) <= BufferSize && alignof(T) <= alignof(void *);
+
+    template <typename T, typename U> void Construct(U &&callable)
+    {
+        if constexpr (std::is_same_v<T, std::nullptr_t>) {
+            invoke = detail::__small_function_empty<Result, Args...>;
+            ops    = nullptr;
+        }
+        else if constexpr (fitsInline<T>) {
+            using Impl = detail::__small_function_inline<T>;
+            new (storage) T(std::forward<U>(callable));
+            invoke = Impl::template Invoke<Result, Args...>;
+            ops    = std::is_trivially_copyable_v<T> ? nullptr : &Impl::unique_ops;
+        }
+        else {
+            static_assert(!std::is_same_v<Overflow, OverflowAssert>,
+                          "function is too large for buffer");
+            using Impl = detail::__small_function_heap<T>;
+            Impl::Construct(storage, std::forward<U>(callable), Overflow::Resource());
+            invoke = Impl::template Invoke<Result, Args...>;
+            ops    = &Impl::unique_ops;
+        }
+    }
+
+    template <typename Other> void MoveFrom(Other &other) noexcept
+    {
+        if (other.ops && other.ops->move)
+            other.ops->move(storage, other.storage);
+        else
+            std::memcpy(storage, other.storage, sizeof(other.storage));
+        invoke       = other.invoke;
+        ops          = other.ops;
+        other.invoke = detail::__small_function_empty<Result, Args...>;
+        other.ops    = nullptr;
+    }
+
+    void Destroy() noexcept
+    {
+        if (ops)
+            ops->destroy(storage);
+    }
+
+    InvokeFn                            invoke;
+    const detail::__small_function_ops *ops;
+    alignas(void *) char storage[BufferSize];
+};
+
+template <typename F> SmallUniqueFunction(F) -> SmallUniqueFunction<signature_of_t<F>>;
+
+}  // namespace ftc
@@ -0,0 +1,651 @@
+/**
+ * @file Reclaim.hpp
+ * Safe memory reclamation for lock-free structures
+ *
+ * Epoch based reclamation and hazard pointers, deferring the destruction of nodes unlinked from
+ * a lock-free structure until no reader can still access them, without any reference counting on
+ * the read path.
+ */
+
+#pragma once
+
+#include "FTC/Detail/CacheLine.hpp"
+
+#include <algorithm>        // for std::find, std::rotate, std::sort, std::binary_search
+#include <atomic>           // for std::atomic, std::atomic_thread_fence
+#include <cstddef>          // for std::size_t
+#include <cstdint>          // for std::uint64_t
+#include <memory>           // for std::default_delete
+#include <memory_resource>  // for std::pmr::memory_resource, std::pmr::vector
+#include <mutex>            // for std::mutex, std::lock_guard
+#include <new>              // for placement new
+#include <stdexcept>        // for std::length_error
+#include <type_traits>      // for std::decay_t
+#include <utility>          // for std::forward, std::move
+#include <vector>           // for std::vector
+
+namespace ftc {
+
+namespace detail {
+
+    /// A retired object and its type erased deleter, allocated from the resource of its domain
+    struct __retired
+    {
+        __retired *   next;
+        std::uint64_t epoch;  ///< Epoch of retirement, unused by hazard pointers
+        const void *  ptr;
+        void (*reclaim)(__retired *self, std::pmr::memory_resource *resource);
+    };
+
+    template <typename Deleter> struct __retired_with : __retired
+    {
+        Deleter deleter;
+    };
+
+    /// List of retired objects, only accessed by the thread owning it
+    struct __retired_list
+    {
+        __retired * head     = nullptr;
+        std::size_t count    = 0;
+        std::size_t nextScan = 0;  ///< Count triggering the next reclamation attempt
+
+        void Push(__retired *r) noexcept
+        {
+            r->next = head;
+            head    = r;
+            count++;
+        }
+
+        /// Reclaims the objects satisfying pred. Deleters may retire other objects meanwhile.
+        template <typename Pred> void ReclaimIf(Pred pred, std::pmr::memory_resource *resource)
+        {
+            __retired *r = head;
+            head         = nullptr;
+            count        = 0;
+            while (r) {
+                __retired *next = r->next;
+                if (pred(r))
+                    r->reclaim(r, resource);
+                else
+                    Push(r);
+                r = next;
+            }
+        }
+    };
+
+    template <typename T, typename Deleter>
+    __retired *MakeRetired(std::pmr::memory_resource *resource, T *ptr, Deleter &&deleter)
+    {
+        using Node = __retired_with<std::decay_t<Deleter>>;
+
+        void *mem = resource->allocate(sizeof(Node), alignof(Node));
+        try {
+            return ::new (mem) Node {
+                {nullptr,
+                 0,
+                 ptr,
+                 [](__retired *self, std::pmr::memory_resource *resource) {
+                     Node *node = static_cast<Node *>(self);
+                     node->deleter(static_cast<T *>(const_cast<void *>(node->ptr)));
+                     node->~Node();
+                     resource->deallocate(node, sizeof(Node), alignof(Node));
+                 }},
+                std::forward<Deleter>(deleter)};
+        }
+        catch (...) {
+            resource->deallocate(mem, sizeof(Node), alignof(Node));
+            throw;
+        }
+    }
+
+    /// Per-thread state of a reclamation domain
+    struct __reclaim_record
+    {
+        std::atomic<bool> inUse {true};
+        __reclaim_record *next = nullptr;
+        __retired_list    retired;
+
+        /// Guards and hazard pointers using the record, only accessed by the owning thread
+        std::size_t holders = 0;
+        /// Set when the record left the thread table while held, the last holder releases it
+        bool detached = false;
+
+        void Hold() noexcept { holders++; }
+        void Unhold() noexcept
+        {
+            if (--holders == 0 && detached) {
+                detached = false;
+                inUse.store(false, std::memory_order_release);
+            }
+        }
+    };
+
+    /// Thread records of a domain, owned by the domain and reused after their thread exits, so
+    /// that objects retired by an exited thread are reclaimed by the next thread adopting them.
+    template <typename Record> class __reclaim_registry
+    {
+    public:
+        explicit __reclaim_registry(std::pmr::memory_resource *resource);
+        ~__reclaim_registry();
+
+        /// Gets the record of the calling thread
+        Record *Local();
+
+        /// Gets the first record, others follow by next
+        Record *Head() const noexcept { return head.load(std::memory_order_acquire); }
+
+        std::pmr::memory_resource *Resource() const noexcept { return resource; }
+
+    private:
+        /// Records of domains used by the current thread, most recently used first
+        struct ThreadTable
+        {
+            struct Entry
+            {
+                std::uint64_t id;  ///< Domain id, never reused
+                Record *      record;
+            };
+
+            static constexpr std::size_t NumEntries = 4;
+            Entry                        entries[NumEntries] {};
+
+            ~ThreadTable()
+            {
+                std::lock_guard<std::mutex> lock(Mutex());
+                for (Entry &e : entries)
+                    Release(e);
+            }
+        };
+
+        Record *AcquireRecord();
+
+        /// Releases a thread table entry if its domain is alive, or leaves the record to its
+        /// holders if it is still held. Requires Mutex().
+        static void Release(typename ThreadTable::Entry &e) noexcept;
+
+        static std::mutex &Mutex() noexcept
+        {
+            static std::mutex mutex;
+            return mutex;
+        }
+        /// Ids of alive domains, guarded by Mutex()
+        static std::vector<std::uint64_t> &AliveIds()
+        {
+            static std::vector<std::uint64_t> ids;
+            return ids;
+        }
+        static ThreadTable &LocalTable() noexcept
+        {
+            thread_local ThreadTable table;
+            return table;
+        }
+
+        std::pmr::memory_resource *resource;
+        std::uint64_t              id;
+        std::atomic<Record *>      head {nullptr};
+    };
+
+}  // namespace detail
+
+/// @defgroup Reclaim Memory Reclamation
+/// @{
+
+/// Epoch based reclamation domain
+///
+/// Readers enter a critical section with Pin(), during which any object they load from the
+/// structure stays alive. Writers unlink an object then Retire() it: it is destroyed once the
+/// global epoch advanced twice, which happens only after every thread pinned at the time of
+/// retirement has left its critical section.
+///
+/// Pinning costs a store and a fence on a thread-local record, much cheaper than a shared_ptr
+/// copy and independent of the number of readers, but a reader stalled inside a critical
+/// section delays the reclamation of all objects. Critical sections may be nested.
+///
+/// Retired records are allocated from the memory resource of the domain, which must be
+/// thread-safe (the default resource, or a concurrent_pool_resource).
+class EpochDomain
+{
+public:
+    class Guard;
+
+    /// Number of retired objects of a thread before trying to reclaim them
+    static constexpr std::size_t ReclaimThreshold = 64;
+
+    explicit EpochDomain(std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+        : registry(resource)
+    {}
+
+    /// Destroys all retired objects, no thread may be pinned or use the domain any longer.
+    ~EpochDomain();
+
+    EpochDomain(const EpochDomain &) = delete;
+    EpochDomain &operator=(const EpochDomain &) = delete;
+
+    /// Gets the process-wide domain
+    static EpochDomain &Default()
+    {
+        static EpochDomain domain;
+        return domain;
+    }
+
+    /// Enters a critical section, left when the returned guard is destroyed or released
+    [[nodiscard]] Guard Pin();
+
+    /// Destroys ptr with deleter(ptr) once no thread can access it any longer
+    /// @note ptr must be already unlinked, so that threads pinning later cannot load it.
+    template <typename T, typename Deleter = std::default_delete<T>>
+    void Retire(T *ptr, Deleter &&deleter = Deleter());
+
+    /// Tries to advance the epoch, then reclaims the safe objects retired by the calling thread
+    void Collect();
+
+    /// Gets the current global epoch
+    [[nodiscard]] std::uint64_t Epoch() const noexcept
+    {
+        return epoch.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] std::pmr::memory_resource *Resource() const noexcept
+    {
+        return registry.Resource();
+    }
+
+private:
+    struct alignas(detail::__cache_line_size) Record : detail::__reclaim_record
+    {
+        explicit Record(std::pmr::memory_resource *) {}
+
+        /// Pinned epoch shifted left by one, with the lowest bit set while pinned
+        std::atomic<std::uint64_t> state {0};
+        std::size_t                nesting = 0;
+    };
+
+    bool TryAdvance();
+    void Reclaim(Record *record);
+
+    alignas(detail::__cache_line_size) std::atomic<std::uint64_t> epoch {1};
+    detail::__reclaim_registry<Record> registry;
+};
+
+/// Critical section of an EpochDomain
+class EpochDomain::Guard
+{
+public:
+    Guard(Guard &&other) noexcept : record(other.record) { other.record = nullptr; }
+    Guard(const Guard &) = delete;
+    Guard &operator=(const Guard &) = delete;
+    ~Guard() { Release(); }
+
+    /// Leaves the critical section before destruction
+    void Release() noexcept
+    {
+        if (!record)
+            return;
+        if (--record->nesting == 0)
+            record->state.store(0, std::memory_order_release);
+        record->Unhold();
+        record = nullptr;
+    }
+
+private:
+    friend class EpochDomain;
+    explicit Guard(Record *record) noexcept : record(record) { record->Hold(); }
+
+    Record *record;
+};
+
+class HazardPointer;
+
+/// Hazard pointer reclamation domain
+///
+/// Readers publish each pointer they are about to dereference in a HazardPointer, which keeps
+/// that single object alive. Retire() destroys an object once no hazard pointer holds it.
+///
+/// Protecting costs a store and a fence per object, more than an epoch guard covering a whole
+/// traversal, but a stalled reader only holds back the few objects it protects, which bounds the
+/// memory waiting for reclamation.
+///
+/// Retired records are allocated from the memory resource of the domain, which must be
+/// thread-safe (the default resource, or a concurrent_pool_resource).
+class HazardDomain
+{
+public:
+    /// Number of hazard pointers a thread can hold at the same time
+    static constexpr std::size_t SlotsPerThread = 8;
+
+    /// Number of retired objects of a thread before trying to reclaim them
+    static constexpr std::size_t ReclaimThreshold = 64;
+
+    explicit HazardDomain(std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+        : registry(resource)
+    {}
+
+    /// Destroys all retired objects, no hazard pointer may be alive any longer.
+    ~HazardDomain();
+
+    HazardDomain(const HazardDomain &) = delete;
+    HazardDomain &operator=(const HazardDomain &) = delete;
+
+    /// Gets the process-wide domain
+    static HazardDomain &Default()
+    {
+        static HazardDomain domain;
+        return domain;
+    }
+
+    /// Destroys ptr with deleter(ptr) once no hazard pointer holds it
+    /// @note ptr must be already unlinked, so that hazard pointers cannot protect it again.
+    template <typename T, typename Deleter = std::default_delete<T>>
+    void Retire(T *ptr, Deleter &&deleter = Deleter());
+
+    /// Reclaims the objects retired by the calling thread that are no longer protected
+    void Collect();
+
+    [[nodiscard]] std::pmr::memory_resource *Resource() const noexcept
+    {
+        return registry.Resource();
+    }
+
+private:
+    friend class HazardPointer;
+
+    struct alignas(detail::__cache_line_size) Record : detail::__reclaim_record
+    {
+        explicit Record(std::pmr::memory_resource *) {}
+
+        std::atomic<const void *> slots[SlotsPerThread] {};
+        unsigned                  usedSlots = 0;  ///< Bitmask of slots owned by a HazardPointer
+    };
+
+    void Reclaim(Record *record);
+
+    detail::__reclaim_registry<Record> registry;
+};
+
+/// A single-writer hazard pointer of a HazardDomain
+///
+/// Owns one of the hazard slots of the calling thread, it must be used and destroyed by the
+/// thread that created it.
+///
+/// Example:
+/// ```cpp
+/// HazardPointer hp;
+/// Node *node = hp.Protect(head);  // node cannot be destroyed until hp is reset
+/// ```
+class HazardPointer
+{
+public:
+    /// Acquires a hazard slot of the calling thread
+    /// @throw std::length_error if the thread already holds HazardDomain::SlotsPerThread
+    /// hazard pointers of this domain.
+    explicit HazardPointer(HazardDomain &domain = HazardDomain::Default());
+    ~HazardPointer();
+
+    HazardPointer(const HazardPointer &) = delete;
+    HazardPointer &operator=(const HazardPointer &) = delete;
+
+    /// Loads src and protects the loaded pointer, retrying until src is stable
+    template <typename T> T *Protect(const std::atomic<T *> &src) noexcept
+    {
+        T *ptr = src.load(std::memory_order_relaxed);
+        while (!TryProtect(ptr, src)) {}
+        return ptr;
+    }
+
+    /// Protects ptr if src still holds it, otherwise updates ptr with the value of src
+    /// @return Whether ptr is protected.
+    template <typename T> bool TryProtect(T *&ptr, const std::atomic<T *> &src) noexcept
+    {
+        T *expected = ptr;
+        Reset(expected);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        ptr = src.load(std::memory_order_acquire);
+        if (ptr == expected)
+            return true;
+        Reset();
+        return false;
+    }
+
+    /// Protects ptr, which must be known to be alive by other means
+    void Reset(const void *ptr = nullptr) noexcept { slot->store(ptr, std::memory_order_release); }
+
+private:
+    HazardDomain::Record *     record;
+    std::atomic<const void *> *slot;
+};
+
+/// @}
+
+}  // namespace ftc
+
+// -------------------------------------------------
+// Implementation
+
+template <typename Record>
+ftc::detail::__reclaim_registry<Record>::__reclaim_registry(std::pmr::memory_resource *resource)
+    : resource(resource)
+{
+    static std::atomic<std::uint64_t> nextId {1};
+    id = nextId.fetch_add(1, std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(Mutex());
+    AliveIds().push_back(id);
+}
+
+template <typename Record> ftc::detail::__reclaim_registry<Record>::~__reclaim_registry()
+{
+    {
+        // After this, exiting threads no longer touch the records of this domain
+        std::lock_guard<std::mutex> lock(Mutex());
+        std::vector<std::uint64_t> &ids = AliveIds();
+        ids.erase(std::find(ids.begin(), ids.end(), id));
+    }
+
+    for (typename ThreadTable::Entry &e : LocalTable().entries) {
+        if (e.id == id)
+            e = {};
+    }
+
+    for (Record *record = Head(); record;) {
+        Record *next = static_cast<Record *>(record->next);
+        record->~Record();
+        resource->deallocate(record, sizeof(Record), alignof(Record));
+        record = next;
+    }
+}
+
+template <typename Record> Record *ftc::detail::__reclaim_registry<Record>::Local()
+{
+    ThreadTable &table = LocalTable();
+    if (table.entries[0].id == id)
+        return table.entries[0].record;
+
+    for (std::size_t i = 1; i < ThreadTable::NumEntries; i++) {
+        if (table.entries[i].id == id) {
+            std::rotate(table.entries, table.entries + i, table.entries + i + 1);
+            return table.entries[0].record;
+        }
+    }
+
+    // First use in this thread
+    typename ThreadTable::Entry &last = table.entries[ThreadTable::NumEntries - 1];
+    if (last.id) {
+        std::lock_guard<std::mutex> lock(Mutex());
+        Release(last);
+    }
+    last = {id, AcquireRecord()};
+    std::rotate(table.entries, &last, &last + 1);
+    return table.entries[0].record;
+}
+
+template <typename Record> Record *ftc::detail::__reclaim_registry<Record>::AcquireRecord()
+{
+    // Reuse a record left by an exited thread, keeping its retired objects
+    for (Record *record = Head(); record; record = static_cast<Record *>(record->next)) {
+        bool expected = false;
+        if (!record->inUse.load(std::memory_order_relaxed)
+            && record->inUse.compare_exchange_strong(expected, true, std::memory_order_acquire))
+            return record;
+    }
+
+    Record *record = ::new (resource->allocate(sizeof(Record), alignof(Record))) Record(resource);
+    Record *next   = head.load(std::memory_order_relaxed);
+    do
+        record->next = next;
+    while (!head.compare_exchange_weak(next,
+                                       record,
+                                       std::memory_order_release,
+                                       std::memory_order_relaxed));
+    return record;
+}
+
+template <typename Record>
+void ftc::detail::__reclaim_registry<Record>::Release(typename ThreadTable::Entry &e) noexcept
+{
+    if (!e.id)
+        return;
+
+    std::vector<std::uint64_t> &ids = AliveIds();
+    if (std::find(ids.begin(), ids.end(), e.id) != ids.end()) {
+        if (e.record->holders)
+            e.record->detached = true;
+        else
+            e.record->inUse.store(false, std::memory_order_release);
+    }
+    e = {};
+}
+
+inline ftc::EpochDomain::~EpochDomain()
+{
+    // Deleters may retire more objects
+    for (Record *record = registry.Head(); record; record = static_cast<Record *>(record->next))
+        while (record->retired.head)
+            record->retired.ReclaimIf([](detail::__retired *) { return true; }, Resource());
+}
+
+inline ftc::EpochDomain::Guard ftc::EpochDomain::Pin()
+{
+    Record *record = registry.Local();
+    if (record->nesting++ == 0) {
+        // Announces the epoch then reads it again after the fence, so that a writer retiring an
+        // object this thread could still load reads an epoch not older than the announced one.
+        std::uint64_t e = epoch.load(std::memory_order_relaxed);
+        for (;;) {
+            record->state.store(e << 1 | 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            std::uint64_t current = epoch.load(std::memory_order_seq_cst);
+            if (current == e)
+                break;
+            e = current;
+        }
+    }
+    return Guard(record);
+}
+
+template <typename T, typename Deleter>
+void ftc::EpochDomain::Retire(T *ptr, Deleter &&deleter)
+{
+    Record *           record = registry.Local();
+    detail::__retired *retired =
+        detail::MakeRetired(Resource(), ptr, std::forward<Deleter>(deleter));
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    retired->epoch = epoch.load(std::memory_order_seq_cst);
+    record->retired.Push(retired);
+    if (record->retired.count >= std::max(ReclaimThreshold, record->retired.nextScan))
+        Reclaim(record);
+}
+
+inline void ftc::EpochDomain::Collect()
+{
+    Reclaim(registry.Local());
+}
+
+inline bool ftc::EpochDomain::TryAdvance()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::uint64_t e = epoch.load(std::memory_order_seq_cst);
+    for (Record *record = registry.Head(); record; record = static_cast<Record *>(record->next)) {
+        std::uint64_t state = record->state.load(std::memory_order_seq_cst);
+        if ((state & 1) && (state >> 1) != e)
+            return false;
+    }
+    return epoch.compare_exchange_strong(e, e + 1, std::memory_order_seq_cst);
+}
+
+inline void ftc::EpochDomain::Reclaim(Record *record)
+{
+    // Objects are safe two epochs after their retirement
+    if (TryAdvance())
+        TryAdvance();
+    std::uint64_t e = epoch.load(std::memory_order_seq_cst);
+    record->retired.ReclaimIf([e](detail::__retired *r) { return r->epoch + 2 <= e; },
+                              Resource());
+    // Objects kept by a slow reader are retried after ReclaimThreshold more retirements
+    record->retired.nextScan = record->retired.count + ReclaimThreshold;
+}
+
+inline ftc::HazardDomain::~HazardDomain()
+{
+    // Deleters may retire more objects
+    for (Record *record = registry.Head(); record; record = static_cast<Record *>(record->next))
+        while (record->retired.head)
+            record->retired.ReclaimIf([](detail::__retired *) { return true; }, Resource());
+}
+
+template <typename T, typename Deleter>
+void ftc::HazardDomain::Retire(T *ptr, Deleter &&deleter)
+{
+    Record *record = registry.Local();
+    record->retired.Push(detail::MakeRetired(Resource(), ptr, std::forward<Deleter>(deleter)));
+    if (record->retired.count >= std::max(ReclaimThreshold, record->retired.nextScan))
+        Reclaim(record);
+}
+
+inline void ftc::HazardDomain::Collect()
+{
+    Reclaim(registry.Local());
+}
+
+inline void ftc::HazardDomain::Reclaim(Record *record)
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    std::pmr::vector<const void *> hazards(Resource());
+    hazards.reserve(SlotsPerThread * 4);
+    for (Record *r = registry.Head(); r; r = static_cast<Record *>(r->next)) {
+        for (std::atomic<const void *> &slot : r->slots) {
+            if (const void *ptr = slot.load(std::memory_order_acquire))
+                hazards.push_back(ptr);
+        }
+    }
+    std::sort(hazards.begin(), hazards.end());
+
+    record->retired.ReclaimIf(
+        [&](detail::__retired *r) {
+            return !std::binary_search(hazards.begin(), hazards.end(), r->ptr);
+        },
+        Resource());
+    // Protected objects are retried after the list doubled, keeping Retire() O(1)
+    record->retired.nextScan = 2 * record->retired.count;
+}
+
+inline ftc::HazardPointer::HazardPointer(HazardDomain &domain) : record(domain.registry.Local())
+{
+    for (unsigned i = 0; i < HazardDomain::SlotsPerThread; i++) {
+        if (!(record->usedSlots & (1u << i))) {
+            record->usedSlots |= 1u << i;
+            slot = &record->slots[i];
+            record->Hold();
+            return;
+        }
+    }
+    throw std::length_error("HazardPointer: too many hazard pointers in this thread");
+}
+
+inline ftc::HazardPointer::~HazardPointer()
+{
+    Reset();
+    record->usedSlots &= ~(1u << (slot - record->slots));
+    record->Unhold();
+}
@@ -0,0 +1,430 @@
+/**
+ * @file ConcurrentPoolResource.hpp
+ * Concurrent pool memory resource
+ *
+ * A thread-safe pool resource with size-class free lists, thread-local caches and a lock-free
+ * global refill path.
+ */
+
+#pragma once
+
+#include "FTC/Container/LockFreeCircularQueue.hpp"
+#include "FTC/Detail/CacheLine.hpp"
+
+#include <algorithm>        // for std::min, std::max
+#include <array>            // for std::array
+#include <atomic>           // for std::atomic
+#include <cstddef>          // for std::size_t, std::max_align_t
+#include <cstdint>          // for std::uint64_t
+#include <deque>            // for std::deque
+#include <memory_resource>  // for std::memory_resource, std::pmr::pool_options
+#include <mutex>            // for std::mutex, std::lock_guard
+#include <new>              // for placement new
+#include <optional>         // for std::optional
+#include <vector>           // for std::vector
+
+namespace ftc {
+
+namespace pmr {
+
+    /// Thread-safe pool resource that scales across cores
+    ///
+    /// Requests up to largest_required_pool_block bytes are served from size classes of powers
+    /// of 2, requests aligned to more than max_block_align go to the upstream resource. Each
+    /// thread keeps a small free list per size class, so allocation and deallocation normally
+    /// touch only thread-local memory. Free blocks move between threads in batches through a
+    /// lock-free queue per size class. Only carving a new chunk, oversized or over-aligned
+    /// requests and thread registration lock a mutex.
+    ///
+    /// Memory is returned to the upstream resource when the resource is destroyed.
+    class concurrent_pool_resource : public std::pmr::memory_resource
+    {
+    public:
+        static constexpr std::size_t min_block_size       = 8;
+        static constexpr std::size_t default_largest_block = 4096;
+        static constexpr std::size_t max_largest_block     = 65536;
+        static constexpr std::size_t max_block_align       = 4096;  ///< Alignment of chunks
+
+        concurrent_pool_resource()
+            : concurrent_pool_resource(std::pmr::pool_options {}, std::pmr::get_default_resource())
+        {}
+
+        explicit concurrent_pool_resource(std::pmr::memory_resource *_upstream)
+            : concurrent_pool_resource(std::pmr::pool_options {}, _upstream)
+        {}
+
+        /// @param opts largest_required_pool_block is rounded up to a power of 2 in
+        /// [min_block_size, max_largest_block]. max_blocks_per_chunk bounds chunk growth.
+        explicit concurrent_pool_resource(
+            const std::pmr::pool_options &opts,
+            std::pmr::memory_resource *   _upstream = std::pmr::get_default_resource());
+
+        ~concurrent_pool_resource();
+
+        concurrent_pool_resource(const concurrent_pool_resource &) = delete;
+        concurrent_pool_resource &operator=(const concurrent_pool_resource &) = delete;
+
+        [[nodiscard]] std::pmr::memory_resource *upstream_resource() const noexcept
+        {
+            return upstream;
+        }
+
+        [[nodiscard]] std::pmr::pool_options options() const noexcept { return opts; }
+
+    private:
+        /// Count of size classes up to max_largest_block
+        static constexpr std::size_t max_classes = 14;
+        static_assert(min_block_size << (max_classes - 1) == max_largest_block);
+
+        struct free_block
+        {
+            free_block *next;
+        };
+
+        /// Placed after the blocks of a chunk, so that blocks start at the chunk alignment
+        struct chunk_header
+        {
+            chunk_header *next;
+            void *        base;  ///< Start of the chunk, as allocated from upstream
+            std::size_t   bytes;
+            std::size_t   align;
+        };
+
+        /// Free list of one size class in a thread cache
+        struct local_list
+        {
+            free_block *head;
+            std::size_t count;
+        };
+
+        /// Per-thread cache, owned by the resource and reused after its thread exits.
+        struct alignas(ftc::detail::__cache_line_size) thread_cache
+        {
+            std::atomic<bool> in_use;
+            thread_cache *    next;
+            std::array<local_list, max_classes> lists;  ///< First num_classes lists are used
+        };
+
+        /// Global state of one size class
+        struct size_class
+        {
+            using batch_queue = LockFreeCircularQueue<free_block *,
+                                                      DynamicSize,
+                                                      false,
+                                                      false,
+                                                      BusySpinWait,
+                                                      CompactLayout>;
+
+            size_class(std::pmr::memory_resource *r) : batches(1024, r) {}
+
+            batch_queue batches;      ///< Full batches of free blocks
+            std::size_t chunk_blocks;  ///< Block count of the next chunk, guarded by mutex
+        };
+
+        /// Caches of resources used by the current thread, most recently used first
+        struct thread_table
+        {
+            struct entry
+            {
+                std::uint64_t id;  ///< Resource id, never reused
+                thread_cache *cache;
+            };
+
+            static constexpr std::size_t num_entries = 4;
+            entry                        entries[num_entries] {};
+
+            ~thread_table()
+            {
+                std::lock_guard<std::mutex> lock(registry_mutex());
+                for (entry &e : entries)
+                    release_entry(e);
+            }
+        };
+
+        void *do_allocate(std::size_t bytes, std::size_t align) override;
+        void  do_deallocate(void *ptr, std::size_t bytes, std::size_t align) override;
+        bool  do_is_equal(const memory_resource &that) const noexcept override
+        {
+            return this == &that;
+        }
+
+        /// Gets the size class index of a request, or num_classes for oversized or over-aligned
+        /// requests.
+        std::size_t class_of(std::size_t bytes, std::size_t align) const noexcept;
+        std::size_t block_size(std::size_t c) const noexcept { return min_block_size << c; }
+        std::size_t batch_blocks(std::size_t c) const noexcept
+        {
+            return std::clamp<std::size_t>(16384 / block_size(c), 4, 64);
+        }
+
+        thread_cache *local_cache();
+        thread_cache *acquire_cache();
+        void          refill(thread_cache *cache, std::size_t c);
+        void          flush(thread_cache *cache, std::size_t c) noexcept;
+
+        /// Releases a thread table entry if its resource is alive. Requires registry_mutex().
+        static void release_entry(thread_table::entry &e) noexcept;
+
+        static std::mutex &registry_mutex() noexcept
+        {
+            static std::mutex mutex;
+            return mutex;
+        }
+        /// Ids of alive resources, guarded by registry_mutex()
+        static std::vector<std::uint64_t> &alive_ids()
+        {
+            static std::vector<std::uint64_t> ids;
+            return ids;
+        }
+        static thread_table &local_table() noexcept
+        {
+            thread_local thread_table table;
+            return table;
+        }
+
+        memory_resource *         upstream;
+        std::pmr::pool_options    opts;
+        std::size_t               num_classes;
+        std::uint64_t             id;
+        std::deque<size_class>    classes;  ///< Not movable, so kept in a deque
+        std::atomic<thread_cache *> caches {nullptr};
+        std::mutex                mutex;  ///< Guards upstream and chunks
+        chunk_header *            chunks = nullptr;
+    };
+
+}  // namespace pmr
+
+}  // namespace ftc
+
+inline ftc::pmr::concurrent_pool_resource::concurrent_pool_resource(
+    const std::pmr::pool_options &_opts,
+    std::pmr::memory_resource *   _upstream)
+    : upstream(_upstream)
+    , opts(_opts)
+{
+    std::size_t largest = opts.largest_required_pool_block ? opts.largest_required_pool_block
+                                                           : default_largest_block;
+    largest             = std::clamp(largest, min_block_size, max_largest_block);
+    for (num_classes = 1; block_size(num_classes - 1) < largest; num_classes++) {}
+    opts.largest_required_pool_block = block_size(num_classes - 1);
+    if (opts.max_blocks_per_chunk == 0)
+        opts.max_blocks_per_chunk = 1024;
+
+    for (std::size_t c = 0; c < num_classes; c++) {
+        classes.emplace_back(upstream);
+        classes.back().chunk_blocks = batch_blocks(c);
+    }
+
+    static std::atomic<std::uint64_t> next_id {1};
+    id = next_id.fetch_add(1, std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(registry_mutex());
+    alive_ids().push_back(id);
+}
+
+inline ftc::pmr::concurrent_pool_resource::~concurrent_pool_resource()
+{
+    {
+        // After this, exiting threads no longer touch the caches of this resource
+        std::lock_guard<std::mutex> lock(registry_mutex());
+        std::vector<std::uint64_t> &ids = alive_ids();
+        ids.erase(std::find(ids.begin(), ids.end(), id));
+    }
+
+    thread_table &table = local_table();
+    for (thread_table::entry &e : table.entries) {
+        if (e.id == id)
+            e = {};
+    }
+
+    for (thread_cache *cache = caches.load(std::memory_order_acquire); cache;) {
+        thread_cache *next = cache->next;
+        cache->~thread_cache();
+        upstream->deallocate(cache, sizeof(thread_cache), alignof(thread_cache));
+        cache = next;
+    }
+    for (chunk_header *chunk = chunks; chunk;) {
+        chunk_header *next = chunk->next;
+        upstream->deallocate(chunk->base, chunk->bytes, chunk->align);
+        chunk = next;
+    }
+}
+
+inline std::size_t ftc::pmr::concurrent_pool_resource::class_of(std::size_t bytes,
+                                                                std::size_t align) const noexcept
+{
+    // Blocks of a class are only aligned to their size up to max_block_align
+    std::size_t size = std::max(bytes, align);
+    if (size > opts.largest_required_pool_block || align > max_block_align)
+        return num_classes;
+
+    std::size_t c = 0;
+    while (block_size(c) < size)
+        c++;
+    return c;
+}
+
+inline void *ftc::pmr::concurrent_pool_resource::do_allocate(std::size_t bytes, std::size_t align)
+{
+    std::size_t c = class_of(bytes, align);
+    if (c == num_classes) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return upstream->allocate(bytes, align);
+    }
+
+    thread_cache *cache = local_cache();
+    local_list &  list  = cache->lists[c];
+    if (!list.head)
+        refill(cache, c);
+
+    free_block *block = list.head;
+    list.head         = block->next;
+    list.count--;
+    return block;
+}
+
+inline void
+ftc::pmr::concurrent_pool_resource::do_deallocate(void *ptr, std::size_t bytes, std::size_t align)
+{
+    std::size_t c = class_of(bytes, align);
+    if (c == num_classes) {
+        std::lock_guard<std::mutex> lock(mutex);
+        upstream->deallocate(ptr, bytes, align);
+        return;
+    }
+
+    thread_cache *cache = local_cache();
+    local_list &  list  = cache->lists[c];
+    list.head           = new (ptr) free_block {list.head};
+    list.count++;
+    if (list.count >= 2 * batch_blocks(c))
+        flush(cache, c);
+}
+
+inline ftc::pmr::concurrent_pool_resource::thread_cache *
+ftc::pmr::concurrent_pool_resource::local_cache()
+{
+    thread_table &table = local_table();
+    if (table.entries[0].id == id)
+        return table.entries[0].cache;
+
+    for (std::size_t i = 1; i < thread_table::num_entries; i++) {
+        if (table.entries[i].id == id) {
+            std::rotate(table.entries, table.entries + i, table.entries + i + 1);
+            return table.entries[0].cache;
+        }
+    }
+
+    // First use in this thread
+    thread_table::entry &last = table.entries[thread_table::num_entries - 1];
+    if (last.id) {
+        std::lock_guard<std::mutex> lock(registry_mutex());
+        release_entry(last);
+    }
+    last = {id, acquire_cache()};
+    std::rotate(table.entries, &last, &last + 1);
+    return table.entries[0].cache;
+}
+
+inline ftc::pmr::concurrent_pool_resource::thread_cache *
+ftc::pmr::concurrent_pool_resource::acquire_cache()
+{
+    // Reuse a cache left by an exited thread, keeping its blocks
+    for (thread_cache *cache = caches.load(std::memory_order_acquire); cache;
+         cache               = cache->next) {
+        bool expected = false;
+        if (!cache->in_use.load(std::memory_order_relaxed)
+            && cache->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire))
+            return cache;
+    }
+
+    void *mem;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        mem = upstream->allocate(sizeof(thread_cache), alignof(thread_cache));
+    }
+    thread_cache *cache = new (mem) thread_cache {{true}, nullptr, {}};
+
+    cache->next = caches.load(std::memory_order_relaxed);
+    while (!caches.compare_exchange_weak(cache->next,
+                                         cache,
+                                         std::memory_order_release,
+                                         std::memory_order_relaxed)) {}
+    return cache;
+}
+
+inline void ftc::pmr::concurrent_pool_resource::refill(thread_cache *cache, std::size_t c)
+{
+    local_list &list = cache->lists[c];
+    size_class &sc   = classes[c];
+
+    if (std::optional<free_block *> batch = sc.batches.TryPop()) {
+        list = {*batch, batch_blocks(c)};
+        return;
+    }
+
+    // Carve a new chunk: keep one batch, publish the others
+    std::size_t size  = block_size(c);
+    std::size_t align = std::max(alignof(chunk_header), std::min(size, max_block_align));
+    std::size_t count;
+    char *      base;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        count           = sc.chunk_blocks;
+        sc.chunk_blocks = std::min(count * 2, std::max(opts.max_blocks_per_chunk, batch_blocks(c)));
+
+        // Blocks are multiples of alignof(chunk_header), so the header fits right after them
+        std::size_t bytes = count * size + sizeof(chunk_header);
+        base              = static_cast<char *>(upstream->allocate(bytes, align));
+        chunks = new (base + count * size) chunk_header {chunks, base, bytes, align};
+    }
+
+    std::size_t batch = batch_blocks(c);
+    for (std::size_t first = 0; first < count; first += batch) {
+        std::size_t n    = std::min(batch, count - first);
+        free_block *head = nullptr;
+        for (std::size_t i = first + n; i-- > first;)
+            head = new (base + i * size) free_block {head};
+
+        if (first == 0)
+            list = {head, n};
+        else if (n < batch || !sc.batches.TryPush(head)) {
+            // Partial batch, or global queue is full: keep it in this thread
+            free_block *tail = head;
+            while (tail->next)
+                tail = tail->next;
+            tail->next = list.head;
+            list       = {head, list.count + n};
+        }
+    }
+}
+
+inline void ftc::pmr::concurrent_pool_resource::flush(thread_cache *cache, std::size_t c) noexcept
+{
+    local_list &list  = cache->lists[c];
+    std::size_t batch = batch_blocks(c);
+
+    // Detach the first batch_blocks(c) blocks as a batch
+    free_block *head = list.head;
+    free_block *tail = head;
+    for (std::size_t i = 1; i < batch; i++)
+        tail = tail->next;
+
+    free_block *rest = tail->next;
+    tail->next       = nullptr;
+    if (classes[c].batches.TryPush(head))
+        list = {rest, list.count - batch};
+    else
+        tail->next = rest;  // global queue is full, keep the blocks
+}
+
+inline void ftc::pmr::concurrent_pool_resource::release_entry(thread_table::entry &e) noexcept
+{
+    if (!e.id)
+        return;
+
+    std::vector<std::uint64_t> &ids = alive_ids();
+    if (std::find(ids.begin(), ids.end(), e.id) != ids.end())
+        e.cache->in_use.store(false, std::memory_order_release);
+    e = {};
+}
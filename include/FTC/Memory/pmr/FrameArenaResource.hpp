@@ -0,0 +1,201 @@
+/**
+ * @file FrameArenaResource.hpp
+ * Frame arena memory resource
+ *
+ * A bump allocating pmr resource for objects that all die at the end of a frame (a request, a
+ * game frame...), reset in O(1) and reusing its chunks across frames.
+ */
+
+#pragma once
+
+#include <algorithm>        // for std::max
+#include <cstddef>          // for std::size_t, std::max_align_t
+#include <cstdint>          // for std::uintptr_t
+#include <memory_resource>  // for std::memory_resource
+#include <new>              // for placement new
+
+namespace ftc {
+
+namespace pmr {
+
+    /// Bump allocator with frame reset semantics
+    ///
+    /// Allocation bumps a pointer in the current chunk, deallocation does nothing. reset() ends
+    /// the frame in O(1): all chunks are kept and reused by the next frames, and are only
+    /// returned to the upstream resource by release() or destruction. mark() and rewind() (or a
+    /// scope) free everything allocated after a point, for nested lifetimes inside a frame.
+    ///
+    /// It is not thread-safe. Use one arena per thread, for example a thread_local instance, so
+    /// each thread bumps its own chunks without synchronization.
+    class frame_arena_resource : public std::pmr::memory_resource
+    {
+        struct chunk_header
+        {
+            chunk_header *next;
+            std::size_t   size;  ///< Size of the chunk, including the header
+        };
+
+    public:
+        static constexpr std::size_t default_chunk_size = 4096;
+
+        /// Position in the arena, see mark() and rewind()
+        struct mark_type
+        {
+            chunk_header *chunk;
+            char *        ptr;
+            std::size_t   used;
+        };
+
+        /// Rewinds the arena to its position at construction on scope exit
+        class scope
+        {
+        public:
+            explicit scope(frame_arena_resource &_arena) : arena(_arena), m(_arena.mark()) {}
+            ~scope() { arena.rewind(m); }
+
+            scope(const scope &) = delete;
+            scope &operator=(const scope &) = delete;
+
+        private:
+            frame_arena_resource &arena;
+            mark_type             m;
+        };
+
+        explicit frame_arena_resource(
+            std::size_t                _initial_chunk_size = default_chunk_size,
+            std::pmr::memory_resource *_upstream           = std::pmr::get_default_resource())
+            : upstream(_upstream)
+            , next_chunk_size(std::max(_initial_chunk_size, 2 * sizeof(chunk_header)))
+        {}
+
+        explicit frame_arena_resource(std::pmr::memory_resource *_upstream)
+            : frame_arena_resource(default_chunk_size, _upstream)
+        {}
+
+        ~frame_arena_resource() { release(); }
+
+        frame_arena_resource(const frame_arena_resource &) = delete;
+        frame_arena_resource &operator=(const frame_arena_resource &) = delete;
+
+        [[nodiscard]] std::pmr::memory_resource *upstream_resource() const noexcept
+        {
+            return upstream;
+        }
+
+        /// Ends the frame: all allocations become invalid, chunks are kept for reuse.
+        void reset() noexcept { rewind({first, first ? data_of(first) : nullptr, 0}); }
+
+        /// Returns all chunks to the upstream resource.
+        void release() noexcept
+        {
+            for (chunk_header *chunk = first; chunk;) {
+                chunk_header *next = chunk->next;
+                upstream->deallocate(chunk, chunk->size, alignof(std::max_align_t));
+                chunk = next;
+            }
+            first = current = nullptr;
+            ptr = end = nullptr;
+            used      = 0;
+            reserved  = 0;
+        }
+
+        /// Gets the current position, to free later allocations with rewind().
+        [[nodiscard]] mark_type mark() const noexcept { return {current, ptr, used}; }
+
+        /// Frees all allocations made after a mark of the current frame.
+        void rewind(const mark_type &m) noexcept
+        {
+            current = m.chunk;
+            ptr     = m.ptr;
+            end     = current ? reinterpret_cast<char *>(current) + current->size : nullptr;
+            used    = m.used;
+        }
+
+        /// Gets the bytes allocated in the current frame, including alignment padding.
+        [[nodiscard]] std::size_t used_bytes() const noexcept { return used; }
+
+        /// Gets the bytes of all chunks held from the upstream resource.
+        [[nodiscard]] std::size_t reserved_bytes() const noexcept { return reserved; }
+
+    private:
+        static char *data_of(chunk_header *chunk) noexcept
+        {
+            return reinterpret_cast<char *>(chunk) + sizeof(chunk_header);
+        }
+
+        static char *align_up(char *p, std::size_t align) noexcept
+        {
+            std::uintptr_t v = reinterpret_cast<std::uintptr_t>(p);
+            return p + ((align - v % align) % align);
+        }
+
+        void *do_allocate(std::size_t bytes, std::size_t align) override
+        {
+            char *p = ptr ? align_up(ptr, align) : nullptr;
+            if (!p || bytes > std::size_t(end - p))
+                p = next_chunk(bytes, align);
+
+            used += static_cast<std::size_t>(p + bytes - ptr);
+            ptr = p + bytes;
+            return p;
+        }
+
+        void do_deallocate(void *, std::size_t, std::size_t) noexcept override {}
+
+        bool do_is_equal(const memory_resource &that) const noexcept override
+        {
+            return this == &that;
+        }
+
+        /// Moves to the next reusable chunk that fits, or allocates a new one after current.
+        /// @return Aligned pointer with room for bytes in the new current chunk.
+        char *next_chunk(std::size_t bytes, std::size_t align)
+        {
+            chunk_header **link = current ? &current->next : &first;
+            for (chunk_header *chunk = *link; chunk; chunk = chunk->next) {
+                char *p = align_up(data_of(chunk), align);
+                if (bytes <= std::size_t(reinterpret_cast<char *>(chunk) + chunk->size - p)) {
+                    enter(chunk);
+                    return p;
+                }
+                // Too small for this request, skipped (but kept) for this frame
+                link = &chunk->next;
+                enter(chunk);
+            }
+
+            std::size_t max_align = alignof(std::max_align_t);
+            std::size_t padding   = align > max_align ? align - max_align : 0;
+            std::size_t size = std::max(next_chunk_size, sizeof(chunk_header) + padding + bytes);
+            void *mem = upstream->allocate(size, max_align);
+            next_chunk_size = std::max(next_chunk_size, size) * 2;
+            reserved += size;
+
+            chunk_header *chunk = new (mem) chunk_header {nullptr, size};
+            *link               = chunk;
+            enter(chunk);
+            return align_up(data_of(chunk), align);
+        }
+
+        void enter(chunk_header *chunk) noexcept
+        {
+            // Space left in the previous chunk counts as used in this frame
+            if (current)
+                used += static_cast<std::size_t>(end - ptr);
+            current = chunk;
+            ptr     = data_of(chunk);
+            end     = reinterpret_cast<char *>(chunk) + chunk->size;
+        }
+
+        memory_resource *upstream;
+        std::size_t      next_chunk_size;
+        chunk_header *   first    = nullptr;
+        chunk_header *   current  = nullptr;
+        char *           ptr      = nullptr;  ///< Bump pointer in current chunk
+        char *           end      = nullptr;  ///< End of current chunk
+        std::size_t      used     = 0;
+        std::size_t      reserved = 0;
+    };
+
+}  // namespace pmr
+
+}  // namespace ftc
@@ -0,0 +1,140 @@
+/**
+ * @file HugePageResource.hpp
+ * Huge page memory resource
+ *
+ * A pmr resource that maps large allocations directly from the OS, backed by huge pages when
+ * possible, to reduce TLB misses on big arrays.
+ */
+
+#pragma once
+
+#include <cstddef>          // for std::size_t
+#include <memory_resource>  // for std::memory_resource
+#include <new>              // for std::bad_alloc
+
+#if defined(__linux__)
+    #include <sys/mman.h>  // for mmap, munmap, madvise
+#elif defined(_WIN32)
+    #include "FTC/Detail/Windows.hpp"  // for VirtualAlloc, VirtualFree, GetLargePageMinimum
+#endif
+
+namespace ftc {
+
+namespace pmr {
+
+    /// Memory resource for large, long-lived allocations such as queue slot arrays.
+    ///
+    /// Allocations of at least min_bytes are mapped from the OS in multiples of the huge page
+    /// size. On Linux, explicit huge pages (MAP_HUGETLB) are tried first, then transparent huge
+    /// pages are requested with madvise. On Windows, large pages are used if the process holds
+    /// the lock pages privilege. Smaller or over-aligned allocations go to the upstream resource.
+    class huge_page_resource : public std::pmr::memory_resource
+    {
+    public:
+        static constexpr std::size_t default_huge_page_size = 2 * 1024 * 1024;
+
+        explicit huge_page_resource(
+            std::size_t                _min_bytes = default_huge_page_size / 2,
+            std::pmr::memory_resource *_upstream  = std::pmr::get_default_resource())
+            : upstream(_upstream)
+            , min_bytes(_min_bytes)
+            , page_size(query_huge_page_size())
+        {}
+        ~huge_page_resource() = default;
+
+        [[nodiscard]] std::pmr::memory_resource *upstream_resource() const noexcept
+        {
+            return upstream;
+        }
+
+        /// Gets the huge page size allocations are rounded up to.
+        [[nodiscard]] std::size_t huge_page_size() const noexcept { return page_size; }
+
+    private:
+        bool is_mapped(std::size_t bytes, std::size_t align) const noexcept
+        {
+#if defined(__linux__) || defined(_WIN32)
+            return bytes >= min_bytes && align <= page_size;
+#else
+            return false;
+#endif
+        }
+
+        std::size_t round_up(std::size_t bytes) const noexcept
+        {
+            return (bytes + page_size - 1) / page_size * page_size;
+        }
+
+        void *do_allocate(std::size_t bytes, std::size_t align) override
+        {
+            if (!is_mapped(bytes, align))
+                return upstream->allocate(bytes, align);
+
+            std::size_t size = round_up(bytes);
+            void *      ptr  = nullptr;
+#if defined(__linux__)
+            constexpr int prot  = PROT_READ | PROT_WRITE;
+            constexpr int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+    #ifdef MAP_HUGETLB
+            ptr = mmap(nullptr, size, prot, flags | MAP_HUGETLB, -1, 0);
+    #else
+            ptr = MAP_FAILED;
+    #endif
+            if (ptr == MAP_FAILED) {
+                ptr = mmap(nullptr, size, prot, flags, -1, 0);
+                if (ptr == MAP_FAILED)
+                    throw std::bad_alloc();
+    #ifdef MADV_HUGEPAGE
+                madvise(ptr, size, MADV_HUGEPAGE);
+    #endif
+            }
+#elif defined(_WIN32)
+            ptr = VirtualAlloc(nullptr,
+                               size,
+                               MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES,
+                               PAGE_READWRITE);
+            if (!ptr)
+                ptr = VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+            if (!ptr)
+                throw std::bad_alloc();
+#endif
+            return ptr;
+        }
+
+        void do_deallocate(void *ptr, std::size_t bytes, std::size_t align) override
+        {
+            if (!is_mapped(bytes, align)) {
+                upstream->deallocate(ptr, bytes, align);
+                return;
+            }
+
+#if defined(__linux__)
+            munmap(ptr, round_up(bytes));
+#elif defined(_WIN32)
+            VirtualFree(ptr, 0, MEM_RELEASE);
+#endif
+        }
+
+        bool do_is_equal(const memory_resource &that) const noexcept override
+        {
+            return this == &that;
+        }
+
+        static std::size_t query_huge_page_size() noexcept
+        {
+#if defined(_WIN32)
+            std::size_t size = GetLargePageMinimum();
+            return size ? size : default_huge_page_size;
+#else
+            return default_huge_page_size;
+#endif
+        }
+
+        memory_resource *upstream;
+        std::size_t      min_bytes;
+        std::size_t      page_size;
+    };
+
+}  // namespace pmr
+
+}  // namespace ftc
@@ -2,27 +2,68 @@
  * @file ProfileResource.hpp
  * Profile memory resource
  *
- * A pmr resource that records memory allocation stats.
+ * A pmr resource that records memory allocation stats, size and alignment histograms and sampled
+ * call sites.
  */
 
 #pragma once
 
+#include <algorithm>        // for std::sort, std::equal, std::copy
+#include <atomic>           // for std::atomic
+#include <chrono>           // for std::chrono::steady_clock
+#include <cstddef>          // for std::size_t
+#include <cstdint>          // for std::uintptr_t
 #include <memory_resource>  // for std::memory_resource
-#include <set>              // for std::pmr::set
+#include <mutex>            // for std::mutex, std::lock_guard
+#include <ostream>          // for std::ostream
+#include <stdexcept>        // for std::invalid_argument
+#include <vector>           // for std::vector
+
+#if defined(_WIN32)
+    #include "FTC/Detail/Windows.hpp"  // for CaptureStackBackTrace
+#elif __has_include(<execinfo.h>)
+    #include <execinfo.h>  // for backtrace
+#endif
 
 namespace ftc {
 
 namespace pmr {
 
+    /// Memory resource that counts the allocations passed to its upstream resource
+    ///
+    /// The counters are relaxed atomics, so a profile_resource can be shared between threads.
+    /// In record_mode::validate, every allocation is also recorded in an open-addressing hash
+    /// table guarded by a mutex, and deallocate() throws std::invalid_argument on pointers,
+    /// sizes or alignments that do not match a live allocation. In record_mode::none, nothing
+    /// is recorded and the overhead is a few atomic additions per call.
+    ///
+    /// Allocation sizes and alignments are counted in log2 buckets. With set_sample_interval(n),
+    /// the call stack of every nth allocate() call is attributed in a small call site table, as
+    /// raw return addresses to symbolize offline (addr2line, dladdr). Without a stack capture API
+    /// on the platform, only the immediate return address is kept. get_snapshot() and dump()
+    /// export everything at once.
     class profile_resource : public std::pmr::memory_resource
     {
     public:
+        enum class record_mode {
+            none,      ///< Only count
+            validate,  ///< Record live allocations and validate deallocations
+        };
+
+        explicit profile_resource(
+            std::pmr::memory_resource *_upstream        = std::pmr::get_default_resource(),
+            std::pmr::memory_resource *_record_upstream = std::pmr::get_default_resource())
+            : profile_resource(record_mode::validate, _upstream, _record_upstream)
+        {}
+
         explicit profile_resource(
+            record_mode                _mode,
             std::pmr::memory_resource *_upstream        = std::pmr::get_default_resource(),
             std::pmr::memory_resource *_record_upstream = std::pmr::get_default_resource())
             : upstream(_upstream)
+            , mode(_mode)
             , alloc_rec(_record_upstream)
-            , stat {}
+            , start_time(clock::now())
         {}
         ~profile_resource() = default;
 
@@ -31,44 +72,200 @@ namespace pmr {
             return upstream;
         }
 
+        [[nodiscard]] record_mode get_record_mode() const noexcept { return mode; }
+
         struct statistic
         {
-            std::size_t bytes_allocated;
-            std::size_t bytes_in_use;
-            std::size_t bytes_highestest;
+            std::size_t bytes_allocated;    ///< Total bytes of all allocate() calls
+            std::size_t bytes_in_use;       ///< Bytes allocated but not yet deallocated
+            std::size_t bytes_highestest;   ///< High-water mark of bytes_in_use
+            std::size_t num_allocations;    ///< Number of allocate() calls
+            std::size_t num_deallocations;  ///< Number of deallocate() calls
+        };
+
+        /// Gets a snapshot of the counters. Under concurrent use, each counter is read
+        /// separately, so the snapshot may be slightly inconsistent.
+        [[nodiscard]] statistic get_stat() const noexcept
+        {
+            return {stat.bytes_allocated.load(std::memory_order_relaxed),
+                    stat.bytes_in_use.load(std::memory_order_relaxed),
+                    stat.bytes_highestest.load(std::memory_order_relaxed),
+                    stat.num_allocations.load(std::memory_order_relaxed),
+                    stat.num_deallocations.load(std::memory_order_relaxed)};
+        }
+
+        /// Number of log2 buckets of the histograms
+        static constexpr std::size_t num_buckets = sizeof(std::size_t) * 8;
+        /// Capacity of the call site table
+        static constexpr std::size_t max_call_sites = 64;
+        /// Maximal captured stack depth of a call site
+        static constexpr std::size_t max_frames = 8;
+
+        /// Gets the histogram bucket of a value: bucket i counts values in [2^i, 2^(i+1)),
+        /// bucket 0 counts also 0.
+        static constexpr std::size_t bucket_of(std::size_t value) noexcept
+        {
+            std::size_t bucket = 0;
+            while (value >>= 1)
+                bucket++;
+            return bucket;
+        }
+
+        /// Sets the call site sampling interval. 0 disables sampling (the default).
+        void set_sample_interval(std::size_t every_nth) noexcept
+        {
+            sample_interval.store(every_nth, std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] std::size_t get_sample_interval() const noexcept
+        {
+            return sample_interval.load(std::memory_order_relaxed);
+        }
+
+        struct call_site
+        {
+            void *      frames[max_frames];  ///< Return addresses, innermost first
+            std::size_t num_frames;
+            std::size_t count;  ///< Number of samples from this call site
+            std::size_t bytes;  ///< Total bytes of the sampled allocations
         };
 
-        [[nodiscard]] statistic get_stat() const noexcept { return stat; }
+        struct snapshot
+        {
+            statistic   stat;
+            double      elapsed_seconds;  ///< Time since construction
+            std::size_t size_histogram[num_buckets];
+            std::size_t alignment_histogram[num_buckets];
+
+            std::vector<call_site> call_sites;       ///< Sorted by bytes, descending
+            std::size_t            dropped_samples;  ///< Samples lost as the table was full
+
+            double allocation_rate() const noexcept
+            {
+                return elapsed_seconds > 0 ? stat.num_allocations / elapsed_seconds : 0;
+            }
+            double deallocation_rate() const noexcept
+            {
+                return elapsed_seconds > 0 ? stat.num_deallocations / elapsed_seconds : 0;
+            }
+            double byte_rate() const noexcept
+            {
+                return elapsed_seconds > 0 ? stat.bytes_allocated / elapsed_seconds : 0;
+            }
+        };
+
+        /// Gets a snapshot of all counters, histograms and sampled call sites.
+        [[nodiscard]] snapshot get_snapshot() const
+        {
+            snapshot snap;
+            snap.stat = get_stat();
+            snap.elapsed_seconds = std::chrono::duration<double>(clock::now() - start_time).count();
+            for (std::size_t i = 0; i < num_buckets; i++) {
+                snap.size_histogram[i]      = size_hist[i].load(std::memory_order_relaxed);
+                snap.alignment_histogram[i] = align_hist[i].load(std::memory_order_relaxed);
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(site_mutex);
+                snap.call_sites.assign(sites, sites + num_sites);
+                snap.dropped_samples = dropped_samples;
+            }
+            std::sort(snap.call_sites.begin(),
+                      snap.call_sites.end(),
+                      [](const call_site &a, const call_site &b) { return a.bytes > b.bytes; });
+            return snap;
+        }
+
+        /// Writes a snapshot as "key value" lines, one metric per line.
+        static void dump(std::ostream &os, const snapshot &snap)
+        {
+            os << "bytes_allocated " << snap.stat.bytes_allocated << '\n'
+               << "bytes_in_use " << snap.stat.bytes_in_use << '\n'
+               << "bytes_highest " << snap.stat.bytes_highestest << '\n'
+               << "num_allocations " << snap.stat.num_allocations << '\n'
+               << "num_deallocations " << snap.stat.num_deallocations << '\n'
+               << "elapsed_seconds " << snap.elapsed_seconds << '\n'
+               << "allocation_rate " << snap.allocation_rate() << '\n'
+               << "deallocation_rate " << snap.deallocation_rate() << '\n'
+               << "byte_rate " << snap.byte_rate() << '\n';
+            for (std::size_t i = 0; i < num_buckets; i++) {
+                if (snap.size_histogram[i])
+                    os << "size_bucket{le=" << ((std::size_t(2) << i) - 1) << "} "
+                       << snap.size_histogram[i] << '\n';
+            }
+            for (std::size_t i = 0; i < num_buckets; i++) {
+                if (snap.alignment_histogram[i])
+                    os << "alignment_bucket{eq=" << (std::size_t(1) << i) << "} "
+                       << snap.alignment_histogram[i] << '\n';
+            }
+            for (const call_site &site : snap.call_sites) {
+                os << "call_site{stack=";
+                for (std::size_t i = 0; i < site.num_frames; i++)
+                    os << (i ? ";" : "") << site.frames[i];
+                os << "} " << site.count << ' ' << site.bytes << '\n';
+            }
+            if (snap.dropped_samples)
+                os << "dropped_samples " << snap.dropped_samples << '\n';
+        }
+
+        void dump(std::ostream &os) const { dump(os, get_snapshot()); }
 
     private:
         void *do_allocate(std::size_t bytes, std::size_t align) override
         {
             void *ptr = upstream->allocate(bytes, align);
-            alloc_rec.insert({ptr, bytes, align});
+            if (mode == record_mode::validate) {
+                std::lock_guard<std::mutex> lock(rec_mutex);
+                try {
+                    alloc_rec.insert({ptr, bytes, align});
+                }
+                catch (...) {
+                    upstream->deallocate(ptr, bytes, align);
+                    throw;
+                }
+            }
+
+            std::size_t n = stat.num_allocations.fetch_add(1, std::memory_order_relaxed);
+            size_hist[bucket_of(bytes)].fetch_add(1, std::memory_order_relaxed);
+            align_hist[bucket_of(align)].fetch_add(1, std::memory_order_relaxed);
+
+            std::size_t interval = sample_interval.load(std::memory_order_relaxed);
+            if (interval && n % interval == 0)
+                sample(bytes);
 
-            stat.bytes_allocated += bytes;
-            stat.bytes_in_use += bytes;
-            if (stat.bytes_allocated > stat.bytes_highestest)
-                stat.bytes_highestest = stat.bytes_allocated;
+            stat.bytes_allocated.fetch_add(bytes, std::memory_order_relaxed);
+            std::size_t in_use = stat.bytes_in_use.fetch_add(bytes, std::memory_order_relaxed);
+            in_use += bytes;
 
+            std::size_t highest = stat.bytes_highestest.load(std::memory_order_relaxed);
+            while (in_use > highest
+                   && !stat.bytes_highestest.compare_exchange_weak(highest,
+                                                                   in_use,
+                                                                   std::memory_order_relaxed)) {}
             return ptr;
         }
 
         void do_deallocate(void *ptr, std::size_t bytes, std::size_t align) override
         {
-            auto recIt = alloc_rec.find({ptr, bytes, align});
+            if (mode == record_mode::validate) {
+                std::lock_guard<std::mutex> lock(rec_mutex);
+                const allocation_record *rec = alloc_rec.find(ptr);
 
-            if (recIt == alloc_rec.end())
-                throw std::invalid_argument("deallocate: invalid pointer");
-            else if (recIt->size != bytes)
-                throw std::invalid_argument("deallocate: size mismatch");
-            else if (recIt->alignment != align)
-                throw std::invalid_argument("deallocate: align mismatch");
+                if (!rec)
+                    throw std::invalid_argument("deallocate: invalid pointer");
+                else if (rec->size != bytes)
+                    throw std::invalid_argument("deallocate: size mismatch");
+                else if (rec->alignment != align)
+                    throw std::invalid_argument("deallocate: align mismatch");
+
+                // Erase before upstream can hand out the same pointer to another thread
+                alloc_rec.erase(ptr);
+            }
 
             upstream->deallocate(ptr, bytes, align);
 
-            alloc_rec.erase(recIt);
-            stat.bytes_in_use -= bytes;
+            stat.num_deallocations.fetch_add(1, std::memory_order_relaxed);
+            stat.bytes_in_use.fetch_sub(bytes, std::memory_order_relaxed);
         }
 
         bool do_is_equal(const memory_resource &that) const noexcept override
@@ -76,21 +273,175 @@ namespace pmr {
             return this == &that;
         }
 
+        /// Captures the current call stack, skipping the frames inside profile_resource.
+        static std::size_t capture_stack(void **frames) noexcept
+        {
+#if defined(_WIN32)
+            return CaptureStackBackTrace(2, DWORD(max_frames), frames, nullptr);
+#elif __has_include(<execinfo.h>)
+            constexpr int skip = 2;
+            void *        buffer[max_frames + skip];
+            int           n = backtrace(buffer, int(max_frames + skip));
+            std::copy(buffer + std::min(n, skip), buffer + n, frames);
+            return std::size_t(n > skip ? n - skip : 0);
+#else
+            frames[0] = __builtin_return_address(0);
+            return 1;
+#endif
+        }
+
+        void sample(std::size_t bytes) noexcept
+        {
+            call_site site {};
+            site.num_frames = capture_stack(site.frames);
+
+            std::lock_guard<std::mutex> lock(site_mutex);
+            for (std::size_t i = 0; i < num_sites; i++) {
+                if (sites[i].num_frames == site.num_frames
+                    && std::equal(site.frames, site.frames + site.num_frames, sites[i].frames)) {
+                    sites[i].count++;
+                    sites[i].bytes += bytes;
+                    return;
+                }
+            }
+
+            if (num_sites < max_call_sites) {
+                site.count        = 1;
+                site.bytes        = bytes;
+                sites[num_sites++] = site;
+            }
+            else
+                dropped_samples++;
+        }
+
         struct allocation_record
         {
             void *      ptr;
             std::size_t size;
             std::size_t alignment;
+        };
 
-            friend bool operator<(const allocation_record &a, const allocation_record &b) noexcept
+        /// Linear probing hash table of live allocations, keyed by pointer
+        class record_table
+        {
+        public:
+            explicit record_table(std::pmr::memory_resource *_upstream) : upstream(_upstream) {}
+            ~record_table()
             {
-                return a.ptr < b.ptr;
+                if (slots)
+                    upstream->deallocate(slots,
+                                         capacity * sizeof(allocation_record),
+                                         alignof(allocation_record));
             }
+
+            record_table(const record_table &) = delete;
+            record_table &operator=(const record_table &) = delete;
+
+            void insert(const allocation_record &rec)
+            {
+                // Keep load factor under 1/2
+                if (2 * (count + 1) > capacity)
+                    rehash(capacity ? 2 * capacity : 64);
+
+                std::size_t i = index_of(rec.ptr);
+                while (slots[i].ptr && slots[i].ptr != rec.ptr)
+                    i = (i + 1) & (capacity - 1);
+                if (!slots[i].ptr)
+                    count++;
+                slots[i] = rec;
+            }
+
+            const allocation_record *find(void *ptr) const noexcept
+            {
+                if (!count)
+                    return nullptr;
+                for (std::size_t i = index_of(ptr); slots[i].ptr; i = (i + 1) & (capacity - 1)) {
+                    if (slots[i].ptr == ptr)
+                        return &slots[i];
+                }
+                return nullptr;
+            }
+
+            /// Erases a present record with backward shift, so no tombstones are needed.
+            void erase(void *ptr) noexcept
+            {
+                std::size_t mask = capacity - 1;
+                std::size_t hole = static_cast<std::size_t>(find(ptr) - slots);
+                for (std::size_t i = (hole + 1) & mask; slots[i].ptr; i = (i + 1) & mask) {
+                    // Move the record into the hole if its probe sequence passes the hole
+                    std::size_t home = index_of(slots[i].ptr);
+                    if (((i - home) & mask) >= ((i - hole) & mask)) {
+                        slots[hole] = slots[i];
+                        hole        = i;
+                    }
+                }
+                slots[hole].ptr = nullptr;
+                count--;
+            }
+
+        private:
+            std::size_t index_of(void *ptr) const noexcept
+            {
+                // Fibonacci hashing, low bits of pointers are mostly zero
+                std::uint64_t h = std::uint64_t(reinterpret_cast<std::uintptr_t>(ptr))
+                                  * 0x9E3779B97F4A7C15ull;
+                return static_cast<std::size_t>(h >> 32) & (capacity - 1);
+            }
+
+            void rehash(std::size_t new_capacity)
+            {
+                void *mem = upstream->allocate(new_capacity * sizeof(allocation_record),
+                                               alignof(allocation_record));
+                allocation_record *old_slots    = slots;
+                std::size_t        old_capacity = capacity;
+
+                slots    = static_cast<allocation_record *>(mem);
+                capacity = new_capacity;
+                count    = 0;
+                for (std::size_t i = 0; i < capacity; i++)
+                    slots[i].ptr = nullptr;
+                for (std::size_t i = 0; i < old_capacity; i++) {
+                    if (old_slots[i].ptr)
+                        insert(old_slots[i]);
+                }
+
+                if (old_slots)
+                    upstream->deallocate(old_slots,
+                                         old_capacity * sizeof(allocation_record),
+                                         alignof(allocation_record));
+            }
+
+            std::pmr::memory_resource *upstream;
+            allocation_record *        slots    = nullptr;
+            std::size_t                capacity = 0;  ///< Power of 2, or 0
+            std::size_t                count    = 0;
         };
 
-        memory_resource *                upstream;
-        statistic                        stat;
-        std::pmr::set<allocation_record> alloc_rec;
+        struct atomic_statistic
+        {
+            std::atomic<std::size_t> bytes_allocated {0};
+            std::atomic<std::size_t> bytes_in_use {0};
+            std::atomic<std::size_t> bytes_highestest {0};
+            std::atomic<std::size_t> num_allocations {0};
+            std::atomic<std::size_t> num_deallocations {0};
+        };
+
+        using clock = std::chrono::steady_clock;
+
+        memory_resource *        upstream;
+        record_mode              mode;
+        atomic_statistic         stat;
+        std::mutex               rec_mutex;  ///< Guards alloc_rec
+        record_table             alloc_rec;
+        clock::time_point        start_time;
+        std::atomic<std::size_t> size_hist[num_buckets] {};
+        std::atomic<std::size_t> align_hist[num_buckets] {};
+        std::atomic<std::size_t> sample_interval {0};
+
+        mutable std::mutex site_mutex;  ///< Guards sites, num_sites and dropped_samples
+        call_site          sites[max_call_sites];
+        std::size_t        num_sites       = 0;
+        std::size_t        dropped_samples = 0;
     };
 
 }  // namespace pmr
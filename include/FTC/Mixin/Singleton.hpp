@@ -7,11 +7,22 @@
 
 #pragma once
 
+#include "FTC/Detail/CacheLine.hpp"
 #include "FTC/Traits/FunctionTraits.hpp"
 
-#include <atomic>  // for std::atomic
-#include <memory>  // for std::allocator_traits
-#include <mutex>   // for std::mutex
+#include <atomic>     // for std::atomic
+#include <cstddef>    // for std::size_t
+#include <cstdint>    // for std::uint64_t
+#include <memory>     // for std::allocator_traits, std::unique_ptr
+#include <mutex>      // for std::mutex
+#include <stdexcept>  // for std::logic_error
+#include <thread>      // for std::thread, std::this_thread
+
+#if defined(__linux__)
+    #include <sched.h>  // for sched_getcpu
+#elif defined(_WIN32)
+    #include "FTC/Detail/Windows.hpp"  // for GetCurrentProcessorNumberEx
+#endif
 
 namespace ftc {
 
@@ -89,7 +100,104 @@ public:
     }
 };
 
+/// Singleton Mixin with one instance per thread
+///
+/// Get() returns the instance of the calling thread without any synchronization, so that
+/// counters or caches hit from every thread no longer share a cache line. Instances are owned by
+/// the singleton: after a thread exits, its instance is adopted by the next new thread with its
+/// state intact (a counter keeps its counts), so their number is bounded by the peak number of
+/// threads.
+///
+/// ForEach() and Aggregate() visit every instance from any thread while their owners may be
+/// writing them, so fields read this way should be atomics (relaxed is enough for counters).
+/// @tparam T Singleton class
+/// @tparam CreateFunc A functor that returns a created prvalue of T
+template <class T, typename Creator = DefaultCreator<T>>
+class ThreadLocalSingleton : public ISingleton<T>
+{
+    static_assert(std::is_same_v<result_of_t<Creator>, T>,
+                  "Creator must be a function object which returns a value of type T");
+
+public:
+    /// Gets the instance of the calling thread
+    /// @note Instance is created or adopted on the first call of Get() in each thread
+    static T &Get();
+
+    /// Calls f(T &) on every instance, including the ones left by exited threads
+    template <typename F> static void ForEach(F &&f);
+
+    /// Folds all instances as init = op(init, instance), e.g. to sum per-thread counters
+    template <typename R, typename BinaryOp> static R Aggregate(R init, BinaryOp op);
+
+private:
+    struct Node;
+    struct NodeList;
+    struct ThreadHandle;
+
+    inline static NodeList nodes;
+};
+
+/// Singleton Mixin with one instance per CPU core
+///
+/// Get() returns the instance of the core the calling thread runs on (sched_getcpu() on Linux,
+/// GetCurrentProcessorNumberEx() on Windows, a hash of the thread id elsewhere). Compared with
+/// ThreadLocalSingleton, it needs far less instances when there are many threads, but a thread
+/// may migrate to another core even while using an instance: T must still be thread-safe, only
+/// mostly uncontended, typically atomics updated with relaxed read-modify-writes.
+/// @tparam T Singleton class
+/// @tparam CreateFunc A functor that returns a created prvalue of T
+template <class T, typename Creator = DefaultCreator<T>>
+class PerCoreSingleton : public ISingleton<T>
+{
+    static_assert(std::is_same_v<result_of_t<Creator>, T>,
+                  "Creator must be a function object which returns a value of type T");
+
+public:
+    /// Gets the instance of the current core
+    /// @note All instances are created on the first call of Get()
+    static T &Get()
+    {
+        Shards &shards = GetShards();
+        return shards.shards[CurrentCore() & shards.mask].instance;
+    }
+
+    /// Gets the number of instances, the power of two not less than the number of cores
+    static std::size_t NumInstances() { return GetShards().mask + 1; }
+
+    /// Calls f(T &) on every instance
+    template <typename F> static void ForEach(F &&f);
+
+    /// Folds all instances as init = op(init, instance), e.g. to sum per-core counters
+    template <typename R, typename BinaryOp> static R Aggregate(R init, BinaryOp op);
+
+private:
+    struct alignas(detail::__cache_line_size) Shard
+    {
+        Shard() : instance(Creator {}()) {}
+        T instance;
+    };
+    struct Shards
+    {
+        std::unique_ptr<Shard[]> shards;
+        std::size_t              mask;
+    };
+
+    static Shards &     GetShards();
+    static std::size_t CurrentCore();
+};
+
 /// Singleton Mixin with explicit lifetime control (thread-safe)
+///
+/// The instance can be destroyed by FreeInstance(), or hot-swapped by Replace(), while other
+/// threads are reading it through handles returned by Acquire(). Destruction is deferred until
+/// all handles acquired before the swap are released (an epoch based grace period like RCU), so
+/// readers never wait: acquiring a handle is two atomic increments on a counter shared by few
+/// threads, and only the thread swapping the instance waits for the grace period.
+///
+/// References returned by Get() are not protected and must not be used across FreeInstance().
+/// Since Replace() cannot wait for them, it refuses to run once Get() has been called on the
+/// current instance: use Acquire() to read an instance that may be replaced. A thread must not
+/// call FreeInstance() or Replace() while holding a handle itself, it would wait forever.
 /// @tparam T Singleton class
 /// @tparam CreateFunc A functor that returns a created prvalue of T
 /// @tparam Allocator Allocator to use for dynamic allocation
@@ -97,14 +205,26 @@ template <class T, typename Creator = DefaultCreator<T>, typename Allocator = st
 class DynamicSingleton : public ISingleton<T>
 {
 public:
+    class ReadHandle;
+
     /// Gets the singleton instance of class type T
     /// @return The singleton instance of class type T
     /// @note An instance will be created if one does not exist when called
     static T &Get();
 
-    /// Destroy the created instance and free its space if there is one
+    /// Gets a handle to the instance, which keeps it alive until the handle is released
+    /// @note An instance will be created if one does not exist when called
+    static ReadHandle Acquire();
+
+    /// Destroy the created instance and free its space if there is one, after all handles to
+    /// it have been released
     static void FreeInstance();
 
+    /// Replaces the instance by a new one constructed from args, then destroys the previous
+    /// instance after all handles to it have been released
+    /// @throw std::logic_error if Get() was called since the instance was last freed
+    template <typename... Args> static void Replace(Args &&... args);
+
 private:
     using AllocTy     = typename std::allocator_traits<Allocator>::template rebind_alloc<T>;
     using AllocTraits = typename std::allocator_traits<Allocator>::template rebind_traits<T>;
@@ -112,10 +232,53 @@ private:
     struct ExitGuard;
     template <typename AlTy, typename AlTraits, typename InCreator> struct ConstructPolicy;
 
-    inline static AllocTy          allocator;
-    inline static std::atomic<T *> instancePtr;
-    inline static std::mutex       mutex;
-    inline static ExitGuard        exitGuard;
+    /// Reader counters of both epoch parities, threads are spread over slots
+    struct alignas(detail::__cache_line_size) ReaderSlot
+    {
+        std::atomic<std::uint64_t> count[2];
+    };
+    static constexpr std::size_t NumReaderSlots = 16;
+
+    static T *  Create();
+    static void Synchronize();
+    static void Destroy(T *ptr);
+
+    inline static AllocTy                    allocator;
+    inline static std::atomic<T *>           instancePtr;
+    inline static std::atomic<bool>          referenced;  ///< Set by Get(), reset on free
+    inline static std::mutex                 mutex;
+    inline static ExitGuard                  exitGuard;
+    inline static std::atomic<std::uint64_t> epoch;
+    inline static ReaderSlot                 readerSlots[NumReaderSlots];
+};
+
+/// Handle keeping an instance of DynamicSingleton alive
+template <class T, typename Creator, typename Allocator>
+class DynamicSingleton<T, Creator, Allocator>::ReadHandle
+{
+public:
+    ReadHandle(ReadHandle &&other) noexcept : ptr(other.ptr), counter(other.counter)
+    {
+        other.counter = nullptr;
+    }
+    ReadHandle(const ReadHandle &) = delete;
+    ReadHandle &operator=(const ReadHandle &) = delete;
+    ~ReadHandle()
+    {
+        if (counter)
+            counter->fetch_sub(1, std::memory_order_release);
+    }
+
+    T &operator*() const noexcept { return *ptr; }
+    T *operator->() const noexcept { return ptr; }
+    T *get() const noexcept { return ptr; }
+
+private:
+    friend class DynamicSingleton;
+    ReadHandle(T *ptr, std::atomic<std::uint64_t> *counter) : ptr(ptr), counter(counter) {}
+
+    T *                         ptr;
+    std::atomic<std::uint64_t> *counter;
 };
 
 /// @}
@@ -166,20 +329,165 @@ struct DynamicSingleton<T, Creator, Allocator>::ConstructPolicy<AlTy, AlTraits,
     }
 };
 
+template <class T, typename Creator> struct ThreadLocalSingleton<T, Creator>::Node
+{
+    Node() : instance(Creator {}()) {}
+
+    T                 instance;
+    std::atomic<bool> inUse {true};
+    Node *            next = nullptr;
+};
+
+/// Intrusive list of all nodes, freed at exit
+template <class T, typename Creator> struct ThreadLocalSingleton<T, Creator>::NodeList
+{
+    ~NodeList()
+    {
+        for (Node *node = head.load(std::memory_order_acquire); node;) {
+            Node *next = node->next;
+            delete node;
+            node = next;
+        }
+    }
+
+    std::atomic<Node *> head {nullptr};
+};
+
+/// Owns a node during the lifetime of a thread
+template <class T, typename Creator> struct ThreadLocalSingleton<T, Creator>::ThreadHandle
+{
+    ThreadHandle()
+    {
+        // Adopt a node left by an exited thread, keeping its instance
+        for (node = nodes.head.load(std::memory_order_acquire); node; node = node->next) {
+            bool expected = false;
+            if (!node->inUse.load(std::memory_order_relaxed)
+                && node->inUse.compare_exchange_strong(expected, true, std::memory_order_acquire))
+                return;
+        }
+
+        node       = new Node;
+        node->next = nodes.head.load(std::memory_order_relaxed);
+        while (!nodes.head.compare_exchange_weak(node->next,
+                                                 node,
+                                                 std::memory_order_release,
+                                                 std::memory_order_relaxed)) {}
+    }
+    ~ThreadHandle() { node->inUse.store(false, std::memory_order_release); }
+
+    Node *node;
+};
+
+template <class T, typename Creator> T &ThreadLocalSingleton<T, Creator>::Get()
+{
+    thread_local ThreadHandle handle;
+    return handle.node->instance;
+}
+
+template <class T, typename Creator>
+template <typename F>
+void ThreadLocalSingleton<T, Creator>::ForEach(F &&f)
+{
+    for (Node *node = nodes.head.load(std::memory_order_acquire); node; node = node->next)
+        f(node->instance);
+}
+
+template <class T, typename Creator>
+template <typename R, typename BinaryOp>
+R ThreadLocalSingleton<T, Creator>::Aggregate(R init, BinaryOp op)
+{
+    ForEach([&](T &instance) { init = op(std::move(init), instance); });
+    return init;
+}
+
+template <class T, typename Creator>
+typename PerCoreSingleton<T, Creator>::Shards &PerCoreSingleton<T, Creator>::GetShards()
+{
+    static Shards shards = [] {
+        std::size_t n = 1;
+        while (n < std::thread::hardware_concurrency())
+            n *= 2;
+        return Shards {std::unique_ptr<Shard[]>(new Shard[n]), n - 1};
+    }();
+    return shards;
+}
+
+template <class T, typename Creator> std::size_t PerCoreSingleton<T, Creator>::CurrentCore()
+{
+#if defined(__linux__)
+    int cpu = sched_getcpu();
+    if (cpu >= 0)
+        return std::size_t(cpu);
+#elif defined(_WIN32)
+    // Cores are numbered within processor groups of at most 64
+    PROCESSOR_NUMBER number;
+    GetCurrentProcessorNumberEx(&number);
+    return std::size_t(number.Group) * 64 + number.Number;
+#endif
+    thread_local std::size_t threadHash = std::hash<std::thread::id> {}(std::this_thread::get_id());
+    return threadHash;
+}
+
+template <class T, typename Creator>
+template <typename F>
+void PerCoreSingleton<T, Creator>::ForEach(F &&f)
+{
+    Shards &shards = GetShards();
+    for (std::size_t i = 0; i <= shards.mask; i++)
+        f(shards.shards[i].instance);
+}
+
+template <class T, typename Creator>
+template <typename R, typename BinaryOp>
+R PerCoreSingleton<T, Creator>::Aggregate(R init, BinaryOp op)
+{
+    ForEach([&](T &instance) { init = op(std::move(init), instance); });
+    return init;
+}
+
 template <class T, typename Creator, typename Allocator>
 T &DynamicSingleton<T, Creator, Allocator>::Get()
+{
+    if (!referenced.load(std::memory_order_relaxed))
+        referenced.store(true, std::memory_order_relaxed);
+    return *Create();
+}
+
+template <class T, typename Creator, typename Allocator>
+T *DynamicSingleton<T, Creator, Allocator>::Create()
 {
     T *ptr = instancePtr.load(std::memory_order_acquire);
     if (!ptr) {
         std::scoped_lock lock(mutex);
         ptr = instancePtr.load(std::memory_order_relaxed);
         if (!ptr) {
-            ptr = AllocTraits::allocate(allocator, sizeof(T));
+            ptr = AllocTraits::allocate(allocator, 1);
             ConstructPolicy<AllocTy, AllocTraits, Creator>::Construct(allocator, ptr);
             instancePtr.store(ptr, std::memory_order_release);
         }
     }
-    return *ptr;
+    return ptr;
+}
+
+template <class T, typename Creator, typename Allocator>
+typename DynamicSingleton<T, Creator, Allocator>::ReadHandle
+DynamicSingleton<T, Creator, Allocator>::Acquire()
+{
+    thread_local std::size_t slot =
+        std::hash<std::thread::id> {}(std::this_thread::get_id()) % NumReaderSlots;
+
+    for (;;) {
+        // Seq-cst increment then load: either Synchronize() sees this reader, or this reader
+        // sees the instance that replaced the one being destroyed.
+        std::uint64_t               e       = epoch.load(std::memory_order_relaxed);
+        std::atomic<std::uint64_t> *counter = &readerSlots[slot].count[e & 1];
+        counter->fetch_add(1, std::memory_order_seq_cst);
+        if (T *ptr = instancePtr.load(std::memory_order_seq_cst))
+            return ReadHandle(ptr, counter);
+
+        counter->fetch_sub(1, std::memory_order_release);
+        Create();
+    }
 }
 
 template <class T, typename Creator, typename Allocator>
@@ -188,13 +496,57 @@ void DynamicSingleton<T, Creator, Allocator>::FreeInstance()
     T *ptr = instancePtr.load(std::memory_order_acquire);
     if (ptr) {
         std::scoped_lock lock(mutex);
-        ptr = instancePtr.load(std::memory_order_relaxed);
+        ptr = instancePtr.exchange(nullptr, std::memory_order_seq_cst);
+        referenced.store(false, std::memory_order_relaxed);
         if (ptr) {
-            AllocTraits::destroy(allocator, ptr);
-            AllocTraits::deallocate(allocator, ptr, sizeof(T));
-            instancePtr.store(nullptr, std::memory_order_release);
+            Synchronize();
+            Destroy(ptr);
         }
     }
 }
 
+template <class T, typename Creator, typename Allocator>
+template <typename... Args>
+void DynamicSingleton<T, Creator, Allocator>::Replace(Args &&... args)
+{
+    std::scoped_lock lock(mutex);
+    if (referenced.load(std::memory_order_relaxed))
+        throw std::logic_error("DynamicSingleton::Replace: instance was referenced by Get()");
+
+    T *ptr = AllocTraits::allocate(allocator, 1);
+    try {
+        AllocTraits::construct(allocator, ptr, std::forward<Args>(args)...);
+    }
+    catch (...) {
+        AllocTraits::deallocate(allocator, ptr, 1);
+        throw;
+    }
+
+    if (T *old = instancePtr.exchange(ptr, std::memory_order_seq_cst)) {
+        Synchronize();
+        Destroy(old);
+    }
+}
+
+template <class T, typename Creator, typename Allocator>
+void DynamicSingleton<T, Creator, Allocator>::Synchronize()
+{
+    // Flips the epoch and drains the readers of the previous parity, twice, since a reader
+    // may have read the epoch before the previous flip and incremented its counter after.
+    for (int round = 0; round < 2; round++) {
+        std::uint64_t e = epoch.fetch_add(1, std::memory_order_seq_cst);
+        for (ReaderSlot &slot : readerSlots) {
+            while (slot.count[e & 1].load(std::memory_order_seq_cst))
+                std::this_thread::yield();
+        }
+    }
+}
+
+template <class T, typename Creator, typename Allocator>
+void DynamicSingleton<T, Creator, Allocator>::Destroy(T *ptr)
+{
+    AllocTraits::destroy(allocator, ptr);
+    AllocTraits::deallocate(allocator, ptr, 1);
+}
+
 }  // namespace ftc
\ No newline at end of file
@@ -5,9 +5,13 @@
 
 #pragma once
 
+#include <array>        // for std::array
 #include <cstddef>      // for size_t
+#include <cstdint>      // for std::uint64_t
 #include <iterator>     // for std::reverse_iterator
+#include <stdexcept>    // for std::invalid_argument, std::length_error
 #include <string_view>  // for std::string_view
+#include <type_traits>  // for std::is_integral_v, std::is_floating_point_v
 #include <utility>      // for std::index_sequence, std::make_index_sequence
 
 namespace ftc {
@@ -18,6 +22,20 @@ namespace ftc {
 // Forward declaration
 template <size_t Len> class ConstString;
 
+/// Gets the 64-bit FNV-1a hash of a string
+///
+/// The same function at compile time and at runtime, so a hash computed from a ConstString
+/// (see ConstString::Hash()) can be compared with the hash of a runtime string.
+[[nodiscard]] constexpr std::uint64_t HashString(std::string_view str)
+{
+    std::uint64_t hash = 14695981039346656037ull;
+    for (char c : str) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
 /// A wrapper around string literal value
 ///
 /// StringLiteral is intended for capturing the length of a literal value, so that the literal can
@@ -98,6 +116,9 @@ public:
     /// Gets an iterator at the end
     [[nodiscard]] constexpr iterator end() const { return &literal[Len]; }
 
+    /// Gets the FNV-1a hash of the string literal, see HashString()
+    [[nodiscard]] constexpr std::uint64_t Hash() const { return HashString(*this); }
+
     // StringLiteral can not be assigned
     constexpr StringLiteral &operator=(const StringLiteral &) = delete;
 
@@ -136,9 +157,9 @@ template <size_t L>
 
 /// Compile time string
 ///
-/// ConstString is mainly for compile time string storage, it doesn't support many calculations,
-/// such as find / find_first_of, etc. If string calculation is needed, it should be first converted
-/// to a std::string_view, the use the string_view to calcuate a constexpr result.
+/// ConstString is mainly for compile time string storage. It provides hashing, searching,
+/// splitting and replacing as constexpr functions, other calculations should convert it to a
+/// std::string_view first, then use the string_view to calculate a constexpr result.
 ///
 /// @tparam Len The length of string (without terminator)
 template <size_t Len> class ConstString
@@ -243,6 +264,72 @@ public:
     /// @tparam Count Substring length
     template <size_t Pos = 0, size_t Count = Len>[[nodiscard]] constexpr auto SubStr() const;
 
+    /// @name Algorithms
+    /// Results in std::string_view refer to the characters of this const string, so they can only
+    /// be constexpr if the const string has static storage duration.
+    /// @{
+
+    /// Value returned by searches that find nothing
+    static constexpr size_t npos = std::string_view::npos;
+
+    /// Gets the FNV-1a hash of the const string, see HashString()
+    [[nodiscard]] constexpr std::uint64_t Hash() const { return HashString(*this); }
+
+    /// Finds the first occurrence of a substring or a character at or after pos
+    /// @return Position of the occurrence, or npos if not found.
+    [[nodiscard]] constexpr size_t Find(std::string_view str, size_t pos = 0) const;
+    [[nodiscard]] constexpr size_t Find(char ch, size_t pos = 0) const;
+
+    /// Finds the last occurrence of a substring or a character starting at or before pos
+    /// @return Position of the occurrence, or npos if not found.
+    [[nodiscard]] constexpr size_t RFind(std::string_view str, size_t pos = npos) const;
+    [[nodiscard]] constexpr size_t RFind(char ch, size_t pos = npos) const;
+
+    /// Checks whether the const string begins with a prefix
+    [[nodiscard]] constexpr bool StartsWith(std::string_view prefix) const;
+
+    /// Checks whether the const string ends with a suffix
+    [[nodiscard]] constexpr bool EndsWith(std::string_view suffix) const;
+
+    /// Counts the non-overlapping occurrences of a non-empty substring
+    [[nodiscard]] constexpr size_t Count(std::string_view str) const;
+
+    /// Splits the const string around a non-empty delimiter
+    ///
+    /// Example:
+    /// ```cpp
+    /// static constexpr ConstString Path = "net.http.requests";
+    /// constexpr auto Parts = Path.Split<Path.Count(".") + 1>(".");  // {"net", "http", "requests"}
+    /// ```
+    ///
+    /// @tparam N Maximal number of parts. The last part holds the rest of the string, and
+    ///     missing parts are empty.
+    template <size_t N>
+    [[nodiscard]] constexpr std::array<std::string_view, N> Split(std::string_view delim) const;
+
+    /// Replaces all occurrences of a character
+    [[nodiscard]] constexpr ConstString Replace(char from, char to) const;
+
+    /// Replaces all non-overlapping occurrences of a non-empty substring
+    ///
+    /// Example:
+    /// ```cpp
+    /// constexpr ConstString Sql = "SELECT ? FROM ?";
+    /// constexpr auto Query = Sql.Replace<Sql.ReplacedLength("?", "$1")>("?", "$1");
+    /// ```
+    ///
+    /// @tparam NewLen Length of the result, which must be ReplacedLength(from, to).
+    /// @throw std::length_error if NewLen is wrong, which fails compilation in a constant
+    ///     expression.
+    template <size_t NewLen>
+    [[nodiscard]] constexpr ConstString<NewLen> Replace(std::string_view from,
+                                                        std::string_view to) const;
+
+    /// Gets the length of Replace(from, to)
+    [[nodiscard]] constexpr size_t ReplacedLength(std::string_view from,
+                                                  std::string_view to) const;
+    /// @}
+
     // ConstString can not be assigned
     constexpr ConstString &operator=(const ConstString &other) = delete;
 
@@ -299,6 +386,26 @@ template <size_t L>
 [[nodiscard]] constexpr ConstString<L + 1> operator+(char lhs, const ConstString<L> &rhs);
 /// @}
 
+/// @name Number conversion
+/// @{
+
+/// Converts an integer to a const string in decimal
+///
+/// Example: `ToConstString<-42>()` is `ConstString("-42")`.
+template <auto Value>[[nodiscard]] constexpr auto ToConstString();
+
+/// Converts a number given by a constexpr function (such as a captureless lambda) to a const
+/// string in decimal
+///
+/// Floating point values are written in fixed notation, rounded to Precision fractional digits
+/// without trailing zeros. Example: `ToConstString([] { return 0.25; })` is `ConstString("0.25")`.
+///
+/// @tparam Precision Maximal fractional digits of floating point values, at most 18.
+/// @param valueFn Constexpr function returning the number.
+template <size_t Precision = 6, typename F>
+[[nodiscard]] constexpr auto ToConstString(F valueFn);
+/// @}
+
 /// @}
 
 }  // namespace ftc
@@ -316,6 +423,59 @@ namespace detail {
         template <typename T> static constexpr auto Identity(T v) { return v; };
     };
 
+    /// Writes a number in decimal to out (if not null)
+    /// @return Length of the decimal string.
+    template <typename T> constexpr size_t FormatNumber(T value, size_t precision, char *out)
+    {
+        static_assert(std::is_integral_v<T> || std::is_floating_point_v<T>,
+                      "Only integers and floating point values can be converted");
+
+        bool          negative = value < 0;
+        std::uint64_t intPart  = 0;
+        std::uint64_t fracPart = 0;  // Fractional digits, multiplied by 10^precision
+        if constexpr (std::is_floating_point_v<T>) {
+            if (!(value == value) || value >= T(1e19) || value <= T(-1e19))
+                throw std::invalid_argument("Value out of range of ToConstString");
+
+            std::uint64_t scale = 1;
+            for (size_t i = 0; i < precision; i++)
+                scale *= 10;
+            T magnitude = negative ? -value : value;
+            intPart     = std::uint64_t(magnitude);
+            fracPart    = std::uint64_t((magnitude - T(intPart)) * T(scale) + T(0.5));
+            if (fracPart >= scale) {
+                intPart++;
+                fracPart -= scale;
+            }
+            for (; precision > 0 && fracPart % 10 == 0; precision--)
+                fracPart /= 10;
+            negative = negative && (intPart || fracPart);
+        }
+        else {
+            // Negated in unsigned arithmetic, exact for the minimal value
+            intPart   = negative ? 0 - std::uint64_t(value) : std::uint64_t(value);
+            precision = 0;
+        }
+
+        size_t numIntDigits = 1;
+        for (std::uint64_t v = intPart; v >= 10; v /= 10)
+            numIntDigits++;
+        size_t length = negative + numIntDigits + (precision ? precision + 1 : 0);
+
+        if (out) {
+            size_t pos = length;
+            for (size_t i = 0; i < precision; i++, fracPart /= 10)
+                out[--pos] = char('0' + fracPart % 10);
+            if (precision)
+                out[--pos] = '.';
+            for (size_t i = 0; i < numIntDigits; i++, intPart /= 10)
+                out[--pos] = char('0' + intPart % 10);
+            if (negative)
+                out[--pos] = '-';
+        }
+        return length;
+    }
+
 }  // namespace detail
 
 template <size_t L1, size_t L2>
@@ -413,6 +573,110 @@ inline constexpr auto ConstString<Len>::SubStr() const
     return ConstString<SubLength>(array + Pos, std::make_index_sequence<SubLength>());
 }
 
+template <size_t Len>
+inline constexpr size_t ConstString<Len>::Find(std::string_view str, size_t pos) const
+{
+    return std::string_view(*this).find(str, pos);
+}
+
+template <size_t Len> inline constexpr size_t ConstString<Len>::Find(char ch, size_t pos) const
+{
+    return std::string_view(*this).find(ch, pos);
+}
+
+template <size_t Len>
+inline constexpr size_t ConstString<Len>::RFind(std::string_view str, size_t pos) const
+{
+    return std::string_view(*this).rfind(str, pos);
+}
+
+template <size_t Len> inline constexpr size_t ConstString<Len>::RFind(char ch, size_t pos) const
+{
+    return std::string_view(*this).rfind(ch, pos);
+}
+
+template <size_t Len>
+inline constexpr bool ConstString<Len>::StartsWith(std::string_view prefix) const
+{
+    return std::string_view(*this).substr(0, prefix.size()) == prefix;
+}
+
+template <size_t Len>
+inline constexpr bool ConstString<Len>::EndsWith(std::string_view suffix) const
+{
+    return suffix.size() <= Len && std::string_view(*this).substr(Len - suffix.size()) == suffix;
+}
+
+template <size_t Len> inline constexpr size_t ConstString<Len>::Count(std::string_view str) const
+{
+    if (str.empty())
+        throw std::invalid_argument("ConstString::Count: empty substring");
+
+    size_t count = 0;
+    for (size_t pos = Find(str); pos != npos; pos = Find(str, pos + str.size()))
+        count++;
+    return count;
+}
+
+template <size_t Len>
+template <size_t N>
+inline constexpr std::array<std::string_view, N>
+ConstString<Len>::Split(std::string_view delim) const
+{
+    static_assert(N > 0, "Split must produce at least one part");
+    if (delim.empty())
+        throw std::invalid_argument("ConstString::Split: empty delimiter");
+
+    std::array<std::string_view, N> parts {};
+    std::string_view                rest = *this;
+    size_t                          i    = 0;
+    for (size_t pos = 0; i + 1 < N && (pos = rest.find(delim)) != npos; i++) {
+        parts[i] = rest.substr(0, pos);
+        rest     = rest.substr(pos + delim.size());
+    }
+    parts[i] = rest;
+    return parts;
+}
+
+template <size_t Len>
+inline constexpr ConstString<Len> ConstString<Len>::Replace(char from, char to) const
+{
+    char buffer[Len + 1] {};
+    for (size_t i = 0; i < Len; i++)
+        buffer[i] = array[i] == from ? to : array[i];
+    return ConstString(std::string_view(buffer, Len));
+}
+
+template <size_t Len>
+template <size_t NewLen>
+inline constexpr ConstString<NewLen> ConstString<Len>::Replace(std::string_view from,
+                                                               std::string_view to) const
+{
+    if (ReplacedLength(from, to) != NewLen)
+        throw std::length_error("ConstString::Replace: NewLen must be ReplacedLength()");
+
+    char             buffer[NewLen + 1] {};
+    size_t           length = 0;
+    std::string_view rest   = *this;
+    for (size_t pos = rest.find(from); pos != npos; pos = rest.find(from)) {
+        for (char c : rest.substr(0, pos))
+            buffer[length++] = c;
+        for (char c : to)
+            buffer[length++] = c;
+        rest = rest.substr(pos + from.size());
+    }
+    for (char c : rest)
+        buffer[length++] = c;
+    return ConstString<NewLen>(std::string_view(buffer, NewLen));
+}
+
+template <size_t Len>
+inline constexpr size_t ConstString<Len>::ReplacedLength(std::string_view from,
+                                                         std::string_view to) const
+{
+    return Len + Count(from) * to.size() - Count(from) * from.size();
+}
+
 template <size_t L1, size_t L2>
 inline constexpr ConstString<L1 + L2> operator+(const ConstString<L1> &lhs,
                                                 const ConstString<L2> &rhs)
@@ -460,4 +724,21 @@ inline constexpr ConstString<L + 1> operator+(char lhs, const ConstString<L> &rh
     return ConstString<1>(lhs) + rhs;
 }
 
+template <auto Value> inline constexpr auto ToConstString()
+{
+    static_assert(std::is_integral_v<decltype(Value)>, "Value must be an integer");
+    return ToConstString([] { return Value; });
+}
+
+template <size_t Precision, typename F> inline constexpr auto ToConstString(F valueFn)
+{
+    static_assert(Precision <= 18, "Precision must be at most 18");
+    constexpr auto   Value = valueFn();
+    constexpr size_t Len   = detail::FormatNumber(Value, Precision, nullptr);
+
+    char buffer[Len + 1] {};
+    detail::FormatNumber(Value, Precision, buffer);
+    return ConstString<Len>(std::string_view(buffer, Len));
+}
+
 }  // namespace ftc
@@ -0,0 +1,504 @@
+/**
+ * @file Format.hpp
+ * Compile time checked string formatting
+ *
+ * A subset of the std::format syntax, whose format string is parsed and checked against the
+ * argument types during compilation, then formatted into a buffer or a SmallString without
+ * allocation.
+ */
+
+#pragma once
+
+#include "FTC/Container/SmallString.hpp"
+
+#include <array>        // for std::array
+#include <charconv>     // for std::to_chars
+#include <cstddef>      // for size_t
+#include <cstdint>      // for std::uintptr_t
+#include <cstdio>       // for std::snprintf
+#include <cstring>      // for std::memcpy, std::memset
+#include <stdexcept>    // for std::invalid_argument
+#include <string_view>  // for std::string_view
+#include <tuple>        // for std::forward_as_tuple
+#include <type_traits>  // for std::is_integral_v, std::is_floating_point_v
+#include <utility>      // for std::index_sequence, std::make_index_sequence
+
+/// Makes a format string argument of Format() from a string literal
+#define FORMAT_STRING(str) [] { return std::string_view(str); }
+
+namespace ftc {
+
+/// @defgroup Format Compile Time Checked Format
+/// @{
+
+/// Parsed replacement field options: [[fill]align][0][width][.precision][type]
+struct FormatSpec
+{
+    char fill      = ' ';
+    char align     = 0;  ///< '<', '>' or 0 for default (right for numbers, left otherwise)
+    bool zero      = false;
+    int  width     = 0;
+    int  precision = -1;
+    char type      = 0;  ///< One of "dxXobfeEgGscp" or 0 for default
+};
+
+/// Output of formatting: a fixed buffer that counts the characters that do not fit
+class FormatSink
+{
+public:
+    FormatSink(char *buffer, size_t size) noexcept : ptr(buffer), end(buffer + size) {}
+
+    /// Appends characters, keeping only what fits in the buffer
+    void Append(const char *str, size_t n) noexcept
+    {
+        size_t room = static_cast<size_t>(end - ptr);
+        size_t fits = n < room ? n : room;
+        std::memcpy(ptr, str, fits);
+        ptr += fits;
+        length += n;
+    }
+    void Append(std::string_view str) noexcept { Append(str.data(), str.size()); }
+    void Append(char ch, size_t count = 1) noexcept
+    {
+        size_t room = static_cast<size_t>(end - ptr);
+        size_t fits = count < room ? count : room;
+        std::memset(ptr, ch, fits);
+        ptr += fits;
+        length += count;
+    }
+
+    /// Gets the length of the whole output, including what did not fit
+    size_t Length() const noexcept { return length; }
+
+private:
+    char * ptr;
+    char * end;
+    size_t length = 0;
+};
+
+/// Formatting of user types, specialize it with a static function
+/// `void Format(FormatSink &sink, const T &value, const FormatSpec &spec)`.
+template <typename T, typename = void> struct Formatter;
+
+/// Formats arguments into a sink
+///
+/// The format string is given by a constexpr function returning it, usually made by
+/// FORMAT_STRING(). Replacement fields are `{}` or `{index}`, optionally followed by `:spec`
+/// (see FormatSpec), and `{{` `}}` are escaped braces. A malformed format string, a wrong number
+/// of arguments or a spec that does not apply to its argument fails compilation.
+///
+/// Example:
+/// ```cpp
+/// FormatTo(sink, FORMAT_STRING("{} took {:.3f} ms"), name, ms);
+/// ```
+template <typename F, typename... Args>
+void FormatTo(FormatSink &sink, F formatString, const Args &... args);
+
+/// Formats arguments into a buffer, as snprintf does
+/// @return Length of the formatted string (the buffer holds size - 1 characters of it, and a
+///     null terminator if size > 0).
+template <typename F, typename... Args>
+size_t FormatTo(char *buffer, size_t size, F formatString, const Args &... args);
+
+/// Appends formatted arguments to a SmallString, allocating only when its capacity is exceeded
+template <size_t N, typename Alloc, typename F, typename... Args>
+void FormatTo(SmallString<N, Alloc> &out, F formatString, const Args &... args);
+
+/// Formats arguments into a new SmallString with inline capacity N
+template <size_t N = 127, typename F, typename... Args>
+[[nodiscard]] SmallString<N> Format(F formatString, const Args &... args);
+
+/// @}
+
+namespace detail {
+
+    /// A literal chunk or a replacement field of a format string
+    struct FormatPiece
+    {
+        std::string_view literal;
+        int              arg = -1;  ///< Argument index, or -1 for a literal chunk
+        FormatSpec       spec;
+    };
+
+    constexpr bool IsDigit(char c)
+    {
+        return c >= '0' && c <= '9';
+    }
+
+    constexpr int ParseInt(std::string_view fmt, size_t &pos)
+    {
+        int value = 0;
+        for (; pos < fmt.size() && IsDigit(fmt[pos]); pos++) {
+            value = value * 10 + (fmt[pos] - '0');
+            if (value > 4096)
+                throw std::invalid_argument("Format: width or precision too large");
+        }
+        return value;
+    }
+
+    constexpr FormatSpec ParseSpec(std::string_view spec)
+    {
+        FormatSpec result;
+        size_t     pos     = 0;
+        auto       isAlign = [](char c) { return c == '<' || c == '>'; };
+        if (spec.size() >= 2 && isAlign(spec[1])) {
+            result.fill  = spec[0];
+            result.align = spec[1];
+            pos          = 2;
+        }
+        else if (!spec.empty() && isAlign(spec[0])) {
+            result.align = spec[0];
+            pos          = 1;
+        }
+        if (pos < spec.size() && spec[pos] == '0') {
+            result.zero = true;
+            pos++;
+        }
+        result.width = ParseInt(spec, pos);
+        if (pos < spec.size() && spec[pos] == '.') {
+            pos++;
+            if (pos == spec.size() || !IsDigit(spec[pos]))
+                throw std::invalid_argument("Format: missing precision after '.'");
+            result.precision = ParseInt(spec, pos);
+            if (result.precision > 100)
+                throw std::invalid_argument("Format: precision larger than 100");
+        }
+        if (pos < spec.size())
+            result.type = spec[pos++];
+        if (pos != spec.size())
+            throw std::invalid_argument("Format: invalid format spec");
+        if (result.type && std::string_view("dxXobfeEgGscp").find(result.type) == spec.npos)
+            throw std::invalid_argument("Format: unknown format type");
+        return result;
+    }
+
+    /// Parses a format string, pieces may be null to only count them.
+    /// @return Number of pieces.
+    constexpr size_t ParseFormat(std::string_view fmt, FormatPiece *pieces, int &numFields)
+    {
+        size_t count    = 0;
+        size_t start    = 0;
+        int    autoNext = 0;
+        auto   emit     = [&](FormatPiece piece) {
+            if (pieces)
+                pieces[count] = piece;
+            count++;
+        };
+        auto   literal  = [&](std::string_view chunk) {
+            FormatPiece piece;
+            piece.literal = chunk;
+            emit(piece);
+        };
+
+        numFields = 0;
+        for (size_t pos = 0; pos < fmt.size(); pos++) {
+            char c = fmt[pos];
+            if (c != '{' && c != '}')
+                continue;
+
+            if (pos + 1 < fmt.size() && fmt[pos + 1] == c) {
+                // Escaped brace, kept at the end of the current chunk
+                literal(fmt.substr(start, pos + 1 - start));
+                start = ++pos + 1;
+                continue;
+            }
+            if (c == '}')
+                throw std::invalid_argument("Format: unmatched '}'");
+
+            size_t close = fmt.find('}', pos);
+            if (close == fmt.npos)
+                throw std::invalid_argument("Format: unmatched '{'");
+            if (pos > start)
+                literal(fmt.substr(start, pos - start));
+
+            FormatPiece      field;
+            std::string_view body  = fmt.substr(pos + 1, close - pos - 1);
+            size_t           colon = body.find(':');
+            std::string_view index = body.substr(0, colon);
+            if (index.empty())
+                field.arg = autoNext++;
+            else {
+                size_t indexEnd = 0;
+                field.arg       = ParseInt(index, indexEnd);
+                if (indexEnd != index.size())
+                    throw std::invalid_argument("Format: invalid argument index");
+            }
+            if (colon != body.npos)
+                field.spec = ParseSpec(body.substr(colon + 1));
+            numFields = field.arg + 1 > numFields ? field.arg + 1 : numFields;
+            emit(field);
+            start = pos = close;
+            start++;
+        }
+        if (start < fmt.size())
+            literal(fmt.substr(start));
+        return count;
+    }
+
+    template <size_t N> struct ParsedFormat
+    {
+        std::array<FormatPiece, N> pieces {};
+        int                        numFields = 0;
+    };
+
+    template <size_t N> constexpr ParsedFormat<N> Parse(std::string_view fmt)
+    {
+        ParsedFormat<N> parsed;
+        ParseFormat(fmt, parsed.pieces.data(), parsed.numFields);
+        return parsed;
+    }
+
+    constexpr size_t CountPieces(std::string_view fmt)
+    {
+        int numFields = 0;
+        return ParseFormat(fmt, nullptr, numFields);
+    }
+
+    template <typename T>
+    inline constexpr bool IsStringLike =
+        std::is_convertible_v<const T &, std::string_view> && !std::is_same_v<T, std::nullptr_t>;
+
+    template <typename T>
+    inline constexpr bool IsInteger =
+        std::is_integral_v<T> && !std::is_same_v<T, bool> && !std::is_same_v<T, char>;
+
+    template <typename T, typename = void> struct HasFormatter : std::false_type
+    {};
+
+    template <typename T>
+    struct HasFormatter<T, std::void_t<decltype(&Formatter<T>::Format)>> : std::true_type
+    {};
+
+    /// Checks a spec against its argument type at compile time
+    template <typename T> constexpr bool CheckSpec(const FormatSpec &spec)
+    {
+        std::string_view allowed;
+        if constexpr (IsInteger<T> || std::is_enum_v<T>)
+            allowed = "dxXobc";
+        else if constexpr (std::is_floating_point_v<T>)
+            allowed = "fFeEgG";
+        else if constexpr (std::is_same_v<T, bool>)
+            allowed = "sdxXob";
+        else if constexpr (std::is_same_v<T, char>)
+            allowed = "cdxXob";
+        else if constexpr (IsStringLike<T>)
+            allowed = "s";
+        else if constexpr (std::is_pointer_v<T> || std::is_null_pointer_v<T>)
+            allowed = "p";
+        else {
+            static_assert(HasFormatter<T>::value, "Format: argument type is not formattable");
+            return true;  // Specs of user types are checked by their formatter
+        }
+        if (spec.type && allowed.find(spec.type) == allowed.npos)
+            throw std::invalid_argument("Format: format type does not apply to the argument");
+        if (spec.precision >= 0 && !std::is_floating_point_v<T> && !IsStringLike<T>)
+            throw std::invalid_argument("Format: precision only applies to floats and strings");
+        return true;
+    }
+
+    template <typename... Args, size_t N>
+    constexpr bool CheckArgs(const ParsedFormat<N> &parsed)
+    {
+        constexpr size_t NumArgs               = sizeof...(Args);
+        bool (*const checks[NumArgs + 1])(const FormatSpec &) = {&CheckSpec<Args>..., nullptr};
+
+        if (size_t(parsed.numFields) > NumArgs)
+            throw std::invalid_argument("Format: more replacement fields than arguments");
+        if (size_t(parsed.numFields) < NumArgs)
+            throw std::invalid_argument("Format: more arguments than replacement fields");
+        for (const FormatPiece &piece : parsed.pieces)
+            if (piece.arg >= 0)
+                checks[piece.arg](piece.spec);
+        return true;
+    }
+
+    /// Writes a formatted value with the width and alignment of spec
+    inline void WritePadded(FormatSink &      sink,
+                            std::string_view  str,
+                            const FormatSpec &spec,
+                            bool              numeric)
+    {
+        size_t width = size_t(spec.width);
+        if (str.size() >= width) {
+            sink.Append(str);
+            return;
+        }
+
+        size_t padding = width - str.size();
+        if (numeric && spec.zero && !spec.align) {
+            // Zeros go after the sign
+            if (!str.empty() && (str[0] == '-' || str[0] == '+')) {
+                sink.Append(str[0]);
+                str.remove_prefix(1);
+            }
+            sink.Append('0', padding);
+            sink.Append(str);
+        }
+        else if (spec.align == '<' || (!spec.align && !numeric)) {
+            sink.Append(str);
+            sink.Append(spec.fill, padding);
+        }
+        else {
+            sink.Append(spec.fill, padding);
+            sink.Append(str);
+        }
+    }
+
+    template <typename T>
+    inline void WriteInteger(FormatSink &sink, T value, const FormatSpec &spec)
+    {
+        int base = 10;
+        switch (spec.type) {
+        case 'x':
+        case 'X': base = 16; break;
+        case 'o': base = 8; break;
+        case 'b': base = 2; break;
+        default: break;
+        }
+
+        char buffer[80];
+        auto end = std::to_chars(buffer, buffer + sizeof(buffer), value, base).ptr;
+        if (spec.type == 'X')
+            for (char *p = buffer; p != end; p++)
+                *p = *p >= 'a' ? char(*p - 'a' + 'A') : *p;
+        WritePadded(sink, std::string_view(buffer, size_t(end - buffer)), spec, true);
+    }
+
+    template <typename T>
+    inline void WriteFloat(FormatSink &sink, T value, const FormatSpec &spec)
+    {
+        // Fixed notation of the largest doubles takes 309 digits before the precision
+        char  buffer[309 + 100 + 8];
+        char *end = buffer;
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+        std::chars_format format = std::chars_format::general;
+        switch (spec.type) {
+        case 'f':
+        case 'F': format = std::chars_format::fixed; break;
+        case 'e':
+        case 'E': format = std::chars_format::scientific; break;
+        default: break;
+        }
+        if (spec.precision >= 0)
+            end = std::to_chars(buffer, buffer + sizeof(buffer), value, format, spec.precision).ptr;
+        else if (spec.type)
+            end = std::to_chars(buffer, buffer + sizeof(buffer), value, format).ptr;
+        else
+            end = std::to_chars(buffer, buffer + sizeof(buffer), value).ptr;  // Shortest
+#else
+        char conversion[] = {'%', '.', '*', spec.type ? char(spec.type | 0x20) : 'g', '\0'};
+        int  precision    = spec.precision >= 0 ? spec.precision : spec.type ? 6 : 17;
+        end += std::snprintf(buffer, sizeof(buffer), conversion, precision, double(value));
+#endif
+        if (spec.type == 'E' || spec.type == 'G' || spec.type == 'F')
+            for (char *p = buffer; p != end; p++)
+                *p = *p >= 'a' && *p <= 'z' ? char(*p - 'a' + 'A') : *p;
+        WritePadded(sink, std::string_view(buffer, size_t(end - buffer)), spec, true);
+    }
+
+    template <typename T>
+    inline void WriteArg(FormatSink &sink, const T &value, const FormatSpec &spec)
+    {
+        if constexpr (std::is_same_v<T, bool>) {
+            if (spec.type && spec.type != 's')
+                WriteInteger(sink, int(value), spec);
+            else
+                WritePadded(sink, value ? "true" : "false", spec, false);
+        }
+        else if constexpr (std::is_same_v<T, char>) {
+            if (spec.type && spec.type != 'c')
+                WriteInteger(sink, int(value), spec);
+            else
+                WritePadded(sink, std::string_view(&value, 1), spec, false);
+        }
+        else if constexpr (std::is_enum_v<T>)
+            WriteArg(sink, std::underlying_type_t<T>(value), spec);
+        else if constexpr (IsInteger<T>) {
+            if (spec.type == 'c')
+                WriteArg(sink, char(value), spec);
+            else
+                WriteInteger(sink, value, spec);
+        }
+        else if constexpr (std::is_floating_point_v<T>)
+            WriteFloat(sink, value, spec);
+        else if constexpr (IsStringLike<T>) {
+            std::string_view str = value;
+            if (spec.precision >= 0 && size_t(spec.precision) < str.size())
+                str = str.substr(0, size_t(spec.precision));
+            WritePadded(sink, str, spec, false);
+        }
+        else if constexpr (std::is_pointer_v<T> || std::is_null_pointer_v<T>) {
+            auto address = reinterpret_cast<std::uintptr_t>(static_cast<const void *>(value));
+            char buffer[2 + 2 * sizeof(void *)] = {'0', 'x'};
+            auto end = std::to_chars(buffer + 2, buffer + sizeof(buffer), address, 16).ptr;
+            WritePadded(sink, std::string_view(buffer, size_t(end - buffer)), spec, true);
+        }
+        else
+            Formatter<T>::Format(sink, value, spec);
+    }
+
+    template <size_t... I, typename G> inline void Unroll(std::index_sequence<I...>, G &&g)
+    {
+        (g(std::integral_constant<size_t, I>()), ...);
+    }
+
+}  // namespace detail
+
+}  // namespace ftc
+
+// -------------------------------------------------
+// Implementation
+
+template <typename F, typename... Args>
+inline void ftc::FormatTo(FormatSink &sink, F formatString, const Args &... args)
+{
+    // Kept in static storage, so that a format string returned as a ConstString outlives the
+    // string_views of the parsed pieces
+    static constexpr auto             Source    = formatString();
+    static constexpr std::string_view Fmt       = Source;
+    static constexpr size_t           NumPieces = detail::CountPieces(Fmt);
+    static constexpr auto             Parsed    = detail::Parse<NumPieces>(Fmt);
+    static_assert(detail::CheckArgs<Args...>(Parsed), "Invalid format arguments");
+
+    auto argTuple = std::forward_as_tuple(args...);
+    detail::Unroll(std::make_index_sequence<NumPieces>(), [&](auto i) {
+        constexpr detail::FormatPiece Piece = Parsed.pieces[i];
+        if constexpr (Piece.arg < 0)
+            sink.Append(Piece.literal.data(), Piece.literal.size());
+        else
+            detail::WriteArg(sink, std::get<size_t(Piece.arg)>(argTuple), Piece.spec);
+    });
+}
+
+template <typename F, typename... Args>
+inline size_t ftc::FormatTo(char *buffer, size_t size, F formatString, const Args &... args)
+{
+    FormatSink sink(buffer, size ? size - 1 : 0);
+    FormatTo(sink, formatString, args...);
+    if (size)
+        buffer[sink.Length() < size ? sink.Length() : size - 1] = '\0';
+    return sink.Length();
+}
+
+template <size_t N, typename Alloc, typename F, typename... Args>
+inline void ftc::FormatTo(SmallString<N, Alloc> &out, F formatString, const Args &... args)
+{
+    // Formats into the spare capacity, and again after growing if it does not fit
+    size_t offset = out.size();
+    out.resize(out.capacity());
+    size_t length = FormatTo(out.data() + offset, out.size() - offset + 1, formatString, args...);
+    if (offset + length > out.size()) {
+        out.resize(offset + length);
+        FormatTo(out.data() + offset, length + 1, formatString, args...);
+    }
+    else
+        out.resize(offset + length);
+}
+
+template <size_t N, typename F, typename... Args>
+inline ftc::SmallString<N> ftc::Format(F formatString, const Args &... args)
+{
+    SmallString<N> out;
+    FormatTo(out, formatString, args...);
+    return out;
+}
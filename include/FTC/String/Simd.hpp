@@ -0,0 +1,1034 @@
+/**
+ * @file Simd.hpp
+ * Vectorized runtime string kernels
+ *
+ * Runtime counterparts of the ConstString queries for hot parsing paths: character search,
+ * character set search, substring search, equality, ASCII case folding and UTF-8 validation.
+ * Every kernel has SSE2, SSE4.2 and AVX2 versions picked by runtime cpu detection on x86, a NEON
+ * version on AArch64, and a scalar fallback. Character sets and substring searchers are
+ * constexpr, so the lookup tables of a ConstString needle are built at compile time.
+ */
+
+#pragma once
+
+#include "FTC/String/ConstString.hpp"
+
+#include <array>        // for std::array
+#include <atomic>       // for std::atomic
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::uint8_t, std::uint64_t
+#include <cstring>      // for std::memchr, std::memcmp, std::memcpy
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+
+#if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__)) \
+    || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <immintrin.h>
+    #define FTC_SIMD_X86 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    #include <arm_neon.h>
+    #define FTC_SIMD_NEON 1
+#endif
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
+// Functions using instructions above the compilation target are compiled for their own target,
+// and only called after runtime detection. MSVC allows any instruction set without it.
+#if defined(FTC_SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+    #define FTC_SIMD_TARGET(isa) __attribute__((target(isa)))
+#else
+    #define FTC_SIMD_TARGET(isa)
+#endif
+
+namespace ftc::simd {
+
+/// @defgroup Simd Vectorized String Kernels
+/// @{
+
+/// Instruction set used by the string kernels
+enum class SimdLevel { Scalar, SSE2, SSE42, AVX2, NEON };
+
+/// Gets the best instruction set supported by the cpu
+SimdLevel SupportedLevel() noexcept;
+
+/// Gets the instruction set currently used by the string kernels, SupportedLevel() by default
+SimdLevel ActiveLevel() noexcept;
+
+/// Sets the instruction set used by the string kernels, mainly for tests and benchmarks
+///
+/// A level that is not supported is lowered to the best supported level of the same family, or
+/// to Scalar.
+///
+/// @return The instruction set now in use.
+SimdLevel SetLevel(SimdLevel level) noexcept;
+
+inline constexpr std::size_t npos = std::string_view::npos;
+
+/// A set of bytes with the lookup tables of the vectorized FindAnyOf()
+///
+/// All construction is constexpr, so a set declared constexpr (eg. from a ConstString) has its
+/// tables computed at compile time:
+///
+///     constexpr simd::CharSet Delims(ConstString(" \t\r\n,;"));
+///     std::size_t end = simd::FindAnyOf(line, Delims);
+class CharSet
+{
+public:
+    /// Constructor, initialize an empty set
+    constexpr CharSet() noexcept = default;
+
+    /// Constructor, initialize a set from every character of a string
+    constexpr CharSet(std::string_view chars) noexcept
+    {
+        for (char ch : chars)
+            Insert(ch);
+    }
+
+    /// Adds a character to the set
+    constexpr void Insert(char ch) noexcept
+    {
+        if (Contains(ch))
+            return;
+
+        auto b = static_cast<unsigned char>(ch);
+        bitmap[b >> 6] |= std::uint64_t(1) << (b & 63);
+        (b & 0x80 ? highNibbles : lowNibbles)[b & 15] |= std::uint8_t(1u << ((b >> 4) & 7));
+        if (count < chars.size())
+            chars[count] = ch;
+        count++;
+    }
+
+    /// Checks whether a character is in the set
+    [[nodiscard]] constexpr bool Contains(char ch) const noexcept
+    {
+        auto b = static_cast<unsigned char>(ch);
+        return (bitmap[b >> 6] >> (b & 63)) & 1;
+    }
+
+    /// Gets the number of distinct characters in the set
+    [[nodiscard]] constexpr std::size_t Size() const noexcept { return count; }
+
+    /// @name Lookup tables of the vectorized kernels
+    /// @{
+
+    /// Bit (hi & 7) of LowNibbleTable()[lo] is set if byte (hi << 4 | lo) is in the set, for bytes
+    /// below 0x80, HighNibbleTable() is the same for bytes from 0x80.
+    [[nodiscard]] constexpr const std::uint8_t *LowNibbleTable() const noexcept
+    {
+        return lowNibbles.data();
+    }
+    [[nodiscard]] constexpr const std::uint8_t *HighNibbleTable() const noexcept
+    {
+        return highNibbles.data();
+    }
+
+    /// The first 16 characters padded with zeros, every character if Size() <= 16
+    [[nodiscard]] constexpr const char *Chars() const noexcept { return chars.data(); }
+
+    /// @}
+
+private:
+    std::array<std::uint64_t, 4> bitmap {};
+    std::array<std::uint8_t, 16> lowNibbles {};
+    std::array<std::uint8_t, 16> highNibbles {};
+    std::array<char, 16>         chars {};
+    std::size_t                  count = 0;
+};
+
+/// A substring searcher with a needle known at compile time
+///
+/// Stores a copy of the needle and its Horspool skip table, so a searcher declared constexpr
+/// needs no preprocessing at runtime:
+///
+///     constexpr simd::Searcher Header(ConstString("Content-Length:"));
+///     std::size_t pos = Header.Find(request);
+///
+/// @tparam Len The length of needle
+template <std::size_t Len> class Searcher
+{
+public:
+    /// Constructor, initialize a searcher from a string literal value
+    constexpr Searcher(const char (&literal)[Len + 1]) noexcept
+        : Searcher(std::string_view(literal, Len), 0)
+    {}
+
+    /// Constructor, initialize a searcher from a StringLiteral
+    constexpr Searcher(const StringLiteral<Len> &str) noexcept
+        : Searcher(std::string_view(str), 0)
+    {}
+
+    /// Constructor, initialize a searcher from a ConstString
+    constexpr Searcher(const ConstString<Len> &str) noexcept : Searcher(std::string_view(str), 0)
+    {}
+
+    /// Gets the needle
+    [[nodiscard]] constexpr std::string_view Needle() const noexcept
+    {
+        return {needle.data(), Len};
+    }
+
+    /// Finds the first occurrence of the needle in str starting from pos
+    /// @return Index of the occurrence, or npos if not found.
+    [[nodiscard]] std::size_t Find(std::string_view str, std::size_t pos = 0) const noexcept;
+
+private:
+    constexpr Searcher(std::string_view str, int) noexcept
+    {
+        for (std::size_t i = 0; i < Len; i++)
+            needle[i] = str[i];
+        for (auto &s : skip)
+            s = Len;
+        for (std::size_t i = 0; i + 1 < Len; i++)
+            skip[static_cast<unsigned char>(str[i])] = Len - 1 - i;
+    }
+
+    std::size_t Horspool(const char *s, std::size_t n) const noexcept;
+
+    std::array<char, (Len > 0 ? Len : 1)> needle {};
+    std::array<std::size_t, 256>          skip {};
+};
+
+/// Deduction guide for Searcher
+template <std::size_t LenWithTerminator>
+Searcher(const char (&)[LenWithTerminator]) -> Searcher<LenWithTerminator - 1>;
+
+/// Deduction guide for Searcher
+template <std::size_t Len> Searcher(const StringLiteral<Len> &) -> Searcher<Len>;
+
+/// Deduction guide for Searcher
+template <std::size_t Len> Searcher(const ConstString<Len> &) -> Searcher<Len>;
+
+/// Finds the first occurrence of a character in str starting from pos
+/// @return Index of the occurrence, or npos if not found.
+[[nodiscard]] std::size_t FindChar(std::string_view str, char ch, std::size_t pos = 0) noexcept;
+
+/// Finds the first character of str in a set starting from pos
+/// @return Index of the character, or npos if not found.
+[[nodiscard]] std::size_t
+FindAnyOf(std::string_view str, const CharSet &set, std::size_t pos = 0) noexcept;
+
+/// Finds the first character of str in chars starting from pos
+///
+/// Builds the character set at every call, prefer a constexpr CharSet for a fixed set.
+///
+/// @return Index of the character, or npos if not found.
+[[nodiscard]] std::size_t
+FindAnyOf(std::string_view str, std::string_view chars, std::size_t pos = 0) noexcept;
+
+/// Finds the first occurrence of needle in str starting from pos
+/// @return Index of the occurrence, or npos if not found.
+[[nodiscard]] std::size_t
+Find(std::string_view str, std::string_view needle, std::size_t pos = 0) noexcept;
+
+/// Checks whether two strings are equal
+[[nodiscard]] bool Equal(std::string_view a, std::string_view b) noexcept;
+
+/// Checks whether two strings are equal ignoring the case of ASCII letters
+[[nodiscard]] bool EqualIgnoreCase(std::string_view a, std::string_view b) noexcept;
+
+/// Converts ASCII letters to lower case, dst must have room for src.size() characters
+///
+/// dst may be src.data() for an in place conversion.
+void ToLower(std::string_view src, char *dst) noexcept;
+
+/// Converts ASCII letters to upper case, dst must have room for src.size() characters
+///
+/// dst may be src.data() for an in place conversion.
+void ToUpper(std::string_view src, char *dst) noexcept;
+
+/// Returns a copy of a string with ASCII letters converted to lower case
+[[nodiscard]] std::string ToLower(std::string_view str);
+
+/// Returns a copy of a string with ASCII letters converted to upper case
+[[nodiscard]] std::string ToUpper(std::string_view str);
+
+/// Checks whether a string is well-formed UTF-8
+///
+/// Rejects overlong encodings, surrogates, code points above U+10FFFF and truncated sequences.
+[[nodiscard]] bool IsValidUtf8(std::string_view str) noexcept;
+
+/// @}
+
+}  // namespace ftc::simd
+
+///////////////////////////////////////////////////////////////////////////////
+// Implementation
+///////////////////////////////////////////////////////////////////////////////
+
+namespace ftc::simd {
+
+namespace detail {
+
+    // Every kernel takes a pointer and a length and returns the index of its result, or the
+    // length if there is none. Vector kernels hand the tail shorter than a vector to the kernel
+    // of the next narrower width.
+
+    inline std::uint32_t __ctz(std::uint64_t x) noexcept
+    {
+#if defined(_MSC_VER)
+        unsigned long i;
+        _BitScanForward64(&i, x);
+        return i;
+#else
+        return static_cast<std::uint32_t>(__builtin_ctzll(x));
+#endif
+    }
+
+    inline SimdLevel __detect_level() noexcept
+    {
+#if defined(FTC_SIMD_X86)
+    #if defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        int  maxLeaf = info[0];
+        __cpuid(info, 1);
+        bool sse42   = info[2] & (1 << 20);
+        bool osAvx   = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (_xgetbv(0) & 6) == 6;
+        bool avx2    = false;
+        if (maxLeaf >= 7 && osAvx) {
+            __cpuidex(info, 7, 0);
+            avx2 = info[1] & (1 << 5);
+        }
+    #else
+        __builtin_cpu_init();
+        bool sse42 = __builtin_cpu_supports("sse4.2");
+        bool avx2  = __builtin_cpu_supports("avx2");
+    #endif
+        return avx2 ? SimdLevel::AVX2 : sse42 ? SimdLevel::SSE42 : SimdLevel::SSE2;
+#elif defined(FTC_SIMD_NEON)
+        return SimdLevel::NEON;
+#else
+        return SimdLevel::Scalar;
+#endif
+    }
+
+    inline std::atomic<SimdLevel> &__active_level() noexcept
+    {
+        static std::atomic<SimdLevel> level {SupportedLevel()};
+        return level;
+    }
+
+    /* ---------------------------------------------------------------------
+       Scalar kernels
+       --------------------------------------------------------------------- */
+
+    inline char __fold_case(char ch, char first) noexcept
+    {
+        return static_cast<unsigned char>(ch - first) < 26 ? char(ch ^ 0x20) : ch;
+    }
+
+    inline std::size_t __find_char_scalar(const char *s, std::size_t n, char ch) noexcept
+    {
+        const void *p = n ? std::memchr(s, ch, n) : nullptr;
+        return p ? static_cast<const char *>(p) - s : n;
+    }
+
+    inline std::size_t __find_any_scalar(const char *s, std::size_t n, const CharSet &set) noexcept
+    {
+        std::size_t i = 0;
+        while (i < n && !set.Contains(s[i]))
+            i++;
+        return i;
+    }
+
+    inline std::size_t
+    __find_scalar(const char *s, std::size_t n, const char *needle, std::size_t m) noexcept
+    {
+        std::size_t i = std::string_view(s, n).find(std::string_view(needle, m));
+        return i == npos ? n : i;
+    }
+
+    inline bool __equal_scalar(const char *a, const char *b, std::size_t n) noexcept
+    {
+        return n == 0 || std::memcmp(a, b, n) == 0;
+    }
+
+    inline bool __equal_icase_scalar(const char *a, const char *b, std::size_t n) noexcept
+    {
+        for (std::size_t i = 0; i < n; i++)
+            if (__fold_case(a[i], 'A') != __fold_case(b[i], 'A'))
+                return false;
+        return true;
+    }
+
+    inline void
+    __convert_case_scalar(const char *src, char *dst, std::size_t n, char first) noexcept
+    {
+        for (std::size_t i = 0; i < n; i++)
+            dst[i] = __fold_case(src[i], first);
+    }
+
+    /// Length of the leading ASCII bytes, 8 bytes at a time
+    inline std::size_t __ascii_prefix_scalar(const unsigned char *s, std::size_t n) noexcept
+    {
+        std::size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            std::uint64_t word;
+            std::memcpy(&word, s + i, 8);
+            if (word & 0x8080808080808080ull)
+                break;
+        }
+        while (i < n && s[i] < 0x80)
+            i++;
+        return i;
+    }
+
+    /// Validates the UTF-8 sequence at s, returns its length or 0 if it is ill-formed
+    inline std::size_t __utf8_sequence(const unsigned char *s, std::size_t n) noexcept
+    {
+        auto isCont = [&](std::size_t i) { return (s[i] & 0xC0) == 0x80; };
+
+        unsigned char c = s[0];
+        if (c < 0x80)
+            return 1;
+        if (c < 0xC2)  // continuation byte, or overlong 2 bytes sequence
+            return 0;
+        if (c < 0xE0)
+            return n >= 2 && isCont(1) ? 2 : 0;
+        if (c < 0xF0) {
+            if (n < 3 || !isCont(1) || !isCont(2))
+                return 0;
+            if ((c == 0xE0 && s[1] < 0xA0) || (c == 0xED && s[1] > 0x9F))
+                return 0;  // overlong, or surrogate
+            return 3;
+        }
+        if (c < 0xF5) {
+            if (n < 4 || !isCont(1) || !isCont(2) || !isCont(3))
+                return 0;
+            if ((c == 0xF0 && s[1] < 0x90) || (c == 0xF4 && s[1] > 0x8F))
+                return 0;  // overlong, or above U+10FFFF
+            return 4;
+        }
+        return 0;
+    }
+
+    /// Skips ASCII runs with a vector kernel, and validates multibyte sequences one by one
+    template <typename AsciiPrefix>
+    inline bool __validate_utf8(const unsigned char *s, std::size_t n, AsciiPrefix asciiPrefix)
+    {
+        std::size_t i = 0;
+        while (i < n) {
+            i += asciiPrefix(s + i, n - i);
+            while (i < n && s[i] >= 0x80) {
+                std::size_t len = __utf8_sequence(s + i, n - i);
+                if (len == 0)
+                    return false;
+                i += len;
+            }
+        }
+        return true;
+    }
+
+#if defined(FTC_SIMD_X86)
+    /* ---------------------------------------------------------------------
+       SSE2 kernels
+       --------------------------------------------------------------------- */
+
+    inline __m128i __load128(const void *p) noexcept
+    {
+        return _mm_loadu_si128(static_cast<const __m128i *>(p));
+    }
+
+    inline std::uint32_t __mask128(__m128i v) noexcept
+    {
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(v));
+    }
+
+    /// Flips bit 0x20 of the bytes in [first, first + 26)
+    inline __m128i __fold_case128(__m128i v, char first) noexcept
+    {
+        __m128i shifted = _mm_sub_epi8(v, _mm_set1_epi8(static_cast<char>(first + 128)));
+        __m128i inRange = _mm_cmplt_epi8(shifted, _mm_set1_epi8(static_cast<char>(-128 + 26)));
+        return _mm_xor_si128(v, _mm_and_si128(inRange, _mm_set1_epi8(0x20)));
+    }
+
+    inline std::size_t __find_char_sse2(const char *s, std::size_t n, char ch) noexcept
+    {
+        const __m128i c = _mm_set1_epi8(ch);
+        std::size_t   i = 0;
+        for (; i + 16 <= n; i += 16) {
+            if (std::uint32_t mask = __mask128(_mm_cmpeq_epi8(__load128(s + i), c)))
+                return i + __ctz(mask);
+        }
+        return i + __find_char_scalar(s + i, n - i, ch);
+    }
+
+    /// First and last character filter, then a comparison of the middle
+    inline std::size_t
+    __find_sse2(const char *s, std::size_t n, const char *needle, std::size_t m) noexcept
+    {
+        const __m128i first = _mm_set1_epi8(needle[0]);
+        const __m128i last  = _mm_set1_epi8(needle[m - 1]);
+        std::size_t   i     = 0;
+        for (; i + m - 1 + 16 <= n; i += 16) {
+            __m128i       eqFirst = _mm_cmpeq_epi8(__load128(s + i), first);
+            __m128i       eqLast  = _mm_cmpeq_epi8(__load128(s + i + m - 1), last);
+            std::uint32_t mask    = __mask128(_mm_and_si128(eqFirst, eqLast));
+            for (; mask; mask &= mask - 1) {
+                std::size_t j = i + __ctz(mask);
+                if (std::memcmp(s + j + 1, needle + 1, m - 2) == 0)
+                    return j;
+            }
+        }
+        return i + __find_scalar(s + i, n - i, needle, m);
+    }
+
+    inline bool __equal_sse2(const char *a, const char *b, std::size_t n) noexcept
+    {
+        std::size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            if (__mask128(_mm_cmpeq_epi8(__load128(a + i), __load128(b + i))) != 0xFFFF)
+                return false;
+        }
+        return __equal_scalar(a + i, b + i, n - i);
+    }
+
+    inline bool __equal_icase_sse2(const char *a, const char *b, std::size_t n) noexcept
+    {
+        std::size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            __m128i va = __fold_case128(__load128(a + i), 'A');
+            __m128i vb = __fold_case128(__load128(b + i), 'A');
+            if (__mask128(_mm_cmpeq_epi8(va, vb)) != 0xFFFF)
+                return false;
+        }
+        return __equal_icase_scalar(a + i, b + i, n - i);
+    }
+
+    inline void __convert_case_sse2(const char *src, char *dst, std::size_t n, char first) noexcept
+    {
+        std::size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i),
+                             __fold_case128(__load128(src + i), first));
+        }
+        __convert_case_scalar(src + i, dst + i, n - i, first);
+    }
+
+    inline std::size_t __ascii_prefix_sse2(const unsigned char *s, std::size_t n) noexcept
+    {
+        std::size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            if (std::uint32_t mask = __mask128(__load128(s + i)))
+                return i + __ctz(mask);
+        }
+        return i + __ascii_prefix_scalar(s + i, n - i);
+    }
+
+    /* ---------------------------------------------------------------------
+       SSE4.2 kernels
+       --------------------------------------------------------------------- */
+
+    /// Character set search with pcmpestri, the set must have at most 16 characters
+    FTC_SIMD_TARGET("sse4.2")
+    inline std::size_t __find_any_sse42(const char *s, std::size_t n, const CharSet &set) noexcept
+    {
+        constexpr int mode  = _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_LEAST_SIGNIFICANT;
+        const __m128i chars = __load128(set.Chars());
+        const int     count = static_cast<int>(set.Size());
+        std::size_t   i     = 0;
+        for (; i + 16 <= n; i += 16) {
+            int index = _mm_cmpestri(chars, count, __load128(s + i), 16, mode);
+            if (index < 16)
+                return i + index;
+        }
+        return i + __find_any_scalar(s + i, n - i, set);
+    }
+
+    /* ---------------------------------------------------------------------
+       AVX2 kernels
+       --------------------------------------------------------------------- */
+
+    FTC_SIMD_TARGET("avx2") inline __m256i __load256(const void *p) noexcept
+    {
+        return _mm256_loadu_si256(static_cast<const __m256i *>(p));
+    }
+
+    FTC_SIMD_TARGET("avx2") inline std::uint32_t __mask256(__m256i v) noexcept
+    {
+        return static_cast<std::uint32_t>(_mm256_movemask_epi8(v));
+    }
+
+    FTC_SIMD_TARGET("avx2") inline __m256i __fold_case256(__m256i v, char first) noexcept
+    {
+        __m256i shifted = _mm256_sub_epi8(v, _mm256_set1_epi8(static_cast<char>(first + 128)));
+        __m256i inRange =
+            _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(-128 + 26)), shifted);
+        return _mm256_xor_si256(v, _mm256_and_si256(inRange, _mm256_set1_epi8(0x20)));
+    }
+
+    FTC_SIMD_TARGET("avx2")
+    inline std::size_t __find_char_avx2(const char *s, std::size_t n, char ch) noexcept
+    {
+        const __m256i c = _mm256_set1_epi8(ch);
+        std::size_t   i = 0;
+        for (; i + 128 <= n; i += 128) {
+            __m256i eq[4];
+            for (int k = 0; k < 4; k++)
+                eq[k] = _mm256_cmpeq_epi8(__load256(s + i + 32 * k), c);
+            __m256i any = _mm256_or_si256(_mm256_or_si256(eq[0], eq[1]),
+                                          _mm256_or_si256(eq[2], eq[3]));
+            if (!_mm256_testz_si256(any, any)) {
+                for (int k = 0;; k++)
+                    if (std::uint32_t mask = __mask256(eq[k]))
+                        return i + 32 * k + __ctz(mask);
+            }
+        }
+        for (; i + 32 <= n; i += 32) {
+            if (std::uint32_t mask = __mask256(_mm256_cmpeq_epi8(__load256(s + i), c)))
+                return i + __ctz(mask);
+        }
+        return i + __find_char_sse2(s + i, n - i, ch);
+    }
+
+    /// Character set search with nibble lookup tables, for sets of any size
+    FTC_SIMD_TARGET("avx2")
+    inline std::size_t __find_any_avx2(const char *s, std::size_t n, const CharSet &set) noexcept
+    {
+        const __m256i lowTable  = _mm256_broadcastsi128_si256(__load128(set.LowNibbleTable()));
+        const __m256i highTable = _mm256_broadcastsi128_si256(__load128(set.HighNibbleTable()));
+        const __m256i bitTable  = _mm256_broadcastsi128_si256(
+            _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128));
+        const __m256i nibble = _mm256_set1_epi8(0x0F);
+
+        std::size_t i = 0;
+        for (; i + 32 <= n; i += 32) {
+            __m256i v   = __load256(s + i);
+            __m256i lo  = _mm256_and_si256(v, nibble);
+            __m256i hi  = _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble);
+            __m256i row = _mm256_blendv_epi8(
+                _mm256_shuffle_epi8(lowTable, lo), _mm256_shuffle_epi8(highTable, lo), v);
+            __m256i bit = _mm256_shuffle_epi8(bitTable, hi);
+            __m256i hit = _mm256_cmpeq_epi8(_mm256_and_si256(row, bit), bit);
+            if (std::uint32_t mask = __mask256(hit))
+                return i + __ctz(mask);
+        }
+        return i + __find_any_scalar(s + i, n - i, set);
+    }
+
+    FTC_SIMD_TARGET("avx2")
+    inline std::size_t
+    __find_avx2(const char *s, std::size_t n, const char *needle, std::size_t m) noexcept
+    {
+        const __m256i first = _mm256_set1_epi8(needle[0]);
+        const __m256i last  = _mm256_set1_epi8(needle[m - 1]);
+        std::size_t   i     = 0;
+        for (; i + m - 1 + 32 <= n; i += 32) {
+            __m256i       eqFirst = _mm256_cmpeq_epi8(__load256(s + i), first);
+            __m256i       eqLast  = _mm256_cmpeq_epi8(__load256(s + i + m - 1), last);
+            std::uint32_t mask    = __mask256(_mm256_and_si256(eqFirst, eqLast));
+            for (; mask; mask &= mask - 1) {
+                std::size_t j = i + __ctz(mask);
+                if (std::memcmp(s + j + 1, needle + 1, m - 2) == 0)
+                    return j;
+            }
+        }
+        return i + __find_sse2(s + i, n - i, needle, m);
+    }
+
+    FTC_SIMD_TARGET("avx2")
+    inline bool __equal_avx2(const char *a, const char *b, std::size_t n) noexcept
+    {
+        std::size_t i = 0;
+        for (; i + 128 <= n; i += 128) {
+            __m256i eq = _mm256_set1_epi8(-1);
+            for (int k = 0; k < 4; k++) {
+                __m256i va = __load256(a + i + 32 * k);
+                eq         = _mm256_and_si256(eq, _mm256_cmpeq_epi8(va, __load256(b + i + 32 * k)));
+            }
+            if (__mask256(eq) != 0xFFFFFFFF)
+                return false;
+        }
+        for (; i + 32 <= n; i += 32) {
+            if (__mask256(_mm256_cmpeq_epi8(__load256(a + i), __load256(b + i))) != 0xFFFFFFFF)
+                return false;
+        }
+        return __equal_sse2(a + i, b + i, n - i);
+    }
+
+    FTC_SIMD_TARGET("avx2")
+    inline bool __equal_icase_avx2(const char *a, const char *b, std::size_t n) noexcept
+    {
+        std::size_t i = 0;
+        for (; i + 32 <= n; i += 32) {
+            __m256i va = __fold_case256(__load256(a + i), 'A');
+            __m256i vb = __fold_case256(__load256(b + i), 'A');
+            if (__mask256(_mm256_cmpeq_epi8(va, vb)) != 0xFFFFFFFF)
+                return false;
+        }
+        return __equal_icase_sse2(a + i, b + i, n - i);
+    }
+
+    FTC_SIMD_TARGET("avx2")
+    inline void __convert_case_avx2(const char *src, char *dst, std::size_t n, char first) noexcept
+    {
+        std::size_t i = 0;
+        for (; i + 32 <= n; i += 32) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i),
+                                __fold_case256(__load256(src + i), first));
+        }
+        __convert_case_sse2(src + i, dst + i, n - i, first);
+    }
+
+    FTC_SIMD_TARGET("avx2")
+    inline std::size_t __ascii_prefix_avx2(const unsigned char *s, std::size_t n) noexcept
+    {
+        std::size_t i = 0;
+        for (; i + 32 <= n; i += 32) {
+            if (std::uint32_t mask = __mask256(__load256(s + i)))
+                return i + __ctz(mask);
+        }
+        return i + __ascii_prefix_sse2(s + i, n - i);
+    }
+#elif defined(FTC_SIMD_NEON)
+    /* ---------------------------------------------------------------------
+       NEON kernels
+       --------------------------------------------------------------------- */
+
+    inline uint8x16_t __load128(const void *p) noexcept
+    {
+        return vld1q_u8(static_cast<const std::uint8_t *>(p));
+    }
+
+    /// Narrows each 8-bit lane to 4 bits, the index of a lane is ctz(mask) / 4
+    inline std::uint64_t __mask128(uint8x16_t v) noexcept
+    {
+        uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(v), 4);
+        return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0);
+    }
+
+    inline uint8x16_t __fold_case128(uint8x16_t v, char first) noexcept
+    {
+        uint8x16_t inRange = vcltq_u8(vsubq_u8(v, vdupq_n_u8(std::uint8_t(first))), vdupq_n_u8(26));
+        return veorq_u8(v, vandq_u8(inRange, vdupq_n_u8(0x20)));
+    }
+
+    inline std::size_t __find_char_neon(const char *s, std::size_t n, char ch) noexcept
+    {
+        const uint8x16_t c = vdupq_n_u8(std::uint8_t(ch));
+        std::size_t      i = 0;
+        for (; i + 16 <= n; i += 16) {
+            if (std::uint64_t mask = __mask128(vceqq_u8(__load128(s + i), c)))
+                return i + __ctz(mask) / 4;
+        }
+        return i + __find_char_scalar(s + i, n - i, ch);
+    }
+
+    inline std::size_t __find_any_neon(const char *s, std::size_t n, const CharSet &set) noexcept
+    {
+        static constexpr std::uint8_t bits[16] = {
+            1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+        const uint8x16_t lowTable  = __load128(set.LowNibbleTable());
+        const uint8x16_t highTable = __load128(set.HighNibbleTable());
+        const uint8x16_t bitTable  = __load128(bits);
+        const uint8x16_t nibble    = vdupq_n_u8(0x0F);
+
+        std::size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            uint8x16_t v    = __load128(s + i);
+            uint8x16_t lo   = vandq_u8(v, nibble);
+            uint8x16_t high = vreinterpretq_u8_s8(vshrq_n_s8(vreinterpretq_s8_u8(v), 7));
+            uint8x16_t row  = vbslq_u8(high, vqtbl1q_u8(highTable, lo), vqtbl1q_u8(lowTable, lo));
+            uint8x16_t bit  = vqtbl1q_u8(bitTable, vshrq_n_u8(v, 4));
+            if (std::uint64_t mask = __mask128(vtstq_u8(row, bit)))
+                return i + __ctz(mask) / 4;
+        }
+        return i + __find_any_scalar(s + i, n - i, set);
+    }
+
+    inline std::size_t
+    __find_neon(const char *s, std::size_t n, const char *needle, std::size_t m) noexcept
+    {
+        const uint8x16_t first = vdupq_n_u8(std::uint8_t(needle[0]));
+        const uint8x16_t last  = vdupq_n_u8(std::uint8_t(needle[m - 1]));
+        std::size_t      i     = 0;
+        for (; i + m - 1 + 16 <= n; i += 16) {
+            uint8x16_t    eqFirst = vceqq_u8(__load128(s + i), first);
+            uint8x16_t    eqLast  = vceqq_u8(__load128(s + i + m - 1), last);
+            std::uint64_t mask    = __mask128(vandq_u8(eqFirst, eqLast)) & 0x8888888888888888ull;
+            for (; mask; mask &= mask - 1) {
+                std::size_t j = i + __ctz(mask) / 4;
+                if (std::memcmp(s + j + 1, needle + 1, m - 2) == 0)
+                    return j;
+            }
+        }
+        return i + __find_scalar(s + i, n - i, needle, m);
+    }
+
+    inline bool __equal_neon(const char *a, const char *b, std::size_t n) noexcept
+    {
+        std::size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            if (vminvq_u8(vceqq_u8(__load128(a + i), __load128(b + i))) != 0xFF)
+                return false;
+        }
+        return __equal_scalar(a + i, b + i, n - i);
+    }
+
+    inline bool __equal_icase_neon(const char *a, const char *b, std::size_t n) noexcept
+    {
+        std::size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            uint8x16_t va = __fold_case128(__load128(a + i), 'A');
+            uint8x16_t vb = __fold_case128(__load128(b + i), 'A');
+            if (vminvq_u8(vceqq_u8(va, vb)) != 0xFF)
+                return false;
+        }
+        return __equal_icase_scalar(a + i, b + i, n - i);
+    }
+
+    inline void __convert_case_neon(const char *src, char *dst, std::size_t n, char first) noexcept
+    {
+        std::size_t i = 0;
+        for (; i + 16 <= n; i += 16)
+            vst1q_u8(reinterpret_cast<std::uint8_t *>(dst + i),
+                     __fold_case128(__load128(src + i), first));
+        __convert_case_scalar(src + i, dst + i, n - i, first);
+    }
+
+    inline std::size_t __ascii_prefix_neon(const unsigned char *s, std::size_t n) noexcept
+    {
+        std::size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            uint8x16_t high = vcgeq_u8(__load128(s + i), vdupq_n_u8(0x80));
+            if (std::uint64_t mask = __mask128(high))
+                return i + __ctz(mask) / 4;
+        }
+        return i + __ascii_prefix_scalar(s + i, n - i);
+    }
+#endif
+
+    /// Finds needle of length m >= 2 in s of length n >= m with the active kernel
+    inline std::size_t
+    __find(const char *s, std::size_t n, const char *needle, std::size_t m) noexcept
+    {
+        switch (ActiveLevel()) {
+#if defined(FTC_SIMD_X86)
+        case SimdLevel::AVX2: return __find_avx2(s, n, needle, m);
+        case SimdLevel::SSE42:
+        case SimdLevel::SSE2: return __find_sse2(s, n, needle, m);
+#elif defined(FTC_SIMD_NEON)
+        case SimdLevel::NEON: return __find_neon(s, n, needle, m);
+#endif
+        default: return __find_scalar(s, n, needle, m);
+        }
+    }
+
+    inline void __convert_case(std::string_view src, char *dst, char first) noexcept
+    {
+        switch (ActiveLevel()) {
+#if defined(FTC_SIMD_X86)
+        case SimdLevel::AVX2: return __convert_case_avx2(src.data(), dst, src.size(), first);
+        case SimdLevel::SSE42:
+        case SimdLevel::SSE2: return __convert_case_sse2(src.data(), dst, src.size(), first);
+#elif defined(FTC_SIMD_NEON)
+        case SimdLevel::NEON: return __convert_case_neon(src.data(), dst, src.size(), first);
+#endif
+        default: return __convert_case_scalar(src.data(), dst, src.size(), first);
+        }
+    }
+
+}  // namespace detail
+
+inline SimdLevel SupportedLevel() noexcept
+{
+    static const SimdLevel level = detail::__detect_level();
+    return level;
+}
+
+inline SimdLevel ActiveLevel() noexcept
+{
+    return detail::__active_level().load(std::memory_order_relaxed);
+}
+
+inline SimdLevel SetLevel(SimdLevel level) noexcept
+{
+    SimdLevel supported = SupportedLevel();
+    if (level == SimdLevel::NEON || supported == SimdLevel::NEON)
+        level = level == supported ? level : SimdLevel::Scalar;
+    else if (level > supported)
+        level = supported;
+
+    detail::__active_level().store(level, std::memory_order_relaxed);
+    return level;
+}
+
+template <std::size_t Len>
+inline std::size_t Searcher<Len>::Find(std::string_view str, std::size_t pos) const noexcept
+{
+    if (pos > str.size())
+        return npos;
+
+    if constexpr (Len == 0) {
+        return pos;
+    }
+    else if constexpr (Len == 1) {
+        return FindChar(str, needle[0], pos);
+    }
+    else {
+        std::size_t n = str.size() - pos;
+        if (n < Len)
+            return npos;
+
+        const char *s = str.data() + pos;
+        std::size_t i = ActiveLevel() == SimdLevel::Scalar
+                            ? Horspool(s, n)
+                            : detail::__find(s, n, needle.data(), Len);
+        return i == n ? npos : pos + i;
+    }
+}
+
+template <std::size_t Len>
+inline std::size_t Searcher<Len>::Horspool(const char *s, std::size_t n) const noexcept
+{
+    for (std::size_t i = 0; i + Len <= n; i += skip[static_cast<unsigned char>(s[i + Len - 1])]) {
+        if (s[i + Len - 1] == needle[Len - 1] && std::memcmp(s + i, needle.data(), Len - 1) == 0)
+            return i;
+    }
+    return n;
+}
+
+inline std::size_t FindChar(std::string_view str, char ch, std::size_t pos) noexcept
+{
+    if (pos >= str.size())
+        return npos;
+
+    const char *s = str.data() + pos;
+    std::size_t n = str.size() - pos;
+    std::size_t i;
+    switch (ActiveLevel()) {
+#if defined(FTC_SIMD_X86)
+    case SimdLevel::AVX2: i = detail::__find_char_avx2(s, n, ch); break;
+    case SimdLevel::SSE42:
+    case SimdLevel::SSE2: i = detail::__find_char_sse2(s, n, ch); break;
+#elif defined(FTC_SIMD_NEON)
+    case SimdLevel::NEON: i = detail::__find_char_neon(s, n, ch); break;
+#endif
+    default: i = detail::__find_char_scalar(s, n, ch); break;
+    }
+    return i == n ? npos : pos + i;
+}
+
+inline std::size_t FindAnyOf(std::string_view str, const CharSet &set, std::size_t pos) noexcept
+{
+    if (pos >= str.size() || set.Size() == 0)
+        return npos;
+
+    const char *s = str.data() + pos;
+    std::size_t n = str.size() - pos;
+    std::size_t i;
+    switch (ActiveLevel()) {
+#if defined(FTC_SIMD_X86)
+    case SimdLevel::AVX2: i = detail::__find_any_avx2(s, n, set); break;
+    case SimdLevel::SSE42:
+        if (set.Size() <= 16) {
+            i = detail::__find_any_sse42(s, n, set);
+            break;
+        }
+        [[fallthrough]];
+#elif defined(FTC_SIMD_NEON)
+    case SimdLevel::NEON: i = detail::__find_any_neon(s, n, set); break;
+#endif
+    default: i = detail::__find_any_scalar(s, n, set); break;
+    }
+    return i == n ? npos : pos + i;
+}
+
+inline std::size_t FindAnyOf(std::string_view str, std::string_view chars, std::size_t pos) noexcept
+{
+    return FindAnyOf(str, CharSet(chars), pos);
+}
+
+inline std::size_t Find(std::string_view str, std::string_view needle, std::size_t pos) noexcept
+{
+    if (pos > str.size())
+        return npos;
+    if (needle.size() <= 1)
+        return needle.empty() ? pos : FindChar(str, needle[0], pos);
+
+    std::size_t n = str.size() - pos;
+    if (n < needle.size())
+        return npos;
+
+    std::size_t i = detail::__find(str.data() + pos, n, needle.data(), needle.size());
+    return i == n ? npos : pos + i;
+}
+
+inline bool Equal(std::string_view a, std::string_view b) noexcept
+{
+    if (a.size() != b.size())
+        return false;
+
+    switch (ActiveLevel()) {
+#if defined(FTC_SIMD_X86)
+    case SimdLevel::AVX2: return detail::__equal_avx2(a.data(), b.data(), a.size());
+    case SimdLevel::SSE42:
+    case SimdLevel::SSE2: return detail::__equal_sse2(a.data(), b.data(), a.size());
+#elif defined(FTC_SIMD_NEON)
+    case SimdLevel::NEON: return detail::__equal_neon(a.data(), b.data(), a.size());
+#endif
+    default: return detail::__equal_scalar(a.data(), b.data(), a.size());
+    }
+}
+
+inline bool EqualIgnoreCase(std::string_view a, std::string_view b) noexcept
+{
+    if (a.size() != b.size())
+        return false;
+
+    switch (ActiveLevel()) {
+#if defined(FTC_SIMD_X86)
+    case SimdLevel::AVX2: return detail::__equal_icase_avx2(a.data(), b.data(), a.size());
+    case SimdLevel::SSE42:
+    case SimdLevel::SSE2: return detail::__equal_icase_sse2(a.data(), b.data(), a.size());
+#elif defined(FTC_SIMD_NEON)
+    case SimdLevel::NEON: return detail::__equal_icase_neon(a.data(), b.data(), a.size());
+#endif
+    default: return detail::__equal_icase_scalar(a.data(), b.data(), a.size());
+    }
+}
+
+inline void ToLower(std::string_view src, char *dst) noexcept
+{
+    detail::__convert_case(src, dst, 'A');
+}
+
+inline void ToUpper(std::string_view src, char *dst) noexcept
+{
+    detail::__convert_case(src, dst, 'a');
+}
+
+inline std::string ToLower(std::string_view str)
+{
+    std::string result(str.size(), '\0');
+    ToLower(str, result.data());
+    return result;
+}
+
+inline std::string ToUpper(std::string_view str)
+{
+    std::string result(str.size(), '\0');
+    ToUpper(str, result.data());
+    return result;
+}
+
+inline bool IsValidUtf8(std::string_view str) noexcept
+{
+    const auto *s = reinterpret_cast<const unsigned char *>(str.data());
+    std::size_t n = str.size();
+
+    switch (ActiveLevel()) {
+#if defined(FTC_SIMD_X86)
+    case SimdLevel::AVX2: return detail::__validate_utf8(s, n, detail::__ascii_prefix_avx2);
+    case SimdLevel::SSE42:
+    case SimdLevel::SSE2: return detail::__validate_utf8(s, n, detail::__ascii_prefix_sse2);
+#elif defined(FTC_SIMD_NEON)
+    case SimdLevel::NEON: return detail::__validate_utf8(s, n, detail::__ascii_prefix_neon);
+#endif
+    default: return detail::__validate_utf8(s, n, detail::__ascii_prefix_scalar);
+    }
+}
+
+}  // namespace ftc::simd
@@ -37,6 +37,11 @@ template <typename F> inline constexpr std::size_t arity_of_v = arity_of<F>::val
 template <typename F, std::size_t N> struct arg_at;
 template <typename F, std::size_t N> using arg_at_t = typename arg_at<F, N>::type;
 
+/// Gets the function type Ret(Args...) of a callable type
+/// @note For a member function pointer, the class reference is the first argument.
+template <typename F> struct signature_of;
+template <typename F> using signature_of_t = typename signature_of<F>::type;
+
 /// Gets the class type of a member function pointer type
 template <typename F> struct class_of_member_func;
 template <typename F> using class_of_member_func_t = typename class_of_member_func<F>::type;
@@ -77,6 +82,7 @@ namespace detail {
 
     public:
         using RetType                         = typename CallType::RetType;
+        using Signature                       = typename CallType::MemberSignature;
         static constexpr std::size_t ArgCount = CallType::ArgCount - 1;
 
         template <std::size_t N> struct Argument
@@ -89,6 +95,7 @@ namespace detail {
     template <typename Ret, typename... Args> struct FunctionTraits<Ret(Args...)>
     {
         using RetType                         = Ret;
+        using Signature                       = Ret(Args...);
         static constexpr std::size_t ArgCount = sizeof...(Args);
 
         template <std::size_t N> struct Argument
@@ -119,7 +126,8 @@ namespace detail {
     template <typename Class, typename Ret, typename... Args>
     struct FunctionTraits<Ret (Class::*)(Args...)> : FunctionTraits<Ret(Class &, Args...)>
     {
-        using ClassType = Class;
+        using ClassType       = Class;
+        using MemberSignature = Ret(Args...);
     };
 
     // 1. Const member function pointer
@@ -194,6 +202,14 @@ template <typename F, std::size_t N> struct arg_at
     using type = typename detail::FunctionTraits<F>::template Argument<N>::type;
 };
 
+template <typename F> struct signature_of
+{
+    static_assert(
+        is_callable_v<F> || std::is_member_function_pointer_v<F>,
+        "signature_of: Type must be an unoverloaded callable type or a member function pointer");
+    using type = typename detail::FunctionTraits<F>::Signature;
+};
+
 template <typename F> struct class_of_member_func
 {
     static_assert(std::is_member_function_pointer_v<F>,
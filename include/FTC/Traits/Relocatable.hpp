@@ -0,0 +1,176 @@
+/**
+ * @file Relocatable.hpp
+ * Trivial Relocation Traits
+ *
+ * Relocating an object moves it to new storage and ends the lifetime of the source. Types whose
+ * relocation is equivalent to a memcpy (no self pointers, no registration of the object
+ * address) are trivially relocatable, which lets containers move them in bulk with memcpy
+ * instead of a move constructor and destructor call per object.
+ */
+
+#pragma once
+
+#include <array>        // for std::array
+#include <cstddef>      // for std::size_t
+#include <cstring>      // for std::memcpy
+#include <memory>       // for std::unique_ptr, std::shared_ptr, std::weak_ptr
+#include <new>          // for placement new
+#include <optional>     // for std::optional
+#include <string>       // for std::basic_string
+#include <tuple>        // for std::tuple
+#include <type_traits>  // for std::is_trivially_copyable, std::is_nothrow_move_constructible
+#include <utility>      // for std::pair, std::move_if_noexcept
+#include <vector>       // for std::vector
+
+namespace ftc {
+
+/// @defgroup Relocation Trivial Relocation
+/// @{
+
+/// Checks if objects of T can be relocated with memcpy
+///
+/// True for trivially copyable types, for common std types known to be relocatable (smart
+/// pointers, and pair, tuple, optional and array of relocatable types; vector and string where
+/// the standard library allows it), and for types that opt in, either with a member alias
+/// `using trivially_relocatable = std::true_type;` or with a specialization:
+///
+///     template <> struct ftc::is_trivially_relocatable<MyType> : std::true_type {};
+template <typename T, typename = void> struct is_trivially_relocatable;
+template <typename T>
+inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+/// Checks if relocating objects of T never throws
+template <typename T>
+inline constexpr bool is_nothrow_relocatable_v =
+    is_trivially_relocatable_v<T> || std::is_nothrow_move_constructible_v<T>;
+
+/// Relocates the object at src to uninitialized storage at dst, returns dst.
+/// Afterwards src is uninitialized storage.
+template <typename T> T *RelocateAt(T *src, T *dst) noexcept(is_nothrow_relocatable_v<T>);
+
+/// Relocates n objects from src to uninitialized storage at dst, returns the end of dst.
+/// The ranges must not overlap. If a move constructor throws, the objects constructed in dst
+/// are destroyed and src is left intact.
+template <typename T>
+T *UninitializedRelocateN(T *src, std::size_t n, T *dst) noexcept(is_nothrow_relocatable_v<T>);
+
+/// Relocates [first, last) to uninitialized storage at dst, returns the end of dst.
+/// @see UninitializedRelocateN
+template <typename T>
+T *UninitializedRelocate(T *first, T *last, T *dst) noexcept(is_nothrow_relocatable_v<T>);
+
+/// @}
+
+}  // namespace ftc
+
+// -------------------------------------------------
+// Implementation
+
+namespace ftc {
+
+template <typename T, typename> struct is_trivially_relocatable : std::is_trivially_copyable<T>
+{};
+
+template <typename T>
+struct is_trivially_relocatable<T, std::void_t<typename T::trivially_relocatable>>
+    : std::bool_constant<T::trivially_relocatable::value || std::is_trivially_copyable_v<T>>
+{};
+
+template <typename T, typename D>
+struct is_trivially_relocatable<std::unique_ptr<T, D>> : is_trivially_relocatable<D>
+{};
+
+template <typename T> struct is_trivially_relocatable<std::shared_ptr<T>> : std::true_type
+{};
+
+template <typename T> struct is_trivially_relocatable<std::weak_ptr<T>> : std::true_type
+{};
+
+template <typename T1, typename T2>
+struct is_trivially_relocatable<std::pair<T1, T2>>
+    : std::bool_constant<is_trivially_relocatable_v<T1> && is_trivially_relocatable_v<T2>>
+{};
+
+template <typename... Ts>
+struct is_trivially_relocatable<std::tuple<Ts...>>
+    : std::bool_constant<(is_trivially_relocatable_v<Ts> && ...)>
+{};
+
+template <typename T>
+struct is_trivially_relocatable<std::optional<T>> : is_trivially_relocatable<T>
+{};
+
+template <typename T, std::size_t N>
+struct is_trivially_relocatable<std::array<T, N>> : is_trivially_relocatable<T>
+{};
+
+template <typename T, std::size_t N>
+struct is_trivially_relocatable<T[N]> : is_trivially_relocatable<T>
+{};
+
+#if !defined(_MSC_VER)
+// MSVC containers may keep a proxy pointing back to the container for iterator debugging
+template <typename T>
+struct is_trivially_relocatable<std::vector<T, std::allocator<T>>> : std::true_type
+{};
+#endif
+
+#if defined(_LIBCPP_VERSION)
+// libstdc++ strings point into themselves when short
+template <typename CharT, typename Traits>
+struct is_trivially_relocatable<std::basic_string<CharT, Traits, std::allocator<CharT>>>
+    : std::true_type
+{};
+#endif
+
+template <typename T>
+inline T *RelocateAt(T *src, T *dst) noexcept(is_nothrow_relocatable_v<T>)
+{
+    if constexpr (is_trivially_relocatable_v<T>)
+        std::memcpy(static_cast<void *>(dst), static_cast<const void *>(src), sizeof(T));
+    else {
+        new (dst) T(std::move(*src));
+        src->~T();
+    }
+    return dst;
+}
+
+template <typename T>
+inline T *UninitializedRelocateN(T *src, std::size_t n, T *dst) noexcept(
+    is_nothrow_relocatable_v<T>)
+{
+    if constexpr (is_trivially_relocatable_v<T>) {
+        if (n)
+            std::memcpy(static_cast<void *>(dst), static_cast<const void *>(src), n * sizeof(T));
+    }
+    else if constexpr (std::is_nothrow_move_constructible_v<T>) {
+        for (std::size_t i = 0; i < n; i++) {
+            new (dst + i) T(std::move(src[i]));
+            src[i].~T();
+        }
+    }
+    else {
+        // Copies if T is copyable, so that src is intact when a constructor throws
+        std::size_t i = 0;
+        try {
+            for (; i < n; i++)
+                new (dst + i) T(std::move_if_noexcept(src[i]));
+        }
+        catch (...) {
+            for (std::size_t j = 0; j < i; j++)
+                dst[j].~T();
+            throw;
+        }
+        for (i = 0; i < n; i++)
+            src[i].~T();
+    }
+    return dst + n;
+}
+
+template <typename T>
+inline T *UninitializedRelocate(T *first, T *last, T *dst) noexcept(is_nothrow_relocatable_v<T>)
+{
+    return UninitializedRelocateN(first, std::size_t(last - first), dst);
+}
+
+}  // namespace ftc
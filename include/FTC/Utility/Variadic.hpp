@@ -291,172 +291,128 @@ namespace ftc::variadic {
 
 namespace detail {
 
-    template <typename... Ts> struct are_same;
+    // All algorithms below are non-recursive: arguments are stored in a flat ArgPack, and each
+    // transformation computes the index sequence to forward at compile time, so that a pack of N
+    // arguments takes O(1) instantiation depth and a single forwarding call.
 
-    template <typename First, typename Second, typename... Ts> struct are_same<First, Second, Ts...>
-    {
-        static bool const value = std::is_same_v<First, Second> && are_same<Second, Ts...>::value;
-    };
-
-    template <typename T> struct are_same<T> : std::true_type
+    template <typename... Ts> struct are_same : std::true_type
     {};
 
-    template <> struct are_same<> : std::true_type
-    {};
-
-    template <typename T, typename... Ts> constexpr auto Head(T &&head, Ts &&... tail)
+    template <typename T, typename... Ts> struct are_same<T, Ts...>
     {
-        return std::forward<T>(head);
-    }
+        static constexpr bool value = (std::is_same_v<T, Ts> && ...);
+    };
 
-    template <typename T> constexpr auto Last(T &&head) { return std::forward<T>(head); }
-    template <typename T, typename... Ts> constexpr auto Last(T &&head, Ts &&... tail)
+    template <typename T, typename... Ts> constexpr auto Head(T &&head, Ts &&...)
     {
-        return Last(std::forward<Ts>(tail)...);
+        return std::forward<T>(head);
     }
 
-    template <std::size_t N, typename T, typename... Ts> struct NthElement
+    /// Argument I of an ArgPack
+    template <std::size_t I, typename T> struct ArgLeaf
     {
-        static constexpr auto call(T &&head, Ts &&... tail)
-        {
-            return NthElement<N - 1, Ts...>::call(std::forward<Ts>(tail)...);
-        }
+        T &&value;
     };
 
-    template <typename T, typename... Ts> struct NthElement<0, T, Ts...>
+    /// Flat pack of forwarding references, where any argument is reached by a base conversion
+    template <typename Seq, typename... Ts> struct ArgPack;
+
+    template <std::size_t... I, typename... Ts>
+    struct ArgPack<std::index_sequence<I...>, Ts...> : ArgLeaf<I, Ts>...
     {
-        static constexpr auto call(T &&head, Ts &&... tail) { return std::forward<T>(head); }
+        constexpr ArgPack(Ts &&... vs) : ArgLeaf<I, Ts> {std::forward<Ts>(vs)}... {}
     };
 
-    template <typename F, typename T, typename U> constexpr auto Foldl(F &&func, T &&v1, U &&v2)
-    {
-        return std::forward<F>(func)(std::forward<T>(v1), std::forward<U>(v2));
-    }
+    template <typename... Ts> using ArgPackOf = ArgPack<std::index_sequence_for<Ts...>, Ts...>;
 
-    template <typename F, typename T, typename U, typename... Ts>
-    constexpr auto Foldl(F &&func, T &&v1, U &&v2, Ts &&... vs)
+    template <std::size_t I, typename T> constexpr T &&GetArg(const ArgLeaf<I, T> &leaf)
     {
-        return Foldl(std::forward<F>(func),
-                     std::forward<F>(func)(std::forward<T>(v1), std::forward<U>(v2)),
-                     std::forward<Ts>(vs)...);
+        return std::forward<T>(leaf.value);
     }
 
-    template <typename F, typename T, typename U> constexpr auto Foldr(F &&func, T &&v1, U &&v2)
-    {
-        return std::forward<F>(func)(std::forward<T>(v1), std::forward<U>(v2));
-    }
+    template <std::size_t I, typename T> T TypeOfArg(const ArgLeaf<I, T> &);
 
-    template <typename F, typename T, typename U, typename... Ts>
-    constexpr auto Foldr(F &&func, T &&v1, U &&v2, Ts &&... vs)
+    template <std::size_t I, typename... Ts>
+    using TypeAt = decltype(TypeOfArg<I>(std::declval<ArgPackOf<Ts...>>()));
+
+    /// Calls func(vs[Idx]...)
+    template <std::size_t... Idx, typename F, typename Pack>
+    constexpr auto Select(std::index_sequence<Idx...>, F &&func, const Pack &pack)
     {
-        return std::forward<F>(func)(
-            std::forward<T>(v1),
-            Foldr(std::forward<F>(func), std::forward<U>(v2), std::forward<Ts>(vs)...));
+        return std::forward<F>(func)(GetArg<Idx>(pack)...);
     }
 
-    template <std::size_t N, typename... Revs> struct Reverse
-    {
-        template <typename F, typename T, typename... Ts>
-        static constexpr auto call(F &&func, Revs &&... revs, T &&v, Ts &&... vs)
-        {
-            return Reverse<N - 1, T, Revs...>::call(std::forward<F>(func),
-                                                    std::forward<T>(v),
-                                                    std::forward<Revs>(revs)...,
-                                                    std::forward<Ts>(vs)...);
-        }
-    };
+    /// Makes std::index_sequence<Indices::At(0), ..., Indices::At(Indices::Size - 1)>
+    template <typename Indices, typename = std::make_index_sequence<Indices::Size>>
+    struct IndexSequenceOf;
 
-    template <typename... Ts> struct Reverse<0, Ts...>
+    template <typename Indices, std::size_t... I>
+    struct IndexSequenceOf<Indices, std::index_sequence<I...>>
     {
-        template <typename F> static constexpr auto call(F &&func, Ts &&... vs)
-        {
-            return std::forward<F>(func)(std::forward<Ts>(vs)...);
-        }
+        using type = std::index_sequence<Indices::At(I)...>;
     };
 
-    template <std::size_t N> struct RotateLeft
+    /// Forwards vs[Indices::At(0)], vs[Indices::At(1)], ... to func
+    template <typename Indices, typename F, typename... Ts>
+    constexpr auto Forward(F &&func, Ts &&... vs)
     {
-        template <typename F, typename T, typename... Ts>
-        static constexpr auto call(F &&func, T &&v, Ts &&... vs)
-        {
-            return RotateLeft<N - 1>::call(std::forward<F>(func),
-                                           std::forward<Ts>(vs)...,
-                                           std::forward<T>(v));
-        }
-    };
+        return Select(typename IndexSequenceOf<Indices>::type {},
+                      std::forward<F>(func),
+                      ArgPackOf<Ts...>(std::forward<Ts>(vs)...));
+    }
 
-    template <> struct RotateLeft<0>
+    template <std::size_t L> struct ReverseIndices
     {
-        template <typename F, typename... Ts> static constexpr auto call(F &&func, Ts &&... vs)
-        {
-            return std::forward<F>(func)(std::forward<Ts>(vs)...);
-        }
+        static constexpr std::size_t Size = L;
+        static constexpr std::size_t At(std::size_t i) { return L - 1 - i; }
     };
 
-    template <std::size_t I, std::size_t J, std::size_t N> struct Swap
+    /// Count indices from Begin, wrapping around at L
+    template <std::size_t Begin, std::size_t Count, std::size_t L> struct RangeIndices
     {
-        template <typename F, typename IV, typename JV, typename T, typename... Ts>
-        static constexpr auto call(F &&func, IV &&iv, JV &&jv, T &&v, Ts &&... vs)
-        {
-            if constexpr (N == I) {
-                return Swap<I, J, N - 1>::call(std::forward<F>(func),
-                                               std::forward<IV>(iv),
-                                               std::forward<JV>(jv),
-                                               std::forward<Ts>(vs)...,
-                                               std::forward<JV>(jv));
-            }
-            else if constexpr (N == J) {
-                return Swap<I, J, N - 1>::call(std::forward<F>(func),
-                                               std::forward<IV>(iv),
-                                               std::forward<JV>(jv),
-                                               std::forward<Ts>(vs)...,
-                                               std::forward<IV>(iv));
-            }
-            else {
-                return Swap<I, J, N - 1>::call(std::forward<F>(func),
-                                               std::forward<IV>(iv),
-                                               std::forward<JV>(jv),
-                                               std::forward<Ts>(vs)...,
-                                               std::forward<T>(v));
-            }
-        }
+        static constexpr std::size_t Size = Count;
+        static constexpr std::size_t At(std::size_t i) { return (Begin + i) % L; }
     };
 
-    template <std::size_t I, std::size_t J> struct Swap<I, J, 0>
+    template <std::size_t I, std::size_t J, std::size_t L> struct SwapIndices
     {
-        template <typename F, typename IV, typename JV, typename... Ts>
-        static constexpr auto call(F &&func, IV &&iv, JV &&jv, Ts &&... vs)
-        {
-            return std::forward<F>(func)(std::forward<Ts>(vs)...);
-        }
+        static constexpr std::size_t Size = L;
+        static constexpr std::size_t At(std::size_t i) { return i == I ? J : i == J ? I : i; }
     };
 
-    template <std::size_t I, std::size_t N> struct Swap<I, I, N>
+    /// Indices of an argument list with the element at I replaced by the extra last argument
+    template <std::size_t I, std::size_t L> struct ReplaceIndices
     {
-        template <typename F, typename IV, typename JV, typename... Ts>
-        static constexpr auto call(F &&func, IV &&iv, JV &&jv, Ts &&... vs)
-        {
-            return std::forward<F>(func)(std::forward<Ts>(vs)...);
-        }
+        static constexpr std::size_t Size = L;
+        static constexpr std::size_t At(std::size_t i) { return i == I ? L : i; }
     };
 
-    template <std::size_t N> struct DropFirst
+    template <bool... Keep> struct FilterIndices
     {
-        template <typename F, typename T, typename... Ts>
-        static constexpr auto call(F &&func, T &&v, Ts &&... vs)
+        static constexpr std::size_t Size = (std::size_t(Keep) + ... + 0);
+        static constexpr std::size_t At(std::size_t i)
         {
-            return DropFirst<N - 1>::call(std::forward<F>(func), std::forward<Ts>(vs)...);
+            constexpr bool keep[] = {Keep..., false};
+            std::size_t    k      = 0;
+            for (;; k++)
+                if (keep[k] && i-- == 0)
+                    break;
+            return k;
         }
     };
 
-    template <> struct DropFirst<0>
-    {
-        template <typename F, typename... Ts> static constexpr auto call(F &&func, Ts &&... vs)
-        {
-            return std::forward<F>(func)(std::forward<Ts>(vs)...);
-        }
-    };
+    /// Checks whether R is a compile time boolean like std::bool_constant
+    template <typename R, typename = void> struct IsBoolConstant : std::false_type
+    {};
+
+    template <typename R>
+    struct IsBoolConstant<
+        R,
+        std::void_t<std::integral_constant<bool, bool(std::remove_reference_t<R>::value)>>>
+        : std::true_type
+    {};
 
+    /// Filters with a runtime predicate, instantiating every reachable subsequence
     template <std::size_t N> struct Filter
     {
         template <typename F, typename Pred, typename T, typename... Ts>
@@ -479,63 +435,83 @@ namespace detail {
     template <> struct Filter<0>
     {
         template <typename F, typename Pred, typename... Ts>
-        static constexpr auto call(F &&func, Pred &&pred, Ts &&... vs)
+        static constexpr auto call(F &&func, Pred &&, Ts &&... vs)
         {
             return std::forward<F>(func)(std::forward<Ts>(vs)...);
         }
     };
 
-    template <std::size_t I, std::size_t N> struct ReplaceAt
+    /// Left fold accumulator, `acc << v` evaluates to func(acc, v) in a fold expression
+    template <typename F, typename Acc> struct FoldlAcc
     {
-        template <typename F, typename Val, typename T, typename... Ts>
-        static constexpr auto call(F &&func, Val &&val, T &&v, Ts &&... vs)
+        F & func;
+        Acc value;
+
+        template <typename T> constexpr auto operator<<(T &&v) &&
         {
-            if constexpr (I == N) {
-                return RotateLeft<N - 1>::call(std::forward<F>(func),
-                                               std::forward<Ts>(vs)...,
-                                               std::forward<Val>(val));
-            }
-            else {
-                return ReplaceAt<I, N - 1>::call(std::forward<F>(func),
-                                                 std::forward<Val>(val),
-                                                 std::forward<Ts>(vs)...,
-                                                 std::forward<T>(v));
-            }
+            using R = std::decay_t<decltype(std::forward<F>(func)(std::move(value),
+                                                                   std::forward<T>(v)))>;
+            return FoldlAcc<F, R> {
+                func, std::forward<F>(func)(std::move(value), std::forward<T>(v))};
         }
     };
 
-    template <std::size_t N> struct GenIndexSequence
+    /// Argument of a right fold
+    template <typename T> struct FoldrArg
     {
-        template <typename F, typename... Ts> static constexpr auto call(F &&func, Ts &&... vs)
-        {
-            return GenIndexSequence<N - 1>::call(std::forward<F>(func),
-                                                 N - 1,
-                                                 std::forward<Ts>(vs)...);
-        }
+        T &&value;
     };
 
-    template <> struct GenIndexSequence<0>
+    /// Right fold accumulator, `v << acc` evaluates to func(v, acc) in a fold expression
+    template <typename F, typename Acc> struct FoldrAcc
     {
-        template <typename F, typename... Ts> static constexpr auto call(F &&func, Ts &&... vs)
+        F & func;
+        Acc value;
+
+        template <typename T> friend constexpr auto operator<<(FoldrArg<T> &&v, FoldrAcc &&acc)
         {
-            return std::forward<F>(func)(std::forward<Ts>(vs)...);
+            using R = std::decay_t<decltype(std::forward<F>(acc.func)(std::forward<T>(v.value),
+                                                                       std::move(acc.value)))>;
+            return FoldrAcc<F, R> {
+                acc.func,
+                std::forward<F>(acc.func)(std::forward<T>(v.value), std::move(acc.value))};
         }
     };
 
-    template <int Cur, int E, int S> struct GenIntSequence
+    template <typename F, typename Acc, typename... Ts>
+    constexpr auto Foldl(F &func, Acc &&init, Ts &&... vs)
     {
-        template <typename F, typename... Ts> static constexpr auto call(F &&func, Ts &&... vs)
-        {
-            if constexpr (S > 0 && Cur >= E || S < 0 && Cur <= E) {
-                return std::forward<F>(func)(std::forward<Ts>(vs)...);
-            }
-            else {
-                return GenIntSequence<Cur + S, E, S>::call(std::forward<F>(func),
-                                                           std::forward<Ts>(vs)...,
-                                                           Cur);
-            }
-        }
-    };
+        return (FoldlAcc<F, std::decay_t<Acc>> {func, std::forward<Acc>(init)} << ...
+                << std::forward<Ts>(vs))
+            .value;
+    }
+
+    template <typename F, typename Acc, typename... Ts>
+    constexpr auto Foldr(F &func, Acc &&init, Ts &&... vs)
+    {
+        return (FoldrArg<Ts> {std::forward<Ts>(vs)} << ...
+                << FoldrAcc<F, std::decay_t<Acc>> {func, std::forward<Acc>(init)})
+            .value;
+    }
+
+    /// Right fold taking the last argument as initial value
+    template <typename F, typename Pack, std::size_t... I>
+    constexpr auto FoldrLast(F &func, const Pack &pack, std::index_sequence<I...>)
+    {
+        return Foldr(func, GetArg<sizeof...(I)>(pack), GetArg<I>(pack)...);
+    }
+
+    template <typename F, std::size_t... I>
+    constexpr auto ForwardIndices(F &&func, std::index_sequence<I...>)
+    {
+        return std::forward<F>(func)(I...);
+    }
+
+    template <int Begin, int Step, typename F, std::size_t... I>
+    constexpr auto ForwardInts(F &&func, std::index_sequence<I...>)
+    {
+        return std::forward<F>(func)((Begin + int(I) * Step)...);
+    }
 
 }  // namespace detail
 
@@ -579,14 +555,14 @@ template <typename... Ts> constexpr auto Head(Ts &&... vs)
 template <typename... Ts> constexpr auto Last(Ts &&... vs)
 {
     static_assert(sizeof...(vs) > 0, "Last: Empty variadic list");
-    return detail::Last(std::forward<Ts>(vs)...);
+    return detail::GetArg<sizeof...(vs) - 1>(detail::ArgPackOf<Ts...>(std::forward<Ts>(vs)...));
 }
 
 template <int Idx, typename... Ts> constexpr auto Get(Ts &&... vs)
 {
     constexpr int Len = sizeof...(vs);
     static_assert(-Len <= Idx && Idx < Len, "Get: Index out of range");
-    return detail::NthElement<(Idx + Len) % Len, Ts...>::call(std::forward<Ts>(vs)...);
+    return detail::GetArg<(Idx + Len) % Len>(detail::ArgPackOf<Ts...>(std::forward<Ts>(vs)...));
 }
 
 template <typename F, typename Acc> constexpr auto Foldl(F &&func, Acc &&init)
@@ -596,9 +572,8 @@ template <typename F, typename Acc> constexpr auto Foldl(F &&func, Acc &&init)
             return std::forward<decltype(init)>(init);
         }
         else {
-            return detail::Foldl(std::forward<decltype(func)>(func),
-                                 std::forward<decltype(init)>(init),
-                                 std::forward<decltype(vs)>(vs)...);
+            return detail::Foldl(
+                func, std::forward<decltype(init)>(init), std::forward<decltype(vs)>(vs)...);
         }
     };
 }
@@ -609,7 +584,7 @@ template <typename F> constexpr auto Foldl(F &&func)
         static_assert(sizeof...(vs) >= 2,
                       "Foldl: Variadic list should contain at least 2 elements");
 
-        return detail::Foldl(std::forward<decltype(func)>(func), std::forward<decltype(vs)>(vs)...);
+        return detail::Foldl(func, std::forward<decltype(vs)>(vs)...);
     };
 }
 
@@ -620,9 +595,8 @@ template <typename F, typename Acc> constexpr auto Foldr(F &&func, Acc &&init)
             return std::forward<decltype(init)>(init);
         }
         else {
-            return detail::Foldr(std::forward<decltype(func)>(func),
-                                 std::forward<decltype(vs)>(vs)...,
-                                 std::forward<decltype(init)>(init));
+            return detail::Foldr(
+                func, std::forward<decltype(init)>(init), std::forward<decltype(vs)>(vs)...);
         }
     };
 }
@@ -633,7 +607,10 @@ template <typename F> constexpr auto Foldr(F &&func)
         static_assert(sizeof...(vs) >= 2,
                       "Foldr: Variadic list should contain at least 2 elements");
 
-        return detail::Foldr(std::forward<decltype(func)>(func), std::forward<decltype(vs)>(vs)...);
+        return detail::FoldrLast(
+            func,
+            detail::ArgPackOf<decltype(vs)...>(std::forward<decltype(vs)>(vs)...),
+            std::make_index_sequence<sizeof...(vs) - 1>());
     };
 }
 
@@ -676,29 +653,30 @@ template <typename F> constexpr auto FindFirst(F &&func)
 template <typename F> constexpr auto Reverse(F &&funcToForward)
 {
     return [func = std::forward<F>(funcToForward)](auto &&... vs) mutable {
-        return detail::Reverse<sizeof...(vs)>::call(std::forward<decltype(func)>(func),
-                                                    std::forward<decltype(vs)>(vs)...);
+        return detail::Forward<detail::ReverseIndices<sizeof...(vs)>>(
+            std::forward<decltype(func)>(func), std::forward<decltype(vs)>(vs)...);
     };
 }
 
 template <std::size_t N, typename F> constexpr auto RotateLeft(F &&funcToForward)
 {
     return [func = std::forward<F>(funcToForward)](auto &&... vs) mutable {
-        constexpr std::size_t ShiftAmount = sizeof...(vs) == 0 ? 0 : N % sizeof...(vs);
+        constexpr std::size_t L           = sizeof...(vs);
+        constexpr std::size_t ShiftAmount = L == 0 ? 0 : N % L;
 
-        return detail::RotateLeft<ShiftAmount>::call(std::forward<decltype(func)>(func),
-                                                     std::forward<decltype(vs)>(vs)...);
+        return detail::Forward<detail::RangeIndices<ShiftAmount, L, L>>(
+            std::forward<decltype(func)>(func), std::forward<decltype(vs)>(vs)...);
     };
 }
 
 template <std::size_t N, typename F> constexpr auto RotateRight(F &&funcToForward)
 {
     return [func = std::forward<F>(funcToForward)](auto &&... vs) mutable {
-        constexpr std::size_t ShiftAmount =
-            sizeof...(vs) == 0 ? 0 : sizeof...(vs) - (N % sizeof...(vs));
+        constexpr std::size_t L           = sizeof...(vs);
+        constexpr std::size_t ShiftAmount = L == 0 ? 0 : L - (N % L);
 
-        return detail::RotateLeft<ShiftAmount>::call(std::forward<decltype(func)>(func),
-                                                     std::forward<decltype(vs)>(vs)...);
+        return detail::Forward<detail::RangeIndices<ShiftAmount, L, L>>(
+            std::forward<decltype(func)>(func), std::forward<decltype(vs)>(vs)...);
     };
 }
 
@@ -719,66 +697,55 @@ template <std::size_t I, std::size_t J, typename F> constexpr auto Swap(F &&func
         static_assert(I < L, "Swap: Index I out of range");
         static_assert(J < L, "Swap: Index J out of range");
 
-        return detail::Swap<L - I, L - J, L>::call(std::forward<decltype(func)>(func),
-                                                   Get<I>(std::forward<decltype(vs)>(vs)...),
-                                                   Get<J>(std::forward<decltype(vs)>(vs)...),
-                                                   std::forward<decltype(vs)>(vs)...);
+        return detail::Forward<detail::SwapIndices<I, J, L>>(std::forward<decltype(func)>(func),
+                                                             std::forward<decltype(vs)>(vs)...);
     };
 }
 
 template <int N, typename F> constexpr auto Take(F &&funcToForward)
 {
-    if constexpr (N < 0) {
-        return [func = std::forward<F>(funcToForward)](auto &&... vs) mutable {
-            static_assert(-N <= sizeof...(vs), "Take: -N is greater than the number of arguments");
-
-            return detail::DropFirst<sizeof...(vs) - (-N)>::call(std::forward<decltype(func)>(func),
-                                                                 std::forward<decltype(vs)>(vs)...);
-        };
-    }
-    else {
-        return RotateLeft<N>([func = std::forward<F>(funcToForward)](auto &&... vs) mutable {
-            static_assert(N <= sizeof...(vs), "Take: N is greater than the number of arguments");
+    return [func = std::forward<F>(funcToForward)](auto &&... vs) mutable {
+        constexpr int L = sizeof...(vs);
+        if constexpr (N < 0)
+            static_assert(-N <= L, "Take: -N is greater than the number of arguments");
+        else
+            static_assert(N <= L, "Take: N is greater than the number of arguments");
+        constexpr std::size_t Count = N < 0 ? -N : N;
 
-            return detail::DropFirst<sizeof...(vs) - N>::call(std::forward<decltype(func)>(func),
-                                                              std::forward<decltype(vs)>(vs)...);
-        });
-    }
+        return detail::Forward<detail::RangeIndices<(N < 0 ? L - Count : 0), Count, L>>(
+            std::forward<decltype(func)>(func), std::forward<decltype(vs)>(vs)...);
+    };
 }
 
 template <int N, typename F> constexpr auto Drop(F &&funcToForward)
 {
-    if constexpr (N < 0) {
-        return RotateRight<-N>([func = std::forward<F>(funcToForward)](auto &&... vs) mutable {
-            static_assert(-N <= sizeof...(vs), "Drop: -N is greater than the number of arguments");
-
-            return detail::DropFirst<-N>::call(std::forward<decltype(func)>(func),
-                                               std::forward<decltype(vs)>(vs)...);
-        });
-    }
-    else {
-        return [func = std::forward<F>(funcToForward)](auto &&... vs) mutable {
-            static_assert(N <= sizeof...(vs), "Drop: N is greater than the number of arguments");
+    return [func = std::forward<F>(funcToForward)](auto &&... vs) mutable {
+        constexpr int L = sizeof...(vs);
+        if constexpr (N < 0)
+            static_assert(-N <= L, "Drop: -N is greater than the number of arguments");
+        else
+            static_assert(N <= L, "Drop: N is greater than the number of arguments");
+        constexpr std::size_t Count = L - (N < 0 ? -N : N);
 
-            return detail::DropFirst<N>::call(std::forward<decltype(func)>(func),
-                                              std::forward<decltype(vs)>(vs)...);
-        };
-    }
+        return detail::Forward<detail::RangeIndices<(N < 0 ? 0 : N), Count, L>>(
+            std::forward<decltype(func)>(func), std::forward<decltype(vs)>(vs)...);
+    };
 }
 
 template <int N, int M, typename F> constexpr auto Slice(F &&funcToForward)
 {
     static_assert(N <= M, "Slice: N must be not greater than M");
     return [func = std::forward<F>(funcToForward)](auto &&... vs) mutable {
-        static_assert(M - N <= sizeof...(vs),
-                      "Slice: Slice size is greater than the number of arguments");
+        constexpr int L = sizeof...(vs);
+        static_assert(M - N <= L, "Slice: Slice size is greater than the number of arguments");
         if constexpr (N < 0)
-            static_assert(-N <= sizeof...(vs), "Slice: -N is greater than the number of arguments");
+            static_assert(-N <= L, "Slice: -N is greater than the number of arguments");
         if constexpr (M >= 0)
-            static_assert(M <= sizeof...(vs), "Slice: M is greater than the number of arguments");
+            static_assert(M <= L, "Slice: M is greater than the number of arguments");
+        constexpr std::size_t Begin = L == 0 ? 0 : ((N % L) + L) % L;
 
-        return Rotate<N>(Take<M - N>(std::forward<decltype(func)>(func)))(
-            std::forward<decltype(vs)>(vs)...);
+        return detail::Forward<detail::RangeIndices<Begin, M - N, L>>(
+            std::forward<decltype(func)>(func), std::forward<decltype(vs)>(vs)...);
     };
 }
 
@@ -795,9 +762,20 @@ template <typename Pred, typename F> constexpr auto Filter(Pred &&pred, F &&func
 {
     return [pred = std::forward<Pred>(pred),
             func = std::forward<F>(funcToForward)](auto &&... vs) mutable {
-        return detail::Filter<sizeof...(vs)>::call(std::forward<decltype(func)>(func),
-                                                   std::forward<decltype(pred)>(pred),
-                                                   std::forward<decltype(vs)>(vs)...);
+        if constexpr ((detail::IsBoolConstant<decltype(std::forward<decltype(pred)>(pred)(
+                           std::forward<decltype(vs)>(vs)))>::value &&
+                       ...)) {
+            using Indices = detail::FilterIndices<bool(
+                std::remove_reference_t<decltype(std::forward<decltype(pred)>(pred)(
+                    std::forward<decltype(vs)>(vs)))>::value)...>;
+            return detail::Forward<Indices>(std::forward<decltype(func)>(func),
+                                            std::forward<decltype(vs)>(vs)...);
+        }
+        else {
+            return detail::Filter<sizeof...(vs)>::call(std::forward<decltype(func)>(func),
+                                                       std::forward<decltype(pred)>(pred),
+                                                       std::forward<decltype(vs)>(vs)...);
+        }
     };
 }
 
@@ -806,13 +784,13 @@ constexpr auto ReplaceAt(Val &&value, F &&funcToForward)
 {
     return [val  = std::forward<Val>(value),
             func = std::forward<F>(funcToForward)](auto &&... vs) mutable {
-        static_assert(-Idx <= sizeof...(vs) && Idx < sizeof...(vs),
-                      "ReplaceAt: Idx is out of range");
+        constexpr int L = sizeof...(vs);
+        static_assert(-L <= Idx && Idx < L, "ReplaceAt: Idx is out of range");
 
-        return detail::ReplaceAt < Idx < 0 ? -Idx : sizeof...(vs) - Idx,
-               sizeof...(vs) > ::call(std::forward<decltype(func)>(func),
-                                      std::forward<decltype(val)>(val),
-                                      std::forward<decltype(vs)>(vs)...);
+        return detail::Forward<detail::ReplaceIndices<(Idx + L) % L, L>>(
+            std::forward<decltype(func)>(func),
+            std::forward<decltype(vs)>(vs)...,
+            std::forward<decltype(val)>(val));
     };
 }
 
@@ -822,22 +800,27 @@ template <int... Idx, typename F> constexpr auto Permute(F &&funcToForward)
         constexpr int Len = sizeof...(vs);
         static_assert(((-Len <= Idx && Idx < Len) && ...), "Permute: Idx is out of range");
 
-        return std::forward<decltype(func)>(func)(Get<Idx>(std::forward<decltype(vs)>(vs)...)...);
+        using Pack = detail::ArgPackOf<decltype(vs)...>;
+        return detail::Select(std::index_sequence<((Idx + Len) % Len)...> {},
+                              std::forward<decltype(func)>(func),
+                              Pack(std::forward<decltype(vs)>(vs)...));
     };
 }
 
 template <std::size_t N, typename F> constexpr auto IndexSequence(F &&funcToForward)
 {
-    return detail::GenIndexSequence<N>::call(std::forward<F>(funcToForward));
+    return detail::ForwardIndices(std::forward<F>(funcToForward), std::make_index_sequence<N>());
 }
 
 template <int Begin, int End, int Step, typename F> constexpr auto IntSequence(F &&funcToForward)
 {
     static_assert(Step != 0, "IntSequence: Step must not be zero");
-    static_assert(Step > 0 && Begin <= End || Step < 0 && Begin >= End,
+    static_assert((Step > 0 && Begin <= End) || (Step < 0 && Begin >= End),
                   "IntSequence: Invalid Range");
 
-    return detail::GenIntSequence<Begin, End, Step>::call(std::forward<F>(funcToForward));
+    constexpr int Count = (End - Begin + Step + (Step > 0 ? -1 : 1)) / Step;
+    return detail::ForwardInts<Begin, Step>(std::forward<F>(funcToForward),
+                                            std::make_index_sequence<Count>());
 }
 
 }  // namespace ftc::variadic
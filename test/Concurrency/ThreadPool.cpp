@@ -0,0 +1,163 @@
+#include "FTC/Concurrency/ThreadPool.hpp"
+
+#include <atomic>
+#include <gtest/gtest.h>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ftc;
+
+TEST(ThreadPool, Submit)
+{
+    ThreadPool pool(4);
+    EXPECT_EQ(pool.NumThreads(), 4);
+
+    std::vector<TaskFuture<int>> futures;
+    for (int i = 0; i < 1000; i++)
+        futures.push_back(pool.Submit([i] { return i * 2; }));
+    for (int i = 0; i < 1000; i++)
+        EXPECT_EQ(futures[i].Get(), i * 2);
+    for (TaskFuture<int> &f : futures)
+        EXPECT_FALSE(f.Valid());
+}
+
+TEST(ThreadPool, SubmitVoidAndMoveOnly)
+{
+    ThreadPool       pool(2);
+    std::atomic<int> sum {0};
+
+    TaskFuture<void> f1 = pool.Submit([&sum] { sum += 1; });
+    TaskFuture<int>  f2 = pool.Submit([p = std::make_unique<int>(41)] { return *p + 1; });
+    TaskFuture<std::string> f3 = pool.Submit([] { return std::string("result"); });
+
+    f1.Get();
+    EXPECT_EQ(sum.load(), 1);
+    EXPECT_EQ(f2.Get(), 42);
+    EXPECT_EQ(f3.Get(), "result");
+}
+
+TEST(ThreadPool, Exception)
+{
+    ThreadPool      pool(2);
+    TaskFuture<int> f = pool.Submit([]() -> int { throw std::runtime_error("error"); });
+    f.Wait();
+    EXPECT_TRUE(f.IsReady());
+    EXPECT_THROW(f.Get(), std::runtime_error);
+}
+
+TEST(ThreadPool, TaskSlotsRecycled)
+{
+    // Far more tasks than slots, including discarded futures
+    ThreadPool       pool(3, 32);
+    std::atomic<int> count {0};
+    for (int i = 0; i < 10000; i++) {
+        if (i % 2)
+            pool.Post([&count] { count++; });
+        else
+            pool.Submit([&count] { count++; });
+    }
+    pool.Submit([] {}).Wait();
+    while (count.load() != 10000)
+        std::this_thread::yield();
+}
+
+TEST(ThreadPool, TaskSlotsNotLostUnderContention)
+{
+    // Several threads cycle through all slots many times, a lost slot would eventually make
+    // Submit() spin forever
+    constexpr std::size_t numSlots = 32;
+    ThreadPool            pool(2, numSlots);
+    std::atomic<int>      count {0};
+
+    std::vector<std::thread> submitters;
+    for (int t = 0; t < 4; t++)
+        submitters.emplace_back([&] {
+            std::vector<TaskFuture<void>> futures;
+            for (int round = 0; round < 2000; round++) {
+                for (std::size_t i = 0; i < numSlots / 4; i++)
+                    futures.push_back(pool.Submit([&count] { count++; }));
+                for (TaskFuture<void> &f : futures)
+                    f.Get();
+                futures.clear();
+            }
+        });
+    for (std::thread &t : submitters)
+        t.join();
+    EXPECT_EQ(count.load(), 4 * 2000 * int(numSlots / 4));
+
+    // Every slot is free again, so all of them can be held at once
+    std::vector<TaskFuture<int>> held;
+    for (std::size_t i = 0; i < numSlots; i++)
+        held.push_back(pool.Submit([i] { return int(i); }));
+    for (std::size_t i = 0; i < numSlots; i++)
+        EXPECT_EQ(held[i].Get(), int(i));
+}
+
+TEST(ThreadPool, NestedSubmit)
+{
+    ThreadPool       pool(4);
+    std::atomic<int> count {0};
+
+    std::vector<TaskFuture<void>> futures;
+    for (int i = 0; i < 16; i++) {
+        futures.push_back(pool.Submit([&pool, &count] {
+            std::vector<TaskFuture<int>> inner;
+            for (int j = 0; j < 16; j++)
+                inner.push_back(pool.Submit([j] { return j; }));
+            for (int j = 0; j < 16; j++)
+                count += inner[j].Get();
+        }));
+    }
+    for (TaskFuture<void> &f : futures)
+        f.Get();
+    EXPECT_EQ(count.load(), 16 * (15 * 16 / 2));
+}
+
+TEST(ThreadPool, ParallelFor)
+{
+    ThreadPool pool(4);
+
+    std::vector<int> values(100000, 0);
+    pool.ParallelFor(std::size_t(0), values.size(), [&](std::size_t i) { values[i] += int(i); });
+    for (std::size_t i = 0; i < values.size(); i++)
+        ASSERT_EQ(values[i], int(i));
+
+    std::atomic<int> count {0};
+    pool.ParallelFor(0, 7, [&](int) { count++; }, 2);
+    EXPECT_EQ(count.load(), 7);
+
+    pool.ParallelFor(5, 5, [&](int) { count++; });
+    EXPECT_EQ(count.load(), 7);
+}
+
+TEST(ThreadPool, NestedParallelFor)
+{
+    ThreadPool       pool(4);
+    std::atomic<int> count {0};
+    pool.ParallelFor(0, 32, [&](int) {
+        pool.ParallelFor(0, 32, [&](int) { count++; }, 1);
+    }, 1);
+    EXPECT_EQ(count.load(), 32 * 32);
+}
+
+TEST(ThreadPool, ParallelForException)
+{
+    ThreadPool       pool(4);
+    std::atomic<int> count {0};
+    auto             body = [&](int i) {
+        count++;
+        if (i == 50)
+            throw std::runtime_error("error");
+    };
+    EXPECT_THROW(pool.ParallelFor(0, 100, body, 10), std::runtime_error);
+    EXPECT_EQ(count.load(), 91);  // the rest of the throwing chunk is skipped
+}
+
+int main(int argc, char *argv[])
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
\ No newline at end of file
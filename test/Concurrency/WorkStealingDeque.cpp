@@ -0,0 +1,96 @@
+#include "FTC/Concurrency/WorkStealingDeque.hpp"
+
+#include <atomic>
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+using namespace ftc;
+
+TEST(WorkStealingDeque, SingleThread)
+{
+    WorkStealingDeque<int, 64> deque;
+    EXPECT_TRUE(deque.Empty());
+    EXPECT_FALSE(deque.TryPop().has_value());
+    EXPECT_FALSE(deque.TrySteal().has_value());
+
+    for (int i = 0; i < 64; i++)
+        EXPECT_TRUE(deque.TryPush(i));
+    EXPECT_FALSE(deque.TryPush(64));
+    EXPECT_EQ(deque.Count(), 64);
+
+    // Owner pops LIFO, thieves steal FIFO
+    EXPECT_EQ(deque.TryPop(), 63);
+    EXPECT_EQ(deque.TrySteal(), 0);
+    EXPECT_EQ(deque.TryPop(), 62);
+    EXPECT_EQ(deque.TrySteal(), 1);
+    EXPECT_EQ(deque.Count(), 60);
+
+    for (int i = 2; i < 62; i++)
+        EXPECT_EQ(deque.TrySteal(), i);
+    EXPECT_TRUE(deque.Empty());
+    EXPECT_FALSE(deque.TryPop().has_value());
+
+    // Wraps around the buffer
+    for (int round = 0; round < 10; round++) {
+        for (int i = 0; i < 48; i++)
+            EXPECT_TRUE(deque.TryPush(i));
+        for (int i = 0; i < 48; i++)
+            EXPECT_EQ(deque.TryPop(), 47 - i);
+    }
+}
+
+TEST(WorkStealingDeque, MultiThreadSteal)
+{
+    constexpr int              NumItems   = 100000;
+    constexpr int              NumThieves = 3;
+    WorkStealingDeque<int, 256> deque;
+
+    std::vector<std::atomic<int>> taken(NumItems);
+    std::atomic<int>              numTaken {0};
+    std::vector<std::thread>      thieves;
+
+    for (int i = 0; i < NumThieves; i++) {
+        thieves.emplace_back([&] {
+            while (numTaken.load() < NumItems) {
+                if (std::optional<int> v = deque.TrySteal()) {
+                    taken[*v]++;
+                    numTaken++;
+                }
+                else
+                    std::this_thread::yield();
+            }
+        });
+    }
+
+    for (int i = 0; i < NumItems; i++) {
+        while (!deque.TryPush(i)) {
+            if (std::optional<int> v = deque.TryPop()) {
+                taken[*v]++;
+                numTaken++;
+            }
+        }
+        if (i % 3 == 0) {
+            if (std::optional<int> v = deque.TryPop()) {
+                taken[*v]++;
+                numTaken++;
+            }
+        }
+    }
+    while (std::optional<int> v = deque.TryPop()) {
+        taken[*v]++;
+        numTaken++;
+    }
+
+    for (std::thread &t : thieves)
+        t.join();
+    EXPECT_EQ(numTaken.load(), NumItems);
+    for (int i = 0; i < NumItems; i++)
+        EXPECT_EQ(taken[i].load(), 1) << "item " << i;
+}
+
+int main(int argc, char *argv[])
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
\ No newline at end of file
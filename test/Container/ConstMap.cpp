@@ -0,0 +1,82 @@
+#include "FTC/Container/ConstMap.hpp"
+
+#include "FTC/String/ConstString.hpp"
+
+#include <gtest/gtest.h>
+#include <string>
+#include <string_view>
+
+using namespace ftc;
+
+constexpr auto Keywords = MakeConstMap<int>({
+    {"alignas", 0},    {"alignof", 1},   {"auto", 2},      {"bool", 3},       {"break", 4},
+    {"case", 5},       {"catch", 6},     {"char", 7},      {"class", 8},      {"const", 9},
+    {"constexpr", 10}, {"continue", 11}, {"decltype", 12}, {"default", 13},   {"delete", 14},
+    {"do", 15},        {"double", 16},   {"else", 17},     {"enum", 18},      {"explicit", 19},
+    {"export", 20},    {"extern", 21},   {"false", 22},    {"float", 23},     {"for", 24},
+    {"friend", 25},    {"goto", 26},     {"if", 27},       {"inline", 28},    {"int", 29},
+    {"long", 30},      {"mutable", 31},  {"namespace", 32}, {"new", 33},      {"noexcept", 34},
+    {"nullptr", 35},   {"operator", 36}, {"private", 37},  {"protected", 38}, {"public", 39},
+    {"return", 40},    {"short", 41},    {"signed", 42},   {"sizeof", 43},    {"static", 44},
+    {"struct", 45},    {"switch", 46},   {"template", 47}, {"this", 48},      {"throw", 49},
+    {"true", 50},      {"try", 51},      {"typedef", 52},  {"typename", 53},  {"union", 54},
+    {"unsigned", 55},  {"using", 56},    {"virtual", 57},  {"void", 58},      {"volatile", 59},
+    {"while", 60},
+});
+
+static_assert(Keywords.Size() == 61);
+static_assert(*Keywords.Find("constexpr") == 10);
+static_assert(Keywords.At("while") == 60);
+static_assert(!Keywords.Contains("constinit"));
+static_assert(Keywords.Get("", -1) == -1);
+
+TEST(ConstMap, Lookup)
+{
+    int index = 0;
+    for (const auto &[key, value] : Keywords) {
+        EXPECT_EQ(value, index++);
+        std::string runtimeKey(key);
+        ASSERT_NE(Keywords.Find(runtimeKey), nullptr);
+        EXPECT_EQ(*Keywords.Find(runtimeKey), value);
+
+        runtimeKey += '_';
+        EXPECT_FALSE(Keywords.Contains(runtimeKey));
+        EXPECT_FALSE(Keywords.Contains(runtimeKey.substr(0, key.size() - 1)));
+    }
+    EXPECT_THROW((void)Keywords.At("register"), std::out_of_range);
+}
+
+static constexpr ConstString Get("get");
+static constexpr ConstString Set("set");
+
+int DoGet(int x)
+{
+    return x;
+}
+
+int DoSet(int x)
+{
+    return -x;
+}
+
+TEST(ConstMap, Dispatch)
+{
+    using Handler            = int (*)(int);
+    constexpr auto Commands  = MakeConstMap<Handler>({{Get, DoGet}, {Set, DoSet}});
+    constexpr auto Empty     = MakeConstMap<int>();
+    constexpr auto Singleton = MakeConstMap<int>({{"only", 1}});
+
+    EXPECT_EQ(Commands.At("get")(3), 3);
+    EXPECT_EQ(Commands.At(Set)(3), -3);
+    EXPECT_EQ(Commands.Find("put"), nullptr);
+    EXPECT_TRUE(Empty.Empty());
+    EXPECT_FALSE(Empty.Contains("only"));
+    EXPECT_EQ(Singleton.Get("only", 0), 1);
+    EXPECT_EQ(Singleton.Get("none", 0), 0);
+
+    // Built at runtime from runtime keys as well
+    std::string a = "a", b = "b";
+    auto        runtime = MakeConstMap<int>({{a, 1}, {b, 2}});
+    EXPECT_EQ(runtime.At("b"), 2);
+    EXPECT_THROW((void)MakeConstMap<int>({{a, 1}, {a, 2}}), std::invalid_argument);
+}
\ No newline at end of file
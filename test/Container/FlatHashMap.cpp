@@ -0,0 +1,209 @@
+#include "FTC/Container/FlatHashMap.hpp"
+
+#include "FTC/Memory/pmr/ProfileResource.hpp"
+#include "FTC/String/ConstString.hpp"
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <memory_resource>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+using namespace ftc;
+
+TEST(FlatHashMap, Basic)
+{
+    FlatHashMap<int, int> m;
+    EXPECT_TRUE(m.empty());
+    EXPECT_EQ(m.capacity(), 0);
+    EXPECT_EQ(m.find(1), m.end());
+    EXPECT_EQ(m.begin(), m.end());
+
+    EXPECT_TRUE(m.insert({1, 10}).second);
+    EXPECT_FALSE(m.insert({1, 11}).second);
+    EXPECT_TRUE(m.emplace(2, 20).second);
+    EXPECT_TRUE(m.try_emplace(3, 30).second);
+    EXPECT_FALSE(m.try_emplace(3, 31).second);
+    m[4] = 40;
+    EXPECT_FALSE(m.insert_or_assign(4, 41).second);
+
+    EXPECT_EQ(m.size(), 4);
+    EXPECT_EQ(m.at(1), 10);
+    EXPECT_EQ(m.at(3), 30);
+    EXPECT_EQ(m[4], 41);
+    EXPECT_TRUE(m.contains(2));
+    EXPECT_EQ(m.count(5), 0);
+    EXPECT_THROW(m.at(5), std::out_of_range);
+
+    int sum = 0;
+    for (auto &[k, v] : m)
+        sum += k * v;
+    EXPECT_EQ(sum, 10 + 40 + 90 + 164);
+
+    EXPECT_EQ(m.erase(2), 1);
+    EXPECT_EQ(m.erase(2), 0);
+    EXPECT_EQ(m.size(), 3);
+    EXPECT_FALSE(m.contains(2));
+
+    FlatHashMap<int, int> copy = m;
+    EXPECT_EQ(copy, m);
+    copy[1] = 0;
+    EXPECT_NE(copy, m);
+
+    m.clear();
+    EXPECT_TRUE(m.empty());
+    EXPECT_EQ(m.begin(), m.end());
+}
+
+TEST(FlatHashMap, Random)
+{
+    // Mirrors random operations in std::unordered_map, a small key range makes many tombstones
+    std::mt19937                       rng(42);
+    FlatHashMap<std::uint32_t, int>    m;
+    std::unordered_map<std::uint32_t, int> ref;
+
+    for (int i = 0; i < 200000; i++) {
+        std::uint32_t key = rng() % 5000;
+        switch (rng() % 3) {
+        case 0: EXPECT_EQ(m.insert({key, i}).second, ref.insert({key, i}).second); break;
+        case 1: EXPECT_EQ(m.erase(key), ref.erase(key)); break;
+        default: EXPECT_EQ(m.contains(key), ref.count(key) == 1); break;
+        }
+    }
+
+    ASSERT_EQ(m.size(), ref.size());
+    std::size_t visited = 0;
+    for (const auto &[k, v] : m) {
+        ASSERT_EQ(ref.at(k), v);
+        visited++;
+    }
+    EXPECT_EQ(visited, ref.size());
+    EXPECT_LE(m.capacity(), 16383);
+
+    // Erasing through iterators keeps the remaining ones valid
+    for (auto it = m.begin(); it != m.end();)
+        it = it->first % 2 ? m.erase(it) : std::next(it);
+    for (const auto &[k, v] : m)
+        EXPECT_EQ(k % 2, 0);
+}
+
+TEST(FlatHashMap, Reserve)
+{
+    FlatHashMap<int, int> m;
+    m.reserve(1000);
+    std::size_t capacity = m.capacity();
+    EXPECT_GE(capacity * 7 / 8, 1000);
+
+    m[0]              = 0;
+    const int *first = &m[0];
+    for (int i = 1; i < 1000; i++)
+        m[i] = i;
+    EXPECT_EQ(m.capacity(), capacity);
+    EXPECT_EQ(first, &m[0]);
+
+    m.rehash(0);
+    EXPECT_EQ(m.size(), 1000);
+    for (int i = 0; i < 1000; i++)
+        EXPECT_EQ(m.at(i), i);
+}
+
+TEST(FlatHashMap, Heterogeneous)
+{
+    pmr::profile_resource profile {pmr::profile_resource::record_mode::none};
+    FlatHashMap<std::pmr::string, int> m {&profile};
+
+    const char *longKey = "a key longer than any small string buffer";
+    m[longKey]          = 1;
+    m["beta"]           = 2;
+    EXPECT_EQ(m.begin()->first.get_allocator().resource(), &profile);
+
+    // No temporary key is built for lookups
+    std::size_t allocations = profile.get_stat().num_allocations;
+    EXPECT_EQ(m.at(std::string_view(longKey)), 1);
+    EXPECT_TRUE(m.contains(longKey));
+    EXPECT_EQ(m.find(ConstString("beta"))->second, 2);
+    EXPECT_EQ(m.count(std::string("beta")), 1);
+    EXPECT_FALSE(m.contains("gamma"));
+    EXPECT_EQ(m.try_emplace(std::string_view(longKey), 3).first->second, 1);
+    EXPECT_EQ(profile.get_stat().num_allocations, allocations);
+
+    EXPECT_TRUE(m.try_emplace(std::string_view("gamma"), 3).second);
+    EXPECT_EQ(m.erase(std::string_view("beta")), 1);
+    EXPECT_EQ(m.size(), 2);
+
+    m.clear();
+    m.rehash(0);
+    EXPECT_EQ(profile.get_stat().bytes_in_use, 0);
+}
+
+TEST(FlatHashMap, MoveOnly)
+{
+    FlatHashMap<std::string, std::unique_ptr<int>> m;
+    for (int i = 0; i < 100; i++)
+        m.emplace(std::to_string(i), std::make_unique<int>(i));
+    for (int i = 0; i < 100; i++)
+        EXPECT_EQ(*m.at(std::to_string(i)), i);
+
+    FlatHashMap<std::string, std::unique_ptr<int>> moved = std::move(m);
+    EXPECT_TRUE(m.empty());
+    EXPECT_EQ(moved.size(), 100);
+
+    // A different resource moves elements one by one
+    std::pmr::monotonic_buffer_resource               arena;
+    FlatHashMap<std::string, std::unique_ptr<int>> other(std::move(moved), &arena);
+    EXPECT_EQ(other.size(), 100);
+    EXPECT_EQ(*other.at("42"), 42);
+}
+
+/// Value whose copy throws once a countdown runs out, counting live objects
+struct ThrowingCopy
+{
+    static inline int live      = 0;
+    static inline int copyLimit = -1;  ///< Number of copies before throwing, -1 for never
+
+    ThrowingCopy() { live++; }
+    ThrowingCopy(const ThrowingCopy &)
+    {
+        if (copyLimit == 0)
+            throw std::runtime_error("copy");
+        if (copyLimit > 0)
+            copyLimit--;
+        live++;
+    }
+    ThrowingCopy &operator=(const ThrowingCopy &) = default;
+    ~ThrowingCopy() { live--; }
+};
+
+TEST(FlatHashMap, ThrowingCopy)
+{
+    {
+        FlatHashMap<int, ThrowingCopy> m;
+        for (int i = 0; i < 10; i++)
+            m[i];
+        EXPECT_EQ(ThrowingCopy::live, 10);
+
+        // Copy construction destroys exactly the copies made before the throw
+        ThrowingCopy::copyLimit = 5;
+        EXPECT_THROW((FlatHashMap<int, ThrowingCopy>(m)), std::runtime_error);
+        EXPECT_EQ(ThrowingCopy::live, 10);
+
+        // Copy assignment keeps the copies made before the throw
+        FlatHashMap<int, ThrowingCopy> target;
+        target[100];
+        ThrowingCopy::copyLimit = 5;
+        EXPECT_THROW(target = m, std::runtime_error);
+        EXPECT_EQ(target.size(), 5);
+        EXPECT_EQ(ThrowingCopy::live, 15);
+        for (const auto &[key, value] : target)
+            EXPECT_TRUE(m.contains(key));
+
+        ThrowingCopy::copyLimit = -1;
+        target = m;
+        EXPECT_EQ(target.size(), 10);
+        EXPECT_EQ(ThrowingCopy::live, 20);
+    }
+    EXPECT_EQ(ThrowingCopy::live, 0);
+}
\ No newline at end of file
@@ -0,0 +1,51 @@
+#include "FTC/Container/FlatHashSet.hpp"
+
+#include "FTC/Memory/pmr/ProfileResource.hpp"
+
+#include <gtest/gtest.h>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+
+using namespace ftc;
+
+TEST(FlatHashSet, Basic)
+{
+    pmr::profile_resource profile {pmr::profile_resource::record_mode::none};
+    {
+        FlatHashSet<int> s {&profile};
+        for (int i = 0; i < 1000; i++)
+            EXPECT_TRUE(s.insert(i * 7).second);
+        EXPECT_FALSE(s.insert(7).second);
+        EXPECT_EQ(s.size(), 1000);
+        EXPECT_EQ(profile.get_stat().num_allocations, profile.get_stat().num_deallocations + 1);
+
+        for (int i = 0; i < 1000; i += 2)
+            EXPECT_EQ(s.erase(i * 7), 1);
+        for (int i = 0; i < 1000; i++)
+            EXPECT_EQ(s.contains(i * 7), i % 2 == 1);
+
+        int count = 0;
+        for (int k : s) {
+            EXPECT_EQ(k % 14, 7);
+            count++;
+        }
+        EXPECT_EQ(count, 500);
+        EXPECT_EQ(s, FlatHashSet<int>(s.begin(), s.end()));
+    }
+    EXPECT_EQ(profile.get_stat().bytes_in_use, 0);
+}
+
+TEST(FlatHashSet, Heterogeneous)
+{
+    FlatHashSet<std::string> s {"alpha", "beta"};
+    EXPECT_TRUE(s.contains(std::string_view("alpha")));
+    EXPECT_FALSE(s.contains("gamma"));
+
+    // Heterogeneous insertion builds the key only when absent
+    EXPECT_FALSE(s.insert(std::string_view("beta")).second);
+    EXPECT_TRUE(s.insert(std::string_view("gamma")).second);
+    EXPECT_EQ(s.size(), 3);
+    EXPECT_EQ(s.erase("alpha"), 1);
+    EXPECT_EQ(*s.find("gamma"), "gamma");
+}
\ No newline at end of file
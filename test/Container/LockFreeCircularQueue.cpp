@@ -0,0 +1,455 @@
+#include "FTC/Container/LockFreeCircularQueue.hpp"
+
+#include "FTC/Debug/LifetimeTester.hpp"
+#include "FTC/Memory/pmr/HugePageResource.hpp"
+
+#include <array>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+using namespace ftc;
+
+template <bool SP, bool SC> void SingleThreadRoundTrip()
+{
+    auto queue = std::make_unique<LockFreeCircularQueue<int, 32, SP, SC>>();
+
+    EXPECT_TRUE(queue->Empty());
+    EXPECT_FALSE(queue->TryPop().has_value());
+
+    for (int round = 0; round < 4; round++) {
+        int pushed = 0;
+        while (queue->TryPush(round * 100 + pushed))
+            pushed++;
+        EXPECT_GE(pushed, 1);
+        EXPECT_LE(pushed, 32);
+
+        for (int i = 0; i < pushed; i++) {
+            std::optional<int> value = queue->TryPop();
+            ASSERT_TRUE(value.has_value());
+            EXPECT_EQ(*value, round * 100 + i);
+        }
+        EXPECT_FALSE(queue->TryPop().has_value());
+        EXPECT_TRUE(queue->Empty());
+    }
+}
+
+TEST(LockFreeCircularQueue, SingleThreadSPSC)
+{
+    SingleThreadRoundTrip<true, true>();
+}
+
+TEST(LockFreeCircularQueue, SingleThreadMPSC)
+{
+    SingleThreadRoundTrip<false, true>();
+}
+
+TEST(LockFreeCircularQueue, SingleThreadSPMC)
+{
+    SingleThreadRoundTrip<true, false>();
+}
+
+TEST(LockFreeCircularQueue, SingleThreadMPMC)
+{
+    SingleThreadRoundTrip<false, false>();
+}
+
+TEST(LockFreeCircularQueue, FullSPSC)
+{
+    auto queue = std::make_unique<LockFreeCircularQueue<int, 32, true, true>>();
+    for (int i = 0; i < 32; i++)
+        EXPECT_TRUE(queue->TryPush(i));
+    EXPECT_TRUE(queue->Full());
+    EXPECT_FALSE(queue->TryPush(32));
+    EXPECT_EQ(queue->Pop(), 0);
+    EXPECT_TRUE(queue->TryPush(32));
+}
+
+TEST(LockFreeCircularQueue, MoveOnly)
+{
+    auto queue = std::make_unique<LockFreeCircularQueue<std::unique_ptr<int>, 32, true, true>>();
+    queue->Emplace(std::make_unique<int>(42));
+    queue->Push(std::make_unique<int>(43));
+    std::unique_ptr<int> p = queue->Pop();
+    ASSERT_TRUE(p);
+    EXPECT_EQ(*p, 42);
+    // Remaining element is destroyed along with the queue
+}
+
+TEST(LockFreeCircularQueue, NoExtraCopies)
+{
+    using Counter = LifetimeCounter<struct QueueTag>;
+    using Tester  = LifetimeTester<Counter>;
+
+    Counter::Scope scope;
+    {
+        auto queue = std::make_unique<LockFreeCircularQueue<Tester, 32, true, true>>();
+        EXPECT_EQ(scope.Delta(), LifetimeCounts {});
+
+        // Emplace constructs in place
+        EXPECT_TRUE(queue->TryEmplace("a"));
+        queue->Emplace("b");
+        EXPECT_EQ(scope.Delta().defaultConstructs, 2);
+        EXPECT_EQ(scope.Delta().Copies() + scope.Delta().Moves(), 0);
+
+        // Push of an rvalue moves once
+        Counter::Scope pushScope;
+        queue->Push(Tester("c"));
+        EXPECT_EQ(pushScope.Delta().Copies(), 0);
+        EXPECT_EQ(pushScope.Delta().moveConstructs, 1);
+
+        Counter::Scope popScope;
+        Tester         a = queue->Pop();
+        EXPECT_STREQ(a.Name(), "a");
+        std::optional<Tester> b = queue->TryPop();
+        EXPECT_STREQ(b->Name(), "b");
+        EXPECT_EQ(popScope.Delta().Copies(), 0);
+        EXPECT_EQ(popScope.Delta().live, 0);  // Elements are moved out of their slots
+    }
+    EXPECT_EQ(scope.Delta().Copies(), 0);
+    EXPECT_EQ(scope.Delta().live, 0);
+}
+
+TEST(LockFreeCircularQueue, RelocatingPopBulk)
+{
+    using Counter = LifetimeCounter<struct QueueRelocateTag>;
+    using Value   = RelocatableLifetimeTester<Counter>;
+
+    auto queue = std::make_unique<LockFreeCircularQueue<Value, 32, true, true>>();
+    for (const char *name : {"a", "b", "c"})
+        queue->Emplace(name);
+
+    // Targets are destroyed and values relocated over them, no moves
+    std::array<Value, 4> out;
+    Counter::Scope       scope;
+    EXPECT_EQ(queue->TryPopBulk(out.data(), out.size()), 3);
+    EXPECT_STREQ(out[0].Name(), "a");
+    EXPECT_STREQ(out[2].Name(), "c");
+    EXPECT_STREQ(out[3].Name(), "Unnamed");
+    EXPECT_EQ(scope.Delta().destructs, 3);
+    EXPECT_EQ(scope.Delta().Moves() + scope.Delta().Copies(), 0);
+    EXPECT_EQ(scope.Delta().live, -3);  // The values left the queue, replacing the targets
+    EXPECT_TRUE(queue->Empty());
+
+    // Other output iterators assign
+    std::vector<std::unique_ptr<int>> ptrs;
+    auto ptrQueue = std::make_unique<LockFreeCircularQueue<std::unique_ptr<int>, 32, true, true>>();
+    ptrQueue->Push(std::make_unique<int>(1));
+    ptrQueue->Push(std::make_unique<int>(2));
+    EXPECT_EQ(ptrQueue->TryPopBulk(std::back_inserter(ptrs), 8), 2);
+    EXPECT_EQ(*ptrs[1], 2);
+
+    std::unique_ptr<int> raw[2] = {std::make_unique<int>(0), nullptr};
+    ptrQueue->Push(std::make_unique<int>(3));
+    ptrQueue->Push(std::make_unique<int>(4));
+    EXPECT_EQ(ptrQueue->TryPopBulk(raw, 2), 2);
+    EXPECT_EQ(*raw[0], 3);
+    EXPECT_EQ(*raw[1], 4);
+}
+
+template <typename Queue> void MultiThreadHandoff(Queue &queue, int numProducers, int numConsumers)
+{
+    constexpr int numItems = 20000;
+
+    std::vector<std::thread>       threads;
+    std::vector<std::vector<int>>  received(numConsumers);
+    std::atomic<int>               consumed {0};
+    const int                      total = numItems * numProducers;
+
+    for (int p = 0; p < numProducers; p++)
+        threads.emplace_back([&, p] {
+            for (int i = 0; i < numItems; i++)
+                queue.Push(p * numItems + i);
+        });
+
+    for (int c = 0; c < numConsumers; c++)
+        threads.emplace_back([&, c] {
+            while (consumed.load(std::memory_order_relaxed) < total) {
+                if (std::optional<int> value = queue.TryPop()) {
+                    received[c].push_back(*value);
+                    consumed.fetch_add(1, std::memory_order_relaxed);
+                }
+                else
+                    std::this_thread::yield();
+            }
+        });
+
+    for (std::thread &t : threads)
+        t.join();
+
+    // Every value is received exactly once, in producer order for each consumer
+    std::vector<int> seen(total, 0);
+    for (const std::vector<int> &values : received) {
+        std::vector<int> last(numProducers, -1);
+        for (int v : values) {
+            seen[v]++;
+            EXPECT_GT(v, last[v / numItems]);
+            last[v / numItems] = v;
+        }
+    }
+    for (int count : seen)
+        ASSERT_EQ(count, 1);
+    EXPECT_TRUE(queue.Empty());
+}
+
+template <bool SP, bool SC, typename Wait = BusySpinWait>
+void MultiThreadHandoff(int numProducers, int numConsumers)
+{
+    auto queue = std::make_unique<LockFreeCircularQueue<int, 1024, SP, SC, Wait>>();
+    MultiThreadHandoff(*queue, numProducers, numConsumers);
+}
+
+TEST(LockFreeCircularQueue, MultiThreadSPSC)
+{
+    MultiThreadHandoff<true, true>(1, 1);
+}
+
+TEST(LockFreeCircularQueue, MultiThreadMPSC)
+{
+    MultiThreadHandoff<false, true>(4, 1);
+}
+
+TEST(LockFreeCircularQueue, MultiThreadSPMC)
+{
+    MultiThreadHandoff<true, false>(1, 4);
+}
+
+TEST(LockFreeCircularQueue, MultiThreadMPMC)
+{
+    MultiThreadHandoff<false, false>(4, 4);
+}
+
+TEST(LockFreeCircularQueue, BackoffWait)
+{
+    MultiThreadHandoff<false, false, BackoffWait<>>(4, 4);
+}
+
+TEST(LockFreeCircularQueue, ParkingWait)
+{
+    MultiThreadHandoff<false, false, ParkingWait<>>(4, 4);
+    MultiThreadHandoff<true, true, ParkingWait<0>>(1, 1);
+}
+
+TEST(LockFreeCircularQueue, ParkingWaitWakeUp)
+{
+    auto queue = std::make_unique<LockFreeCircularQueue<int, 32, true, true, ParkingWait<0>>>();
+
+    std::thread consumer([&] {
+        for (int i = 0; i < 100; i++)
+            EXPECT_EQ(queue->Pop(), i);
+    });
+    for (int i = 0; i < 100; i++) {
+        if (i % 10 == 0)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        queue->Push(i);
+    }
+    consumer.join();
+    EXPECT_TRUE(queue->Empty());
+}
+
+template <bool SP, bool SC> void BulkRoundTrip()
+{
+    auto queue = std::make_unique<LockFreeCircularQueue<int, 64, SP, SC>>();
+
+    std::vector<int> input(100);
+    std::iota(input.begin(), input.end(), 0);
+
+    EXPECT_EQ(queue->TryPushBulk(input.begin(), input.begin()), 0);
+    EXPECT_EQ(queue->TryPushBulk(input.begin(), input.begin() + 40), 40);
+    EXPECT_EQ(queue->TryPushBulk(input.begin() + 40, input.end()), 24);
+    EXPECT_EQ(queue->TryPushBulk(input.begin() + 64, input.end()), 0);
+
+    std::vector<int> output;
+    EXPECT_EQ(queue->TryPopBulk(std::back_inserter(output), 30), 30);
+    EXPECT_EQ(queue->TryPopBulk(std::back_inserter(output), 0), 0);
+    EXPECT_EQ(queue->TryPushBulk(input.begin() + 64, input.end()), 30);
+    EXPECT_EQ(queue->TryPopBulk(std::back_inserter(output), 200), 64);
+    EXPECT_EQ(queue->TryPopBulk(std::back_inserter(output), 200), 0);
+
+    ASSERT_EQ(output.size(), 94);
+    for (int i = 0; i < 94; i++)
+        EXPECT_EQ(output[i], i);
+}
+
+TEST(LockFreeCircularQueue, BulkSPSC)
+{
+    BulkRoundTrip<true, true>();
+}
+
+TEST(LockFreeCircularQueue, BulkMPMC)
+{
+    BulkRoundTrip<false, false>();
+}
+
+TEST(LockFreeCircularQueue, MultiThreadBulkMPMC)
+{
+    constexpr int numProducers = 4;
+    constexpr int numConsumers = 4;
+    constexpr int numItems     = 20000;
+    constexpr int batchSize    = 32;
+    constexpr int total        = numProducers * numItems;
+
+    auto queue = std::make_unique<LockFreeCircularQueue<int, 1024, false, false>>();
+
+    std::vector<std::thread> threads;
+    std::vector<int>         seen(total, 0);
+    std::atomic<int>         consumed {0};
+
+    for (int p = 0; p < numProducers; p++)
+        threads.emplace_back([&, p] {
+            std::vector<int> batch(numItems);
+            std::iota(batch.begin(), batch.end(), p * numItems);
+            for (auto it = batch.begin(); it != batch.end();) {
+                auto last = batch.end() - it > batchSize ? it + batchSize : batch.end();
+                it += queue->TryPushBulk(it, last);
+            }
+        });
+
+    for (int c = 0; c < numConsumers; c++)
+        threads.emplace_back([&] {
+            int values[batchSize];
+            while (consumed.load(std::memory_order_relaxed) < total) {
+                std::size_t count = queue->TryPopBulk(values, batchSize);
+                for (std::size_t i = 0; i < count; i++)
+                    seen[values[i]]++;
+                consumed.fetch_add((int)count, std::memory_order_relaxed);
+            }
+        });
+
+    for (std::thread &t : threads)
+        t.join();
+
+    for (int count : seen)
+        ASSERT_EQ(count, 1);
+}
+
+TEST(LockFreeCircularQueue, DynamicSize)
+{
+    LockFreeCircularQueue<int, DynamicSize, true, true> queue(100);
+    EXPECT_EQ(queue.Capacity(), 128);
+
+    for (int round = 0; round < 3; round++) {
+        for (int i = 0; i < 128; i++)
+            EXPECT_TRUE(queue.TryPush(i));
+        EXPECT_FALSE(queue.TryPush(128));
+        EXPECT_TRUE(queue.Full());
+        for (int i = 0; i < 128; i++)
+            EXPECT_EQ(queue.Pop(), i);
+        EXPECT_TRUE(queue.Empty());
+    }
+
+    LockFreeCircularQueue<int, DynamicSize, false, false> small(1);
+    EXPECT_EQ(small.Capacity(), 32);
+}
+
+TEST(LockFreeCircularQueue, DynamicSizeHugePage)
+{
+    pmr::huge_page_resource resource;
+
+    {
+        LockFreeCircularQueue<std::unique_ptr<int>, DynamicSize, false, false> queue(1 << 16,
+                                                                                     &resource);
+        EXPECT_EQ(queue.Capacity(), 1 << 16);
+        for (int i = 0; i < 1000; i++)
+            queue.Push(std::make_unique<int>(i));
+        for (int i = 0; i < 500; i++)
+            EXPECT_EQ(*queue.Pop(), i);
+        // Remaining elements are destroyed along with the queue
+    }
+
+    LockFreeCircularQueue<int, DynamicSize, false, false> queue(1 << 16, &resource);
+    MultiThreadHandoff(queue, 4, 4);
+}
+
+template <typename Queue> void FillAndDrain(Queue &queue)
+{
+    int capacity = (int)queue.Capacity();
+    for (int round = 0; round < 3; round++) {
+        for (int i = 0; i < capacity; i++)
+            EXPECT_TRUE(queue.TryPush(round * capacity + i));
+        EXPECT_FALSE(queue.TryPush(-1));
+        for (int i = 0; i < capacity; i++)
+            EXPECT_EQ(queue.Pop(), round * capacity + i);
+        EXPECT_FALSE(queue.TryPop().has_value());
+    }
+}
+
+TEST(LockFreeCircularQueue, CompactLayout)
+{
+    using PaddedQueue = LockFreeCircularQueue<int, 1024, false, false>;
+    using CompactQueue =
+        LockFreeCircularQueue<int, 1024, false, false, BusySpinWait, CompactLayout>;
+    EXPECT_LT(sizeof(CompactQueue) * 3, sizeof(PaddedQueue));
+
+    auto queue = std::make_unique<CompactQueue>();
+    FillAndDrain(*queue);
+    MultiThreadHandoff(*queue, 4, 4);
+
+    LockFreeCircularQueue<int, DynamicSize, true, true, BusySpinWait, CompactLayout> dynamicQueue(
+        64);
+    FillAndDrain(dynamicQueue);
+    MultiThreadHandoff(dynamicQueue, 1, 1);
+
+    LockFreeCircularQueue<std::array<char, 100>, 32, true, true, BusySpinWait, CompactLayout>
+        largeQueue;
+    for (int i = 0; i < 32; i++)
+        EXPECT_TRUE(largeQueue.TryPush({}));
+    EXPECT_FALSE(largeQueue.TryPush({}));
+}
+
+TEST(LockFreeCircularQueue, MaxProducers)
+{
+    EXPECT_GE((LockFreeCircularQueue<int, 32, false, false>::DefaultMaxProducers()), 1);
+
+    // Thread indices deciding the fetch_add path are reused after a thread exits
+    std::size_t first = 0, second = 0;
+    std::thread([&] { first = detail::__thread_index(); }).join();
+    std::thread([&] { second = detail::__thread_index(); }).join();
+    EXPECT_EQ(first, second);
+    EXPECT_NE(first, detail::__thread_index());
+
+    // More producers than the bound only takes the CAS path more often
+    auto queue =
+        std::make_unique<LockFreeCircularQueue<int, 1024, false, false, BackoffWait<>>>(2);
+    MultiThreadHandoff(*queue, 8, 2);
+
+    // Bound larger than the capacity disables the fetch_add path
+    LockFreeCircularQueue<int, DynamicSize, false, true, BackoffWait<>> casOnly(
+        64, std::pmr::get_default_resource(), 1000);
+    FillAndDrain(casOnly);
+    MultiThreadHandoff(casOnly, 8, 1);
+}
+
+TEST(LockFreeCircularQueue, TryPushNeverWaitsForConsumers)
+{
+    // Many more producers than the bound fill the queue without any consumer, each TryPush()
+    // must give up once the queue is full instead of waiting for room
+    for (int round = 0; round < 50; round++) {
+        auto queue = std::make_unique<LockFreeCircularQueue<int, 32, false, false>>(1);
+        std::atomic<int>         pushed {0};
+        std::vector<std::thread> producers;
+        for (int p = 0; p < 8; p++)
+            producers.emplace_back([&, p] {
+                while (queue->TryPush(p))
+                    pushed++;
+            });
+        for (std::thread &t : producers)
+            t.join();
+
+        EXPECT_EQ(pushed.load(), 32);
+        int popped = 0;
+        while (queue->TryPop())
+            popped++;
+        EXPECT_EQ(popped, 32);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
\ No newline at end of file
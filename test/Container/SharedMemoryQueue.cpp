@@ -0,0 +1,167 @@
+#include "FTC/Container/SharedMemoryQueue.hpp"
+
+#include <gtest/gtest.h>
+#include <string>
+
+#if !defined(_WIN32)
+    #include <sys/mman.h>
+    #include <sys/wait.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+using namespace ftc;
+
+using IntQueue = SharedMemoryQueue<int, 64, true, true>;
+
+/// Unique region name per test and process, removed at the end of the test
+class SharedMemoryQueueTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        const auto *test = ::testing::UnitTest::GetInstance()->current_test_info();
+        name = std::string("ftc-test-") + test->name() + "-"
+               + std::to_string(detail::__current_pid());
+        IntQueue::Remove(name);
+    }
+    void TearDown() override { IntQueue::Remove(name); }
+
+    std::string name;
+};
+
+TEST_F(SharedMemoryQueueTest, CreateAndAttach)
+{
+    IntQueue a = IntQueue::Open(name);
+    EXPECT_TRUE(a.Initialized());
+    EXPECT_EQ(a.Name(), name);
+    EXPECT_TRUE(a->Empty());
+
+    // A second mapping of the same region sees the values at another address
+    IntQueue b = IntQueue::Open(name);
+    EXPECT_FALSE(b.Initialized());
+    EXPECT_NE(&a.Get(), &b.Get());
+
+    for (int i = 0; i < 10; i++)
+        EXPECT_TRUE(a->TryPush(i));
+    for (int i = 0; i < 10; i++)
+        EXPECT_EQ(b->Pop(), i);
+    EXPECT_TRUE(a->Empty());
+
+    IntQueue c = std::move(b);
+    c->Push(42);
+    EXPECT_EQ(a->Pop(), 42);
+}
+
+TEST_F(SharedMemoryQueueTest, Remove)
+{
+    IntQueue a = IntQueue::Open(name);
+    a->Push(1);
+#if !defined(_WIN32)
+    EXPECT_TRUE(IntQueue::Remove(name));
+    EXPECT_FALSE(IntQueue::Remove(name));
+
+    // The old mapping stays usable, a new open creates a new queue
+    IntQueue b = IntQueue::Open(name);
+    EXPECT_TRUE(b.Initialized());
+    EXPECT_TRUE(b->Empty());
+    EXPECT_EQ(a->Pop(), 1);
+#endif
+}
+
+TEST_F(SharedMemoryQueueTest, RejectsIncompatible)
+{
+    SharedMemoryOptions v1;
+    v1.version = 1;
+    IntQueue a = IntQueue::Open(name, v1);
+
+    SharedMemoryOptions v2;
+    v2.version = 2;
+    EXPECT_THROW(IntQueue::Open(name, v2), std::runtime_error);
+    EXPECT_NO_THROW(IntQueue::Open(name, v1));
+
+    // Another capacity changes the size of the region, another element size its layout
+    using BigQueue = SharedMemoryQueue<int, 128, true, true>;
+    EXPECT_THROW(BigQueue::Open(name, v1), std::runtime_error);
+    using DoubleQueue = SharedMemoryQueue<double, 64, true, true>;
+    static_assert(DoubleQueue::RegionSize() == IntQueue::RegionSize());
+    EXPECT_THROW(DoubleQueue::Open(name, v1), std::runtime_error);
+}
+
+#if !defined(_WIN32)
+
+/// Maps the header of an existing region, as a crashed process would have left it
+static detail::__shm_queue_header *MapHeader(const std::string &name)
+{
+    int fd = shm_open(("/" + name).c_str(), O_RDWR, 0);
+    EXPECT_GE(fd, 0);
+    void *p = mmap(nullptr, IntQueue::RegionSize(), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    EXPECT_NE(p, MAP_FAILED);
+    return static_cast<detail::__shm_queue_header *>(p);
+}
+
+TEST_F(SharedMemoryQueueTest, TakeOverFromDeadInitializer)
+{
+    IntQueue a = IntQueue::Open(name);
+    a->Push(7);
+
+    // A child process that exited in the middle of initializing
+    pid_t child = fork();
+    if (child == 0)
+        _exit(0);
+    waitpid(child, nullptr, 0);
+
+    detail::__shm_queue_header *header = MapHeader(name);
+    header->state.store(std::uint64_t(child));
+
+    IntQueue b = IntQueue::Open(name);
+    EXPECT_TRUE(b.Initialized());
+    EXPECT_TRUE(b->Empty());
+    EXPECT_EQ(header->state.load(), detail::__shm_queue_header::Ready);
+    munmap(header, IntQueue::RegionSize());
+}
+
+TEST_F(SharedMemoryQueueTest, TimesOutOnLiveInitializer)
+{
+    IntQueue a = IntQueue::Open(name);
+
+    // This process pretends to be still initializing
+    detail::__shm_queue_header *header = MapHeader(name);
+    header->state.store(detail::__current_pid());
+
+    SharedMemoryOptions options;
+    options.attachTimeout = std::chrono::milliseconds(20);
+    EXPECT_THROW(IntQueue::Open(name, options), std::runtime_error);
+    munmap(header, IntQueue::RegionSize());
+}
+
+TEST_F(SharedMemoryQueueTest, CrossProcess)
+{
+    using Queue = SharedMemoryQueue<long, 64, true, true, BackoffWait<>>;
+    constexpr long Count = 100000;
+
+    Queue consumer = Queue::Open(name);
+    pid_t child    = fork();
+    if (child == 0) {
+        Queue producer = Queue::Open(name);
+        for (long i = 0; i < Count; i++)
+            producer->Push(i);
+        _exit(producer.Initialized() ? 1 : 0);
+    }
+
+    long sum = 0;
+    for (long i = 0; i < Count; i++) {
+        long value = consumer->Pop();
+        ASSERT_EQ(value, i);
+        sum += value;
+    }
+    EXPECT_EQ(sum, Count * (Count - 1) / 2);
+
+    int status = 0;
+    waitpid(child, &status, 0);
+    EXPECT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+}
+
+#endif
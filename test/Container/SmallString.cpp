@@ -0,0 +1,101 @@
+#include "FTC/Container/SmallString.hpp"
+
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <unordered_set>
+
+using namespace ftc;
+
+TEST(SmallString, Basic)
+{
+    SmallString<8> s;
+    EXPECT_TRUE(s.empty());
+    EXPECT_STREQ(s.c_str(), "");
+    EXPECT_EQ(s.capacity(), 8);
+
+    s = "hello";
+    EXPECT_EQ(s.size(), 5);
+    EXPECT_TRUE(s.is_inline());
+    EXPECT_EQ(s, "hello");
+
+    s += ", world";
+    EXPECT_FALSE(s.is_inline());
+    EXPECT_STREQ(s.c_str(), "hello, world");
+    EXPECT_EQ(s.find("world"), 7);
+    EXPECT_EQ(s.rfind('o'), 8);
+
+    s.push_back('!');
+    EXPECT_EQ(s.back(), '!');
+    s.pop_back();
+    s.resize(5);
+    EXPECT_EQ(s, "hello");
+    EXPECT_EQ(s.c_str()[5], '\0');
+    s.resize(7, '?');
+    EXPECT_EQ(s, "hello??");
+
+    s.clear();
+    EXPECT_TRUE(s.empty());
+    EXPECT_STREQ(s.c_str(), "");
+}
+
+TEST(SmallString, SelfAppend)
+{
+    SmallString<4> s {"abc"};
+    s.append(s);
+    EXPECT_EQ(s, "abcabc");
+    s.append(std::string_view(s).substr(1, 2));
+    EXPECT_EQ(s, "abcabcbc");
+    s.append(3, 'x');
+    EXPECT_EQ(s, "abcabcbcxxx");
+}
+
+TEST(SmallString, CopyMove)
+{
+    SmallString<4> a {"short"};
+    SmallString<4> b = a;
+    EXPECT_EQ(a, b);
+
+    SmallString<4> c = std::move(a);
+    EXPECT_EQ(c, "short");
+    EXPECT_TRUE(a.empty());
+    EXPECT_STREQ(a.c_str(), "");
+
+    a = std::move(c);
+    EXPECT_EQ(a, "short");
+    EXPECT_STREQ(c.c_str(), "");
+
+    swap(a, c);
+    EXPECT_EQ(c, "short");
+    EXPECT_TRUE(a < c);
+    EXPECT_TRUE("abc" < c);
+    EXPECT_NE(a, c);
+}
+
+TEST(SmallString, Interop)
+{
+    SmallString<16>  s {"key"};
+    std::string      str {s};
+    std::string_view sv = s;
+    EXPECT_EQ(str, "key");
+    EXPECT_EQ(sv, "key");
+
+    std::ostringstream os;
+    os << s;
+    EXPECT_EQ(os.str(), "key");
+
+    std::unordered_set<SmallString<16>> set {"a", "b"};
+    EXPECT_EQ(set.count("a"), 1);
+    EXPECT_EQ(set.count("c"), 0);
+}
+
+TEST(SmallString, MixedSize)
+{
+    SmallString<4>  a {"abc"};
+    SmallString<32> b {"abc"};
+    std::string     c {"abd"};
+    EXPECT_TRUE(a == b);
+    EXPECT_TRUE(b == a);
+    EXPECT_TRUE(a < c);
+    EXPECT_TRUE(c != b);
+}
\ No newline at end of file
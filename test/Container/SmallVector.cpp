@@ -0,0 +1,200 @@
+#include "FTC/Container/SmallVector.hpp"
+
+#include "FTC/Debug/LifetimeTester.hpp"
+#include "FTC/Memory/pmr/ProfileResource.hpp"
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <memory_resource>
+#include <numeric>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+using namespace ftc;
+
+TEST(SmallVector, Inline)
+{
+    pmr::profile_resource      profile {pmr::profile_resource::record_mode::none};
+    SmallVector<int, 4>        v {&profile};
+    EXPECT_TRUE(v.empty());
+    EXPECT_TRUE(v.is_inline());
+    EXPECT_EQ(v.capacity(), 4);
+
+    for (int i = 0; i < 4; i++)
+        v.push_back(i);
+    EXPECT_TRUE(v.is_inline());
+    EXPECT_EQ(profile.get_stat().num_allocations, 0);
+
+    v.push_back(4);  // Spills to the memory resource
+    EXPECT_FALSE(v.is_inline());
+    EXPECT_EQ(profile.get_stat().num_allocations, 1);
+    EXPECT_EQ(v.size(), 5);
+    for (int i = 0; i < 5; i++)
+        EXPECT_EQ(v[i], i);
+
+    v.resize(3);
+    v.shrink_to_fit();
+    EXPECT_TRUE(v.is_inline());
+    EXPECT_EQ(profile.get_stat().bytes_in_use, 0);
+    EXPECT_EQ(v, (SmallVector<int, 4> {0, 1, 2}));
+}
+
+TEST(SmallVector, Constructors)
+{
+    SmallVector<int, 2> a(5, 7);
+    EXPECT_EQ(a.size(), 5);
+    EXPECT_EQ(std::count(a.begin(), a.end(), 7), 5);
+
+    SmallVector<int, 2> b(3);
+    EXPECT_EQ(b, (SmallVector<int, 2> {0, 0, 0}));
+
+    std::vector<int>    source {1, 2, 3, 4};
+    SmallVector<int, 8> c(source.begin(), source.end());
+    EXPECT_TRUE(std::equal(c.begin(), c.end(), source.begin(), source.end()));
+
+    SmallVector<int, 0> d {1, 2, 3};  // No inline storage at all
+    EXPECT_FALSE(d.is_inline());
+    EXPECT_EQ(d.back(), 3);
+
+    SmallVector<int, 2> e = a;
+    EXPECT_EQ(e, a);
+    e = b;
+    EXPECT_EQ(e, b);
+    e = {9};
+    EXPECT_EQ(e.size(), 1);
+    EXPECT_EQ(e.at(0), 9);
+    EXPECT_THROW(e.at(1), std::out_of_range);
+}
+
+TEST(SmallVector, Move)
+{
+    // Heap storage is stolen
+    SmallVector<std::string, 2> a {"a", "b", "c"};
+    const std::string *         data = a.data();
+    SmallVector<std::string, 2> b    = std::move(a);
+    EXPECT_EQ(b.data(), data);
+    EXPECT_TRUE(a.empty());
+    EXPECT_TRUE(a.is_inline());
+
+    // Inline elements are moved one by one
+    SmallVector<std::string, 2> c {"x"};
+    SmallVector<std::string, 2> d = std::move(c);
+    EXPECT_TRUE(c.empty());
+    EXPECT_EQ(d.size(), 1);
+    EXPECT_EQ(d[0], "x");
+
+    d = std::move(b);
+    EXPECT_EQ(d.data(), data);
+    EXPECT_EQ(d.size(), 3);
+
+    SmallVector<std::string, 2> e {"y"};
+    swap(d, e);
+    EXPECT_EQ(e.size(), 3);
+    EXPECT_EQ(d.size(), 1);
+    EXPECT_EQ(d[0], "y");
+
+    // Different memory resources cannot steal storage
+    std::pmr::monotonic_buffer_resource mbr;
+    SmallVector<std::string, 2>         f(std::move(e), &mbr);
+    EXPECT_NE(f.data(), data);
+    EXPECT_EQ(f.size(), 3);
+    EXPECT_EQ(f[2], "c");
+
+    // Move assignment between different resources copies into the own resource, so it may throw
+    SmallVector<std::string, 2> g {"z"};
+    g = std::move(f);
+    EXPECT_NE(g.data(), f.data());
+    EXPECT_EQ(g.size(), 3);
+    EXPECT_EQ(g[0], "a");
+    static_assert(!std::is_nothrow_move_assignable_v<SmallVector<std::string, 2>>);
+    static_assert(std::is_nothrow_move_assignable_v<
+                  SmallVector<std::string, 2, std::allocator<std::string>>>);
+}
+
+TEST(SmallVector, Relocate)
+{
+    using Counter = LifetimeCounter<struct SmallVectorRelocateTag>;
+    using Value   = RelocatableLifetimeTester<Counter>;
+
+    Counter::Scope scope;
+    {
+        // Growing and moving inline elements relocate them with memcpy
+        SmallVector<Value, 2> a;
+        for (int i = 0; i < 9; i++)
+            a.emplace_back("grown");
+        SmallVector<Value, 2> b;
+        b.emplace_back("inline");
+        SmallVector<Value, 2> c = std::move(b);
+        EXPECT_TRUE(b.empty());
+        EXPECT_STREQ(c[0].Name(), "inline");
+        EXPECT_STREQ(a[8].Name(), "grown");
+
+        EXPECT_EQ(scope.Delta().Moves() + scope.Delta().Copies(), 0);
+        EXPECT_EQ(scope.Delta().destructs, 0);
+        EXPECT_EQ(scope.Delta().live, 10);
+    }
+    EXPECT_EQ(scope.Delta().live, 0);
+}
+
+TEST(SmallVector, InsertErase)
+{
+    SmallVector<int, 4> v {1, 5};
+    v.insert(v.begin() + 1, {2, 3, 4});
+    EXPECT_EQ(v, (SmallVector<int, 4> {1, 2, 3, 4, 5}));
+
+    v.insert(v.begin(), 2, 0);
+    EXPECT_EQ(v, (SmallVector<int, 4> {0, 0, 1, 2, 3, 4, 5}));
+
+    v.erase(v.begin(), v.begin() + 2);
+    v.erase(v.end() - 1);
+    EXPECT_EQ(v, (SmallVector<int, 4> {1, 2, 3, 4}));
+
+    v.emplace(v.begin() + 2, 9);
+    EXPECT_EQ(v, (SmallVector<int, 4> {1, 2, 9, 3, 4}));
+
+    // Inserting an element of the vector itself while growing
+    SmallVector<std::string, 2> s {"first", "second"};
+    s.push_back(s[0]);
+    s.insert(s.begin(), 3, s[1]);
+    EXPECT_EQ(s, (SmallVector<std::string, 2> {"second", "second", "second", "first", "second",
+                                               "first"}));
+
+    s.assign(2, "z");
+    EXPECT_EQ(s, (SmallVector<std::string, 2> {"z", "z"}));
+    s.pop_back();
+    s.clear();
+    EXPECT_TRUE(s.empty());
+}
+
+TEST(SmallVector, NonTrivial)
+{
+    auto counter = std::make_shared<int>(0);
+    {
+        SmallVector<std::shared_ptr<int>, 3> v;
+        for (int i = 0; i < 10; i++)
+            v.push_back(counter);
+        EXPECT_EQ(counter.use_count(), 11);
+
+        SmallVector<std::shared_ptr<int>, 3> copy = v;
+        EXPECT_EQ(counter.use_count(), 21);
+        copy.resize(2);
+        copy.shrink_to_fit();
+        EXPECT_TRUE(copy.is_inline());
+        EXPECT_EQ(counter.use_count(), 13);
+        v.erase(v.begin() + 1, v.end() - 1);
+        EXPECT_EQ(counter.use_count(), 5);
+    }
+    EXPECT_EQ(counter.use_count(), 1);
+}
+
+TEST(SmallVector, Compare)
+{
+    SmallVector<int, 2> a {1, 2, 3};
+    SmallVector<int, 2> b {1, 2, 4};
+    EXPECT_TRUE(a < b);
+    EXPECT_TRUE(a <= b);
+    EXPECT_TRUE(b > a);
+    EXPECT_TRUE(a != b);
+    EXPECT_EQ(std::accumulate(a.rbegin(), a.rend(), 0), 6);
+}
\ No newline at end of file
@@ -0,0 +1,124 @@
+#include "FTC/Debug/LifetimeTester.hpp"
+
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace ftc;
+
+namespace {
+struct StringWrapper
+{
+    static std::string &Output()
+    {
+        static std::string output;
+        return output;
+    }
+    template <typename T> StringWrapper &operator<<(T &&t)
+    {
+        Output() += t;
+        return *this;
+    }
+};
+}  // namespace
+
+TEST(LifetimeTester, Output)
+{
+    using Tester = LifetimeTester<StringWrapper>;
+    StringWrapper::Output().clear();
+    {
+        Tester a("a"), b("b");
+        b = a;
+        b = std::move(a);
+    }
+    EXPECT_EQ(StringWrapper::Output(),
+              "a: Default constructor called.\n"
+              "b: Default constructor called.\n"
+              "a: Copy Assignment called.\n"
+              "a: Move Assignment called.\n"
+              "a: Destructor called.\n"
+              "a: Destructor called.\n");
+}
+
+TEST(LifetimeTester, Name)
+{
+    LifetimeTester<LifetimeCounter<struct NameTag>, 8> t("a long name");
+    EXPECT_STREQ(t.Name(), "a long ");
+    t = t;
+    EXPECT_STREQ(t.Name(), "a long ");
+}
+
+TEST(LifetimeTester, Counting)
+{
+    using Counter = LifetimeCounter<struct CountingTag>;
+    using Tester  = LifetimeTester<Counter>;
+
+    Counter::Scope scope;
+    {
+        Tester a;
+        Tester b(a);
+        Tester c(std::move(a));
+        Tester &r = (b = c);
+        EXPECT_EQ(&r, &b);
+        EXPECT_EQ(&(c = std::move(b)), &c);
+        EXPECT_EQ(scope.Delta().live, 3);
+    }
+
+    LifetimeCounts expected;
+    expected.defaultConstructs = 1;
+    expected.copyConstructs    = 1;
+    expected.moveConstructs    = 1;
+    expected.copyAssigns       = 1;
+    expected.moveAssigns       = 1;
+    expected.destructs         = 3;
+    EXPECT_EQ(scope.Delta(), expected);
+    EXPECT_EQ(scope.Delta().Constructs(), 3u);
+    EXPECT_EQ(scope.Delta().Copies(), 2u);
+    EXPECT_EQ(scope.Delta().Moves(), 2u);
+
+    std::ostringstream os;
+    os << expected;
+    EXPECT_EQ(os.str(),
+              "{default: 1, copy: 1, move: 1, copyAssign: 1, moveAssign: 1, destruct: 3, live: 0}");
+}
+
+TEST(LifetimeTester, Reset)
+{
+    using Counter = LifetimeCounter<struct ResetTag>;
+    using Tester  = LifetimeTester<Counter>;
+
+    Tester a, b(a);
+    Counter::Reset();
+    LifetimeCounts expected;
+    expected.live = 2;
+    EXPECT_EQ(Counter::Snapshot(), expected);
+
+    // Counters of different tags are independent
+    LifetimeTester<LifetimeCounter<struct OtherTag>> other;
+    EXPECT_EQ(Counter::Snapshot(), expected);
+}
+
+TEST(LifetimeTester, MultiThread)
+{
+    using Counter = LifetimeCounter<struct MultiThreadTag>;
+    using Tester  = LifetimeTester<Counter>;
+
+    Counter::Scope           scope;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++)
+        threads.emplace_back([] {
+            for (int i = 0; i < 1000; i++) {
+                Tester a;
+                Tester b(std::move(a));
+            }
+        });
+    for (auto &thread : threads)
+        thread.join();
+
+    EXPECT_EQ(scope.Delta().Constructs(), 8000u);
+    EXPECT_EQ(scope.Delta().destructs, 8000u);
+    EXPECT_EQ(scope.Delta().live, 0);
+}
@@ -0,0 +1,99 @@
+#include "FTC/Debug/Trace.hpp"
+
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ftc;
+
+static std::size_t CountOf(const std::string &str, const std::string &pattern)
+{
+    std::size_t count = 0;
+    for (std::size_t pos = str.find(pattern); pos != std::string::npos;
+         pos = str.find(pattern, pos + 1))
+        count++;
+    return count;
+}
+
+static void Work(int depth)
+{
+    TRACE_SCOPE("work");
+    if (depth > 0) {
+        TRACE_SCOPE("nested \"quoted\"");
+        Work(depth - 1);
+    }
+}
+
+TEST(Trace, NotRunning)
+{
+    Tracer &tracer = Tracer::Instance();
+    ASSERT_FALSE(tracer.Running());
+    Work(3);  // Not recorded anywhere
+    tracer.Stop();
+}
+
+TEST(Trace, ChromeTraceJson)
+{
+    Tracer &           tracer = Tracer::Instance();
+    std::ostringstream out;
+    ASSERT_TRUE(tracer.Start(out));
+    EXPECT_TRUE(tracer.Running());
+    EXPECT_FALSE(tracer.Start(out));
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&tracer] {
+            tracer.SetThreadName("worker");
+            for (int i = 0; i < 100; i++)
+                Work(1);
+        });
+    }
+    for (auto &t : threads)
+        t.join();
+    Work(0);
+    tracer.Stop();
+    EXPECT_FALSE(tracer.Running());
+
+    std::string json = out.str();
+    EXPECT_EQ(json.rfind("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n", 0), 0u);
+    EXPECT_EQ(json.substr(json.size() - 4), "\n]}\n");
+    EXPECT_EQ(tracer.DroppedEvents(), 0u);
+    EXPECT_EQ(CountOf(json, "{\"name\":\"work\",\"ph\":\"X\""), 4 * 200u + 1);
+    EXPECT_EQ(CountOf(json, "{\"name\":\"nested \\\"quoted\\\"\",\"ph\":\"X\""), 4 * 100u);
+    EXPECT_EQ(CountOf(json, "\"args\":{\"name\":\"worker\"}"), 4u);
+}
+
+TEST(Trace, DropsWhenFull)
+{
+    Tracer &           tracer = Tracer::Instance();
+    std::ostringstream out;
+    TraceOptions       options;
+    options.drainPeriod    = std::chrono::hours(1);
+    options.bufferCapacity = 32;
+    ASSERT_TRUE(tracer.Start(out, options));
+
+    // A new thread gets a buffer of the session capacity
+    std::thread([] {
+        for (int i = 0; i < 100; i++)
+            Work(0);
+    }).join();
+    tracer.Stop();
+
+    EXPECT_EQ(tracer.DroppedEvents(), 100u - 32u);
+    EXPECT_EQ(CountOf(out.str(), "\"ph\":\"X\""), 32u);
+}
+
+TEST(Trace, SessionsAreIndependent)
+{
+    Tracer &tracer = Tracer::Instance();
+    for (int session = 0; session < 3; session++) {
+        std::ostringstream out;
+        ASSERT_TRUE(tracer.Start(out));
+        Work(session);
+        tracer.Stop();
+        Work(5);  // After the session, not exported by the next one
+        EXPECT_EQ(CountOf(out.str(), "\"ph\":\"X\""), std::size_t(2 * session + 1));
+    }
+}
@@ -0,0 +1,206 @@
+#include "FTC/Function/Event.hpp"
+
+#include "FTC/Debug/LifetimeTester.hpp"
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace ftc;
+
+TEST(Event, Dispatch)
+{
+    Event<void(int, const std::string &)> event;
+    std::vector<std::string>              received;
+
+    EXPECT_TRUE(event.Empty());
+    event(0, "nobody");
+
+    auto h1 = event.Subscribe([&](int x, const std::string &s) {
+        received.push_back(std::to_string(x) + s);
+    });
+    auto h2 = event.Subscribe([&](int x, const std::string &s) {
+        received.push_back(s + std::to_string(x));
+    });
+    EXPECT_TRUE(h1 && h2);
+    EXPECT_NE(h1, h2);
+    EXPECT_EQ(event.Size(), 2);
+
+    event(1, "a");
+    event.Dispatch(2, "b");
+    EXPECT_EQ(received, (std::vector<std::string> {"1a", "a1", "2b", "b2"}));
+}
+
+TEST(Event, Unsubscribe)
+{
+    MulticastDelegate<void(std::vector<int> &)> event;
+    std::vector<Event<void(std::vector<int> &)>::Handle> handles;
+    for (int i = 0; i < 8; i++)
+        handles.push_back(event.Subscribe([i](std::vector<int> &out) { out.push_back(i); }));
+
+    EXPECT_TRUE(event.Unsubscribe(handles[3]));
+    EXPECT_FALSE(event.Unsubscribe(handles[3]));
+    EXPECT_FALSE(event.Contains(handles[3]));
+    EXPECT_FALSE(event.Unsubscribe({}));
+    EXPECT_FALSE(decltype(handles)::value_type {});
+
+    // Removing more than half of the listeners compacts them, the order is kept
+    for (int i : {0, 5, 6, 7})
+        EXPECT_TRUE(event.Unsubscribe(handles[i]));
+    std::vector<int> out;
+    event(out);
+    EXPECT_EQ(out, (std::vector<int> {1, 2, 4}));
+    EXPECT_EQ(event.Size(), 3);
+
+    // Slots are reused, but stale handles stay stale
+    auto h = event.Subscribe([](std::vector<int> &out) { out.push_back(8); });
+    EXPECT_TRUE(event.Contains(h));
+    for (int i : {0, 3, 5, 6, 7})
+        EXPECT_FALSE(event.Contains(handles[i]));
+    EXPECT_TRUE(event.Contains(handles[4]));
+
+    out.clear();
+    event(out);
+    EXPECT_EQ(out, (std::vector<int> {1, 2, 4, 8}));
+
+    event.Clear();
+    EXPECT_TRUE(event.Empty());
+    EXPECT_FALSE(event.Contains(h));
+    out.clear();
+    event(out);
+    EXPECT_TRUE(out.empty());
+}
+
+TEST(Event, ModifyDuringDispatch)
+{
+    Event<void(int), 48>         event;
+    Event<void(int), 48>::Handle self, other, added;
+    std::vector<int>             calls;
+
+    // Unsubscribes itself and a later listener, and subscribes a new listener
+    self = event.Subscribe([&](int x) {
+        calls.push_back(x * 10 + 1);
+        EXPECT_TRUE(event.Unsubscribe(self));
+        EXPECT_TRUE(event.Unsubscribe(other));
+        added = event.Subscribe([&](int x) { calls.push_back(x * 10 + 4); });
+        EXPECT_TRUE(event.Contains(added));
+    });
+    event.Subscribe([&](int x) { calls.push_back(x * 10 + 2); });
+    other = event.Subscribe([&](int x) { calls.push_back(x * 10 + 3); });
+
+    event(1);
+    EXPECT_EQ(calls, (std::vector<int> {11, 12}));
+    EXPECT_EQ(event.Size(), 2);
+    event(2);
+    EXPECT_EQ(calls, (std::vector<int> {11, 12, 22, 24}));
+    EXPECT_TRUE(event.Unsubscribe(added));
+    EXPECT_EQ(event.Size(), 1);
+}
+
+TEST(Event, NestedDispatch)
+{
+    Event<void(int)> event;
+    std::vector<int> calls;
+    event.Subscribe([&](int depth) {
+        calls.push_back(depth);
+        if (depth < 2)
+            event(depth + 1);
+    });
+    auto h = event.Subscribe([&](int depth) {
+        calls.push_back(-depth);
+        event.Clear();
+    });
+
+    event(0);
+    EXPECT_EQ(calls, (std::vector<int> {0, 1, 2, -2}));
+    EXPECT_FALSE(event.Contains(h));
+    EXPECT_TRUE(event.Empty());
+}
+
+TEST(Event, ListenerLifetime)
+{
+    using Counter = LifetimeCounter<struct EventTag>;
+    using Tester  = LifetimeTester<Counter>;
+
+    Counter::Scope scope;
+    {
+        Event<void(), 32>         event;
+        Event<void(), 32>::Handle h;
+        event.Reserve(4);
+        h = event.Subscribe([t = Tester("listener"), &event, &h] {
+            event.Unsubscribe(h);
+            EXPECT_STREQ(t.Name(), "listener");  // Not destroyed while running
+        });
+        EXPECT_EQ(scope.Delta().Copies(), 0);
+        EXPECT_EQ(scope.Delta().live, 1);
+
+        event();
+        EXPECT_EQ(scope.Delta().live, 0);
+        EXPECT_EQ(scope.Delta().Copies(), 0);
+
+        event.Subscribe([t = Tester("kept")] {});
+        Event<void(), 32> moved(std::move(event));
+        EXPECT_EQ(moved.Size(), 1);
+        EXPECT_EQ(scope.Delta().live, 1);
+    }
+    EXPECT_EQ(scope.Delta().live, 0);
+    EXPECT_EQ(scope.Delta().Copies(), 0);
+}
+
+TEST(Event, SubscribeUnsubscribeDuringDispatch)
+{
+    Event<void(), 32> event;
+    int               calls = 0;
+    event.Subscribe([&] {
+        // Listeners subscribed and unsubscribed again during dispatch are never merged
+        for (int i = 0; i < 1000; i++) {
+            auto a = event.Subscribe([&] { calls += 100; });
+            auto b = event.Subscribe([&] { calls += 100; });
+            EXPECT_TRUE(event.Unsubscribe(a));
+            EXPECT_TRUE(event.Unsubscribe(b));
+        }
+        if (event.Size() == 1)
+            event.Subscribe([&] { calls++; });
+    });
+
+    event();
+    EXPECT_EQ(calls, 0);
+    EXPECT_EQ(event.Size(), 2);
+    event();
+    EXPECT_EQ(calls, 1);
+    EXPECT_EQ(event.Size(), 2);
+}
+
+TEST(Event, ThrowingListener)
+{
+    using Counter = LifetimeCounter<struct EventThrowTag>;
+    using Tester  = LifetimeTester<Counter>;
+
+    Counter::Scope    scope;
+    Event<void(), 32> event;
+    int               calls = 0;
+    auto              removed = event.Subscribe([t = Tester("removed")] {});
+    event.Subscribe([&] {
+        if (calls++ == 0) {
+            event.Unsubscribe(removed);
+            event.Subscribe([&] { calls += 10; });
+            throw std::runtime_error("listener");
+        }
+    });
+    EXPECT_EQ(scope.Delta().live, 1);
+
+    // The removed listener is destroyed, the pending one is invoked by the next dispatch
+    EXPECT_THROW(event(), std::runtime_error);
+    EXPECT_EQ(scope.Delta().live, 0);
+    EXPECT_EQ(event.Size(), 2);
+    event();
+    EXPECT_EQ(calls, 12);
+}
+
+int main(int argc, char *argv[])
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
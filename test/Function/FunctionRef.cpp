@@ -0,0 +1,109 @@
+#include "FTC/Function/FunctionRef.hpp"
+
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace ftc;
+
+int func(int x)
+{
+    return x + 42;
+}
+
+int Apply(FunctionRef<int(int)> f, int x)
+{
+    return f(x);
+}
+
+TEST(FunctionRef, Size)
+{
+    EXPECT_EQ(sizeof(FunctionRef<void()>), 2 * sizeof(void *));
+    EXPECT_EQ(sizeof(FunctionRef<int(int, int)>), 2 * sizeof(void *));
+}
+
+TEST(FunctionRef, FunctionPointer)
+{
+    FunctionRef<int(int)> f1(func);
+    FunctionRef<int(int)> f2 = &func;
+    for (int i = 0; i < 10; i++) {
+        EXPECT_EQ(f1(i), i + 42);
+        EXPECT_EQ(f2(i), i + 42);
+        EXPECT_EQ(Apply(func, i), i + 42);
+    }
+}
+
+TEST(FunctionRef, Lambda)
+{
+    int  y = 42;
+    auto f = [&y](int x) { return x + y; };
+
+    FunctionRef<int(int)> f1(f);
+    EXPECT_EQ(f1(1), 43);
+
+    // References the lambda, not a copy of it
+    y = 0;
+    EXPECT_EQ(f1(1), 1);
+
+    EXPECT_EQ(Apply([](int x) { return x * 2; }, 21), 42);
+}
+
+TEST(FunctionRef, MutableState)
+{
+    struct counter
+    {
+        int count = 0;
+        int operator()(int x) { return count += x; }
+    } c;
+
+    FunctionRef<int(int)> f(c);
+    f(1);
+    f(2);
+    EXPECT_EQ(c.count, 3);
+
+    FunctionRef<int(int)> g = f;
+    g(3);
+    EXPECT_EQ(c.count, 6);
+}
+
+TEST(FunctionRef, Conversion)
+{
+    // Result and argument types only need to be convertible
+    auto f = [](double x) { return int(x * 2); };
+
+    FunctionRef<long(int)> f1(f);
+    EXPECT_EQ(f1(21), 42L);
+
+    std::vector<int>       v;
+    auto                   push = [&v](int x) { v.push_back(x); };
+    FunctionRef<void(int)> f2   = push;
+    f2(1);
+    f2(2);
+    EXPECT_EQ(v.size(), 2);
+
+    // A void reference discards the result
+    int                    calls = 0;
+    auto                   count = [&calls](int x) { return calls += x; };
+    FunctionRef<void(int)> f3    = count;
+    f3(3);
+    FunctionRef<void()> f4 = +[] { return 1; };
+    f4();
+    EXPECT_EQ(calls, 3);
+}
+
+TEST(FunctionRef, Deduction)
+{
+    auto f = [](int x) { return x + 1; };
+
+    FunctionRef f1(f);
+    FunctionRef f2(func);
+    static_assert(std::is_same_v<decltype(f1), FunctionRef<int(int)>>);
+    static_assert(std::is_same_v<decltype(f2), FunctionRef<int(int)>>);
+    EXPECT_EQ(f1(1), 2);
+    EXPECT_EQ(f2(1), 43);
+}
+
+int main(int argc, char *argv[])
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
\ No newline at end of file
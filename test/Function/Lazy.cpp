@@ -0,0 +1,60 @@
+#include "FTC/Function/Lazy.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ftc;
+
+TEST(Lazy, Get)
+{
+    int  numCalls = 0;
+    Lazy lazy     = [&] {
+        numCalls++;
+        return std::string("computed");
+    };
+    static_assert(std::is_same_v<decltype(lazy), Lazy<std::string>>);
+
+    EXPECT_FALSE(lazy.HasValue());
+    EXPECT_EQ(numCalls, 0);
+    EXPECT_EQ(lazy.Get(), "computed");
+    EXPECT_TRUE(lazy.HasValue());
+    EXPECT_EQ(*lazy, "computed");
+    EXPECT_EQ(lazy->size(), 8);
+    EXPECT_EQ(numCalls, 1);
+}
+
+TEST(Lazy, Exception)
+{
+    int       numCalls = 0;
+    Lazy<int> lazy([&] {
+        if (numCalls++ == 0)
+            throw std::runtime_error("first call fails");
+        return 42;
+    });
+    EXPECT_THROW(lazy.Get(), std::runtime_error);
+    EXPECT_FALSE(lazy.HasValue());
+    EXPECT_EQ(lazy.Get(), 42);
+    EXPECT_EQ(numCalls, 2);
+}
+
+TEST(Lazy, MultiThread)
+{
+    std::atomic<int> numCalls {0};
+    Lazy<int>        lazy([&] {
+        numCalls++;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        return 42;
+    });
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++)
+        threads.emplace_back([&] { EXPECT_EQ(lazy.Get(), 42); });
+    for (auto &thread : threads)
+        thread.join();
+    EXPECT_EQ(numCalls.load(), 1);
+}
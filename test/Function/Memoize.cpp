@@ -0,0 +1,136 @@
+#include "FTC/Function/Memoize.hpp"
+
+#include <atomic>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ftc;
+
+static int numCalls = 0;
+
+int Square(int x)
+{
+    numCalls++;
+    return x * x;
+}
+
+TEST(Memoize, Key)
+{
+    auto unary  = Memoize(Square, 4);
+    auto binary = Memoize([](const std::string &s, int n) { return s.substr(0, n); }, 4);
+    static_assert(std::is_same_v<decltype(unary)::Key, int>);
+    static_assert(std::is_same_v<decltype(binary)::Key, std::tuple<std::string, int>>);
+    static_assert(std::is_same_v<decltype(binary)::Value, std::string>);
+
+    EXPECT_EQ(binary("hello", 2), "he");
+    EXPECT_EQ(binary(std::string("hello"), 2), "he");
+    EXPECT_EQ(binary("hello", 3), "hel");
+    EXPECT_EQ(binary.Stats().hits, 1);
+    EXPECT_EQ(binary.Stats().misses, 2);
+    EXPECT_EQ(binary.Size(), 2);
+}
+
+TEST(Memoize, LRU)
+{
+    numCalls  = 0;
+    auto memo = Memoize(Square, 3);
+    EXPECT_EQ(memo.Capacity(), 3);
+
+    for (int x : {1, 2, 3, 1, 2, 3})
+        EXPECT_EQ(memo(x), x * x);
+    EXPECT_EQ(numCalls, 3);
+
+    // 1 is the least recently used, and is evicted by 4
+    memo(2);
+    memo(3);
+    memo(4);
+    EXPECT_EQ(memo.Size(), 3);
+    EXPECT_EQ(numCalls, 4);
+    memo(2);
+    memo(3);
+    memo(4);
+    EXPECT_EQ(numCalls, 4);
+    memo(1);
+    EXPECT_EQ(numCalls, 5);
+
+    memo.Clear();
+    EXPECT_EQ(memo.Size(), 0);
+    memo(1);
+    EXPECT_EQ(numCalls, 6);
+}
+
+TEST(Memoize, Clock)
+{
+    numCalls  = 0;
+    auto memo = Memoize<CachePolicy::Clock>(Square, 3);
+    for (int x : {1, 2, 3})
+        memo(x);
+    EXPECT_EQ(numCalls, 3);
+
+    // 1 and 3 are referenced, so 2 is evicted by 4
+    memo(1);
+    memo(3);
+    memo(4);
+    EXPECT_EQ(numCalls, 4);
+    memo(1);
+    memo(3);
+    memo(4);
+    EXPECT_EQ(numCalls, 4);
+    memo(2);
+    EXPECT_EQ(numCalls, 5);
+    EXPECT_EQ(memo.Size(), 3);
+
+    // A working set larger than the cache never hits
+    for (int round = 0; round < 4; round++)
+        for (int x = 10; x < 14; x++)
+            EXPECT_EQ(memo(x), x * x);
+    EXPECT_EQ(memo.Size(), 3);
+}
+
+TEST(Memoize, Sharded)
+{
+    std::atomic<int> calls {0};
+    auto             memo = Memoize<CachePolicy::LRU, 8>(
+        [&](int x, int y) {
+            calls.fetch_add(1, std::memory_order_relaxed);
+            return std::to_string(x) + "," + std::to_string(y);
+        },
+        1024);
+    EXPECT_EQ(memo.Capacity(), 1024);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++)
+        threads.emplace_back([&] {
+            for (int round = 0; round < 10; round++)
+                for (int i = 0; i < 100; i++)
+                    EXPECT_EQ(memo(i, i + 1), std::to_string(i) + "," + std::to_string(i + 1));
+        });
+    for (auto &thread : threads)
+        thread.join();
+
+    // Each key is computed once, except when several threads miss it at the same time
+    EXPECT_GE(calls.load(), 100);
+    EXPECT_LT(calls.load(), 400);
+    EXPECT_EQ(memo.Size(), 100);
+    EXPECT_EQ(memo.Stats().hits + memo.Stats().misses, 4000);
+}
+
+TEST(Memoize, Exception)
+{
+    numCalls  = 0;
+    auto memo = Memoize(
+        [](int x) {
+            if (numCalls++ == 0)
+                throw std::runtime_error("first call fails");
+            return x;
+        },
+        2);
+    EXPECT_THROW(memo(1), std::runtime_error);
+    EXPECT_EQ(memo.Size(), 0);
+    EXPECT_EQ(memo(1), 1);
+    EXPECT_EQ(memo(1), 1);
+    EXPECT_EQ(numCalls, 2);
+}
@@ -1,19 +1,23 @@
 #include "FTC/Function/SmallFunction.hpp"
 
+#include "FTC/Debug/LifetimeTester.hpp"
+#include "FTC/Memory/pmr/ProfileResource.hpp"
+
 #include <gtest/gtest.h>
+#include <memory>
 
 using namespace ftc;
 
 TEST(SmallFunction, Size)
 {
-    EXPECT_EQ(sizeof(SmallFunction<void()>), 32);
-    EXPECT_EQ(sizeof(SmallFunction<void(), 8>), 16);
-    EXPECT_EQ(sizeof(SmallFunction<void(), 16>), 24);
-    EXPECT_EQ(sizeof(SmallFunction<void(), 24>), 32);
-    EXPECT_EQ(sizeof(SmallFunction<void(), 32>), 40);
-    EXPECT_EQ(sizeof(SmallFunction<void(), 40>), 48);
-    EXPECT_EQ(sizeof(SmallFunction<void(), 48>), 56);
-    EXPECT_EQ(sizeof(SmallFunction<void(), 56>), 64);
+    EXPECT_EQ(sizeof(SmallFunction<void()>), 40);
+    EXPECT_EQ(sizeof(SmallFunction<void(), 8>), 24);
+    EXPECT_EQ(sizeof(SmallFunction<void(), 16>), 32);
+    EXPECT_EQ(sizeof(SmallFunction<void(), 24>), 40);
+    EXPECT_EQ(sizeof(SmallFunction<void(), 32>), 48);
+    EXPECT_EQ(sizeof(SmallFunction<void(), 40>), 56);
+    EXPECT_EQ(sizeof(SmallFunction<void(), 48>), 64);
+    EXPECT_EQ(sizeof(SmallFunction<void(), 56>), 72);
 }
 
 int func(int x)
@@ -158,6 +162,177 @@ TEST(SmallFunction, OperatorEqual)
     EXPECT_EQ(sf3 != nullptr, false);
 }
 
+TEST(SmallFunction, NonTrivial)
+{
+    auto counter = std::make_shared<int>(42);
+    auto f       = [counter](int x) { return x + *counter; };
+
+    {
+        SmallFunction<int(int)> sf1(f);
+        EXPECT_EQ(counter.use_count(), 3);
+
+        SmallFunction<int(int)> sf2(sf1);
+        EXPECT_EQ(counter.use_count(), 4);
+
+        SmallFunction<int(int), 32> sf3(std::move(sf2));
+        EXPECT_EQ(counter.use_count(), 4);
+        EXPECT_EQ(sf2, nullptr);
+        EXPECT_EQ(sf3(1), 43);
+
+        sf1 = nullptr;
+        EXPECT_EQ(counter.use_count(), 3);
+
+        sf3 = sf3;
+        EXPECT_EQ(counter.use_count(), 3);
+        EXPECT_EQ(sf3(2), 44);
+    }
+    EXPECT_EQ(counter.use_count(), 2);
+}
+
+TEST(SmallFunction, Deduction)
+{
+    SmallFunction sf1 = [](int x) { return x + 1; };
+    SmallFunction sf2(func);
+    static_assert(std::is_same_v<decltype(sf1), SmallFunction<int(int)>>);
+    static_assert(std::is_same_v<decltype(sf2), SmallFunction<int(int)>>);
+    EXPECT_EQ(sf1(1), 2);
+    EXPECT_EQ(sf2(1), 43);
+}
+
+struct ProfiledOverflow
+{
+    static pmr::profile_resource &Profile()
+    {
+        static pmr::profile_resource profile;
+        return profile;
+    }
+    static std::pmr::memory_resource *Resource() noexcept { return &Profile(); }
+};
+
+TEST(SmallFunction, Overflow)
+{
+    using Func = SmallFunction<int(int), 8, ProfiledOverflow>;
+    EXPECT_EQ(sizeof(Func), 24);
+
+    pmr::profile_resource &profile = ProfiledOverflow::Profile();
+    std::size_t            base    = profile.get_stat().num_allocations;
+    auto allocations = [&] { return profile.get_stat().num_allocations - base; };
+
+    int  y     = 42;
+    auto small = [y](int x) { return x + y; };
+    Func sf1(small);
+    EXPECT_EQ(sf1(1), 43);
+    EXPECT_EQ(allocations(), 0);
+
+    int  array[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+    auto large    = [array](int x) { return x + array[7]; };
+    Func sf2(large);
+    EXPECT_EQ(sf2(1), 9);
+    EXPECT_EQ(allocations(), 1);
+
+    Func sf3(sf2);
+    EXPECT_EQ(sf3(2), 10);
+    EXPECT_EQ(allocations(), 2);
+
+    Func sf4(std::move(sf3));
+    EXPECT_EQ(sf4(3), 11);
+    EXPECT_EQ(sf3, nullptr);
+    EXPECT_EQ(allocations(), 2);
+
+    SmallFunction<int(int), 64, ProfiledOverflow> sf5(sf4);
+    EXPECT_EQ(sf5(4), 12);
+    EXPECT_EQ(allocations(), 3);
+
+    sf1 = sf2;
+    sf2 = small;
+    sf4 = nullptr;
+    sf5 = large;
+    EXPECT_EQ(sf1(5), 13);
+    EXPECT_EQ(sf2(5), 47);
+    EXPECT_EQ(sf5(5), 13);
+    EXPECT_EQ(allocations(), 4);
+
+    pmr::profile_resource::statistic stat = ProfiledOverflow::Profile().get_stat();
+    EXPECT_EQ(stat.num_allocations - stat.num_deallocations, 1);
+}
+
+TEST(SmallFunction, NoExtraCopies)
+{
+    using Counter = LifetimeCounter<struct SmallFunctionTag>;
+    using Tester  = LifetimeTester<Counter>;
+
+    Counter::Scope scope;
+    {
+        SmallFunction<int()> sf1 = [t = Tester("inline")] { return 1; };
+        EXPECT_EQ(scope.Delta().Copies(), 0);
+        EXPECT_EQ(scope.Delta().live, 1);
+
+        // Moving an inline functor moves it exactly once
+        Counter::Scope           moveScope;
+        SmallFunction<int()>     sf2(std::move(sf1));
+        sf1 = std::move(sf2);
+        SmallFunction<int(), 32> sf3(std::move(sf1));
+        EXPECT_EQ(moveScope.Delta().Copies(), 0);
+        EXPECT_EQ(moveScope.Delta().moveConstructs, 3);
+        EXPECT_EQ(moveScope.Delta().live, 0);
+        EXPECT_EQ(sf3(), 1);
+
+        // Copying copies exactly once
+        Counter::Scope           copyScope;
+        SmallFunction<int(), 32> sf4(sf3);
+        EXPECT_EQ(copyScope.Delta().copyConstructs, 1);
+        EXPECT_EQ(copyScope.Delta().Moves(), 0);
+    }
+    EXPECT_EQ(scope.Delta().live, 0);
+}
+
+TEST(SmallFunction, Relocatable)
+{
+    using Counter = LifetimeCounter<struct SmallFunctionRelocatableTag>;
+    struct Functor : RelocatableLifetimeTester<Counter>
+    {
+        int operator()() const { return 3; }
+    };
+    static_assert(!std::is_trivially_copyable_v<Functor>);
+
+    Counter::Scope scope;
+    {
+        SmallFunction<int()> sf1 = Functor {};
+        LifetimeCounts       constructed = scope.Delta();
+
+        // Moves of a trivially relocatable functor are memcpy
+        SmallFunction<int()>     sf2(std::move(sf1));
+        sf1 = std::move(sf2);
+        SmallFunction<int(), 32> sf3(std::move(sf1));
+        EXPECT_EQ(scope.Delta(), constructed);
+        EXPECT_EQ(sf3(), 3);
+        EXPECT_EQ(sf1, nullptr);
+        EXPECT_EQ(sf2, nullptr);
+    }
+    EXPECT_EQ(scope.Delta().live, 0);
+}
+
+TEST(SmallFunction, NoExtraCopiesOverflow)
+{
+    using Counter = LifetimeCounter<struct SmallFunctionOverflowTag>;
+    using Tester  = LifetimeTester<Counter, 64>;
+    using Func    = SmallFunction<int(), 8, ProfiledOverflow>;
+
+    Counter::Scope scope;
+    {
+        Func sf1 = [t = Tester("overflow")] { return 2; };
+        EXPECT_EQ(scope.Delta().Copies(), 0);
+
+        // Moving a heap allocated functor only transfers the pointer
+        Counter::Scope moveScope;
+        Func           sf2(std::move(sf1));
+        sf1 = std::move(sf2);
+        EXPECT_EQ(moveScope.Delta(), LifetimeCounts {});
+        EXPECT_EQ(sf1(), 2);
+    }
+    EXPECT_EQ(scope.Delta().live, 0);
+}
+
 int main(int argc, char *argv[])
 {
     ::testing::InitGoogleTest(&argc, argv);
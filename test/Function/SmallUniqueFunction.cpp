@@ -0,0 +1,97 @@
+#include "FTC/Function/SmallUniqueFunction.hpp"
+
+#include <future>
+#include <gtest/gtest.h>
+#include <memory>
+
+using namespace ftc;
+
+TEST(SmallUniqueFunction, Size)
+{
+    EXPECT_EQ(sizeof(SmallUniqueFunction<void()>), sizeof(SmallFunction<void()>));
+    EXPECT_EQ(sizeof(SmallUniqueFunction<void(), 8>), sizeof(SmallFunction<void(), 8>));
+    EXPECT_EQ(sizeof(SmallUniqueFunction<void(), 56>), sizeof(SmallFunction<void(), 56>));
+}
+
+TEST(SmallUniqueFunction, MoveOnly)
+{
+    auto f = [p = std::make_unique<int>(42)](int x) { return x + *p; };
+
+    SmallUniqueFunction<int(int)> sf1(std::move(f));
+    EXPECT_EQ(sf1(1), 43);
+
+    SmallUniqueFunction<int(int)> sf2(std::move(sf1));
+    EXPECT_EQ(sf1, nullptr);
+    EXPECT_EQ(sf2(2), 44);
+
+    SmallUniqueFunction<int(int), 32> sf3;
+    EXPECT_EQ(sf3, nullptr);
+    sf3 = std::move(sf2);
+    EXPECT_EQ(sf2, nullptr);
+    EXPECT_NE(sf3, nullptr);
+    EXPECT_EQ(sf3(3), 45);
+
+    sf3 = nullptr;
+    EXPECT_EQ((bool)sf3, false);
+    EXPECT_THROW(sf3(4), std::bad_function_call);
+}
+
+TEST(SmallUniqueFunction, Promise)
+{
+    std::promise<int> promise;
+    std::future<int>  future = promise.get_future();
+
+    SmallUniqueFunction<void(int)> sf([p = std::move(promise)](int x) mutable { p.set_value(x); });
+    sf(42);
+    EXPECT_EQ(future.get(), 42);
+}
+
+TEST(SmallUniqueFunction, FromSmallFunction)
+{
+    auto counter = std::make_shared<int>(42);
+
+    SmallFunction<int()>       sf([counter] { return *counter; });
+    SmallUniqueFunction<int()> uf(std::move(sf));
+    EXPECT_EQ(sf, nullptr);
+    EXPECT_EQ(uf(), 42);
+    EXPECT_EQ(counter.use_count(), 2);
+
+    uf = SmallFunction<int(), 8>([] { return 1; });
+    EXPECT_EQ(uf(), 1);
+    EXPECT_EQ(counter.use_count(), 1);
+}
+
+TEST(SmallUniqueFunction, Overflow)
+{
+    std::size_t numAlive = 0;
+    struct Large
+    {
+        std::unique_ptr<std::size_t, void (*)(std::size_t *)> alive;
+        char                                                  padding[64];
+        std::size_t operator()() const { return *alive; }
+    };
+
+    {
+        numAlive = 1;
+        Large large {{&numAlive, [](std::size_t *n) { --*n; }}, {}};
+
+        SmallUniqueFunction<std::size_t(), 8, OverflowToResource> sf1(std::move(large));
+        SmallUniqueFunction<std::size_t(), 16, OverflowToResource> sf2(std::move(sf1));
+        EXPECT_EQ(sf1, nullptr);
+        EXPECT_EQ(sf2(), 1);
+    }
+    EXPECT_EQ(numAlive, 0);
+}
+
+TEST(SmallUniqueFunction, Deduction)
+{
+    SmallUniqueFunction sf = [p = std::make_unique<int>(1)](int x) { return x + *p; };
+    static_assert(std::is_same_v<decltype(sf), SmallUniqueFunction<int(int)>>);
+    EXPECT_EQ(sf(1), 2);
+}
+
+int main(int argc, char *argv[])
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
\ No newline at end of file
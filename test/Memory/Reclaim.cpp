@@ -0,0 +1,205 @@
+#include "FTC/Memory/Reclaim.hpp"
+
+#include "FTC/Memory/pmr/ProfileResource.hpp"
+
+#include <atomic>
+#include <gtest/gtest.h>
+#include <memory>
+#include <memory_resource>
+#include <thread>
+#include <vector>
+
+using namespace ftc;
+
+struct Node
+{
+    static inline std::atomic<int> numAlive {0};
+
+    Node(int value = 0) : value(value) { numAlive++; }
+    ~Node()
+    {
+        value = -1;
+        numAlive--;
+    }
+
+    int value;
+};
+
+TEST(Reclaim, EpochRetire)
+{
+    pmr::profile_resource resource {std::pmr::new_delete_resource()};
+    {
+        EpochDomain domain {&resource};
+        EXPECT_EQ(domain.Resource(), &resource);
+
+        Node *node = new Node(1);
+        {
+            EpochDomain::Guard guard = domain.Pin();
+            {
+                EpochDomain::Guard nested = domain.Pin();
+            }
+            domain.Retire(node);
+
+            // A pinned thread holds back the epoch
+            for (int i = 0; i < 10; i++)
+                domain.Collect();
+            EXPECT_EQ(node->value, 1);
+            EXPECT_EQ(Node::numAlive, 1);
+        }
+
+        domain.Collect();
+        domain.Collect();
+        EXPECT_EQ(Node::numAlive, 0);
+
+        // Custom deleters, and retiring from a deleter
+        int numDeleted = 0;
+        domain.Retire(new Node(2), [&](Node *n) {
+            numDeleted++;
+            domain.Retire(new Node(3));
+            delete n;
+        });
+        domain.Collect();
+        EXPECT_EQ(numDeleted, 1);
+        EXPECT_EQ(Node::numAlive, 1);
+    }
+    EXPECT_EQ(Node::numAlive, 0);
+    EXPECT_EQ(resource.get_stat().bytes_in_use, 0);
+}
+
+TEST(Reclaim, HazardRetire)
+{
+    pmr::profile_resource resource {std::pmr::new_delete_resource()};
+    {
+        HazardDomain       domain {&resource};
+        std::atomic<Node *> head {new Node(1)};
+        {
+            HazardPointer hp {domain};
+            Node *        node = hp.Protect(head);
+            EXPECT_EQ(node, head.load());
+            head.store(new Node(2));
+            domain.Retire(node);
+            domain.Collect();
+            EXPECT_EQ(node->value, 1);
+            EXPECT_EQ(Node::numAlive, 2);
+        }
+        domain.Collect();
+        EXPECT_EQ(Node::numAlive, 1);
+
+        // Slots of a thread are bounded, and freed by destruction
+        {
+            std::vector<std::unique_ptr<HazardPointer>> hps;
+            for (std::size_t i = 0; i < HazardDomain::SlotsPerThread; i++)
+                hps.push_back(std::make_unique<HazardPointer>(domain));
+            EXPECT_THROW(HazardPointer {domain}, std::length_error);
+            hps.pop_back();
+            HazardPointer hp {domain};
+        }
+        domain.Retire(head.exchange(nullptr));
+    }
+    EXPECT_EQ(Node::numAlive, 0);
+    EXPECT_EQ(resource.get_stat().bytes_in_use, 0);
+}
+
+/// Readers check that the current node is alive while a writer keeps replacing it
+template <typename Read, typename Retire> void StressReplace(Read read, Retire retire)
+{
+    std::atomic<Node *>      current {new Node(0)};
+    std::atomic<bool>        stop {false};
+    std::atomic<int>         numErrors {0};
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; i++)
+        readers.emplace_back([&] {
+            while (!stop.load(std::memory_order_relaxed))
+                read(current, [&](Node *node) {
+                    if (node->value < 0)
+                        numErrors++;
+                });
+        });
+
+    for (int v = 1; v <= 20000; v++)
+        retire(current.exchange(new Node(v)));
+    stop = true;
+    for (std::thread &t : readers)
+        t.join();
+    retire(current.exchange(nullptr));
+
+    EXPECT_EQ(numErrors, 0);
+}
+
+TEST(Reclaim, EpochConcurrent)
+{
+    {
+        EpochDomain domain;
+        StressReplace(
+            [&](std::atomic<Node *> &current, auto check) {
+                EpochDomain::Guard guard = domain.Pin();
+                check(current.load(std::memory_order_acquire));
+            },
+            [&](Node *node) { domain.Retire(node); });
+
+        // Everything is reclaimed once readers are gone
+        domain.Collect();
+        EXPECT_EQ(Node::numAlive, 0);
+    }
+}
+
+TEST(Reclaim, HazardConcurrent)
+{
+    {
+        HazardDomain domain;
+        StressReplace(
+            [&](std::atomic<Node *> &current, auto check) {
+                HazardPointer hp {domain};
+                check(hp.Protect(current));
+            },
+            [&](Node *node) { domain.Retire(node); });
+
+        // Everything is reclaimed once readers are gone
+        domain.Collect();
+        EXPECT_EQ(Node::numAlive, 0);
+    }
+}
+
+TEST(Reclaim, ThreadExit)
+{
+    EpochDomain domain;
+
+    // Objects retired by an exited thread are reclaimed by the thread adopting its record
+    std::thread([&] { domain.Retire(new Node(1)); }).join();
+    EXPECT_EQ(Node::numAlive, 1);
+    std::thread([&] {
+        domain.Collect();
+        domain.Collect();
+    }).join();
+    EXPECT_EQ(Node::numAlive, 0);
+}
+TEST(Reclaim, HeldRecordEviction)
+{
+    HazardDomain        domain;
+    std::atomic<Node *> head {new Node(1)};
+    HazardPointer       hp {domain};
+    Node *              node = hp.Protect(head);
+
+    // Using more domains than a thread caches evicts the record held by hp, which must not be
+    // handed to another thread while hp uses it
+    {
+        std::vector<std::unique_ptr<HazardDomain>> others;
+        for (int i = 0; i < 8; i++) {
+            others.push_back(std::make_unique<HazardDomain>());
+            others.back()->Collect();
+        }
+    }
+    std::thread([&] {
+        std::vector<std::unique_ptr<HazardPointer>> hps;
+        for (std::size_t i = 0; i < HazardDomain::SlotsPerThread; i++)
+            EXPECT_NO_THROW(hps.push_back(std::make_unique<HazardPointer>(domain)));
+        domain.Retire(head.exchange(nullptr));
+        domain.Collect();
+    }).join();
+    EXPECT_EQ(node->value, 1);
+
+    // Once unprotected, the node is reclaimed by the thread adopting the record it was retired to
+    hp.Reset();
+    std::thread([&] { domain.Collect(); }).join();
+    EXPECT_EQ(Node::numAlive, 0);
+}
\ No newline at end of file
@@ -0,0 +1,182 @@
+#include "FTC/Memory/pmr/ConcurrentPoolResource.hpp"
+
+#include "FTC/Memory/pmr/ProfileResource.hpp"
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstring>
+#include <memory_resource>
+#include <thread>
+#include <vector>
+
+using namespace ftc;
+
+TEST(ConcurrentPoolResource, Options)
+{
+    pmr::concurrent_pool_resource r1;
+    EXPECT_EQ(r1.options().largest_required_pool_block,
+              pmr::concurrent_pool_resource::default_largest_block);
+    EXPECT_EQ(r1.upstream_resource(), std::pmr::get_default_resource());
+
+    pmr::concurrent_pool_resource r2({16, 1000}, std::pmr::new_delete_resource());
+    EXPECT_EQ(r2.options().max_blocks_per_chunk, 16);
+    EXPECT_EQ(r2.options().largest_required_pool_block, 1024);
+    EXPECT_EQ(r2.upstream_resource(), std::pmr::new_delete_resource());
+    EXPECT_TRUE(r2.is_equal(r2));
+    EXPECT_FALSE(r2.is_equal(r1));
+}
+
+TEST(ConcurrentPoolResource, SizeClasses)
+{
+    pmr::profile_resource         upstream {std::pmr::new_delete_resource()};
+    pmr::concurrent_pool_resource r {&upstream};
+
+    std::vector<std::pair<void *, std::size_t>> blocks;
+    for (std::size_t bytes = 1; bytes <= 8192; bytes = bytes * 3 / 2 + 1) {
+        for (std::size_t align : {std::size_t(1), alignof(std::max_align_t), std::size_t(64)}) {
+            void *p = r.allocate(bytes, align);
+            EXPECT_EQ(reinterpret_cast<std::uintptr_t>(p) % align, 0) << bytes << ", " << align;
+            std::memset(p, 0xcd, bytes);
+            blocks.emplace_back(p, bytes);
+            r.deallocate(p, bytes, align);
+            blocks.back().first = r.allocate(bytes, align);
+            if (bytes <= r.options().largest_required_pool_block) {
+                EXPECT_EQ(blocks.back().first, p) << "freed block should be reused";
+            }
+        }
+    }
+
+    for (std::size_t i = 0; i < blocks.size(); i++) {
+        std::size_t align = i % 3 == 0 ? 1 : i % 3 == 1 ? alignof(std::max_align_t) : 64;
+        r.deallocate(blocks[i].first, blocks[i].second, align);
+    }
+    EXPECT_GT(upstream.get_stat().bytes_in_use, 0);  // Chunks are kept until destruction
+}
+
+TEST(ConcurrentPoolResource, ReleaseOnDestroy)
+{
+    pmr::profile_resource upstream {std::pmr::new_delete_resource()};
+    {
+        pmr::concurrent_pool_resource r {&upstream};
+        std::vector<void *>           ptrs;
+        for (int i = 0; i < 10000; i++)
+            ptrs.push_back(r.allocate(24));
+        void *large = r.allocate(100000);
+        r.deallocate(large, 100000);
+        for (void *p : ptrs)
+            r.deallocate(p, 24);
+
+        // Threads leave their blocks to the resource when exiting
+        std::thread([&] { r.deallocate(r.allocate(24), 24); }).join();
+    }
+    EXPECT_EQ(upstream.get_stat().bytes_in_use, 0);
+}
+
+TEST(ConcurrentPoolResource, CrossThread)
+{
+    constexpr int NumThreads = 4;
+    constexpr int NumBlocks  = 20000;
+
+    pmr::concurrent_pool_resource r;
+    std::vector<std::vector<int *>> produced(NumThreads);
+
+    // Each thread allocates blocks that another thread frees
+    std::vector<std::thread> threads;
+    for (int t = 0; t < NumThreads; t++)
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < NumBlocks; i++) {
+                int *p = static_cast<int *>(r.allocate(sizeof(int) * (1 + i % 8)));
+                *p     = t * NumBlocks + i;
+                produced[t].push_back(p);
+            }
+        });
+    for (std::thread &th : threads)
+        th.join();
+    threads.clear();
+
+    for (int t = 0; t < NumThreads; t++)
+        threads.emplace_back([&, t] {
+            std::vector<int *> &blocks = produced[(t + 1) % NumThreads];
+            int                 owner  = (t + 1) % NumThreads;
+            for (int i = 0; i < NumBlocks; i++) {
+                EXPECT_EQ(*blocks[i], owner * NumBlocks + i);
+                r.deallocate(blocks[i], sizeof(int) * (1 + i % 8));
+            }
+            // Freed blocks flow back through the global batches
+            for (int i = 0; i < NumBlocks; i++)
+                r.deallocate(r.allocate(16), 16);
+        });
+    for (std::thread &th : threads)
+        th.join();
+}
+
+TEST(ConcurrentPoolResource, ManyResources)
+{
+    // More resources than thread table entries, used in turn by one thread
+    std::vector<std::unique_ptr<pmr::concurrent_pool_resource>> resources;
+    for (int i = 0; i < 8; i++)
+        resources.push_back(std::make_unique<pmr::concurrent_pool_resource>());
+
+    for (int round = 0; round < 3; round++) {
+        for (auto &r : resources) {
+            std::pmr::vector<int> v {r.get()};
+            for (int i = 0; i < 100; i++)
+                v.push_back(i);
+            EXPECT_EQ(v[99], 99);
+        }
+    }
+    resources.erase(resources.begin(), resources.begin() + 4);
+    std::thread([&] {
+        for (auto &r : resources)
+            r->deallocate(r->allocate(64), 64);
+    }).join();
+}
+
+TEST(ConcurrentPoolResource, OverAligned)
+{
+    pmr::profile_resource         upstream {std::pmr::new_delete_resource()};
+    pmr::concurrent_pool_resource r {{0, pmr::concurrent_pool_resource::max_largest_block},
+                                     &upstream};
+
+    // Small requests aligned beyond the chunk alignment are passed to upstream unchanged
+    for (std::size_t align = 8192; align <= 65536; align *= 2) {
+        for (std::size_t bytes : {std::size_t(16), align / 2, align}) {
+            pmr::profile_resource::statistic before = upstream.get_stat();
+            void *p = r.allocate(bytes, align);
+            EXPECT_EQ(reinterpret_cast<std::uintptr_t>(p) % align, 0) << bytes << ", " << align;
+            EXPECT_EQ(upstream.get_stat().num_allocations, before.num_allocations + 1);
+            EXPECT_EQ(upstream.get_stat().bytes_in_use, before.bytes_in_use + bytes);
+            std::memset(p, 0xcd, bytes);
+            r.deallocate(p, bytes, align);
+            EXPECT_EQ(upstream.get_stat().bytes_in_use, before.bytes_in_use);
+        }
+    }
+
+    // Blocks of large size classes are still aligned up to max_block_align
+    void *p = r.allocate(8192, pmr::concurrent_pool_resource::max_block_align);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(p) % pmr::concurrent_pool_resource::max_block_align,
+              0);
+    r.deallocate(p, 8192, pmr::concurrent_pool_resource::max_block_align);
+}
+
+TEST(ConcurrentPoolResource, ChunkOverhead)
+{
+    pmr::profile_resource         upstream {std::pmr::new_delete_resource()};
+    pmr::concurrent_pool_resource r {{0, pmr::concurrent_pool_resource::max_largest_block},
+                                     &upstream};
+
+    // The chunk header does not take a whole block of the largest class
+    constexpr std::size_t Block = pmr::concurrent_pool_resource::max_largest_block;
+    r.deallocate(r.allocate(8), 8);  // Allocates the thread cache
+
+    pmr::profile_resource::statistic before = upstream.get_stat();
+    std::vector<void *>              blocks {r.allocate(Block)};
+    std::size_t                      chunk = upstream.get_stat().bytes_in_use - before.bytes_in_use;
+    while (upstream.get_stat().num_allocations == before.num_allocations + 1)
+        blocks.push_back(r.allocate(Block));
+    std::size_t blocksPerChunk = blocks.size() - 1;
+    EXPECT_GE(chunk, blocksPerChunk * Block);
+    EXPECT_LT(chunk, blocksPerChunk * Block + 1024);
+    for (void *p : blocks)
+        r.deallocate(p, Block);
+}
\ No newline at end of file
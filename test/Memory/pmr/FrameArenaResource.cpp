@@ -0,0 +1,116 @@
+#include "FTC/Memory/pmr/FrameArenaResource.hpp"
+
+#include "FTC/Memory/pmr/ProfileResource.hpp"
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstring>
+#include <memory_resource>
+#include <vector>
+
+using namespace ftc;
+
+TEST(FrameArenaResource, Bump)
+{
+    pmr::frame_arena_resource arena {1024};
+
+    char *a = static_cast<char *>(arena.allocate(10, 1));
+    char *b = static_cast<char *>(arena.allocate(10, 1));
+    EXPECT_EQ(b, a + 10);
+
+    void *c = arena.allocate(8, 64);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(c) % 64, 0);
+    arena.deallocate(c, 8, 64);  // No-op
+
+    std::size_t used = arena.used_bytes();
+    EXPECT_GE(used, 28);
+    EXPECT_LE(used, 20 + 64 + 8);
+    EXPECT_EQ(arena.reserved_bytes(), 1024);
+}
+
+TEST(FrameArenaResource, ResetReusesChunks)
+{
+    pmr::profile_resource     upstream {std::pmr::new_delete_resource()};
+    pmr::frame_arena_resource arena {256, &upstream};
+
+    std::vector<void *> first;
+    for (int i = 0; i < 100; i++) {
+        first.push_back(arena.allocate(48));
+        std::memset(first.back(), i, 48);
+    }
+    std::size_t chunks   = upstream.get_stat().num_allocations;
+    std::size_t reserved = arena.reserved_bytes();
+    EXPECT_GT(chunks, 1);
+    EXPECT_EQ(upstream.get_stat().bytes_in_use, reserved);
+
+    for (int frame = 0; frame < 10; frame++) {
+        arena.reset();
+        EXPECT_EQ(arena.used_bytes(), 0);
+        for (int i = 0; i < 100; i++) {
+            void *p = arena.allocate(48);
+            EXPECT_EQ(p, first[i]) << "same allocation sequence gives same addresses";
+        }
+    }
+    EXPECT_EQ(upstream.get_stat().num_allocations, chunks);
+
+    // A request larger than any chunk gets a chunk of its own, kept after reset
+    arena.reset();
+    void *large = arena.allocate(100000);
+    std::memset(large, 0, 100000);
+    EXPECT_EQ(upstream.get_stat().num_allocations, chunks + 1);
+    arena.reset();
+    EXPECT_EQ(arena.allocate(100000), large);
+    EXPECT_EQ(upstream.get_stat().num_allocations, chunks + 1);
+
+    arena.release();
+    EXPECT_EQ(arena.reserved_bytes(), 0);
+    EXPECT_EQ(upstream.get_stat().bytes_in_use, 0);
+    EXPECT_NE(arena.allocate(16), nullptr);
+    EXPECT_EQ(upstream.get_stat().num_allocations, chunks + 2);
+}
+
+TEST(FrameArenaResource, Scope)
+{
+    pmr::frame_arena_resource arena {128};
+
+    void *outer = arena.allocate(16);
+    void *inner = nullptr;
+    {
+        pmr::frame_arena_resource::scope scope {arena};
+        inner = arena.allocate(16);
+        for (int i = 0; i < 20; i++)
+            EXPECT_NE(arena.allocate(64), nullptr);  // Spills into more chunks
+        {
+            pmr::frame_arena_resource::scope nested {arena};
+            EXPECT_NE(arena.allocate(1000), nullptr);
+        }
+    }
+    EXPECT_EQ(arena.allocate(16), inner);
+    EXPECT_NE(inner, outer);
+
+    // Rewinding to a mark taken before the first chunk
+    pmr::frame_arena_resource             arena2;
+    pmr::frame_arena_resource::mark_type m = arena2.mark();
+    void *                                p = arena2.allocate(32);
+    arena2.rewind(m);
+    EXPECT_EQ(arena2.used_bytes(), 0);
+    EXPECT_EQ(arena2.allocate(32), p);
+}
+
+TEST(FrameArenaResource, Container)
+{
+    pmr::profile_resource     upstream {pmr::profile_resource::record_mode::none};
+    pmr::frame_arena_resource arena {&upstream};
+
+    for (int frame = 0; frame < 5; frame++) {
+        {
+            std::pmr::vector<std::pmr::string> strings {&arena};
+            for (int i = 0; i < 100; i++)
+                strings.emplace_back("string long enough to skip SSO #" + std::to_string(i));
+            EXPECT_EQ(strings[42].back(), '2');
+        }
+        arena.reset();
+    }
+    EXPECT_EQ(upstream.get_stat().bytes_in_use, arena.reserved_bytes());
+    EXPECT_EQ(upstream.get_stat().bytes_highestest, arena.reserved_bytes());
+}
\ No newline at end of file
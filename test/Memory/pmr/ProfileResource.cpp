@@ -0,0 +1,155 @@
+#include "FTC/Memory/pmr/ProfileResource.hpp"
+
+#include <gtest/gtest.h>
+#include <memory_resource>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace ftc;
+
+TEST(ProfileResource, Statistic)
+{
+    pmr::profile_resource r;
+    EXPECT_EQ(r.get_record_mode(), pmr::profile_resource::record_mode::validate);
+
+    void *a = r.allocate(100);
+    void *b = r.allocate(200);
+    r.deallocate(a, 100);
+    void *c = r.allocate(50);
+
+    pmr::profile_resource::statistic stat = r.get_stat();
+    EXPECT_EQ(stat.bytes_allocated, 350);
+    EXPECT_EQ(stat.bytes_in_use, 250);
+    EXPECT_EQ(stat.bytes_highestest, 300);  // Peak of bytes in use, not bytes allocated
+    EXPECT_EQ(stat.num_allocations, 3);
+    EXPECT_EQ(stat.num_deallocations, 1);
+
+    r.deallocate(b, 200);
+    r.deallocate(c, 50);
+    EXPECT_EQ(r.get_stat().bytes_in_use, 0);
+    EXPECT_EQ(r.get_stat().bytes_highestest, 300);
+}
+
+TEST(ProfileResource, Validate)
+{
+    pmr::profile_resource r;
+
+    void *p = r.allocate(64, 16);
+    int   x;
+    EXPECT_THROW(r.deallocate(&x, 64, 16), std::invalid_argument);
+    EXPECT_THROW(r.deallocate(p, 32, 16), std::invalid_argument);
+    EXPECT_THROW(r.deallocate(p, 64, 8), std::invalid_argument);
+    r.deallocate(p, 64, 16);
+    EXPECT_THROW(r.deallocate(p, 64, 16), std::invalid_argument);
+
+    // Grow the record table and erase in a different order
+    std::vector<void *> ptrs;
+    for (int i = 0; i < 1000; i++)
+        ptrs.push_back(r.allocate(8 + i % 16));
+    for (int i = 0; i < 1000; i += 2)
+        r.deallocate(ptrs[i], 8 + i % 16);
+    for (int i = 999; i > 0; i -= 2)
+        r.deallocate(ptrs[i], 8 + i % 16);
+    EXPECT_EQ(r.get_stat().bytes_in_use, 0);
+}
+
+TEST(ProfileResource, NoRecord)
+{
+    pmr::profile_resource r {pmr::profile_resource::record_mode::none,
+                             std::pmr::new_delete_resource()};
+    EXPECT_EQ(r.get_record_mode(), pmr::profile_resource::record_mode::none);
+
+    std::pmr::vector<int> v {&r};
+    for (int i = 0; i < 1000; i++)
+        v.push_back(i);
+    v.clear();
+    v.shrink_to_fit();
+
+    pmr::profile_resource::statistic stat = r.get_stat();
+    EXPECT_EQ(stat.bytes_in_use, 0);
+    EXPECT_EQ(stat.num_allocations, stat.num_deallocations);
+    EXPECT_GE(stat.bytes_highestest, 1000 * sizeof(int));
+}
+
+TEST(ProfileResource, Concurrent)
+{
+    constexpr int NumThreads = 4;
+    constexpr int NumIters   = 10000;
+
+    for (auto mode : {pmr::profile_resource::record_mode::none,
+                      pmr::profile_resource::record_mode::validate}) {
+        pmr::profile_resource    r {mode};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < NumThreads; t++)
+            threads.emplace_back([&] {
+                for (int i = 0; i < NumIters; i++) {
+                    void *p = r.allocate(16);
+                    r.deallocate(p, 16);
+                }
+            });
+        for (std::thread &th : threads)
+            th.join();
+
+        pmr::profile_resource::statistic stat = r.get_stat();
+        EXPECT_EQ(stat.num_allocations, NumThreads * NumIters);
+        EXPECT_EQ(stat.num_deallocations, NumThreads * NumIters);
+        EXPECT_EQ(stat.bytes_allocated, 16 * NumThreads * NumIters);
+        EXPECT_EQ(stat.bytes_in_use, 0);
+        EXPECT_LE(stat.bytes_highestest, 16 * NumThreads);
+    }
+}
+
+TEST(ProfileResource, Histogram)
+{
+    EXPECT_EQ(pmr::profile_resource::bucket_of(0), 0);
+    EXPECT_EQ(pmr::profile_resource::bucket_of(1), 0);
+    EXPECT_EQ(pmr::profile_resource::bucket_of(2), 1);
+    EXPECT_EQ(pmr::profile_resource::bucket_of(3), 1);
+    EXPECT_EQ(pmr::profile_resource::bucket_of(4096), 12);
+
+    pmr::profile_resource r {pmr::profile_resource::record_mode::none};
+    r.deallocate(r.allocate(8, 8), 8, 8);
+    r.deallocate(r.allocate(12, 4), 12, 4);
+    r.deallocate(r.allocate(100, 64), 100, 64);
+
+    pmr::profile_resource::snapshot snap = r.get_snapshot();
+    EXPECT_EQ(snap.stat.num_allocations, 3);
+    EXPECT_EQ(snap.size_histogram[3], 2);
+    EXPECT_EQ(snap.size_histogram[6], 1);
+    EXPECT_EQ(snap.alignment_histogram[2], 1);
+    EXPECT_EQ(snap.alignment_histogram[3], 1);
+    EXPECT_EQ(snap.alignment_histogram[6], 1);
+    EXPECT_GT(snap.elapsed_seconds, 0);
+    EXPECT_GT(snap.allocation_rate(), 0);
+    EXPECT_TRUE(snap.call_sites.empty());
+
+    std::ostringstream os;
+    pmr::profile_resource::dump(os, snap);
+    EXPECT_NE(os.str().find("num_allocations 3\n"), std::string::npos);
+    EXPECT_NE(os.str().find("size_bucket{le=15} 2\n"), std::string::npos);
+    EXPECT_NE(os.str().find("alignment_bucket{eq=64} 1\n"), std::string::npos);
+}
+
+TEST(ProfileResource, CallSite)
+{
+    pmr::profile_resource r {pmr::profile_resource::record_mode::none};
+    r.set_sample_interval(4);
+    EXPECT_EQ(r.get_sample_interval(), 4);
+
+    for (int i = 0; i < 16; i++)
+        r.deallocate(r.allocate(32), 32);
+    for (int i = 0; i < 8; i++)
+        r.deallocate(r.allocate(8), 8);
+
+    pmr::profile_resource::snapshot snap = r.get_snapshot();
+    ASSERT_EQ(snap.call_sites.size(), 2);
+    EXPECT_EQ(snap.call_sites[0].count, 4);
+    EXPECT_EQ(snap.call_sites[0].bytes, 4 * 32);
+    EXPECT_EQ(snap.call_sites[1].count, 2);
+    EXPECT_EQ(snap.call_sites[1].bytes, 2 * 8);
+    EXPECT_GT(snap.call_sites[0].num_frames, 0);
+    EXPECT_GT(snap.call_sites[1].num_frames, 0);
+    EXPECT_EQ(snap.dropped_samples, 0);
+}
\ No newline at end of file
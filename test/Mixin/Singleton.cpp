@@ -0,0 +1,167 @@
+#include "FTC/Mixin/Singleton.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ftc;
+
+struct Counter
+{
+    std::atomic<std::uint64_t> count {0};
+
+    Counter() = default;
+    Counter(Counter &&) {}  // required by DefaultCreator
+};
+
+struct ThreadCounter : ThreadLocalSingleton<Counter>
+{};
+
+struct CoreCounter : PerCoreSingleton<Counter>
+{};
+
+static std::uint64_t Sum(std::uint64_t sum, const Counter &c)
+{
+    return sum + c.count.load(std::memory_order_relaxed);
+}
+
+TEST(Singleton, ThreadLocal)
+{
+    constexpr int NumThreads = 4, NumIncrements = 10000;
+
+    std::vector<std::thread> threads;
+    std::vector<Counter *>   instances(NumThreads);
+    std::atomic<int>         numStarted {0};
+    for (int i = 0; i < NumThreads; i++)
+        threads.emplace_back([&, i] {
+            instances[i] = &ThreadCounter::Get();
+            // All threads are alive at the same time, so none adopts the instance of another
+            numStarted++;
+            while (numStarted < NumThreads)
+                std::this_thread::yield();
+            for (int j = 0; j < NumIncrements; j++)
+                ThreadCounter::Get().count.fetch_add(1, std::memory_order_relaxed);
+        });
+    for (std::thread &t : threads)
+        t.join();
+
+    for (int i = 0; i < NumThreads; i++)
+        for (int j = 0; j < i; j++)
+            EXPECT_NE(instances[i], instances[j]);
+
+    // Counts of exited threads are kept
+    EXPECT_EQ(ThreadCounter::Aggregate(std::uint64_t(0), Sum), NumThreads * NumIncrements);
+
+    // Instances of exited threads are reused
+    std::thread([&] {
+        Counter &c = ThreadCounter::Get();
+        EXPECT_NE(std::find(instances.begin(), instances.end(), &c), instances.end());
+        c.count++;
+    }).join();
+
+    std::size_t numInstances = 0;
+    ThreadCounter::ForEach([&](Counter &) { numInstances++; });
+    EXPECT_EQ(numInstances, NumThreads);
+    EXPECT_EQ(ThreadCounter::Aggregate(std::uint64_t(0), Sum), NumThreads * NumIncrements + 1);
+}
+
+TEST(Singleton, PerCore)
+{
+    constexpr int NumThreads = 4, NumIncrements = 10000;
+
+    std::size_t n = CoreCounter::NumInstances();
+    EXPECT_GE(n, std::thread::hardware_concurrency());
+    EXPECT_EQ(n & (n - 1), 0);
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < NumThreads; i++)
+        threads.emplace_back([] {
+            for (int j = 0; j < NumIncrements; j++)
+                CoreCounter::Get().count.fetch_add(1, std::memory_order_relaxed);
+        });
+    for (std::thread &t : threads)
+        t.join();
+
+    EXPECT_EQ(CoreCounter::Aggregate(std::uint64_t(0), Sum), NumThreads * NumIncrements);
+}
+
+struct Config
+{
+    static inline std::atomic<int> numAlive {0};
+
+    Config(int version = 0) : version(version), name("config " + std::to_string(version))
+    {
+        numAlive++;
+    }
+    Config(Config &&other) : Config(other.version) {}
+    ~Config()
+    {
+        version = -1;
+        name.clear();
+        numAlive--;
+    }
+
+    int         version;
+    std::string name;
+};
+
+struct GlobalConfig : DynamicSingleton<Config>
+{};
+
+TEST(Singleton, DynamicReplace)
+{
+    {
+        auto handle = GlobalConfig::Acquire();
+        EXPECT_EQ(handle->version, 0);
+        EXPECT_EQ(&*handle, GlobalConfig::Acquire().get());
+    }
+
+    std::atomic<bool>        stop {false};
+    std::atomic<int>         numErrors {0};
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; i++)
+        readers.emplace_back([&] {
+            int lastVersion = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                auto handle = GlobalConfig::Acquire();
+                // The instance stays valid while the handle holds it
+                int version = handle->version;
+                for (int k = 0; k < 10; k++)
+                    if (handle->version != version
+                        || handle->name != "config " + std::to_string(version))
+                        numErrors++;
+                if (version < lastVersion)
+                    numErrors++;
+                lastVersion = version;
+            }
+        });
+
+    for (int v = 1; v <= 200; v++)
+        GlobalConfig::Replace(v);
+    stop = true;
+    for (std::thread &t : readers)
+        t.join();
+
+    EXPECT_EQ(numErrors, 0);
+    EXPECT_EQ(GlobalConfig::Acquire()->version, 200);
+    EXPECT_EQ(Config::numAlive, 1);
+
+    GlobalConfig::FreeInstance();
+    EXPECT_EQ(Config::numAlive, 0);
+    EXPECT_EQ(GlobalConfig::Acquire()->version, 0);
+    EXPECT_EQ(Config::numAlive, 1);
+
+    // References from Get() are not protected, Replace() refuses to run until FreeInstance()
+    EXPECT_EQ(GlobalConfig::Get().version, 0);
+    EXPECT_THROW(GlobalConfig::Replace(1), std::logic_error);
+    EXPECT_EQ(GlobalConfig::Get().version, 0);
+    GlobalConfig::FreeInstance();
+    GlobalConfig::Replace(1);
+    EXPECT_EQ(GlobalConfig::Acquire()->version, 1);
+    EXPECT_EQ(Config::numAlive, 1);
+}
\ No newline at end of file
@@ -0,0 +1,65 @@
+#include "FTC/String/ConstString.hpp"
+
+#include <gtest/gtest.h>
+#include <string>
+#include <string_view>
+
+using namespace ftc;
+
+static constexpr ConstString Metric = "net.http.requests";
+
+static_assert(Metric.Hash() == HashString("net.http.requests"));
+static_assert(StringLiteral("abc").Hash() == ConstString("abc").Hash());
+static_assert(HashString("") == 14695981039346656037ull);
+static_assert(HashString("a") == 0xAF63DC4C8601EC8Cull);
+
+static_assert(Metric.Find('.') == 3);
+static_assert(Metric.Find("http") == 4);
+static_assert(Metric.Find("ftp") == Metric.npos);
+static_assert(Metric.Find('.', 4) == 8);
+static_assert(Metric.RFind('.') == 8);
+static_assert(Metric.RFind("e") == 13);
+static_assert(Metric.StartsWith("net."));
+static_assert(!Metric.StartsWith("http"));
+static_assert(Metric.EndsWith("requests"));
+static_assert(!Metric.EndsWith("a longer suffix than the metric"));
+static_assert(Metric.Count(".") == 2);
+
+constexpr auto Parts = Metric.Split<Metric.Count(".") + 1>(".");
+static_assert(Parts.size() == 3);
+static_assert(Parts[0] == "net" && Parts[1] == "http" && Parts[2] == "requests");
+
+constexpr auto Head = Metric.Split<2>(".");
+static_assert(Head[0] == "net" && Head[1] == "http.requests");
+
+constexpr auto Padded = Metric.Split<5>(".");
+static_assert(Padded[2] == "requests" && Padded[3].empty() && Padded[4].empty());
+
+static constexpr ConstString Sql = "SELECT ? FROM t WHERE id = ?";
+constexpr auto               Query = Sql.Replace<Sql.ReplacedLength("?", "$1")>("?", "$1");
+static_assert(std::string_view(Query) == "SELECT $1 FROM t WHERE id = $1");
+static_assert(std::string_view(Metric.Replace('.', '_')) == "net_http_requests");
+static_assert(std::string_view(Sql.Replace<24>(" = ?", "")) == "SELECT ? FROM t WHERE id");
+
+static_assert(std::string_view(ToConstString<0>()) == "0");
+static_assert(std::string_view(ToConstString<-42>()) == "-42");
+static_assert(std::string_view(ToConstString<18446744073709551615ull>()) == "18446744073709551615");
+static_assert(std::string_view(ToConstString<(-9223372036854775807ll - 1)>())
+              == "-9223372036854775808");
+static_assert(std::string_view(ToConstString([] { return 0.25; })) == "0.25");
+static_assert(std::string_view(ToConstString([] { return -3.0; })) == "-3");
+static_assert(std::string_view(ToConstString<2>([] { return 2.999; })) == "3");
+static_assert(std::string_view(ToConstString<3>([] { return 1.0625f; })) == "1.063");
+static_assert(std::string_view(ToConstString([] { return -0.0000001; })) == "0");
+
+TEST(ConstString, RuntimeHash)
+{
+    std::string runtime = "net.";
+    runtime += "http.requests";
+    EXPECT_EQ(HashString(runtime), Metric.Hash());
+
+    // Composes a metric name entirely at compile time
+    constexpr auto Name = Metric.Replace('.', '_') + "_p" + ToConstString<99>();
+    EXPECT_EQ(std::string_view(Name), "net_http_requests_p99");
+    EXPECT_EQ(Name.Length(), 21);
+}
\ No newline at end of file
@@ -0,0 +1,93 @@
+#include "FTC/String/Format.hpp"
+
+#include "FTC/Memory/pmr/ProfileResource.hpp"
+#include "FTC/String/ConstString.hpp"
+
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <limits>
+#include <string>
+#include <string_view>
+
+using namespace ftc;
+
+struct Point
+{
+    int x, y;
+};
+
+template <> struct ftc::Formatter<Point>
+{
+    static void Format(FormatSink &sink, const Point &p, const FormatSpec &)
+    {
+        FormatTo(sink, FORMAT_STRING("({}, {})"), p.x, p.y);
+    }
+};
+
+enum class Level : std::uint8_t { Info = 2 };
+
+TEST(Format, Basic)
+{
+    EXPECT_EQ(Format(FORMAT_STRING("")), "");
+    EXPECT_EQ(Format(FORMAT_STRING("no fields")), "no fields");
+    EXPECT_EQ(Format(FORMAT_STRING("{} + {} = {}"), 1, 2u, 3ll), "1 + 2 = 3");
+    EXPECT_EQ(Format(FORMAT_STRING("{1}{0}{1}"), 'a', "b"), "bab");
+    EXPECT_EQ(Format(FORMAT_STRING("{{{}}} }}{{"), true), "{true} }{");
+    EXPECT_EQ(Format(FORMAT_STRING("{} {} {}"),
+                     std::string("s"),
+                     std::string_view("v"),
+                     ConstString("c")),
+              "s v c");
+    EXPECT_EQ(Format(FORMAT_STRING("{}"), Point {1, -2}), "(1, -2)");
+    EXPECT_EQ(Format(FORMAT_STRING("{}"), Level::Info), "2");
+    EXPECT_EQ(Format(FORMAT_STRING("{}"), nullptr), "0x0");
+    EXPECT_EQ(Format(FORMAT_STRING("{}"), std::numeric_limits<std::int64_t>::min()),
+              "-9223372036854775808");
+
+    // The format string may also be a ConstString
+    EXPECT_EQ(Format([] { return ConstString("[") + "{}" + "]"; }, 42), "[42]");
+}
+
+TEST(Format, Spec)
+{
+    EXPECT_EQ(Format(FORMAT_STRING("{:5}|{:<5}|{:>5}"), 42, 42, "ab"), "   42|42   |   ab");
+    EXPECT_EQ(Format(FORMAT_STRING("{:5}|{:*>5}|{:_<4}"), "ab", 7, 'c'), "ab   |****7|c___");
+    EXPECT_EQ(Format(FORMAT_STRING("{:05}|{:08.3f}"), -42, -3.14159), "-0042|-003.142");
+    EXPECT_EQ(Format(FORMAT_STRING("{:x} {:X} {:o} {:b} {:#<4x}"), 255, 255, 8, 5, 10),
+              "ff FF 10 101 a###");
+    EXPECT_EQ(Format(FORMAT_STRING("{:c}{:d}{:d}"), 65, 'A', false), "A650");
+    EXPECT_EQ(Format(FORMAT_STRING("{:.2}"), "abcdef"), "ab");
+    EXPECT_EQ(Format(FORMAT_STRING("{} {} {}"), 0.1, 1e300, -0.5f), "0.1 1e+300 -0.5");
+    EXPECT_EQ(Format(FORMAT_STRING("{:.2f} {:e} {:.1E}"), 2.005, 1234.5, 1234.5),
+              "2.00 1.2345e+03 1.2E+03");
+}
+
+TEST(Format, Buffer)
+{
+    char   buffer[8];
+    size_t length = FormatTo(buffer, sizeof(buffer), FORMAT_STRING("{}-{}"), 1234, 5678);
+    EXPECT_EQ(length, 9);
+    EXPECT_STREQ(buffer, "1234-56");
+
+    EXPECT_EQ(FormatTo(buffer, sizeof(buffer), FORMAT_STRING("{}"), 7), 1);
+    EXPECT_STREQ(buffer, "7");
+    EXPECT_EQ(FormatTo(nullptr, 0, FORMAT_STRING("{:10}"), 7), 10);
+}
+
+TEST(Format, SmallString)
+{
+    pmr::profile_resource profile {pmr::profile_resource::record_mode::none};
+
+    SmallString<16> s {&profile};
+    FormatTo(s, FORMAT_STRING("id={}"), 42);
+    FormatTo(s, FORMAT_STRING(", name={}"), "abc");
+    EXPECT_EQ(s, "id=42, name=abc");
+    EXPECT_TRUE(s.is_inline());
+    EXPECT_EQ(profile.get_stat().num_allocations, 0);
+
+    // Grows and formats again when the capacity is exceeded
+    FormatTo(s, FORMAT_STRING(", long={:>30}"), "tail");
+    EXPECT_EQ(s.size(), 15 + 7 + 30);
+    EXPECT_EQ(s.view().substr(15), ", long=                          tail");
+    EXPECT_EQ(profile.get_stat().num_allocations, 1);
+}
\ No newline at end of file
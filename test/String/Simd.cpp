@@ -0,0 +1,193 @@
+#include "FTC/String/Simd.hpp"
+
+#include "FTC/String/ConstString.hpp"
+
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace ftc;
+using namespace ftc::simd;
+
+/// Runs f once for every instruction set supported by the cpu
+template <typename F> void ForEachLevel(F &&f)
+{
+    SimdLevel saved = ActiveLevel();
+    std::vector<SimdLevel> done;
+    for (SimdLevel level :
+         {SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::SSE42, SimdLevel::AVX2, SimdLevel::NEON}) {
+        level = SetLevel(level);
+        if (std::find(done.begin(), done.end(), level) != done.end())
+            continue;
+        done.push_back(level);
+        SCOPED_TRACE(int(level));
+        f();
+    }
+    SetLevel(saved);
+}
+
+TEST(Simd, SetLevel)
+{
+    SimdLevel saved = ActiveLevel();
+    EXPECT_EQ(saved, SupportedLevel());
+    EXPECT_EQ(SetLevel(SimdLevel::Scalar), SimdLevel::Scalar);
+    EXPECT_EQ(ActiveLevel(), SimdLevel::Scalar);
+    EXPECT_EQ(SetLevel(SupportedLevel()), SupportedLevel());
+    if (SupportedLevel() != SimdLevel::NEON) {
+        EXPECT_EQ(SetLevel(SimdLevel::NEON), SimdLevel::Scalar);
+    }
+    SetLevel(saved);
+}
+
+TEST(Simd, FindChar)
+{
+    ForEachLevel([] {
+        for (std::size_t len = 0; len < 80; len++) {
+            for (std::size_t at = 0; at <= len; at++) {
+                std::string str(len, 'a');
+                if (at < len)
+                    str[at] = '\xF0';
+                EXPECT_EQ(FindChar(str, '\xF0'), std::string_view(str).find('\xF0'));
+                EXPECT_EQ(FindChar(str, '\xF0', at / 2),
+                          std::string_view(str).find('\xF0', at / 2));
+            }
+        }
+        EXPECT_EQ(FindChar("abc", 'c', 3), npos);
+        EXPECT_EQ(FindChar("abc", 'c', 10), npos);
+        EXPECT_EQ(FindChar("", 'c'), npos);
+    });
+}
+
+TEST(Simd, FindAnyOf)
+{
+    constexpr CharSet Delims(ConstString(" ,;\t"));
+    static_assert(Delims.Contains(';') && !Delims.Contains('a') && Delims.Size() == 4);
+
+    std::string allChars;
+    for (int c = 0; c < 256; c += 7)
+        allChars.push_back(char(c));
+
+    ForEachLevel([&] {
+        for (std::string_view chars : {std::string_view(" ,;\t"), std::string_view(allChars)}) {
+            CharSet set(chars);
+            for (std::size_t len = 0; len < 70; len++) {
+                for (char target : chars) {
+                    std::string str(len, 'b');
+                    if (len > 0)
+                        str[len * 3 / 4] = target;
+                    EXPECT_EQ(FindAnyOf(str, set), str.find_first_of(chars));
+                    EXPECT_EQ(FindAnyOf(str, chars, len / 4), str.find_first_of(chars, len / 4));
+                }
+            }
+        }
+        EXPECT_EQ(FindAnyOf("key=value; next", Delims), 9u);
+        EXPECT_EQ(FindAnyOf("no delimiters", CharSet()), npos);
+    });
+}
+
+TEST(Simd, Find)
+{
+    constexpr Searcher Header(ConstString("Content-Length:"));
+    constexpr Searcher Short("ab");
+    static_assert(Header.Needle() == "Content-Length:");
+
+    ForEachLevel([&] {
+        std::string text(100, 'C');
+        for (std::size_t at = 0; at + 15 <= text.size(); at += 7) {
+            std::string str = text;
+            str.replace(at, 15, "Content-Length:");
+            EXPECT_EQ(Header.Find(str), at);
+            EXPECT_EQ(Find(str, "Content-Length:"), at);
+            EXPECT_EQ(Find(str, "Content-Length:", at + 1), npos);
+        }
+        for (std::size_t len = 0; len < 50; len++) {
+            std::string str(len, 'a');
+            str += "ab";
+            EXPECT_EQ(Short.Find(str), len);
+            EXPECT_EQ(Find(str, "aab"), len ? len - 1 : npos);
+        }
+        EXPECT_EQ(Find("abc", ""), 0u);
+        EXPECT_EQ(Find("abc", "", 3), 3u);
+        EXPECT_EQ(Find("abc", "c"), 2u);
+        EXPECT_EQ(Find("abc", "abcd"), npos);
+        EXPECT_EQ(Header.Find("Content-Length"), npos);
+    });
+}
+
+TEST(Simd, Equal)
+{
+    ForEachLevel([] {
+        for (std::size_t len = 0; len < 70; len++) {
+            std::string a(len, 'x'), b(len, 'x');
+            EXPECT_TRUE(Equal(a, b));
+            for (std::size_t at = 0; at < len; at++) {
+                b[at] = 'y';
+                EXPECT_FALSE(Equal(a, b));
+                b[at] = 'x';
+            }
+        }
+        EXPECT_FALSE(Equal("abc", "ab"));
+    });
+}
+
+TEST(Simd, CaseFolding)
+{
+    std::string allChars;
+    for (int c = 0; c < 256; c++)
+        allChars.push_back(char(c));
+
+    std::string lower = allChars, upper = allChars;
+    for (char &c : lower)
+        c = c >= 'A' && c <= 'Z' ? char(c + 32) : c;
+    for (char &c : upper)
+        c = c >= 'a' && c <= 'z' ? char(c - 32) : c;
+
+    ForEachLevel([&] {
+        EXPECT_EQ(ToLower(allChars), lower);
+        EXPECT_EQ(ToUpper(allChars), upper);
+        EXPECT_TRUE(EqualIgnoreCase(lower, upper));
+        EXPECT_TRUE(EqualIgnoreCase(allChars, lower));
+
+        std::string inPlace = allChars;
+        ToLower(inPlace, inPlace.data());
+        EXPECT_EQ(inPlace, lower);
+
+        for (std::size_t len = 1; len < 70; len++) {
+            std::string a(len, 'Q'), b(len, 'q');
+            EXPECT_TRUE(EqualIgnoreCase(a, b));
+            b[len - 1] = 'Q' ^ 0x20 ^ 0x01;
+            EXPECT_FALSE(EqualIgnoreCase(a, b));
+            a[len - 1] = '@';
+            b[len - 1] = '`';  // differ by 0x20, but are not letters
+            EXPECT_FALSE(EqualIgnoreCase(a, b));
+        }
+    });
+}
+
+TEST(Simd, IsValidUtf8)
+{
+    ForEachLevel([] {
+        std::string ascii(100, 'a');
+        EXPECT_TRUE(IsValidUtf8(""));
+        EXPECT_TRUE(IsValidUtf8(ascii));
+        EXPECT_TRUE(IsValidUtf8(ascii + "\xC3\xA9" + ascii + "\xE2\x82\xAC" + ascii));
+        EXPECT_TRUE(IsValidUtf8(ascii + "\xF0\x9F\x98\x80\xF0\x9F\x98\x80"));
+        EXPECT_TRUE(IsValidUtf8("\xED\x9F\xBF\xEE\x80\x80\xF4\x8F\xBF\xBF"));
+
+        for (std::string_view bad : {"\x80",
+                                     "\xC0\xAF",          // overlong
+                                     "\xC3",              // truncated
+                                     "\xE0\x80\xAF",      // overlong
+                                     "\xED\xA0\x80",      // surrogate
+                                     "\xF0\x80\x80\xAF",  // overlong
+                                     "\xF4\x90\x80\x80",  // above U+10FFFF
+                                     "\xF8\x88\x80\x80\x80",
+                                     "\xE2\x82"}) {
+            EXPECT_FALSE(IsValidUtf8(bad)) << bad.size();
+            EXPECT_FALSE(IsValidUtf8(ascii + std::string(bad) + ascii));
+            EXPECT_FALSE(IsValidUtf8(ascii.substr(0, 37) + std::string(bad)));
+        }
+    });
+}
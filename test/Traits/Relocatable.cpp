@@ -0,0 +1,113 @@
+#include "FTC/Traits/Relocatable.hpp"
+
+#include "FTC/Debug/LifetimeTester.hpp"
+
+#include <gtest/gtest.h>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace ftc;
+
+namespace {
+struct OptIn
+{
+    using trivially_relocatable = std::true_type;
+    std::unique_ptr<int> p;
+};
+
+struct OptOut
+{
+    using trivially_relocatable = std::false_type;
+    int x;
+};
+
+struct Specialized
+{
+    Specialized(Specialized &&) {}
+};
+
+struct SelfPointer
+{
+    SelfPointer() : self(this) {}
+    SelfPointer(SelfPointer &&) : self(this) {}
+    SelfPointer *self;
+};
+}  // namespace
+
+template <> struct ftc::is_trivially_relocatable<Specialized> : std::true_type
+{};
+
+TEST(Relocatable, Traits)
+{
+    static_assert(is_trivially_relocatable_v<int>);
+    static_assert(is_trivially_relocatable_v<int[4]>);
+    static_assert(is_trivially_relocatable_v<OptIn>);
+    static_assert(is_trivially_relocatable_v<OptOut>);  // trivially copyable anyway
+    static_assert(is_trivially_relocatable_v<Specialized>);
+    static_assert(!is_trivially_relocatable_v<SelfPointer>);
+    static_assert(!is_trivially_relocatable_v<std::list<int>>);
+
+    static_assert(is_trivially_relocatable_v<std::unique_ptr<std::string>>);
+    static_assert(is_trivially_relocatable_v<std::shared_ptr<int>>);
+    static_assert(is_trivially_relocatable_v<std::weak_ptr<int>>);
+    static_assert(is_trivially_relocatable_v<std::pair<std::unique_ptr<int>, int>>);
+    static_assert(is_trivially_relocatable_v<std::tuple<std::shared_ptr<int>, OptIn>>);
+    static_assert(!is_trivially_relocatable_v<std::tuple<int, SelfPointer>>);
+    static_assert(is_trivially_relocatable_v<std::optional<std::unique_ptr<int>>>);
+    static_assert(is_trivially_relocatable_v<std::array<OptIn, 2>>);
+
+    static_assert(is_nothrow_relocatable_v<Specialized>);
+    static_assert(is_nothrow_relocatable_v<std::list<int>>);
+}
+
+TEST(Relocatable, Relocate)
+{
+    using Counter = LifetimeCounter<struct RelocateTag>;
+    using Tester  = LifetimeTester<Counter>;
+    struct Relocatable : Tester
+    {
+        using trivially_relocatable = std::true_type;
+        using Tester::Tester;
+    };
+
+    alignas(Tester) unsigned char src[4 * sizeof(Tester)];
+    alignas(Tester) unsigned char dst[4 * sizeof(Tester)];
+
+    {
+        Counter::Scope scope;
+        Relocatable *  s = reinterpret_cast<Relocatable *>(src);
+        Relocatable *  d = reinterpret_cast<Relocatable *>(dst);
+        for (int i = 0; i < 4; i++)
+            new (s + i) Relocatable("relocated");
+
+        EXPECT_EQ(UninitializedRelocate(s, s + 4, d), d + 4);
+        EXPECT_EQ(RelocateAt(d + 3, s), s);
+        EXPECT_STREQ(s->Name(), "relocated");
+        EXPECT_EQ(scope.Delta().Constructs(), 4);
+        EXPECT_EQ(scope.Delta().destructs, 0);
+
+        s->~Relocatable();
+        for (int i = 0; i < 3; i++)
+            d[i].~Relocatable();
+    }
+    {
+        // Other types are moved and destroyed one by one
+        Counter::Scope scope;
+        Tester *       s = reinterpret_cast<Tester *>(src);
+        Tester *       d = reinterpret_cast<Tester *>(dst);
+        for (int i = 0; i < 4; i++)
+            new (s + i) Tester("moved");
+
+        EXPECT_EQ(UninitializedRelocateN(s, 4, d), d + 4);
+        EXPECT_EQ(RelocateAt(d + 3, s), s);
+        EXPECT_EQ(scope.Delta().moveConstructs, 5);
+        EXPECT_EQ(scope.Delta().destructs, 5);
+        EXPECT_EQ(scope.Delta().live, 4);
+
+        s->~Tester();
+        for (int i = 0; i < 3; i++)
+            d[i].~Tester();
+    }
+}